@@ -0,0 +1,118 @@
+/********************************************************************************//**
+\file      OVR_CAPI_Profiler.h
+\brief     Per-call latency profiling of the LibOVR entry points
+\copyright Copyright 2016 Oculus VR, LLC All Rights reserved.
+*************************************************************************************/
+
+#ifndef OVR_CAPI_Profiler_h
+#define OVR_CAPI_Profiler_h
+
+
+#include "OVR_CAPI.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/// Layout of the ovrCallProfile latency histogram.
+///
+/// The histogram is log-linear: bucket 0 counts calls faster than 2^MinExponent
+/// nanoseconds, and each following power of two is split into SubBucketCount linear
+/// buckets, so every bucket is within 25% of the latencies it counts. The last bucket
+/// also counts every call slower than 2^(MaxExponent + 1) nanoseconds.
+///
+/// \see ovrCallProfile, ovr_GetCallProfileBucketLimit
+///
+typedef enum ovrCallProfileHistogram_
+{
+    ovrCallProfile_SubBucketBits  = 2,
+    ovrCallProfile_SubBucketCount = (1 << ovrCallProfile_SubBucketBits),
+    ovrCallProfile_MinExponent    = 7,  ///< 128 nanoseconds.
+    ovrCallProfile_MaxExponent    = 31, ///< About 4.3 seconds.
+    ovrCallProfile_BucketCount    = 1 + (ovrCallProfile_MaxExponent - ovrCallProfile_MinExponent + 1) * ovrCallProfile_SubBucketCount
+} ovrCallProfileHistogram;
+
+
+/// Call statistics for a single LibOVR entry point, summed over all threads.
+///
+/// \see ovr_GetCallProfiles
+///
+typedef struct ovrCallProfile_
+{
+    /// Name of the entry point, such as "ovr_SubmitFrame".
+    const char* FunctionName;
+
+    /// Number of calls into the runtime.
+    uint64_t CallCount;
+
+    /// Total and longest time spent in the runtime, in nanoseconds.
+    uint64_t TotalNanoseconds;
+    uint64_t MaxNanoseconds;
+
+    /// Number of calls per latency bucket.
+    uint32_t Histogram[ovrCallProfile_BucketCount];
+} ovrCallProfile;
+
+
+/// Gets the call statistics of the LibOVR entry points.
+///
+/// Profiling is compiled into the LibOVR static library only when OVR_CAPI_PROFILE is
+/// defined; otherwise no calls are timed and this function returns 0. Entry points are
+/// only timed while the runtime library is loaded, since calls that fail before reaching
+/// the runtime cost nothing.
+///
+/// \param[out] outProfiles Receives one ovrCallProfile per entry point that was called
+///             since the last reset. May be NULL to query the count.
+/// \param[in] profilesCapacity Specifies the number of elements outProfiles can hold.
+///
+/// \return Returns the number of entry points that were called, which may be larger than
+///         profilesCapacity.
+///
+OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetCallProfiles(ovrCallProfile* outProfiles, unsigned int profilesCapacity);
+
+/// Clears the call statistics of all threads.
+///
+/// Each thread clears its own statistics the next time it calls an entry point, so calls
+/// made concurrently with the reset may be counted on either side of it.
+///
+OVR_PUBLIC_FUNCTION(void) ovr_ResetCallProfiles();
+
+/// Gets the upper latency limit of a histogram bucket.
+///
+/// \param[in] bucketIndex Specifies a bucket in [0, ovrCallProfile_BucketCount).
+///
+/// \return Returns the latency in nanoseconds below which calls are counted in the bucket.
+///
+OVR_PUBLIC_FUNCTION(uint64_t) ovr_GetCallProfileBucketLimit(unsigned int bucketIndex);
+
+/// Estimates a latency percentile from an ovrCallProfile histogram.
+///
+/// \param[in] profile Specifies the profile to use.
+/// \param[in] percentile Specifies the percentile in [0, 100], such as 99.
+///
+/// \return Returns the upper limit in nanoseconds of the bucket containing the percentile,
+///         or 0 if the profile has no calls.
+///
+OVR_PUBLIC_FUNCTION(uint64_t) ovr_GetCallProfilePercentile(const ovrCallProfile* profile, double percentile);
+
+/// Reports the call statistics periodically.
+///
+/// Every intervalSeconds, the first entry point called after the interval has elapsed
+/// sends one line per entry point called during the interval to the callback at
+/// ovrLogLevel_Info. Reporting doesn't reset the statistics that ovr_GetCallProfiles returns.
+///
+/// \param[in] intervalSeconds Specifies the reporting interval, or 0 to stop reporting.
+/// \param[in] callback Specifies the function that receives the report lines.
+/// \param[in] userData Specifies the value passed to the callback.
+///
+OVR_PUBLIC_FUNCTION(void) ovr_SetCallProfileReporting(double intervalSeconds, ovrLogCallback callback, uintptr_t userData);
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+
+#endif // Header include guard
@@ -0,0 +1,117 @@
+/********************************************************************************//**
+\file      OVR_CAPI_Properties.h
+\brief     Cached, typed handles for reading LibOVR properties
+\copyright Copyright 2016 Oculus VR, LLC All Rights reserved.
+*************************************************************************************/
+
+#ifndef OVR_CAPI_Properties_h
+#define OVR_CAPI_Properties_h
+
+
+#include "OVR_CAPI.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/// Every ovr_GetBool, ovr_GetInt, ovr_GetFloat, ovr_GetFloatArray and ovr_GetString call
+/// looks the property up by name in the runtime. Applications that read properties every
+/// frame can instead resolve each property once to a handle, which points at a copy of the
+/// value held by the LibOVR shim. Reading the value is then a plain memory read.
+///
+/// Cached values are updated:
+///     - When the application changes the property with ovr_SetBool, ovr_SetInt,
+///       ovr_SetFloat, ovr_SetFloatArray or ovr_SetString on the same session.
+///     - When the application calls ovr_RefreshProperties, such as once per second for
+///       properties that the runtime or other applications change.
+///
+/// The string functions keep working as before, and remain the way to read properties
+/// once or to write them.
+
+
+/// Maximum number of elements cached for an ovrPropertyType_FloatArray property.
+#define OVR_PROPERTY_MAX_FLOAT_COUNT 16
+
+/// Capacity of the cached value of an ovrPropertyType_String property, including the
+/// terminating null. Longer strings are truncated.
+#define OVR_PROPERTY_MAX_STRING_SIZE 256
+
+
+/// Selects how a property is read, which is the same as the ovr_Get function used.
+///
+/// \see ovr_GetPropertyHandle
+///
+typedef enum ovrPropertyType_
+{
+    ovrPropertyType_Bool       = 0, ///< Read with ovr_GetBool into ovrPropertyValue::Bool.
+    ovrPropertyType_Int        = 1, ///< Read with ovr_GetInt into ovrPropertyValue::Int.
+    ovrPropertyType_Float      = 2, ///< Read with ovr_GetFloat into ovrPropertyValue::Float.
+    ovrPropertyType_FloatArray = 3, ///< Read with ovr_GetFloatArray into ovrPropertyValue::FloatArray.
+    ovrPropertyType_String     = 4, ///< Read with ovr_GetString into ovrPropertyValue::String.
+    ovrPropertyType_EnumSize   = 0x7fffffff ///< \internal Force type int32_t.
+} ovrPropertyType;
+
+
+/// The cached value of a property. Only the member matching Type is set.
+///
+typedef struct ovrPropertyValue_
+{
+    ovrPropertyType Type;
+    ovrBool         Bool;
+    int             Int;
+    float           Float;
+    unsigned int    FloatCount; ///< Number of valid FloatArray elements, 0 if the property doesn't exist.
+    float           FloatArray[OVR_PROPERTY_MAX_FLOAT_COUNT];
+    char            String[OVR_PROPERTY_MAX_STRING_SIZE];
+} ovrPropertyValue;
+
+
+/// A resolved property, which stays valid until its session is destroyed or ovr_Shutdown
+/// is called.
+typedef const ovrPropertyValue* ovrPropertyHandle;
+
+
+/// Resolves a property to a handle and reads its value.
+///
+/// Resolving the same name, session and type again returns the same handle.
+///
+/// \param[in] session Specifies an ovrSession previously returned by ovr_Create, or NULL
+///            like the ovr_Get functions.
+/// \param[in] propertyName The name of the property, which needs to be valid only for the call.
+/// \param[in] type Specifies the type to read the property as.
+/// \param[in] defaultValue Specifies the value of ovrPropertyType_Bool, ovrPropertyType_Int
+///            and ovrPropertyType_Float properties that don't exist, like the defaultVal
+///            argument of the ovr_Get functions. Missing array and string properties are
+///            always empty.
+/// \param[out] outHandle Receives the handle.
+///
+/// \return Returns an ovrResult indicating success or failure.
+///
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetPropertyHandle(ovrSession session, const char* propertyName,
+                                                     ovrPropertyType type, double defaultValue,
+                                                     ovrPropertyHandle* outHandle);
+
+/// Reads the current values of several properties from the runtime in a single call.
+///
+/// The values are updated in place, so the application must not read them from other
+/// threads while they are refreshed.
+///
+/// \param[in] session Specifies the session that the handles were resolved for.
+/// \param[in] handles Specifies the properties to read, or NULL for all the session's properties.
+/// \param[in] handleCount Specifies the number of handles.
+///
+/// \return Returns an ovrResult indicating success or failure. Fails with
+///         ovrError_InvalidParameter if a handle doesn't belong to the session.
+///
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_RefreshProperties(ovrSession session, const ovrPropertyHandle* handles,
+                                                     unsigned int handleCount);
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+
+#endif // Header include guard
@@ -0,0 +1,103 @@
+/********************************************************************************//**
+\file      OVR_CAPI_Replay.h
+\brief     Client side recording and replay of LibOVR tracking and input results
+\copyright Copyright 2016 Oculus VR, LLC All Rights reserved.
+*************************************************************************************/
+
+#ifndef OVR_CAPI_Replay_h
+#define OVR_CAPI_Replay_h
+
+
+#include "OVR_CAPI.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/// The LibOVR shim can record the results of ovr_GetTrackingState, ovr_GetInputState and
+/// ovr_GetPredictedDisplayTime to a file, and later return the recorded results in place of
+/// the runtime's. This lets an application be run again with exactly the motion, input and
+/// frame timing of an earlier session, such as to reproduce a bug or to compare rendering.
+///
+/// Unlike the runtime's own recording (the "server:RecordingEnabled" property), the recorded
+/// results are those the application received, so replay doesn't depend on the runtime
+/// version or on the tracking algorithms.
+///
+/// The file holds one record per call with the runtime time of the call. Each record is
+/// stored as its difference from the previous record of the same function, which keeps a
+/// recording to a few hundred bytes per frame.
+
+
+/// Receives the recorded time of each replayed call.
+///
+/// Applications that use their own clock, such as OVR::Timer with SetVirtualSeconds, can
+/// use this to run on the recorded time. The times passed never decrease.
+///
+/// \param[in] userData Specifies the value given to ovr_StartCallReplay.
+/// \param[in] timeInSeconds Specifies the ovr_GetTimeInSeconds value at which the replayed
+///            call was made when recording.
+///
+/// \see ovr_StartCallReplay
+///
+typedef void (OVR_CDECL* ovrCallReplayTimeCallback)(uintptr_t userData, double timeInSeconds);
+
+
+/// Starts recording the results of ovr_GetTrackingState, ovr_GetInputState and
+/// ovr_GetPredictedDisplayTime to a file.
+///
+/// Calls are recorded from every thread and session until ovr_StopCallRecording or
+/// ovr_Shutdown. Calls that fail before reaching the runtime are not recorded.
+///
+/// \param[in] path Specifies the file to write, which is replaced if it exists.
+///
+/// \return Returns an ovrResult indicating success or failure. Fails with
+///         ovrError_InvalidOperation if recording or replay is already active.
+///
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_StartCallRecording(const char* path);
+
+/// Stops recording and closes the recording file. Does nothing if not recording.
+///
+OVR_PUBLIC_FUNCTION(void) ovr_StopCallRecording();
+
+/// Starts returning recorded results in place of the runtime's.
+///
+/// Each function returns its recorded results in order, whatever arguments it is called
+/// with, except that ovr_GetInputState returns the next result recorded for the requested
+/// controller type. The runtime must still be initialized and the session created, since
+/// all other functions are forwarded to it as usual.
+///
+/// Replay stops by itself when a function runs out of recorded results, after which calls
+/// are forwarded to the runtime again. \see ovr_IsCallReplayActive
+///
+/// \param[in] path Specifies a file written by ovr_StartCallRecording.
+/// \param[in] timeCallback Specifies an optional function that receives the recorded time of
+///            each replayed call. May be NULL.
+/// \param[in] userData Specifies the value passed to timeCallback.
+///
+/// \return Returns an ovrResult indicating success or failure. Fails with
+///         ovrError_InvalidParameter if the file can't be read or isn't a recording, and
+///         with ovrError_InvalidOperation if recording or replay is already active.
+///
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_StartCallReplay(const char* path, ovrCallReplayTimeCallback timeCallback,
+                                                   uintptr_t userData);
+
+/// Stops replay. Does nothing if not replaying.
+///
+OVR_PUBLIC_FUNCTION(void) ovr_StopCallReplay();
+
+/// Tells whether recorded results are being returned.
+///
+/// \return Returns ovrTrue from ovr_StartCallReplay until replay is stopped or runs out of
+///         recorded results.
+///
+OVR_PUBLIC_FUNCTION(ovrBool) ovr_IsCallReplayActive();
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+
+#endif // Header include guard
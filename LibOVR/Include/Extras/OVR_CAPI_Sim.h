@@ -0,0 +1,157 @@
+/********************************************************************************//**
+\file      OVR_CAPI_Sim.h
+\brief     Control interface of the simulated LibOVR runtime
+\copyright Copyright 2016 Oculus VR, LLC All Rights reserved.
+*************************************************************************************/
+
+#ifndef OVR_CAPI_Sim_h
+#define OVR_CAPI_Sim_h
+
+
+#include "OVR_CAPI.h"
+#include <stddef.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/// The simulated runtime is a LibOVRRT replacement that needs no headset, service or
+/// graphics device. It is loaded by the LibOVR shim like the real runtime, so unmodified
+/// applications run against it when its directory is given in the LIBOVR_DLL_DIR
+/// environment variable.
+///
+/// It exports the whole LibOVR API and provides:
+///     - A fake frame clock that advances one refresh period per ovr_SubmitFrame, or
+///       that follows the system clock and paces ovr_SubmitFrame to it.
+///     - Deterministic head and hand poses, following either a scripted motion or
+///       recorded pose samples.
+///     - Input states, session status, boundary tests and ovrPerfStats.
+///     - Texture swap chains and mirror textures backed by CPU memory.
+///
+/// Applications that know about the simulated runtime can control it through the
+/// ovrSimRuntimeInterface returned by ovr_Lookup(OVR_SIM_RUNTIME_INTERFACE_NAME, ...).
+/// ovr_Lookup fails for this name with the real runtime.
+///
+/// The simulated runtime also reads these environment variables in ovr_Initialize:
+///     - OVR_SIM_CLOCK: "deterministic" (the default) or "realtime". \see ovrSimClockMode
+///     - OVR_SIM_FRAME_RATE: The display refresh rate in Hz. The default is 90.
+///     - OVR_SIM_POSE_FILE: Path of a text file of pose samples to replay in a loop, with
+///       one sample per line in the form "<device> <time> <px> <py> <pz> <qx> <qy> <qz> <qw>",
+///       where device is head, lhand or rhand and time is in seconds from the start.
+///
+#define OVR_SIM_RUNTIME_INTERFACE_NAME "OVR_SimRuntimeInterface"
+
+/// The ovrSimRuntimeInterface version described by this header.
+#define OVR_SIM_RUNTIME_INTERFACE_VERSION 1
+
+
+/// Selects how the simulated runtime's clock advances.
+///
+/// \see ovrSimRuntimeInterface::SetClockMode
+///
+typedef enum ovrSimClockMode_
+{
+    /// Time only advances in ovr_SubmitFrame, by exactly one refresh period, and in
+    /// ovrSimRuntimeInterface::AdvanceTime. Every run sees the same times and poses.
+    ovrSimClock_Deterministic = 0,
+
+    /// Time follows the system clock. ovr_SubmitFrame waits for the next refresh, and
+    /// frames submitted late are reported as dropped in ovrPerfStats.
+    ovrSimClock_RealTime      = 1,
+
+    ovrSimClock_EnumSize      = 0x7fffffff ///< \internal Force type int32_t.
+} ovrSimClockMode;
+
+
+/// Identifies a simulated tracked device.
+///
+typedef enum ovrSimDevice_
+{
+    ovrSimDevice_Head      = 0,
+    ovrSimDevice_LeftHand  = 1,
+    ovrSimDevice_RightHand = 2,
+    ovrSimDevice_Count     = 3,
+    ovrSimDevice_EnumSize  = 0x7fffffff ///< \internal Force type int32_t.
+} ovrSimDevice;
+
+
+/// A recorded device pose, in the eye level tracking space of an uncentered session.
+///
+/// \see ovrSimRuntimeInterface::SetPoseSamples
+///
+typedef struct OVR_ALIGNAS(8) ovrSimPoseSample_
+{
+    double   TimeInSeconds; ///< Time of the sample, relative to the first sample of its device.
+    ovrPosef Pose;
+    OVR_UNUSED_STRUCT_PAD(pad0, 4) ///< \internal struct pad.
+} ovrSimPoseSample;
+
+
+/// Functions that control the simulated runtime.
+///
+/// Every function returns ovrError_InvalidSession for sessions that weren't created by
+/// the simulated runtime.
+///
+typedef struct ovrSimRuntimeInterface_
+{
+    /// Equals OVR_SIM_RUNTIME_INTERFACE_VERSION for the version this header describes.
+    /// Later versions only append functions.
+    uint32_t Version;
+
+    /// Selects how the clock advances, and the display refresh rate in Hz.
+    /// The clock is shared by all sessions and restarts at ovr_Initialize.
+    ovrResult (OVR_CDECL* SetClockMode)(ovrSimClockMode mode, float refreshRate);
+
+    /// Advances a deterministic clock without submitting a frame, for applications that
+    /// only read tracking or input. Fails with ovrError_InvalidOperation in real time mode.
+    ovrResult (OVR_CDECL* AdvanceTime)(double seconds);
+
+    /// Replaces the scripted motion of a device with pose samples, which are interpolated
+    /// in time and optionally replayed in a loop. The samples are copied and must be in
+    /// increasing time order. Passing zero samples restores the scripted motion.
+    ovrResult (OVR_CDECL* SetPoseSamples)(ovrSession session, ovrSimDevice device,
+                                          const ovrSimPoseSample* samples, unsigned int sampleCount,
+                                          ovrBool loop);
+
+    /// Sets which controllers ovr_GetConnectedControllerTypes reports, as ovrControllerType bits.
+    ovrResult (OVR_CDECL* SetConnectedControllerTypes)(ovrSession session, unsigned int controllerTypes);
+
+    /// Sets the input state that ovr_GetInputState returns for a single controller type.
+    /// TimeInSeconds and ControllerType are filled in by ovr_GetInputState.
+    ovrResult (OVR_CDECL* SetInputState)(ovrSession session, ovrControllerType controllerType,
+                                         const ovrInputState* inputState);
+
+    /// Sets the status that ovr_GetSessionStatus returns, such as to test applications'
+    /// handling of ShouldQuit or of losing visibility.
+    ovrResult (OVR_CDECL* SetSessionStatus)(ovrSession session, const ovrSessionStatus* sessionStatus);
+
+    /// Gets the memory of a texture swap chain buffer. Buffers are tightly packed, with all
+    /// the mip levels of an array element following each other, largest first.
+    ovrResult (OVR_CDECL* GetTextureSwapChainBufferData)(ovrSession session, ovrTextureSwapChain chain,
+                                                         int index, void** outData, size_t* outSize);
+
+    /// Gets the memory of a mirror texture, which ovr_SubmitFrame fills with the eye views of
+    /// the first ovrLayerType_EyeFov layer when the formats have four bytes per texel.
+    ovrResult (OVR_CDECL* GetMirrorTextureData)(ovrSession session, ovrMirrorTexture mirror,
+                                                void** outData, size_t* outSize);
+} ovrSimRuntimeInterface;
+
+
+/// Looks up a named runtime extension. The LibOVR shim forwards this to the runtime.
+///
+/// \param[in] name Specifies the extension, such as OVR_SIM_RUNTIME_INTERFACE_NAME.
+/// \param[out] data Receives a pointer to the extension, such as an ovrSimRuntimeInterface.
+///
+/// \return Returns ovrSuccess if the runtime provides the extension.
+///
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_Lookup(const char* name, void** data);
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+
+#endif // Header include guard
@@ -79,6 +79,9 @@ typedef enum ovrHapticsGenMode_
 {
     /// Point sample original signal at Haptics frequency
     ovrHapticsGenMode_PointSample,
+    /// Follow the loudness of the signal, averaged over each Haptics sample period so that
+    /// frequencies above the Haptics Nyquist rate don't alias, and released over 25 ms.
+    ovrHapticsGenMode_Envelope,
     ovrHapticsGenMode_Count
 } ovrHapticsGenMode;
 
@@ -105,6 +108,111 @@ typedef struct ovrHapticsClip_
     int SamplesCount;
 } ovrHapticsClip;
 
+/// State of a streaming Haptics generator, which converts audio to Haptics samples block by block.
+/// The generator doesn't allocate memory, and whatever size the blocks are, it generates the same
+/// samples as ovr_GenHapticsFromAudioData over the whole audio, up to float rounding.
+///
+/// \see ovr_InitHapticsStream, ovr_GenHapticsFromAudioStream
+///
+typedef struct ovrHapticsStream_
+{
+    /// Audio frequency (e.g. 48000)
+    int Frequency;
+    /// Mode used to convert audio to Haptics data
+    ovrHapticsGenMode GenMode;
+    /// Number of audio samples consumed so far
+    long long AudioSamplesCount;
+    /// Number of Haptics samples generated so far
+    long long HapticsSamplesCount;
+    double SamplesPerStep;  ///< \internal Audio samples per Haptics sample.
+    float LevelSum;         ///< \internal Sum of absolute audio samples in the current Haptics period.
+    float Envelope;         ///< \internal Level of the last generated Haptics sample.
+} ovrHapticsStream;
+
+/// A ring buffer of Haptics samples in memory owned by the application.
+/// When the ring is full, adding a sample drops the oldest one, which bounds the latency of
+/// the samples that are played.
+///
+/// \see ovr_GenHapticsFromAudioStream, ovr_SubmitHapticsRing
+///
+typedef struct ovrHapticsRing_
+{
+    /// Storage for Capacity samples
+    uint8_t* Samples;
+    /// Maximum number of samples held
+    int Capacity;
+    /// Index of the oldest sample
+    int ReadIndex;
+    /// Number of samples held, starting at ReadIndex and wrapping around
+    int SamplesCount;
+} ovrHapticsRing;
+
+/// Describes a view rendered relative to the HMD, such as an eye, one of the views of a
+/// quad view layout, or a layer camera.
+///
+/// \see ovr_CalcViews
+///
+typedef struct ovrViewDesc_
+{
+    /// Pose of the view relative to the HMD. For an eye, this is ovrEyeRenderDesc::HmdToEyeOffset
+    /// with an identity orientation.
+    ovrPosef HmdToViewPose;
+    /// Field of view of the projection
+    ovrFovPort Fov;
+    /// Near and far clipping plane distances, as passed to ovrMatrix4f_Projection
+    float ZNear;
+    float ZFar;
+    /// Combination of ovrProjectionModifier flags
+    unsigned int ProjectionModFlags;
+} ovrViewDesc;
+
+/// Results of ovr_CalcViews for a single view.
+/// Must be zero-initialized before its first use, and kept between frames so that the
+/// projection is only recomputed when the ovrViewDesc it depends on changes.
+///
+/// \see ovr_CalcViews
+///
+typedef struct ovrViewState_
+{
+    /// Pose of the view, which is passed to ovr_SubmitFrame in ovrLayerEyeFov::RenderPose
+    ovrPosef Pose;
+    /// Transform from the tracking space to the view space, which is the inverse of Pose
+    ovrMatrix4f View;
+    /// Same as ovrMatrix4f_Projection for the view's Fov, ZNear, ZFar and ProjectionModFlags
+    ovrMatrix4f Projection;
+    /// Same as ovrTimewarpProjectionDesc_FromProjection for Projection
+    ovrTimewarpProjectionDesc TimewarpProjectionDesc;
+    ovrFovPort CachedFov;                   ///< \internal Fov that Projection was computed for.
+    float CachedZNear;                      ///< \internal ZNear that Projection was computed for.
+    float CachedZFar;                       ///< \internal ZFar that Projection was computed for.
+    unsigned int CachedProjectionModFlags;  ///< \internal Flags that Projection was computed for.
+    ovrBool ProjectionValid;                ///< \internal Whether Projection was computed.
+    OVR_UNUSED_STRUCT_PAD(pad0, 3)          ///< \internal struct pad.
+} ovrViewState;
+
+/// A copy of the boundary geometry held by the application, which answers proximity queries
+/// for many points without calling the runtime for each of them. The boundary is treated as
+/// vertical walls standing on the floor points returned by ovr_GetBoundaryGeometry.
+/// Must be zero-initialized before its first use, and released with ovr_ReleaseBoundaryField
+/// to avoid memory leak.
+///
+/// \see ovr_UpdateBoundaryField, ovr_TestBoundaryFieldPoints
+///
+typedef struct ovrBoundaryField_
+{
+    /// Boundary type the field was last updated for
+    ovrBoundaryType BoundaryType;
+    /// Number of boundary floor points, or 0 if the boundary isn't set up
+    int PointsCount;
+    /// Distance from the boundary within which points report IsTriggering, in meters.
+    /// Points outside the boundary always report IsTriggering.
+    float TriggerDistance;
+    /// Incremented every time the boundary changes and the field is rebuilt
+    unsigned int Version;
+    /// Data stored in opaque format
+    const void* Data;
+} ovrBoundaryField;
+
 
 /// Detects Oculus Runtime and Device Status
 ///
@@ -206,6 +314,24 @@ OVR_PUBLIC_FUNCTION(void) ovr_GetEyePoses(ovrSession session, long long frameInd
                                              double* outSensorSampleTime);
 
 
+/// Computes the poses, view matrices and projection matrices of several views at once.
+///
+/// This is equivalent to computing, for each view, the pose with headPose * HmdToViewPose,
+/// the view matrix with the inverse of that pose, and the projection with
+/// ovrMatrix4f_Projection and ovrTimewarpProjectionDesc_FromProjection, but processes the
+/// poses of four views at a time and keeps each projection until its inputs change.
+///
+/// \param[in] headPose Indicates the HMD position and orientation to use for the calculation.
+/// \param[in] viewDescs Specifies viewCount views, such as the two eyes for stereo rendering.
+/// \param[in] viewCount Specifies the number of views.
+/// \param[in,out] inOutViews Specifies viewCount view states, which receive the results.
+///                 The states must be zero-initialized before the first call, and are
+///                 paired with viewDescs by index on every call.
+///
+OVR_PUBLIC_FUNCTION(void) ovr_CalcViews(ovrPosef headPose, const ovrViewDesc* viewDescs,
+                                        unsigned int viewCount, ovrViewState* inOutViews);
+
+
 
 /// Tracking poses provided by the SDK come in a right-handed coordinate system. If an application
 /// is passing in ovrProjection_LeftHanded into ovrMatrix4f_Projection, then it should also use
@@ -220,16 +346,63 @@ OVR_PUBLIC_FUNCTION(void) ovr_GetEyePoses(ovrSession session, long long frameInd
 ///
 OVR_PUBLIC_FUNCTION(void) ovrPosef_FlipHandedness(const ovrPosef* inPose, ovrPosef* outPose);
 
+/// Updates a boundary field from the runtime's current boundary geometry.
+///
+/// The field is only rebuilt when the geometry differs from the one it was built from, so this
+/// can be called every frame.
+///
+/// \param[in] session Specifies an ovrSession previously returned by ovr_Create.
+/// \param[in] boundaryType Must be either ovrBoundary_Outer or ovrBoundary_PlayArea.
+/// \param[in,out] inOutField Specifies the field to update.
+///
+/// \return Returns an ovrResult for which OVR_SUCCESS(result) is false upon error and true
+///         upon success. Return values include but aren't limited to:
+///     - ovrSuccess: The call succeeded and the field holds the boundary.
+///     - ovrSuccess_BoundaryInvalid: The call succeeded but the field is empty due to the
+///       boundary not being set up.
+///
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_UpdateBoundaryField(ovrSession session, ovrBoundaryType boundaryType,
+                                                       ovrBoundaryField* inOutField);
+
+/// Tests the proximity of many 3D points against a boundary field, with the same results as
+/// calling ovr_TestBoundaryPoint for each point. In particular ClosestDistance is negative
+/// for points outside the boundary.
+///
+/// Points are tested faster when consecutive points are close to each other.
+///
+/// \param[in] field Specifies a field updated with ovr_UpdateBoundaryField.
+/// \param[in] points Specifies the points to test.
+/// \param[in] pointsCount Specifies the number of points.
+/// \param[out] outTestResults Receives one result per point.
+/// \param[out] outIsInside Receives whether each point is inside the boundary. May be NULL.
+///
+/// \return Returns an ovrResult for which OVR_SUCCESS(result) is false upon error and true
+///         upon success. Return values include but aren't limited to:
+///     - ovrSuccess: The call succeeded and results were returned.
+///     - ovrSuccess_BoundaryInvalid: The call succeeded but the field is empty, and the
+///       results were zeroed.
+///
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_TestBoundaryFieldPoints(const ovrBoundaryField* field, const ovrVector3f* points,
+                                                           int pointsCount, ovrBoundaryTestResult* outTestResults,
+                                                           ovrBool* outIsInside);
+
+/// Releases memory allocated for ovrBoundaryField. Must be called to avoid memory leak.
+/// \param[in] field pointer to a boundary field
+///
+OVR_PUBLIC_FUNCTION(void) ovr_ReleaseBoundaryField(ovrBoundaryField* field);
+
 /// Reads an audio channel from Wav (Waveform Audio File) data.
 /// Input must be a byte buffer representing a valid Wav file. Audio samples from the specified channel are read,
 /// converted to float [-1.0f, 1.0f] and returned through ovrAudioChannelData.
 ///
-/// Supported formats: PCM 8b, 16b, 32b and IEEE float (little-endian only).
+/// Supported formats: PCM 8b, 16b, 24b, 32b and IEEE float 32b, 64b (little-endian only), including
+/// WAVE_FORMAT_EXTENSIBLE files. Chunks other than "fmt " and "data", such as LIST and fact, are skipped.
 ///
 /// \param[out] outAudioChannel output audio channel data.
 /// \param[in] inputData a binary buffer representing a valid Wav file data.
 /// \param[in] dataSizeInBytes size of the buffer in bytes.
-/// \param[in] stereoChannelToUse audio channel index to extract (0 for mono).
+/// \param[in] stereoChannelToUse audio channel index to extract (0 for mono). Channel 0 is used if the
+///            file has fewer channels.
 ///
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_ReadWavFromBuffer(ovrAudioChannelData* outAudioChannel, const void* inputData, int dataSizeInBytes, int stereoChannelToUse);
 
@@ -241,6 +414,53 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_ReadWavFromBuffer(ovrAudioChannelData* outAud
 ///
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GenHapticsFromAudioData(ovrHapticsClip* outHapticsClip, const ovrAudioChannelData* audioChannel, ovrHapticsGenMode genMode);
 
+/// Generates playable Touch Haptics data from many audio channels at once, such as to convert a
+/// sound bank at load time. Large batches are spread over all CPU cores.
+/// Each clip needs to be released with ovr_ReleaseHapticsClip.
+///
+/// \param[out] outHapticsClips array of clipCount generated Haptics clips.
+/// \param[in] audioChannels array of clipCount input audio channels.
+/// \param[in] clipCount number of clips to generate.
+/// \param[in] genMode mode used to convert and audio channel data to Haptics data.
+///
+/// \return Returns ovrError_InvalidParameter without generating any clips if an audio channel is invalid.
+///
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GenHapticsFromAudioDataBatch(ovrHapticsClip* outHapticsClips, const ovrAudioChannelData* audioChannels,
+                                                                int clipCount, ovrHapticsGenMode genMode);
+
+/// Initializes a streaming Haptics generator.
+///
+/// \param[out] outStream generator state, owned by the application.
+/// \param[in] frequency audio frequency of the blocks that will be generated from.
+/// \param[in] genMode mode used to convert audio to Haptics data.
+///
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_InitHapticsStream(ovrHapticsStream* outStream, int frequency, ovrHapticsGenMode genMode);
+
+/// Generates Haptics samples from the next block of an audio stream, such as live game audio.
+/// Samples are added to the ring as soon as the audio for their whole period has been seen,
+/// so each call can produce none, one or several Haptics samples.
+///
+/// \param[in,out] stream generator state initialized by ovr_InitHapticsStream.
+/// \param[in] samples audio samples as floats [-1.0f, 1.0f], at the stream frequency.
+/// \param[in] samplesCount number of audio samples, which may be 0.
+/// \param[in,out] ring ring that receives the generated Haptics samples.
+///
+/// \return Returns the number of Haptics samples generated, or ovrError_InvalidParameter.
+///
+OVR_PUBLIC_FUNCTION(int) ovr_GenHapticsFromAudioStream(ovrHapticsStream* stream, const float* samples, int samplesCount, ovrHapticsRing* ring);
+
+/// Submits the samples of a Haptics ring to a Touch controller with ovr_SubmitControllerVibration,
+/// keeping at most maxQueuedSamples queued on the controller so that new samples play promptly.
+/// Submitted samples are removed from the ring, and samples that don't fit stay in it.
+///
+/// \param[in] session Specifies an ovrSession previously returned by ovr_Create.
+/// \param[in] controllerType Controller where the samples will be played.
+/// \param[in,out] ring ring of samples to submit.
+/// \param[in] maxQueuedSamples maximum number of samples to have queued on the controller, which
+///            should be at least ovrTouchHapticsDesc::QueueMinSizeToAvoidStarvation.
+///
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitHapticsRing(ovrSession session, ovrControllerType controllerType, ovrHapticsRing* ring, int maxQueuedSamples);
+
 /// Releases memory allocated for ovrAudioChannelData. Must be called to avoid memory leak.
 /// \param[in] audioChannel pointer to an audio channel
 ///
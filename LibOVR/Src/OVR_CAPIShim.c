@@ -34,6 +34,7 @@ limitations under the License.
 #include <string.h>
 #include <ctype.h>
 #include <assert.h>
+#include <time.h>
 
 #if defined(_WIN32)
     #if defined(_MSC_VER)
@@ -58,6 +59,9 @@ limitations under the License.
     #include <unistd.h>
 #endif
 #include "../Include/OVR_CAPI_GL.h"
+#include "../Include/Extras/OVR_CAPI_Profiler.h"
+#include "../Include/Extras/OVR_CAPI_Properties.h"
+#include "../Include/Extras/OVR_CAPI_Replay.h"
 
 
 #if defined(_MSC_VER)
@@ -1047,6 +1051,751 @@ static struct
     OVR_LIST_APIS(OVR_DECLARE_IMPORT, OVR_IGNORE_IMPORT)
 } API = { NULL };
 
+
+//-----------------------------------------------------------------------------------
+// ***** OVR_CAPI_PROFILE
+//
+// If defined then every call through the API table is timed, and its count and latency
+// histogram are accumulated in counters owned by the calling thread. The counters are
+// merged on demand by ovr_GetCallProfiles. Without OVR_CAPI_PROFILE the OVR_API_*
+// macros below are plain calls through the API table.
+//
+// The per-function ids, names and return types are generated from OVR_LIST_APIS(), like
+// the API table itself, so new entry points are profiled automatically.
+//
+
+#if defined(OVR_CAPI_PROFILE)
+
+#define OVR_DECLARE_CALL_ID(ReturnValue, FunctionName, OptionalVersion, Arguments) \
+    OVR_CallId_##FunctionName,
+
+typedef enum OVR_CallId_
+{
+    OVR_LIST_APIS(OVR_DECLARE_CALL_ID, OVR_IGNORE_IMPORT)
+    OVR_CallId_Count
+} OVR_CallId;
+
+#define OVR_DECLARE_CALL_NAME(ReturnValue, FunctionName, OptionalVersion, Arguments) \
+    #FunctionName,
+
+static const char* const OVR_CallNames[OVR_CallId_Count] =
+{
+    OVR_LIST_APIS(OVR_DECLARE_CALL_NAME, OVR_IGNORE_IMPORT)
+};
+
+// Declares OVR_ReturnType_<FunctionName>, for holding the result while the call is timed.
+#define OVR_DECLARE_RETURN_TYPE(ReturnValue, FunctionName, OptionalVersion, Arguments) \
+    typedef ReturnValue OVR_ReturnType_##FunctionName;
+
+OVR_LIST_APIS(OVR_DECLARE_RETURN_TYPE, OVR_IGNORE_IMPORT)
+
+#undef OVR_DECLARE_CALL_ID
+#undef OVR_DECLARE_CALL_NAME
+#undef OVR_DECLARE_RETURN_TYPE
+
+typedef struct OVR_CallCounters_
+{
+    uint64_t CallCount;
+    uint64_t TotalNanoseconds;
+    uint64_t MaxNanoseconds;
+    uint32_t Histogram[ovrCallProfile_BucketCount];
+} OVR_CallCounters;
+
+// Counters written only by the owning thread. They are kept after the thread exits,
+// so that its calls stay in the totals.
+typedef struct OVR_ThreadCallCounters_
+{
+    struct OVR_ThreadCallCounters_* Next;
+    long Generation; // Compared to OVR_CallProfileGeneration to apply ovr_ResetCallProfiles.
+    OVR_CallCounters Calls[OVR_CallId_Count];
+} OVR_ThreadCallCounters;
+
+#if defined(_MSC_VER)
+    #define OVR_CALL_PROFILE_THREAD_LOCAL __declspec(thread)
+#else
+    #define OVR_CALL_PROFILE_THREAD_LOCAL __thread
+#endif
+
+#if defined(_WIN32)
+    #define OVR_CallProfileCompareExchangePointer(destination, exchange, comparand) \
+        InterlockedCompareExchangePointer((PVOID volatile*)(destination), (exchange), (comparand))
+    #define OVR_CallProfileCompareExchange64(destination, exchange, comparand) \
+        InterlockedCompareExchange64((LONGLONG volatile*)(destination), (exchange), (comparand))
+    #define OVR_CallProfileIncrement(destination) InterlockedIncrement(destination)
+#else
+    #define OVR_CallProfileCompareExchangePointer(destination, exchange, comparand) \
+        __sync_val_compare_and_swap((destination), (comparand), (exchange))
+    #define OVR_CallProfileCompareExchange64(destination, exchange, comparand) \
+        __sync_val_compare_and_swap((destination), (comparand), (exchange))
+    #define OVR_CallProfileIncrement(destination) __sync_add_and_fetch((destination), 1)
+#endif
+
+static OVR_CALL_PROFILE_THREAD_LOCAL OVR_ThreadCallCounters* OVR_CurrentThreadCallCounters = NULL;
+static OVR_ThreadCallCounters* volatile OVR_AllThreadCallCounters = NULL; // Push-only list.
+static volatile long OVR_CallProfileGeneration = 0;
+
+// Periodic reporting state. OVR_CallProfileReportInterval is 0 when reporting is off.
+static volatile int64_t OVR_CallProfileReportInterval = 0;
+static volatile int64_t OVR_CallProfileNextReport = 0;
+static ovrLogCallback OVR_CallProfileReportCallback = NULL;
+static uintptr_t OVR_CallProfileReportUserData = 0;
+
+// Totals as of the previous report, so that each report covers only the calls since then
+// without resetting the statistics that ovr_GetCallProfiles returns. Used only by the
+// thread that wins OVR_CallProfileNextReport, and by ovr_SetCallProfileReporting.
+static OVR_CallCounters OVR_CallProfileReported[OVR_CallId_Count];
+static long OVR_CallProfileReportedGeneration = 0;
+
+static int64_t OVR_GetCallProfileTicksPerSecond()
+{
+    #if defined(_WIN32)
+        static int64_t ticksPerSecond = 0;
+        if (ticksPerSecond == 0)
+        {
+            LARGE_INTEGER frequency;
+            QueryPerformanceFrequency(&frequency);
+            ticksPerSecond = frequency.QuadPart;
+        }
+        return ticksPerSecond;
+    #else
+        return 1000000000;
+    #endif
+}
+
+static int64_t OVR_GetCallProfileTicks()
+{
+    #if defined(_WIN32)
+        LARGE_INTEGER ticks;
+        QueryPerformanceCounter(&ticks);
+        return ticks.QuadPart;
+    #else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ((int64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+    #endif
+}
+
+static uint64_t OVR_CallProfileTicksToNanoseconds(int64_t ticks)
+{
+    const int64_t ticksPerSecond = OVR_GetCallProfileTicksPerSecond();
+
+    // Split into whole seconds first so the multiplication can't overflow.
+    return (uint64_t)((ticks / ticksPerSecond) * 1000000000 + ((ticks % ticksPerSecond) * 1000000000) / ticksPerSecond);
+}
+
+static unsigned int OVR_GetCallProfileBucket(uint64_t nanoseconds)
+{
+    unsigned int exponent = 0;
+    uint64_t value = nanoseconds;
+
+    if (nanoseconds < ((uint64_t)1 << ovrCallProfile_MinExponent))
+        return 0;
+
+    // Find the highest set bit.
+    if (value >> 32) { value >>= 32; exponent += 32; }
+    if (value >> 16) { value >>= 16; exponent += 16; }
+    if (value >> 8)  { value >>= 8;  exponent += 8; }
+    if (value >> 4)  { value >>= 4;  exponent += 4; }
+    if (value >> 2)  { value >>= 2;  exponent += 2; }
+    if (value >> 1)  { exponent += 1; }
+
+    if (exponent > ovrCallProfile_MaxExponent)
+        return ovrCallProfile_BucketCount - 1;
+
+    return 1 + (exponent - ovrCallProfile_MinExponent) * ovrCallProfile_SubBucketCount +
+        (unsigned int)((nanoseconds >> (exponent - ovrCallProfile_SubBucketBits)) & (ovrCallProfile_SubBucketCount - 1));
+}
+
+static OVR_ThreadCallCounters* OVR_GetThreadCallCounters()
+{
+    OVR_ThreadCallCounters* counters = OVR_CurrentThreadCallCounters;
+
+    if (!counters)
+    {
+        OVR_ThreadCallCounters* head;
+
+        counters = (OVR_ThreadCallCounters*)calloc(1, sizeof(OVR_ThreadCallCounters));
+        if (!counters)
+            return NULL;
+
+        counters->Generation = OVR_CallProfileGeneration;
+
+        do
+        {
+            head = OVR_AllThreadCallCounters;
+            counters->Next = head;
+        } while (OVR_CallProfileCompareExchangePointer(&OVR_AllThreadCallCounters, counters, head) != head);
+
+        OVR_CurrentThreadCallCounters = counters;
+    }
+    else if (counters->Generation != OVR_CallProfileGeneration)
+    {
+        memset(counters->Calls, 0, sizeof(counters->Calls));
+        counters->Generation = OVR_CallProfileGeneration;
+    }
+
+    return counters;
+}
+
+static void OVR_ReportCallProfiles();
+
+static void OVR_RecordCall(OVR_CallId callId, int64_t startTicks)
+{
+    const int64_t endTicks = OVR_GetCallProfileTicks();
+    const uint64_t nanoseconds = OVR_CallProfileTicksToNanoseconds(endTicks - startTicks);
+    OVR_ThreadCallCounters* threadCounters = OVR_GetThreadCallCounters();
+    int64_t reportInterval;
+
+    if (threadCounters)
+    {
+        OVR_CallCounters* counters = &threadCounters->Calls[callId];
+
+        counters->CallCount++;
+        counters->TotalNanoseconds += nanoseconds;
+        if (nanoseconds > counters->MaxNanoseconds)
+            counters->MaxNanoseconds = nanoseconds;
+        counters->Histogram[OVR_GetCallProfileBucket(nanoseconds)]++;
+    }
+
+    reportInterval = OVR_CallProfileReportInterval;
+    if (reportInterval != 0)
+    {
+        const int64_t nextReport = OVR_CallProfileNextReport;
+
+        // Only the thread that advances the deadline reports.
+        if ((endTicks >= nextReport) &&
+            (OVR_CallProfileCompareExchange64(&OVR_CallProfileNextReport, endTicks + reportInterval, nextReport) == nextReport))
+        {
+            OVR_ReportCallProfiles();
+        }
+    }
+}
+
+#define OVR_API_CALL(FunctionName, Arguments) \
+    do { \
+        const int64_t ovrCallStartTicks = OVR_GetCallProfileTicks(); \
+        API.FunctionName.Ptr Arguments; \
+        OVR_RecordCall(OVR_CallId_##FunctionName, ovrCallStartTicks); \
+    } while(0)
+
+#define OVR_API_ASSIGN(Result, FunctionName, Arguments) \
+    do { \
+        const int64_t ovrCallStartTicks = OVR_GetCallProfileTicks(); \
+        Result = API.FunctionName.Ptr Arguments; \
+        OVR_RecordCall(OVR_CallId_##FunctionName, ovrCallStartTicks); \
+    } while(0)
+
+#define OVR_API_RETURN(FunctionName, Arguments) \
+    do { \
+        OVR_ReturnType_##FunctionName ovrCallResult; \
+        OVR_API_ASSIGN(ovrCallResult, FunctionName, Arguments); \
+        return ovrCallResult; \
+    } while(0)
+
+#else // OVR_CAPI_PROFILE
+
+#define OVR_API_CALL(FunctionName, Arguments) API.FunctionName.Ptr Arguments
+#define OVR_API_ASSIGN(Result, FunctionName, Arguments) Result = API.FunctionName.Ptr Arguments
+#define OVR_API_RETURN(FunctionName, Arguments) return API.FunctionName.Ptr Arguments
+
+#endif // OVR_CAPI_PROFILE
+
+
+//-----------------------------------------------------------------------------------
+// ***** Call recording and replay
+//
+// Records the results of ovr_GetTrackingState, ovr_GetInputState and
+// ovr_GetPredictedDisplayTime, and returns recorded results in their place.
+// See OVR_CAPI_Replay.h.
+//
+// The file starts with an OVR_CallStreamHeader, followed by one record per call:
+//     uint8_t  Record type (OVR_CallRecordType).
+//     varint   Zigzag encoded nanoseconds since the previous record, in runtime time.
+//     uint8_t  Bitmask of the record words that differ from the previous record of the
+//              same type, one bit per 32 bit word.
+//     varint   Each differing word XORed with its previous value.
+// Records are fixed structs of 32 bit words, so a state that changes little between calls
+// costs a few bytes per changed word. Values are stored in the byte order of the machine.
+//
+
+typedef enum OVR_CallRecordType_
+{
+    OVR_CallRecord_TrackingState,
+    OVR_CallRecord_InputState,
+    OVR_CallRecord_PredictedDisplayTime,
+    OVR_CallRecord_Count
+} OVR_CallRecordType;
+
+typedef struct OVR_TrackingStateRecord_
+{
+    double AbsTime;
+    int32_t LatencyMarker;
+    int32_t Pad;
+    ovrTrackingState State;
+} OVR_TrackingStateRecord;
+
+typedef struct OVR_InputStateRecord_
+{
+    int32_t ControllerType;
+    ovrResult Result;
+    ovrInputState State;
+} OVR_InputStateRecord;
+
+typedef struct OVR_PredictedDisplayTimeRecord_
+{
+    long long FrameIndex;
+    double DisplayTime;
+} OVR_PredictedDisplayTimeRecord;
+
+typedef union OVR_CallRecord_
+{
+    OVR_TrackingStateRecord TrackingState;
+    OVR_InputStateRecord InputState;
+    OVR_PredictedDisplayTimeRecord PredictedDisplayTime;
+} OVR_CallRecord;
+
+#define OVR_CALL_RECORD_MAX_WORDS ((sizeof(OVR_CallRecord) + 3) / 4)
+#define OVR_CALL_RECORD_MAX_BYTES (1 + 10 + (OVR_CALL_RECORD_MAX_WORDS + 7) / 8 + OVR_CALL_RECORD_MAX_WORDS * 5)
+#define OVR_CALL_STREAM_VERSION 1
+
+static const uint32_t OVR_CallRecordSizes[OVR_CallRecord_Count] =
+{
+    sizeof(OVR_TrackingStateRecord),
+    sizeof(OVR_InputStateRecord),
+    sizeof(OVR_PredictedDisplayTimeRecord)
+};
+
+typedef struct OVR_CallStreamHeader_
+{
+    char Magic[4]; // "OVRC"
+    uint32_t Version;
+    uint32_t RecordSizes[OVR_CallRecord_Count]; // Must match OVR_CallRecordSizes.
+} OVR_CallStreamHeader;
+
+typedef struct OVR_ReplayedCall_
+{
+    OVR_CallRecordType Type;
+    int64_t TimeNanoseconds;
+    OVR_CallRecord Record;
+} OVR_ReplayedCall;
+
+// Next call to replay for an ovr_GetInputState controller type.
+typedef struct OVR_InputReplayCursor_
+{
+    int32_t ControllerType;
+    size_t Index;
+} OVR_InputReplayCursor;
+
+#define OVR_INPUT_REPLAY_CURSOR_COUNT 16
+
+// The active flags are read without the lock, so that calls cost nothing when neither
+// recording nor replaying. Everything else is guarded by OVR_CallRecordLockValue.
+static volatile long OVR_CallRecordingActive = 0;
+static volatile long OVR_CallReplayActive = 0;
+static volatile long OVR_CallRecordLockValue = 0;
+
+static FILE* OVR_CallRecordFile = NULL;
+static int64_t OVR_CallRecordLastTime = 0;
+static uint32_t OVR_CallRecordPrevious[OVR_CallRecord_Count][OVR_CALL_RECORD_MAX_WORDS];
+
+static OVR_ReplayedCall* OVR_ReplayCalls = NULL;
+static size_t OVR_ReplayCallCount = 0;
+static size_t OVR_ReplayCursors[OVR_CallRecord_Count];
+static OVR_InputReplayCursor OVR_InputReplayCursors[OVR_INPUT_REPLAY_CURSOR_COUNT];
+static unsigned int OVR_InputReplayCursorCount = 0;
+static int64_t OVR_ReplayLastReportedTime = 0;
+static ovrCallReplayTimeCallback OVR_ReplayTimeCallback = NULL;
+static uintptr_t OVR_ReplayTimeCallbackUserData = 0;
+
+// Minimal lock for state that is held only briefly, and that must not require initialization.
+#if defined(_WIN32)
+    #define OVR_SpinLock(lockValue) \
+        while (InterlockedCompareExchange((lockValue), 1, 0) != 0) SwitchToThread()
+    #define OVR_SpinUnlock(lockValue) InterlockedExchange((lockValue), 0)
+#else
+    #define OVR_SpinLock(lockValue) \
+        while (__sync_lock_test_and_set((lockValue), 1) != 0) usleep(0)
+    #define OVR_SpinUnlock(lockValue) __sync_lock_release(lockValue)
+#endif
+
+#define OVR_CallRecordLock() OVR_SpinLock(&OVR_CallRecordLockValue)
+#define OVR_CallRecordUnlock() OVR_SpinUnlock(&OVR_CallRecordLockValue)
+
+static size_t OVR_WriteVarint(uint8_t* dest, uint64_t value)
+{
+    size_t length = 0;
+
+    while (value >= 0x80)
+    {
+        dest[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+
+    dest[length++] = (uint8_t)value;
+    return length;
+}
+
+// Returns NULL if the varint is truncated or longer than 64 bits.
+static const uint8_t* OVR_ReadVarint(const uint8_t* src, const uint8_t* end, uint64_t* value)
+{
+    unsigned int shift = 0;
+
+    *value = 0;
+
+    while ((src < end) && (shift < 64))
+    {
+        const uint8_t byte = *src++;
+        *value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return src;
+        shift += 7;
+    }
+
+    return NULL;
+}
+
+static int64_t OVR_GetCallRecordTime()
+{
+    return (int64_t)(API.ovr_GetTimeInSeconds.Ptr() * 1e9 + 0.5);
+}
+
+// Appends a call result to the recording file. Recording stops if the file can't be written.
+static void OVR_RecordCallResult(OVR_CallRecordType type, const void* record)
+{
+    const size_t wordCount = OVR_CallRecordSizes[type] / 4;
+    const size_t maskSize = (wordCount + 7) / 8;
+    uint32_t words[OVR_CALL_RECORD_MAX_WORDS];
+    uint8_t buffer[OVR_CALL_RECORD_MAX_BYTES];
+    uint8_t* mask;
+    size_t length, i;
+    int64_t time, delta;
+
+    memcpy(words, record, OVR_CallRecordSizes[type]);
+    time = OVR_GetCallRecordTime();
+
+    OVR_CallRecordLock();
+
+    if (!OVR_CallRecordFile)
+    {
+        OVR_CallRecordUnlock();
+        return;
+    }
+
+    delta = time - OVR_CallRecordLastTime;
+    OVR_CallRecordLastTime = time;
+
+    buffer[0] = (uint8_t)type;
+    length = 1;
+    length += OVR_WriteVarint(buffer + length, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+
+    mask = buffer + length;
+    memset(mask, 0, maskSize);
+    length += maskSize;
+
+    for (i = 0; i < wordCount; ++i)
+    {
+        const uint32_t difference = words[i] ^ OVR_CallRecordPrevious[type][i];
+
+        if (difference)
+        {
+            mask[i / 8] |= (uint8_t)(1 << (i % 8));
+            length += OVR_WriteVarint(buffer + length, difference);
+            OVR_CallRecordPrevious[type][i] = words[i];
+        }
+    }
+
+    if (fwrite(buffer, 1, length, OVR_CallRecordFile) != length)
+    {
+        fclose(OVR_CallRecordFile);
+        OVR_CallRecordFile = NULL;
+        OVR_CallRecordingActive = 0;
+    }
+
+    OVR_CallRecordUnlock();
+}
+
+// Must be called with the lock held.
+static void OVR_FreeCallReplay()
+{
+    OVR_CallReplayActive = 0;
+    free(OVR_ReplayCalls);
+    OVR_ReplayCalls = NULL;
+    OVR_ReplayCallCount = 0;
+    OVR_ReplayTimeCallback = NULL;
+    OVR_ReplayTimeCallbackUserData = 0;
+}
+
+// Decodes a recording into OVR_ReplayCalls. Must be called with the lock held.
+static ovrBool OVR_DecodeCallReplay(const uint8_t* data, size_t size)
+{
+    const uint8_t* end = data + size;
+    uint32_t previous[OVR_CallRecord_Count][OVR_CALL_RECORD_MAX_WORDS];
+    OVR_CallStreamHeader header;
+    size_t capacity = 0, i;
+    int64_t time = 0;
+
+    if (size < sizeof(header))
+        return ovrFalse;
+
+    memcpy(&header, data, sizeof(header));
+    data += sizeof(header);
+
+    if ((memcmp(header.Magic, "OVRC", 4) != 0) || (header.Version != OVR_CALL_STREAM_VERSION) ||
+        (memcmp(header.RecordSizes, OVR_CallRecordSizes, sizeof(OVR_CallRecordSizes)) != 0))
+        return ovrFalse;
+
+    memset(previous, 0, sizeof(previous));
+
+    while (data < end)
+    {
+        const OVR_CallRecordType type = (OVR_CallRecordType)*data++;
+        size_t wordCount;
+        const uint8_t* mask;
+        uint64_t value;
+        OVR_ReplayedCall* call;
+
+        if (type >= OVR_CallRecord_Count)
+            return ovrFalse;
+
+        data = OVR_ReadVarint(data, end, &value);
+        if (!data)
+            return ovrFalse;
+        time += (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+
+        wordCount = OVR_CallRecordSizes[type] / 4;
+        if ((size_t)(end - data) < (wordCount + 7) / 8)
+            return ovrFalse;
+        mask = data;
+        data += (wordCount + 7) / 8;
+
+        for (i = 0; i < wordCount; ++i)
+        {
+            if (mask[i / 8] & (1 << (i % 8)))
+            {
+                data = OVR_ReadVarint(data, end, &value);
+                if (!data || (value > 0xffffffff))
+                    return ovrFalse;
+                previous[type][i] ^= (uint32_t)value;
+            }
+        }
+
+        if (OVR_ReplayCallCount == capacity)
+        {
+            OVR_ReplayedCall* calls;
+
+            capacity = capacity ? (capacity * 2) : 1024;
+            calls = (OVR_ReplayedCall*)realloc(OVR_ReplayCalls, capacity * sizeof(OVR_ReplayedCall));
+            if (!calls)
+                return ovrFalse;
+            OVR_ReplayCalls = calls;
+        }
+
+        call = &OVR_ReplayCalls[OVR_ReplayCallCount++];
+        memset(call, 0, sizeof(*call));
+        call->Type = type;
+        call->TimeNanoseconds = time;
+        memcpy(&call->Record, previous[type], OVR_CallRecordSizes[type]);
+    }
+
+    return ovrTrue;
+}
+
+// Copies the next recorded result of the given type to record. Returns false if not replaying,
+// or if the recording has run out, in which case replay stops.
+static ovrBool OVR_ReplayCallResult(OVR_CallRecordType type, int32_t controllerType, void* record)
+{
+    ovrCallReplayTimeCallback callback = NULL;
+    uintptr_t userData = 0;
+    size_t* cursor;
+    int64_t time = 0;
+    unsigned int i;
+
+    OVR_CallRecordLock();
+
+    if (!OVR_CallReplayActive)
+    {
+        OVR_CallRecordUnlock();
+        return ovrFalse;
+    }
+
+    cursor = &OVR_ReplayCursors[type];
+
+    if (type == OVR_CallRecord_InputState)
+    {
+        // Each controller type has its own position in the recording.
+        for (i = 0; (i < OVR_InputReplayCursorCount) && (OVR_InputReplayCursors[i].ControllerType != controllerType); ++i)
+            ;
+
+        if (i == OVR_InputReplayCursorCount)
+        {
+            if (i == OVR_INPUT_REPLAY_CURSOR_COUNT)
+                i = OVR_INPUT_REPLAY_CURSOR_COUNT - 1;
+            else
+                ++OVR_InputReplayCursorCount;
+
+            OVR_InputReplayCursors[i].ControllerType = controllerType;
+            OVR_InputReplayCursors[i].Index = 0;
+        }
+
+        cursor = &OVR_InputReplayCursors[i].Index;
+    }
+
+    while ((*cursor < OVR_ReplayCallCount) &&
+           ((OVR_ReplayCalls[*cursor].Type != type) ||
+            ((type == OVR_CallRecord_InputState) &&
+             (OVR_ReplayCalls[*cursor].Record.InputState.ControllerType != controllerType))))
+    {
+        ++*cursor;
+    }
+
+    if (*cursor == OVR_ReplayCallCount)
+    {
+        OVR_FreeCallReplay();
+        OVR_CallRecordUnlock();
+        return ovrFalse;
+    }
+
+    memcpy(record, &OVR_ReplayCalls[*cursor].Record, OVR_CallRecordSizes[type]);
+    time = OVR_ReplayCalls[*cursor].TimeNanoseconds;
+    ++*cursor;
+
+    if (time > OVR_ReplayLastReportedTime)
+    {
+        OVR_ReplayLastReportedTime = time;
+        callback = OVR_ReplayTimeCallback;
+        userData = OVR_ReplayTimeCallbackUserData;
+    }
+
+    OVR_CallRecordUnlock();
+
+    // Called without the lock, so that the callback can call back into LibOVR.
+    if (callback)
+        callback(userData, (double)time / 1e9);
+
+    return ovrTrue;
+}
+
+static void OVR_StopCallRecordingAndReplay()
+{
+    ovr_StopCallRecording();
+    ovr_StopCallReplay();
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** Property cache
+//
+// Values of properties resolved with ovr_GetPropertyHandle. See OVR_CAPI_Properties.h.
+// Handles point at the Value of an OVR_CachedProperty, which is never moved or freed
+// until its session is destroyed.
+//
+
+typedef struct OVR_CachedProperty_
+{
+    ovrPropertyValue Value; // Must be first, so that a handle is also an OVR_CachedProperty.
+    struct OVR_CachedProperty_* Next;
+    ovrSession Session;
+    double DefaultValue;
+    char Name[1]; // Allocated to the length of the name.
+} OVR_CachedProperty;
+
+// The list head is read without the lock, so that ovr_Set calls cost nothing more when
+// no properties are cached.
+static OVR_CachedProperty* volatile OVR_CachedProperties = NULL;
+static volatile long OVR_CachedPropertyLockValue = 0;
+
+#define OVR_CachedPropertyLock() OVR_SpinLock(&OVR_CachedPropertyLockValue)
+#define OVR_CachedPropertyUnlock() OVR_SpinUnlock(&OVR_CachedPropertyLockValue)
+
+// Reads a property from the runtime. Must be called with the lock held.
+static void OVR_ReadCachedProperty(OVR_CachedProperty* property)
+{
+    ovrPropertyValue* value = &property->Value;
+    const char* string = NULL;
+
+    switch (value->Type)
+    {
+    case ovrPropertyType_Bool:
+        OVR_API_ASSIGN(value->Bool, ovr_GetBool,
+                       (property->Session, property->Name, (property->DefaultValue != 0) ? ovrTrue : ovrFalse));
+        break;
+
+    case ovrPropertyType_Int:
+        OVR_API_ASSIGN(value->Int, ovr_GetInt, (property->Session, property->Name, (int)property->DefaultValue));
+        break;
+
+    case ovrPropertyType_Float:
+        OVR_API_ASSIGN(value->Float, ovr_GetFloat, (property->Session, property->Name, (float)property->DefaultValue));
+        break;
+
+    case ovrPropertyType_FloatArray:
+        OVR_API_ASSIGN(value->FloatCount, ovr_GetFloatArray,
+                       (property->Session, property->Name, value->FloatArray, OVR_PROPERTY_MAX_FLOAT_COUNT));
+        if (value->FloatCount > OVR_PROPERTY_MAX_FLOAT_COUNT)
+            value->FloatCount = OVR_PROPERTY_MAX_FLOAT_COUNT;
+        break;
+
+    case ovrPropertyType_String:
+        OVR_API_ASSIGN(string, ovr_GetString, (property->Session, property->Name, ""));
+        if (!string)
+            string = "";
+        OVR_strlcpy(value->String, string, sizeof(value->String));
+        break;
+
+    default:
+        break;
+    }
+}
+
+// Rereads the cached values of a property that the application has just written.
+static void OVR_OnPropertySet(ovrSession session, const char* propertyName)
+{
+    OVR_CachedProperty* property;
+
+    if (!OVR_CachedProperties || !propertyName)
+        return;
+
+    OVR_CachedPropertyLock();
+
+    for (property = OVR_CachedProperties; property; property = property->Next)
+    {
+        if ((property->Session == session) && (strcmp(property->Name, propertyName) == 0))
+            OVR_ReadCachedProperty(property);
+    }
+
+    OVR_CachedPropertyUnlock();
+}
+
+// Frees the cached properties of a session, or of all sessions if allSessions is true.
+static void OVR_FreeCachedProperties(ovrSession session, ovrBool allSessions)
+{
+    OVR_CachedProperty* volatile* link;
+
+    if (!OVR_CachedProperties)
+        return;
+
+    OVR_CachedPropertyLock();
+
+    link = &OVR_CachedProperties;
+
+    while (*link)
+    {
+        OVR_CachedProperty* property = *link;
+
+        if (allSessions || (property->Session == session))
+        {
+            *link = property->Next;
+            free(property);
+        }
+        else
+        {
+            link = &property->Next;
+        }
+    }
+
+    OVR_CachedPropertyUnlock();
+}
+
 static void OVR_UnloadSharedLibrary()
 {
     memset(&API, 0, sizeof(API));
@@ -1159,7 +1908,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_Initialize(const ovrInitParams* inputParams)
     if (result != ovrSuccess)
        return result;
 
-    result = API.ovr_Initialize.Ptr(&params);
+    OVR_API_ASSIGN(result, ovr_Initialize, (&params));
     if (result != ovrSuccess)
         OVR_UnloadSharedLibrary();
 
@@ -1183,7 +1932,9 @@ OVR_PUBLIC_FUNCTION(void) ovr_Shutdown()
 {
     if (!API.ovr_Shutdown.Ptr)
         return;
-    API.ovr_Shutdown.Ptr();
+    OVR_StopCallRecordingAndReplay();
+    OVR_FreeCachedProperties(NULL, ovrTrue);
+    OVR_API_CALL(ovr_Shutdown, ());
     OVR_UnloadSharedLibrary();
 }
 
@@ -1199,7 +1950,7 @@ OVR_PUBLIC_FUNCTION(const char*) ovr_GetVersionString()
     if (!API.ovr_GetVersionString.Ptr)
         return "(Unable to load LibOVR)";
 
-    dllVersionString = API.ovr_GetVersionString.Ptr(); // Guaranteed to always be valid.
+    OVR_API_ASSIGN(dllVersionString, ovr_GetVersionString, ()); // Guaranteed to always be valid.
     assert(dllVersionString != NULL);
     OVR_strlcpy(dllVersionStringLocal, dllVersionString, sizeof(dllVersionStringLocal));
 
@@ -1214,7 +1965,7 @@ OVR_PUBLIC_FUNCTION(void) ovr_GetLastErrorInfo(ovrErrorInfo* errorInfo)
         errorInfo->Result = ovrError_NotInitialized;
     }
     else
-        API.ovr_GetLastErrorInfo.Ptr(errorInfo);
+        OVR_API_CALL(ovr_GetLastErrorInfo, (errorInfo));
 }
 
 OVR_PUBLIC_FUNCTION(ovrHmdDesc) ovr_GetHmdDesc(ovrSession session)
@@ -1227,7 +1978,7 @@ OVR_PUBLIC_FUNCTION(ovrHmdDesc) ovr_GetHmdDesc(ovrSession session)
         return hmdDesc;
     }
 
-    return API.ovr_GetHmdDesc.Ptr(session);
+    OVR_API_RETURN(ovr_GetHmdDesc, (session));
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetTrackerCount(ovrSession session)
@@ -1237,7 +1988,7 @@ OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetTrackerCount(ovrSession session)
         return 0;
     }
 
-    return API.ovr_GetTrackerCount.Ptr(session);
+    OVR_API_RETURN(ovr_GetTrackerCount, (session));
 }
 
 OVR_PUBLIC_FUNCTION(ovrTrackerDesc) ovr_GetTrackerDesc(ovrSession session, unsigned int trackerDescIndex)
@@ -1249,21 +2000,22 @@ OVR_PUBLIC_FUNCTION(ovrTrackerDesc) ovr_GetTrackerDesc(ovrSession session, unsig
         return trackerDesc;
     }
 
-    return API.ovr_GetTrackerDesc.Ptr(session, trackerDescIndex);
+    OVR_API_RETURN(ovr_GetTrackerDesc, (session, trackerDescIndex));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_Create(ovrSession* pSession, ovrGraphicsLuid* pLuid)
 {
     if (!API.ovr_Create.Ptr)
         return ovrError_NotInitialized;
-    return API.ovr_Create.Ptr(pSession, pLuid);
+    OVR_API_RETURN(ovr_Create, (pSession, pLuid));
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_Destroy(ovrSession session)
 {
     if (!API.ovr_Destroy.Ptr)
         return;
-    API.ovr_Destroy.Ptr(session);
+    OVR_FreeCachedProperties(session, ovrFalse);
+    OVR_API_CALL(ovr_Destroy, (session));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetSessionStatus(ovrSession session, ovrSessionStatus* sessionStatus)
@@ -1283,7 +2035,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetSessionStatus(ovrSession session, ovrSessi
         return ovrError_NotInitialized;
     }
 
-    return API.ovr_GetSessionStatus.Ptr(session, sessionStatus);
+    OVR_API_RETURN(ovr_GetSessionStatus, (session, sessionStatus));
 }
 
 
@@ -1291,28 +2043,28 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SetTrackingOriginType(ovrSession session, ovr
 {
     if (!API.ovr_SetTrackingOriginType.Ptr)
         return ovrError_NotInitialized;
-    return API.ovr_SetTrackingOriginType.Ptr(session, origin);
+    OVR_API_RETURN(ovr_SetTrackingOriginType, (session, origin));
 }
 
 OVR_PUBLIC_FUNCTION(ovrTrackingOrigin) ovr_GetTrackingOriginType(ovrSession session)
 {
     if (!API.ovr_GetTrackingOriginType.Ptr)
         return ovrTrackingOrigin_EyeLevel;
-    return API.ovr_GetTrackingOriginType.Ptr(session);
+    OVR_API_RETURN(ovr_GetTrackingOriginType, (session));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_RecenterTrackingOrigin(ovrSession session)
 {
     if (!API.ovr_RecenterTrackingOrigin.Ptr)
         return ovrError_NotInitialized;
-    return API.ovr_RecenterTrackingOrigin.Ptr(session);
+    OVR_API_RETURN(ovr_RecenterTrackingOrigin, (session));
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_ClearShouldRecenterFlag(ovrSession session)
 {
     if (!API.ovr_ClearShouldRecenterFlag.Ptr)
         return;
-    API.ovr_ClearShouldRecenterFlag.Ptr(session);
+    OVR_API_CALL(ovr_ClearShouldRecenterFlag, (session));
 }
 
 OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingState(ovrSession session, double absTime, ovrBool latencyMarker)
@@ -1324,7 +2076,27 @@ OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingState(ovrSession session, d
         return nullTrackingState;
     }
 
-    return API.ovr_GetTrackingState.Ptr(session, absTime, latencyMarker);
+    if (OVR_CallReplayActive || OVR_CallRecordingActive)
+    {
+        OVR_TrackingStateRecord record;
+
+        if (OVR_ReplayCallResult(OVR_CallRecord_TrackingState, 0, &record))
+            return record.State;
+
+        memset(&record, 0, sizeof(record));
+        OVR_API_ASSIGN(record.State, ovr_GetTrackingState, (session, absTime, latencyMarker));
+
+        if (OVR_CallRecordingActive)
+        {
+            record.AbsTime = absTime;
+            record.LatencyMarker = latencyMarker;
+            OVR_RecordCallResult(OVR_CallRecord_TrackingState, &record);
+        }
+
+        return record.State;
+    }
+
+    OVR_API_RETURN(ovr_GetTrackingState, (session, absTime, latencyMarker));
 }
 
 OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingStateWithSensorData(ovrSession session, double absTime, ovrBool latencyMarker, ovrSensorData* sensorData)
@@ -1338,7 +2110,7 @@ OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingStateWithSensorData(ovrSess
         return nullTrackingState;
     }
 
-    return API.ovr_GetTrackingStateWithSensorData.Ptr(session, absTime, latencyMarker, sensorData);
+    OVR_API_RETURN(ovr_GetTrackingStateWithSensorData, (session, absTime, latencyMarker, sensorData));
 }
 
 OVR_PUBLIC_FUNCTION(ovrTrackerPose) ovr_GetTrackerPose(ovrSession session, unsigned int trackerPoseIndex)
@@ -1350,7 +2122,7 @@ OVR_PUBLIC_FUNCTION(ovrTrackerPose) ovr_GetTrackerPose(ovrSession session, unsig
         return nullTrackerPose;
     }
 
-    return API.ovr_GetTrackerPose.Ptr(session, trackerPoseIndex);
+    OVR_API_RETURN(ovr_GetTrackerPose, (session, trackerPoseIndex));
 }
 
 
@@ -1362,7 +2134,31 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetInputState(ovrSession session, ovrControll
             memset(inputState, 0, sizeof(ovrInputState));
         return ovrError_NotInitialized;
     }
-    return API.ovr_GetInputState.Ptr(session, controllerType, inputState);
+
+    if ((OVR_CallReplayActive || OVR_CallRecordingActive) && inputState)
+    {
+        OVR_InputStateRecord record;
+
+        if (OVR_ReplayCallResult(OVR_CallRecord_InputState, controllerType, &record))
+        {
+            *inputState = record.State;
+            return record.Result;
+        }
+
+        memset(&record, 0, sizeof(record));
+        OVR_API_ASSIGN(record.Result, ovr_GetInputState, (session, controllerType, inputState));
+
+        if (OVR_CallRecordingActive)
+        {
+            record.ControllerType = controllerType;
+            record.State = *inputState;
+            OVR_RecordCallResult(OVR_CallRecord_InputState, &record);
+        }
+
+        return record.Result;
+    }
+
+    OVR_API_RETURN(ovr_GetInputState, (session, controllerType, inputState));
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetConnectedControllerTypes(ovrSession session)
@@ -1371,7 +2167,7 @@ OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetConnectedControllerTypes(ovrSession ses
     {
         return 0;
     }
-    return API.ovr_GetConnectedControllerTypes.Ptr(session);
+    OVR_API_RETURN(ovr_GetConnectedControllerTypes, (session));
 }
 
 OVR_PUBLIC_FUNCTION(ovrTouchHapticsDesc) ovr_GetTouchHapticsDesc(ovrSession session, ovrControllerType controllerType)
@@ -1383,7 +2179,7 @@ OVR_PUBLIC_FUNCTION(ovrTouchHapticsDesc) ovr_GetTouchHapticsDesc(ovrSession sess
         return nullDesc;
     }
 
-    return API.ovr_GetTouchHapticsDesc.Ptr(session, controllerType);
+    OVR_API_RETURN(ovr_GetTouchHapticsDesc, (session, controllerType));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_SetControllerVibration(ovrSession session, ovrControllerType controllerType, float frequency, float amplitude)
@@ -1391,7 +2187,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SetControllerVibration(ovrSession session, ov
     if (!API.ovr_SetControllerVibration.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_SetControllerVibration.Ptr(session, controllerType, frequency, amplitude);
+    OVR_API_RETURN(ovr_SetControllerVibration, (session, controllerType, frequency, amplitude));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitControllerVibration(ovrSession session, ovrControllerType controllerType, const ovrHapticsBuffer* buffer)
@@ -1399,7 +2195,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitControllerVibration(ovrSession session,
     if (!API.ovr_SubmitControllerVibration.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_SubmitControllerVibration.Ptr(session, controllerType, buffer);
+    OVR_API_RETURN(ovr_SubmitControllerVibration, (session, controllerType, buffer));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetControllerVibrationState(ovrSession session, ovrControllerType controllerType, ovrHapticsPlaybackState* outState)
@@ -1407,7 +2203,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetControllerVibrationState(ovrSession sessio
     if (!API.ovr_GetControllerVibrationState.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetControllerVibrationState.Ptr(session, controllerType, outState);
+    OVR_API_RETURN(ovr_GetControllerVibrationState, (session, controllerType, outState));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_TestBoundary(ovrSession session, ovrTrackedDeviceType deviceBitmask, ovrBoundaryType singleBoundaryType, ovrBoundaryTestResult* outTestResult)
@@ -1415,7 +2211,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_TestBoundary(ovrSession session, ovrTrackedDe
     if (!API.ovr_TestBoundary.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_TestBoundary.Ptr(session, deviceBitmask, singleBoundaryType, outTestResult);
+    OVR_API_RETURN(ovr_TestBoundary, (session, deviceBitmask, singleBoundaryType, outTestResult));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_TestBoundaryPoint(ovrSession session, const ovrVector3f* point, ovrBoundaryType singleBoundaryType, ovrBoundaryTestResult* outTestResult)
@@ -1423,7 +2219,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_TestBoundaryPoint(ovrSession session, const o
     if (!API.ovr_TestBoundaryPoint.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_TestBoundaryPoint.Ptr(session, point, singleBoundaryType, outTestResult);
+    OVR_API_RETURN(ovr_TestBoundaryPoint, (session, point, singleBoundaryType, outTestResult));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_SetBoundaryLookAndFeel(ovrSession session, const ovrBoundaryLookAndFeel* lookAndFeel)
@@ -1431,7 +2227,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SetBoundaryLookAndFeel(ovrSession session, co
     if (!API.ovr_SetBoundaryLookAndFeel.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_SetBoundaryLookAndFeel.Ptr(session, lookAndFeel);
+    OVR_API_RETURN(ovr_SetBoundaryLookAndFeel, (session, lookAndFeel));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_ResetBoundaryLookAndFeel(ovrSession session)
@@ -1439,7 +2235,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_ResetBoundaryLookAndFeel(ovrSession session)
     if (!API.ovr_ResetBoundaryLookAndFeel.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_ResetBoundaryLookAndFeel.Ptr(session);
+    OVR_API_RETURN(ovr_ResetBoundaryLookAndFeel, (session));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetBoundaryGeometry(ovrSession session, ovrBoundaryType singleBoundaryType, ovrVector3f* outFloorPoints, int* outFloorPointsCount)
@@ -1447,7 +2243,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetBoundaryGeometry(ovrSession session, ovrBo
     if (!API.ovr_GetBoundaryGeometry.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetBoundaryGeometry.Ptr(session, singleBoundaryType, outFloorPoints, outFloorPointsCount);
+    OVR_API_RETURN(ovr_GetBoundaryGeometry, (session, singleBoundaryType, outFloorPoints, outFloorPointsCount));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetBoundaryDimensions(ovrSession session, ovrBoundaryType singleBoundaryType, ovrVector3f* outDimensions)
@@ -1455,7 +2251,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetBoundaryDimensions(ovrSession session, ovr
     if (!API.ovr_GetBoundaryDimensions.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetBoundaryDimensions.Ptr(session, singleBoundaryType, outDimensions);
+    OVR_API_RETURN(ovr_GetBoundaryDimensions, (session, singleBoundaryType, outDimensions));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetBoundaryVisible(ovrSession session, ovrBool* outIsVisible)
@@ -1463,7 +2259,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetBoundaryVisible(ovrSession session, ovrBoo
     if (!API.ovr_GetBoundaryVisible.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetBoundaryVisible.Ptr(session, outIsVisible);
+    OVR_API_RETURN(ovr_GetBoundaryVisible, (session, outIsVisible));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_RequestBoundaryVisible(ovrSession session, ovrBool visible)
@@ -1471,7 +2267,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_RequestBoundaryVisible(ovrSession session, ov
     if (!API.ovr_RequestBoundaryVisible.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_RequestBoundaryVisible.Ptr(session, visible);
+    OVR_API_RETURN(ovr_RequestBoundaryVisible, (session, visible));
 }
 
 OVR_PUBLIC_FUNCTION(ovrSizei) ovr_GetFovTextureSize(ovrSession session, ovrEyeType eye, ovrFovPort fov,
@@ -1484,7 +2280,7 @@ OVR_PUBLIC_FUNCTION(ovrSizei) ovr_GetFovTextureSize(ovrSession session, ovrEyeTy
         return nullSize;
     }
 
-    return API.ovr_GetFovTextureSize.Ptr(session, eye, fov, pixelsPerDisplayPixel);
+    OVR_API_RETURN(ovr_GetFovTextureSize, (session, eye, fov, pixelsPerDisplayPixel));
 }
 
 #if defined (_WIN32)
@@ -1496,7 +2292,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateTextureSwapChainDX(ovrSession session,
     if (!API.ovr_CreateTextureSwapChainDX.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_CreateTextureSwapChainDX.Ptr(session, d3dPtr, desc, outTextureSet);
+    OVR_API_RETURN(ovr_CreateTextureSwapChainDX, (session, d3dPtr, desc, outTextureSet));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateMirrorTextureDX(ovrSession session,
@@ -1507,7 +2303,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateMirrorTextureDX(ovrSession session,
     if (!API.ovr_CreateMirrorTextureDX.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_CreateMirrorTextureDX.Ptr(session, d3dPtr, desc, outMirrorTexture);
+    OVR_API_RETURN(ovr_CreateMirrorTextureDX, (session, d3dPtr, desc, outMirrorTexture));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainBufferDX(ovrSession session,
@@ -1519,7 +2315,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainBufferDX(ovrSession sessio
     if (!API.ovr_GetTextureSwapChainBufferDX.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetTextureSwapChainBufferDX.Ptr(session, chain, index, iid, ppObject);
+    OVR_API_RETURN(ovr_GetTextureSwapChainBufferDX, (session, chain, index, iid, ppObject));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetMirrorTextureBufferDX(ovrSession session,
@@ -1530,7 +2326,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetMirrorTextureBufferDX(ovrSession session,
     if (!API.ovr_GetMirrorTextureBufferDX.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetMirrorTextureBufferDX.Ptr(session, mirror, iid, ppObject);
+    OVR_API_RETURN(ovr_GetMirrorTextureBufferDX, (session, mirror, iid, ppObject));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceOutWaveId(unsigned int* deviceOutId)
@@ -1538,7 +2334,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceOutWaveId(unsigned int* deviceO
     if (!API.ovr_GetAudioDeviceOutWaveId.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetAudioDeviceOutWaveId.Ptr(deviceOutId);
+    OVR_API_RETURN(ovr_GetAudioDeviceOutWaveId, (deviceOutId));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceInWaveId(unsigned int* deviceInId)
@@ -1546,7 +2342,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceInWaveId(unsigned int* deviceIn
     if (!API.ovr_GetAudioDeviceInWaveId.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetAudioDeviceInWaveId.Ptr(deviceInId);
+    OVR_API_RETURN(ovr_GetAudioDeviceInWaveId, (deviceInId));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceOutGuidStr(WCHAR* deviceOutStrBuffer)
@@ -1554,7 +2350,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceOutGuidStr(WCHAR* deviceOutStrB
     if (!API.ovr_GetAudioDeviceOutGuidStr.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetAudioDeviceOutGuidStr.Ptr(deviceOutStrBuffer);
+    OVR_API_RETURN(ovr_GetAudioDeviceOutGuidStr, (deviceOutStrBuffer));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceOutGuid(GUID* deviceOutGuid)
@@ -1562,7 +2358,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceOutGuid(GUID* deviceOutGuid)
     if (!API.ovr_GetAudioDeviceOutGuid.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetAudioDeviceOutGuid.Ptr(deviceOutGuid);
+    OVR_API_RETURN(ovr_GetAudioDeviceOutGuid, (deviceOutGuid));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceInGuidStr(WCHAR* deviceInStrBuffer)
@@ -1570,7 +2366,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceInGuidStr(WCHAR* deviceInStrBuf
     if (!API.ovr_GetAudioDeviceInGuidStr.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetAudioDeviceInGuidStr.Ptr(deviceInStrBuffer);
+    OVR_API_RETURN(ovr_GetAudioDeviceInGuidStr, (deviceInStrBuffer));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceInGuid(GUID* deviceInGuid)
@@ -1578,7 +2374,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceInGuid(GUID* deviceInGuid)
     if (!API.ovr_GetAudioDeviceInGuid.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetAudioDeviceInGuid.Ptr(deviceInGuid);
+    OVR_API_RETURN(ovr_GetAudioDeviceInGuid, (deviceInGuid));
 }
 
 #endif
@@ -1590,7 +2386,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateTextureSwapChainGL(ovrSession session,
     if (!API.ovr_CreateTextureSwapChainGL.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_CreateTextureSwapChainGL.Ptr(session, desc, outTextureSet);
+    OVR_API_RETURN(ovr_CreateTextureSwapChainGL, (session, desc, outTextureSet));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateMirrorTextureGL(ovrSession session,
@@ -1600,7 +2396,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateMirrorTextureGL(ovrSession session,
     if (!API.ovr_CreateMirrorTextureGL.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_CreateMirrorTextureGL.Ptr(session, desc, outMirrorTexture);
+    OVR_API_RETURN(ovr_CreateMirrorTextureGL, (session, desc, outMirrorTexture));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainBufferGL(ovrSession session,
@@ -1611,7 +2407,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainBufferGL(ovrSession sessio
     if (!API.ovr_GetTextureSwapChainBufferGL.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetTextureSwapChainBufferGL.Ptr(session, chain, index, texId);
+    OVR_API_RETURN(ovr_GetTextureSwapChainBufferGL, (session, chain, index, texId));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetMirrorTextureBufferGL(ovrSession session,
@@ -1621,7 +2417,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetMirrorTextureBufferGL(ovrSession session,
     if (!API.ovr_GetMirrorTextureBufferGL.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetMirrorTextureBufferGL.Ptr(session, mirror, texId);
+    OVR_API_RETURN(ovr_GetMirrorTextureBufferGL, (session, mirror, texId));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainLength(ovrSession session,
@@ -1631,7 +2427,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainLength(ovrSession session,
     if (!API.ovr_GetTextureSwapChainLength.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetTextureSwapChainLength.Ptr(session, chain, length);
+    OVR_API_RETURN(ovr_GetTextureSwapChainLength, (session, chain, length));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainCurrentIndex(ovrSession session,
@@ -1641,7 +2437,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainCurrentIndex(ovrSession se
     if (!API.ovr_GetTextureSwapChainCurrentIndex.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetTextureSwapChainCurrentIndex.Ptr(session, chain, currentIndex);
+    OVR_API_RETURN(ovr_GetTextureSwapChainCurrentIndex, (session, chain, currentIndex));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainDesc(ovrSession session,
@@ -1651,7 +2447,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainDesc(ovrSession session,
     if (!API.ovr_GetTextureSwapChainDesc.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetTextureSwapChainDesc.Ptr(session, chain, desc);
+    OVR_API_RETURN(ovr_GetTextureSwapChainDesc, (session, chain, desc));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_CommitTextureSwapChain(ovrSession session,
@@ -1660,7 +2456,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CommitTextureSwapChain(ovrSession session,
     if (!API.ovr_CommitTextureSwapChain.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_CommitTextureSwapChain.Ptr(session, chain);
+    OVR_API_RETURN(ovr_CommitTextureSwapChain, (session, chain));
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_DestroyTextureSwapChain(ovrSession session, ovrTextureSwapChain chain)
@@ -1668,7 +2464,7 @@ OVR_PUBLIC_FUNCTION(void) ovr_DestroyTextureSwapChain(ovrSession session, ovrTex
     if (!API.ovr_DestroyTextureSwapChain.Ptr)
         return;
 
-    API.ovr_DestroyTextureSwapChain.Ptr(session, chain);
+    OVR_API_CALL(ovr_DestroyTextureSwapChain, (session, chain));
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_DestroyMirrorTexture(ovrSession session, ovrMirrorTexture mirrorTexture)
@@ -1676,7 +2472,7 @@ OVR_PUBLIC_FUNCTION(void) ovr_DestroyMirrorTexture(ovrSession session, ovrMirror
     if (!API.ovr_DestroyMirrorTexture.Ptr)
         return;
 
-    API.ovr_DestroyMirrorTexture.Ptr(session, mirrorTexture);
+    OVR_API_CALL(ovr_DestroyMirrorTexture, (session, mirrorTexture));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long frameIndex, const ovrViewScaleDesc* viewScaleDesc, ovrLayerHeader const * const * layerPtrList, unsigned int layerCount)
@@ -1684,7 +2480,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long fra
     if (!API.ovr_SubmitFrame.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_SubmitFrame.Ptr(session, frameIndex, viewScaleDesc, layerPtrList, layerCount);
+    OVR_API_RETURN(ovr_SubmitFrame, (session, frameIndex, viewScaleDesc, layerPtrList, layerCount));
 }
 
 OVR_PUBLIC_FUNCTION(ovrEyeRenderDesc) ovr_GetRenderDesc(ovrSession session, ovrEyeType eyeType, ovrFovPort fov)
@@ -1695,7 +2491,7 @@ OVR_PUBLIC_FUNCTION(ovrEyeRenderDesc) ovr_GetRenderDesc(ovrSession session, ovrE
         memset(&nullEyeRenderDesc, 0, sizeof(nullEyeRenderDesc));
         return nullEyeRenderDesc;
     }
-    return API.ovr_GetRenderDesc.Ptr(session, eyeType, fov);
+    OVR_API_RETURN(ovr_GetRenderDesc, (session, eyeType, fov));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetPerfStats(ovrSession session, ovrPerfStats* outPerfStats)
@@ -1703,7 +2499,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetPerfStats(ovrSession session, ovrPerfStats
     if (!API.ovr_GetPerfStats.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_GetPerfStats.Ptr(session, outPerfStats);
+    OVR_API_RETURN(ovr_GetPerfStats, (session, outPerfStats));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_ResetPerfStats(ovrSession session)
@@ -1711,7 +2507,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_ResetPerfStats(ovrSession session)
     if (!API.ovr_ResetPerfStats.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_ResetPerfStats.Ptr(session);
+    OVR_API_RETURN(ovr_ResetPerfStats, (session));
 }
 
 OVR_PUBLIC_FUNCTION(double) ovr_GetPredictedDisplayTime(ovrSession session, long long frameIndex)
@@ -1719,56 +2515,87 @@ OVR_PUBLIC_FUNCTION(double) ovr_GetPredictedDisplayTime(ovrSession session, long
     if (!API.ovr_GetPredictedDisplayTime.Ptr)
         return 0.0;
 
-    return API.ovr_GetPredictedDisplayTime.Ptr(session, frameIndex);
+    if (OVR_CallReplayActive || OVR_CallRecordingActive)
+    {
+        OVR_PredictedDisplayTimeRecord record;
+
+        if (OVR_ReplayCallResult(OVR_CallRecord_PredictedDisplayTime, 0, &record))
+            return record.DisplayTime;
+
+        memset(&record, 0, sizeof(record));
+        OVR_API_ASSIGN(record.DisplayTime, ovr_GetPredictedDisplayTime, (session, frameIndex));
+
+        if (OVR_CallRecordingActive)
+        {
+            record.FrameIndex = frameIndex;
+            OVR_RecordCallResult(OVR_CallRecord_PredictedDisplayTime, &record);
+        }
+
+        return record.DisplayTime;
+    }
+
+    OVR_API_RETURN(ovr_GetPredictedDisplayTime, (session, frameIndex));
 }
 
 OVR_PUBLIC_FUNCTION(double) ovr_GetTimeInSeconds()
 {
     if (!API.ovr_GetTimeInSeconds.Ptr)
         return 0.;
-    return API.ovr_GetTimeInSeconds.Ptr();
+    OVR_API_RETURN(ovr_GetTimeInSeconds, ());
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_GetBool(ovrSession session, const char* propertyName, ovrBool defaultVal)
 {
     if (!API.ovr_GetBool.Ptr)
         return ovrFalse;
-    return API.ovr_GetBool.Ptr(session, propertyName, defaultVal);
+    OVR_API_RETURN(ovr_GetBool, (session, propertyName, defaultVal));
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetBool(ovrSession session, const char* propertyName, ovrBool value)
 {
+    ovrBool result;
+
     if (!API.ovr_SetBool.Ptr)
         return ovrFalse;
-    return API.ovr_SetBool.Ptr(session, propertyName, value);
+    OVR_API_ASSIGN(result, ovr_SetBool, (session, propertyName, value));
+    OVR_OnPropertySet(session, propertyName);
+    return result;
 }
 
 OVR_PUBLIC_FUNCTION(int) ovr_GetInt(ovrSession session, const char* propertyName, int defaultVal)
 {
     if (!API.ovr_GetInt.Ptr)
         return 0;
-    return API.ovr_GetInt.Ptr(session, propertyName, defaultVal);
+    OVR_API_RETURN(ovr_GetInt, (session, propertyName, defaultVal));
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetInt(ovrSession session, const char* propertyName, int value)
 {
+    ovrBool result;
+
     if (!API.ovr_SetInt.Ptr)
         return ovrFalse;
-    return API.ovr_SetInt.Ptr(session, propertyName, value);
+    OVR_API_ASSIGN(result, ovr_SetInt, (session, propertyName, value));
+    OVR_OnPropertySet(session, propertyName);
+    return result;
 }
 
 OVR_PUBLIC_FUNCTION(float) ovr_GetFloat(ovrSession session, const char* propertyName, float defaultVal)
 {
     if (!API.ovr_GetFloat.Ptr)
         return 0.f;
-    return API.ovr_GetFloat.Ptr(session, propertyName, defaultVal);
+    OVR_API_RETURN(ovr_GetFloat, (session, propertyName, defaultVal));
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetFloat(ovrSession session, const char* propertyName, float value)
 {
+    ovrBool result;
+
     if (!API.ovr_SetFloat.Ptr)
         return ovrFalse;
-    return API.ovr_SetFloat.Ptr(session, propertyName, value);
+    OVR_API_ASSIGN(result, ovr_SetFloat, (session, propertyName, value));
+    OVR_OnPropertySet(session, propertyName);
+    return result;
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetFloatArray(ovrSession session, const char* propertyName,
@@ -1776,15 +2603,19 @@ OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetFloatArray(ovrSession session, const ch
 {
     if (!API.ovr_GetFloatArray.Ptr)
         return 0;
-    return API.ovr_GetFloatArray.Ptr(session, propertyName, values, arraySize);
+    OVR_API_RETURN(ovr_GetFloatArray, (session, propertyName, values, arraySize));
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetFloatArray(ovrSession session, const char* propertyName,
                                              const float values[], unsigned int arraySize)
 {
+    ovrBool result;
+
     if (!API.ovr_SetFloatArray.Ptr)
         return ovrFalse;
-    return API.ovr_SetFloatArray.Ptr(session, propertyName, values, arraySize);
+    OVR_API_ASSIGN(result, ovr_SetFloatArray, (session, propertyName, values, arraySize));
+    OVR_OnPropertySet(session, propertyName);
+    return result;
 }
 
 OVR_PUBLIC_FUNCTION(const char*) ovr_GetString(ovrSession session, const char* propertyName,
@@ -1792,15 +2623,113 @@ OVR_PUBLIC_FUNCTION(const char*) ovr_GetString(ovrSession session, const char* p
 {
     if (!API.ovr_GetString.Ptr)
         return "(Unable to load LibOVR)";
-    return API.ovr_GetString.Ptr(session, propertyName, defaultVal);
+    OVR_API_RETURN(ovr_GetString, (session, propertyName, defaultVal));
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetString(ovrSession session, const char* propertyName,
                                     const char* value)
 {
+    ovrBool result;
+
     if (!API.ovr_SetString.Ptr)
         return ovrFalse;
-    return API.ovr_SetString.Ptr(session, propertyName, value);
+    OVR_API_ASSIGN(result, ovr_SetString, (session, propertyName, value));
+    OVR_OnPropertySet(session, propertyName);
+    return result;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetPropertyHandle(ovrSession session, const char* propertyName,
+                                                     ovrPropertyType type, double defaultValue,
+                                                     ovrPropertyHandle* outHandle)
+{
+    OVR_CachedProperty* property;
+    size_t nameLength;
+
+    if (!outHandle)
+        return ovrError_InvalidParameter;
+    *outHandle = NULL;
+
+    if (!API.ovr_GetBool.Ptr)
+        return ovrError_NotInitialized;
+
+    if (!propertyName || !*propertyName || (type < ovrPropertyType_Bool) || (type > ovrPropertyType_String))
+        return ovrError_InvalidParameter;
+
+    OVR_CachedPropertyLock();
+
+    for (property = OVR_CachedProperties; property; property = property->Next)
+    {
+        if ((property->Session == session) && (property->Value.Type == type) &&
+            (strcmp(property->Name, propertyName) == 0))
+        {
+            OVR_CachedPropertyUnlock();
+            *outHandle = &property->Value;
+            return ovrSuccess;
+        }
+    }
+
+    nameLength = strlen(propertyName);
+    property = (OVR_CachedProperty*)malloc(offsetof(OVR_CachedProperty, Name) + nameLength + 1);
+
+    if (!property)
+    {
+        OVR_CachedPropertyUnlock();
+        return ovrError_MemoryAllocationFailure;
+    }
+
+    memset(property, 0, sizeof(OVR_CachedProperty));
+    memcpy(property->Name, propertyName, nameLength + 1);
+    property->Value.Type = type;
+    property->Session = session;
+    property->DefaultValue = defaultValue;
+    OVR_ReadCachedProperty(property);
+
+    property->Next = OVR_CachedProperties;
+    OVR_CachedProperties = property;
+
+    OVR_CachedPropertyUnlock();
+
+    *outHandle = &property->Value;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_RefreshProperties(ovrSession session, const ovrPropertyHandle* handles,
+                                                     unsigned int handleCount)
+{
+    OVR_CachedProperty* property;
+    unsigned int i;
+
+    if (!API.ovr_GetBool.Ptr)
+        return ovrError_NotInitialized;
+
+    if (handles)
+    {
+        // Handles are checked before reading any of them, so that a failed call changes nothing.
+        for (i = 0; i < handleCount; ++i)
+        {
+            if (!handles[i] || (((const OVR_CachedProperty*)handles[i])->Session != session))
+                return ovrError_InvalidParameter;
+        }
+    }
+
+    OVR_CachedPropertyLock();
+
+    if (handles)
+    {
+        for (i = 0; i < handleCount; ++i)
+            OVR_ReadCachedProperty((OVR_CachedProperty*)handles[i]);
+    }
+    else
+    {
+        for (property = OVR_CachedProperties; property; property = property->Next)
+        {
+            if (property->Session == session)
+                OVR_ReadCachedProperty(property);
+        }
+    }
+
+    OVR_CachedPropertyUnlock();
+    return ovrSuccess;
 }
 
 OVR_PUBLIC_FUNCTION(int) ovr_TraceMessage(int level, const char* message)
@@ -1808,7 +2737,7 @@ OVR_PUBLIC_FUNCTION(int) ovr_TraceMessage(int level, const char* message)
     if (!API.ovr_TraceMessage.Ptr)
         return -1;
 
-    return API.ovr_TraceMessage.Ptr(level, message);
+    OVR_API_RETURN(ovr_TraceMessage, (level, message));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_IdentifyClient(const char* identity)
@@ -1816,14 +2745,393 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_IdentifyClient(const char* identity)
     if (!API.ovr_IdentifyClient.Ptr)
         return ovrError_NotInitialized;
 
-    return API.ovr_IdentifyClient.Ptr(identity);
+    OVR_API_RETURN(ovr_IdentifyClient, (identity));
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_Lookup(const char* name, void** data)
 {
     if (!API.ovr_Lookup.Ptr)
         return ovrError_NotInitialized;
-    return API.ovr_Lookup.Ptr(name, data);
+    OVR_API_RETURN(ovr_Lookup, (name, data));
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** Call profiling
+//
+
+#if defined(OVR_CAPI_PROFILE)
+
+// Merges the counters of all threads for the given generation into totals.
+static void OVR_SumCallCounters(OVR_CallCounters* totals, long generation)
+{
+    const OVR_ThreadCallCounters* threadCounters;
+    int i, j;
+
+    memset(totals, 0, OVR_CallId_Count * sizeof(OVR_CallCounters));
+
+    // The counters are read while their threads may be updating them, so the totals
+    // are approximate for calls in flight.
+    for (threadCounters = OVR_AllThreadCallCounters; threadCounters; threadCounters = threadCounters->Next)
+    {
+        // Threads that haven't made a call since the last reset still hold old counts.
+        if (threadCounters->Generation != generation)
+            continue;
+
+        for (i = 0; i < OVR_CallId_Count; ++i)
+        {
+            const OVR_CallCounters* counters = &threadCounters->Calls[i];
+
+            totals[i].CallCount += counters->CallCount;
+            totals[i].TotalNanoseconds += counters->TotalNanoseconds;
+            if (counters->MaxNanoseconds > totals[i].MaxNanoseconds)
+                totals[i].MaxNanoseconds = counters->MaxNanoseconds;
+            for (j = 0; j < ovrCallProfile_BucketCount; ++j)
+                totals[i].Histogram[j] += counters->Histogram[j];
+        }
+    }
+}
+
+OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetCallProfiles(ovrCallProfile* outProfiles, unsigned int profilesCapacity)
+{
+    OVR_CallCounters totals[OVR_CallId_Count];
+    unsigned int profileCount = 0;
+    int i;
+
+    OVR_SumCallCounters(totals, OVR_CallProfileGeneration);
+
+    for (i = 0; i < OVR_CallId_Count; ++i)
+    {
+        if (totals[i].CallCount == 0)
+            continue;
+
+        if (outProfiles && (profileCount < profilesCapacity))
+        {
+            ovrCallProfile* profile = &outProfiles[profileCount];
+
+            profile->FunctionName = OVR_CallNames[i];
+            profile->CallCount = totals[i].CallCount;
+            profile->TotalNanoseconds = totals[i].TotalNanoseconds;
+            profile->MaxNanoseconds = totals[i].MaxNanoseconds;
+            memcpy(profile->Histogram, totals[i].Histogram, sizeof(profile->Histogram));
+        }
+
+        ++profileCount;
+    }
+
+    return profileCount;
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_ResetCallProfiles()
+{
+    OVR_CallProfileIncrement(&OVR_CallProfileGeneration);
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_SetCallProfileReporting(double intervalSeconds, ovrLogCallback callback, uintptr_t userData)
+{
+    OVR_CallProfileReportInterval = 0;
+
+    if ((intervalSeconds > 0) && callback)
+    {
+        const int64_t interval = (int64_t)(intervalSeconds * (double)OVR_GetCallProfileTicksPerSecond());
+
+        // The first report covers the calls made from now on.
+        OVR_CallProfileReportedGeneration = OVR_CallProfileGeneration;
+        OVR_SumCallCounters(OVR_CallProfileReported, OVR_CallProfileReportedGeneration);
+
+        OVR_CallProfileReportCallback = callback;
+        OVR_CallProfileReportUserData = userData;
+        OVR_CallProfileNextReport = OVR_GetCallProfileTicks() + interval;
+        OVR_CallProfileReportInterval = (interval > 0) ? interval : 1;
+    }
+}
+
+static void OVR_ReportCallProfiles()
+{
+    OVR_CallCounters* totals = (OVR_CallCounters*)malloc(OVR_CallId_Count * sizeof(OVR_CallCounters));
+    ovrLogCallback callback = OVR_CallProfileReportCallback;
+    const uintptr_t userData = OVR_CallProfileReportUserData;
+    const long generation = OVR_CallProfileGeneration;
+    ovrCallProfile profile;
+    int i, j;
+    char line[256];
+
+    if (!totals || !callback)
+    {
+        free(totals);
+        return;
+    }
+
+    OVR_SumCallCounters(totals, generation);
+
+    // After ovr_ResetCallProfiles the totals start again from zero.
+    if (generation != OVR_CallProfileReportedGeneration)
+        memset(OVR_CallProfileReported, 0, sizeof(OVR_CallProfileReported));
+
+    for (i = 0; i < OVR_CallId_Count; ++i)
+    {
+        const OVR_CallCounters* current = &totals[i];
+        const OVR_CallCounters* previous = &OVR_CallProfileReported[i];
+        uint64_t bucketMax = 0;
+
+        // The totals are approximate while calls are in flight, so don't let them go backwards.
+        if (current->CallCount <= previous->CallCount)
+            continue;
+
+        profile.FunctionName = OVR_CallNames[i];
+        profile.CallCount = current->CallCount - previous->CallCount;
+        profile.TotalNanoseconds = (current->TotalNanoseconds > previous->TotalNanoseconds) ?
+            (current->TotalNanoseconds - previous->TotalNanoseconds) : 0;
+
+        for (j = 0; j < ovrCallProfile_BucketCount; ++j)
+        {
+            profile.Histogram[j] = (current->Histogram[j] > previous->Histogram[j]) ?
+                (current->Histogram[j] - previous->Histogram[j]) : 0;
+            if (profile.Histogram[j])
+                bucketMax = ovr_GetCallProfileBucketLimit((unsigned int)j);
+        }
+
+        // A new maximum happened in this interval. Otherwise the highest bucket used in
+        // this interval bounds it.
+        if (current->MaxNanoseconds > previous->MaxNanoseconds)
+            profile.MaxNanoseconds = current->MaxNanoseconds;
+        else
+            profile.MaxNanoseconds = (bucketMax < current->MaxNanoseconds) ? bucketMax : current->MaxNanoseconds;
+
+        #if defined(_WIN32)
+            sprintf_s(line, sizeof(line),
+        #else
+            snprintf(line, sizeof(line),
+        #endif
+                "%s: %llu calls, mean %.1f us, p50 %.1f us, p99 %.1f us, max %.1f us",
+                profile.FunctionName, (unsigned long long)profile.CallCount,
+                (double)profile.TotalNanoseconds / (double)profile.CallCount / 1000.0,
+                (double)ovr_GetCallProfilePercentile(&profile, 50) / 1000.0,
+                (double)ovr_GetCallProfilePercentile(&profile, 99) / 1000.0,
+                (double)profile.MaxNanoseconds / 1000.0);
+
+        callback(userData, ovrLogLevel_Info, line);
+    }
+
+    memcpy(OVR_CallProfileReported, totals, sizeof(OVR_CallProfileReported));
+    OVR_CallProfileReportedGeneration = generation;
+
+    free(totals);
+}
+
+#else // OVR_CAPI_PROFILE
+
+OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetCallProfiles(ovrCallProfile* outProfiles, unsigned int profilesCapacity)
+{
+    (void)outProfiles;
+    (void)profilesCapacity;
+    return 0;
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_ResetCallProfiles()
+{
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_SetCallProfileReporting(double intervalSeconds, ovrLogCallback callback, uintptr_t userData)
+{
+    (void)intervalSeconds;
+    (void)callback;
+    (void)userData;
+}
+
+#endif // OVR_CAPI_PROFILE
+
+OVR_PUBLIC_FUNCTION(uint64_t) ovr_GetCallProfileBucketLimit(unsigned int bucketIndex)
+{
+    unsigned int exponent, subBucket;
+
+    if (bucketIndex == 0)
+        return (uint64_t)1 << ovrCallProfile_MinExponent;
+
+    if (bucketIndex >= ovrCallProfile_BucketCount)
+        bucketIndex = ovrCallProfile_BucketCount - 1;
+
+    exponent = ovrCallProfile_MinExponent + (bucketIndex - 1) / ovrCallProfile_SubBucketCount;
+    subBucket = (bucketIndex - 1) % ovrCallProfile_SubBucketCount;
+
+    return ((uint64_t)(ovrCallProfile_SubBucketCount + subBucket + 1)) << (exponent - ovrCallProfile_SubBucketBits);
+}
+
+OVR_PUBLIC_FUNCTION(uint64_t) ovr_GetCallProfilePercentile(const ovrCallProfile* profile, double percentile)
+{
+    uint64_t threshold, count = 0;
+    unsigned int i;
+
+    if (!profile || (profile->CallCount == 0))
+        return 0;
+
+    if (percentile < 0)
+        percentile = 0;
+    else if (percentile > 100)
+        percentile = 100;
+
+    threshold = (uint64_t)((double)profile->CallCount * percentile / 100.0);
+    if (threshold == 0)
+        threshold = 1;
+
+    for (i = 0; i < ovrCallProfile_BucketCount; ++i)
+    {
+        count += profile->Histogram[i];
+        if (count >= threshold)
+            return ovr_GetCallProfileBucketLimit(i);
+    }
+
+    return ovr_GetCallProfileBucketLimit(ovrCallProfile_BucketCount - 1);
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_StartCallRecording(const char* path)
+{
+    OVR_CallStreamHeader header;
+    FILE* file = NULL;
+
+    if (!path)
+        return ovrError_InvalidParameter;
+
+    if (OVR_CallRecordingActive || OVR_CallReplayActive)
+        return ovrError_InvalidOperation;
+
+    #if defined(_WIN32)
+        if (fopen_s(&file, path, "wb") != 0)
+            file = NULL;
+    #else
+        file = fopen(path, "wb");
+    #endif
+
+    if (!file)
+        return ovrError_InvalidParameter;
+
+    memcpy(header.Magic, "OVRC", 4);
+    header.Version = OVR_CALL_STREAM_VERSION;
+    memcpy(header.RecordSizes, OVR_CallRecordSizes, sizeof(OVR_CallRecordSizes));
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        fclose(file);
+        return ovrError_InvalidParameter;
+    }
+
+    OVR_CallRecordLock();
+
+    if (OVR_CallRecordingActive || OVR_CallReplayActive)
+    {
+        OVR_CallRecordUnlock();
+        fclose(file);
+        return ovrError_InvalidOperation;
+    }
+
+    OVR_CallRecordFile = file;
+    OVR_CallRecordLastTime = 0;
+    memset(OVR_CallRecordPrevious, 0, sizeof(OVR_CallRecordPrevious));
+    OVR_CallRecordingActive = 1;
+
+    OVR_CallRecordUnlock();
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_StopCallRecording()
+{
+    FILE* file;
+
+    if (!OVR_CallRecordingActive)
+        return;
+
+    OVR_CallRecordLock();
+    file = OVR_CallRecordFile;
+    OVR_CallRecordFile = NULL;
+    OVR_CallRecordingActive = 0;
+    OVR_CallRecordUnlock();
+
+    if (file)
+        fclose(file);
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_StartCallReplay(const char* path, ovrCallReplayTimeCallback timeCallback,
+                                                   uintptr_t userData)
+{
+    FILE* file = NULL;
+    uint8_t* data = NULL;
+    long size;
+    ovrBool decoded;
+
+    if (!path)
+        return ovrError_InvalidParameter;
+
+    if (OVR_CallRecordingActive || OVR_CallReplayActive)
+        return ovrError_InvalidOperation;
+
+    #if defined(_WIN32)
+        if (fopen_s(&file, path, "rb") != 0)
+            file = NULL;
+    #else
+        file = fopen(path, "rb");
+    #endif
+
+    if (!file)
+        return ovrError_InvalidParameter;
+
+    if ((fseek(file, 0, SEEK_END) == 0) && ((size = ftell(file)) > 0) && (fseek(file, 0, SEEK_SET) == 0))
+    {
+        data = (uint8_t*)malloc((size_t)size);
+        if (data && (fread(data, 1, (size_t)size, file) != (size_t)size))
+        {
+            free(data);
+            data = NULL;
+        }
+    }
+
+    fclose(file);
+
+    if (!data)
+        return ovrError_InvalidParameter;
+
+    OVR_CallRecordLock();
+
+    if (OVR_CallRecordingActive || OVR_CallReplayActive)
+    {
+        OVR_CallRecordUnlock();
+        free(data);
+        return ovrError_InvalidOperation;
+    }
+
+    decoded = OVR_DecodeCallReplay(data, (size_t)size);
+    free(data);
+
+    if (!decoded || (OVR_ReplayCallCount == 0))
+    {
+        OVR_FreeCallReplay();
+        OVR_CallRecordUnlock();
+        return ovrError_InvalidParameter;
+    }
+
+    memset(OVR_ReplayCursors, 0, sizeof(OVR_ReplayCursors));
+    OVR_InputReplayCursorCount = 0;
+    OVR_ReplayLastReportedTime = INT64_MIN;
+    OVR_ReplayTimeCallback = timeCallback;
+    OVR_ReplayTimeCallbackUserData = userData;
+    OVR_CallReplayActive = 1;
+
+    OVR_CallRecordUnlock();
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_StopCallReplay()
+{
+    if (!OVR_CallReplayActive)
+        return;
+
+    OVR_CallRecordLock();
+    OVR_FreeCallReplay();
+    OVR_CallRecordUnlock();
+}
+
+OVR_PUBLIC_FUNCTION(ovrBool) ovr_IsCallReplayActive()
+{
+    return OVR_CallReplayActive ? ovrTrue : ovrFalse;
 }
 
 #if defined(_MSC_VER)
@@ -25,19 +25,25 @@ limitations under the License.
 #include <Extras/OVR_StereoProjection.h>
 
 #include <algorithm>
+#include <atomic>
+#include <float.h>
 #include <limits.h>
+#include <math.h>
 #include <memory>
-
-#if defined(_MSC_VER) && _MSC_VER < 1800 // MSVC < 2013
-    #define round(dbl) (dbl) >= 0.0 ? (int)((dbl) + 0.5) : (((dbl) - (double)(int)(dbl)) <= -0.5 ? (int)(dbl) : (int)((dbl) - 0.5))
-#endif
-
+#include <string.h>
+#include <thread>
+#include <vector>
 
 #if defined(_MSC_VER)
     #include <emmintrin.h>
     #pragma intrinsic(_mm_pause)
 #endif
 
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define OVR_CAPI_UTIL_SSE2
+#endif
+
 #if defined(_WIN32)
     // Prevents <Windows.h> from defining min() and max() macro symbols.
     #ifndef NOMINMAX
@@ -187,6 +193,187 @@ OVR_PUBLIC_FUNCTION(void) ovr_GetEyePoses(ovrSession session, long long frameInd
     }
 }
 
+//-----------------------------------------------------------------------------------
+// ***** Multi-view computation
+//
+// Poses and view matrices are computed four views at a time with SSE2, with the views
+// transposed so that each register holds the same component of four views. A last batch
+// of fewer views, such as a stereo pair, is padded. Projections only depend on the view
+// descriptions, so they are kept until these change.
+
+namespace {
+
+const unsigned int kViewBatchSize = 4;
+
+void viewCalcPose(const ovrPosef& headPose, const ovrViewDesc& viewDesc, ovrViewState* view)
+{
+    OVR::Posef pose = OVR::Posef(headPose) * OVR::Posef(viewDesc.HmdToViewPose);
+
+    view->Pose = pose;
+    view->View = OVR::Matrix4f(pose.Inverted());
+}
+
+#if defined(OVR_CAPI_UTIL_SSE2)
+// Computes count views at once, where count is at most kViewBatchSize.
+void viewCalcPoseBatch(const ovrPosef& headPose, const ovrViewDesc* viewDescs, ovrViewState* views, unsigned int count)
+{
+    // Pad a partial batch, such as a stereo pair, by repeating its last view.
+    ovrViewDesc padded[kViewBatchSize];
+    if (count < kViewBatchSize)
+    {
+        for (unsigned int i = 0; i < kViewBatchSize; ++i)
+            padded[i] = viewDescs[(i < count) ? i : (count - 1)];
+        viewDescs = padded;
+    }
+
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 hqx = _mm_set1_ps(headPose.Orientation.x);
+    const __m128 hqy = _mm_set1_ps(headPose.Orientation.y);
+    const __m128 hqz = _mm_set1_ps(headPose.Orientation.z);
+    const __m128 hqw = _mm_set1_ps(headPose.Orientation.w);
+
+    // ovrQuatf is x, y, z, w, so transposing four of them gives a register per component.
+    __m128 lqx = _mm_loadu_ps(&viewDescs[0].HmdToViewPose.Orientation.x);
+    __m128 lqy = _mm_loadu_ps(&viewDescs[1].HmdToViewPose.Orientation.x);
+    __m128 lqz = _mm_loadu_ps(&viewDescs[2].HmdToViewPose.Orientation.x);
+    __m128 lqw = _mm_loadu_ps(&viewDescs[3].HmdToViewPose.Orientation.x);
+    _MM_TRANSPOSE4_PS(lqx, lqy, lqz, lqw);
+
+    __m128 lpx = _mm_setr_ps(viewDescs[0].HmdToViewPose.Position.x, viewDescs[1].HmdToViewPose.Position.x,
+                             viewDescs[2].HmdToViewPose.Position.x, viewDescs[3].HmdToViewPose.Position.x);
+    __m128 lpy = _mm_setr_ps(viewDescs[0].HmdToViewPose.Position.y, viewDescs[1].HmdToViewPose.Position.y,
+                             viewDescs[2].HmdToViewPose.Position.y, viewDescs[3].HmdToViewPose.Position.y);
+    __m128 lpz = _mm_setr_ps(viewDescs[0].HmdToViewPose.Position.z, viewDescs[1].HmdToViewPose.Position.z,
+                             viewDescs[2].HmdToViewPose.Position.z, viewDescs[3].HmdToViewPose.Position.z);
+
+    // q = headPose.Orientation * HmdToViewPose.Orientation
+    __m128 qx = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(hqw, lqx), _mm_mul_ps(hqx, lqw)), _mm_mul_ps(hqy, lqz)), _mm_mul_ps(hqz, lqy));
+    __m128 qy = _mm_add_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(hqw, lqy), _mm_mul_ps(hqx, lqz)), _mm_mul_ps(hqy, lqw)), _mm_mul_ps(hqz, lqx));
+    __m128 qz = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(hqw, lqz), _mm_mul_ps(hqx, lqy)), _mm_mul_ps(hqy, lqx)), _mm_mul_ps(hqz, lqw));
+    __m128 qw = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(hqw, lqw), _mm_mul_ps(hqx, lqx)), _mm_mul_ps(hqy, lqy)), _mm_mul_ps(hqz, lqz));
+
+    // p = headPose.Position + headPose.Orientation.Rotate(HmdToViewPose.Position), as in Quat::Rotate.
+    __m128 uvx = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(hqy, lpz), _mm_mul_ps(hqz, lpy)));
+    __m128 uvy = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(hqz, lpx), _mm_mul_ps(hqx, lpz)));
+    __m128 uvz = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(hqx, lpy), _mm_mul_ps(hqy, lpx)));
+    __m128 px = _mm_add_ps(_mm_set1_ps(headPose.Position.x),
+                           _mm_add_ps(_mm_add_ps(lpx, _mm_mul_ps(hqw, uvx)), _mm_sub_ps(_mm_mul_ps(hqy, uvz), _mm_mul_ps(hqz, uvy))));
+    __m128 py = _mm_add_ps(_mm_set1_ps(headPose.Position.y),
+                           _mm_add_ps(_mm_add_ps(lpy, _mm_mul_ps(hqw, uvy)), _mm_sub_ps(_mm_mul_ps(hqz, uvx), _mm_mul_ps(hqx, uvz))));
+    __m128 pz = _mm_add_ps(_mm_set1_ps(headPose.Position.z),
+                           _mm_add_ps(_mm_add_ps(lpz, _mm_mul_ps(hqw, uvz)), _mm_sub_ps(_mm_mul_ps(hqx, uvy), _mm_mul_ps(hqy, uvx))));
+
+    // Rotation matrix of q, as in Matrix4(const Quat&).
+    __m128 ww = _mm_mul_ps(qw, qw);
+    __m128 xx = _mm_mul_ps(qx, qx);
+    __m128 yy = _mm_mul_ps(qy, qy);
+    __m128 zz = _mm_mul_ps(qz, qz);
+    __m128 xy = _mm_mul_ps(qx, qy);
+    __m128 xz = _mm_mul_ps(qx, qz);
+    __m128 yz = _mm_mul_ps(qy, qz);
+    __m128 wx = _mm_mul_ps(qw, qx);
+    __m128 wy = _mm_mul_ps(qw, qy);
+    __m128 wz = _mm_mul_ps(qw, qz);
+
+    __m128 r00 = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(ww, xx), yy), zz);
+    __m128 r01 = _mm_mul_ps(two, _mm_sub_ps(xy, wz));
+    __m128 r02 = _mm_mul_ps(two, _mm_add_ps(xz, wy));
+    __m128 r10 = _mm_mul_ps(two, _mm_add_ps(xy, wz));
+    __m128 r11 = _mm_sub_ps(_mm_add_ps(_mm_sub_ps(ww, xx), yy), zz);
+    __m128 r12 = _mm_mul_ps(two, _mm_sub_ps(yz, wx));
+    __m128 r20 = _mm_mul_ps(two, _mm_sub_ps(xz, wy));
+    __m128 r21 = _mm_mul_ps(two, _mm_add_ps(yz, wx));
+    __m128 r22 = _mm_add_ps(_mm_sub_ps(_mm_sub_ps(ww, xx), yy), zz);
+
+    // The view matrix is the inverse of [R | p], which is [R^T | -R^T * p].
+    __m128 tx = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(_mm_add_ps(_mm_mul_ps(r00, px), _mm_mul_ps(r10, py)), _mm_mul_ps(r20, pz)));
+    __m128 ty = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(_mm_add_ps(_mm_mul_ps(r01, px), _mm_mul_ps(r11, py)), _mm_mul_ps(r21, pz)));
+    __m128 tz = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(_mm_add_ps(_mm_mul_ps(r02, px), _mm_mul_ps(r12, py)), _mm_mul_ps(r22, pz)));
+
+    // Transpose back to one register per view.
+    _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+    __m128 pw = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(px, py, pz, pw);
+    _MM_TRANSPOSE4_PS(r00, r10, r20, tx);
+    _MM_TRANSPOSE4_PS(r01, r11, r21, ty);
+    _MM_TRANSPOSE4_PS(r02, r12, r22, tz);
+
+    const __m128 orientations[kViewBatchSize] = { qx, qy, qz, qw };
+    const __m128 positions[kViewBatchSize]    = { px, py, pz, pw };
+    const __m128 rows0[kViewBatchSize]        = { r00, r10, r20, tx };
+    const __m128 rows1[kViewBatchSize]        = { r01, r11, r21, ty };
+    const __m128 rows2[kViewBatchSize]        = { r02, r12, r22, tz };
+    const __m128 row3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        float position[4];
+        _mm_storeu_ps(position, positions[i]);
+
+        _mm_storeu_ps(&views[i].Pose.Orientation.x, orientations[i]);
+        views[i].Pose.Position.x = position[0];
+        views[i].Pose.Position.y = position[1];
+        views[i].Pose.Position.z = position[2];
+        _mm_storeu_ps(views[i].View.M[0], rows0[i]);
+        _mm_storeu_ps(views[i].View.M[1], rows1[i]);
+        _mm_storeu_ps(views[i].View.M[2], rows2[i]);
+        _mm_storeu_ps(views[i].View.M[3], row3);
+    }
+}
+#endif
+
+void viewUpdateProjection(const ovrViewDesc& viewDesc, ovrViewState* view)
+{
+    if (view->ProjectionValid &&
+        view->CachedFov.UpTan == viewDesc.Fov.UpTan && view->CachedFov.DownTan == viewDesc.Fov.DownTan &&
+        view->CachedFov.LeftTan == viewDesc.Fov.LeftTan && view->CachedFov.RightTan == viewDesc.Fov.RightTan &&
+        view->CachedZNear == viewDesc.ZNear && view->CachedZFar == viewDesc.ZFar &&
+        view->CachedProjectionModFlags == viewDesc.ProjectionModFlags)
+    {
+        return;
+    }
+
+    view->Projection = ovrMatrix4f_Projection(viewDesc.Fov, viewDesc.ZNear, viewDesc.ZFar, viewDesc.ProjectionModFlags);
+    view->TimewarpProjectionDesc = ovrTimewarpProjectionDesc_FromProjection(view->Projection, viewDesc.ProjectionModFlags);
+    view->CachedFov = viewDesc.Fov;
+    view->CachedZNear = viewDesc.ZNear;
+    view->CachedZFar = viewDesc.ZFar;
+    view->CachedProjectionModFlags = viewDesc.ProjectionModFlags;
+    view->ProjectionValid = ovrTrue;
+}
+
+} // namespace
+
+
+OVR_PUBLIC_FUNCTION(void) ovr_CalcViews(ovrPosef headPose, const ovrViewDesc* viewDescs,
+    unsigned int viewCount, ovrViewState* inOutViews)
+{
+    if (!viewDescs || !inOutViews)
+    {
+        return;
+    }
+
+    unsigned int i = 0;
+
+#if defined(OVR_CAPI_UTIL_SSE2)
+    for (; i < viewCount; i += kViewBatchSize)
+    {
+        const unsigned int count = (viewCount - i < kViewBatchSize) ? (viewCount - i) : kViewBatchSize;
+        viewCalcPoseBatch(headPose, viewDescs + i, inOutViews + i, count);
+    }
+#endif
+
+    for (; i < viewCount; ++i)
+    {
+        viewCalcPose(headPose, viewDescs[i], inOutViews + i);
+    }
+
+    for (i = 0; i < viewCount; ++i)
+    {
+        viewUpdateProjection(viewDescs[i], inOutViews + i);
+    }
+}
+
 OVR_PUBLIC_FUNCTION(ovrDetectResult) ovr_Detect(int timeoutMilliseconds)
 {
     // Initially we assume everything is not running.
@@ -234,134 +421,952 @@ OVR_PUBLIC_FUNCTION(void) ovrPosef_FlipHandedness(const ovrPosef* inPose, ovrPos
     outPose->Position.z = inPose->Position.z;
 }
 
-static float wavPcmBytesToFloat(const void* data, int32_t sizeInBits, bool swapBytes) {
-    // TODO Support big endian
-    (void)swapBytes;
-    
-    // There's not a strong standard to convert 8/16/32b PCM to float.
-    // For 16b: MSDN says range is [-32760, 32760], Pyton Scipy uses [-32767, 32767] and Audacity outputs the full range [-32768, 32767].
-    // We use the same range on both sides and clamp to [-1, 1].
+//-----------------------------------------------------------------------------------
+// ***** Boundary field
+//
+// The boundary walls are 2D segments in the floor plane (x, z), stored in a bounding volume
+// hierarchy so that finding the closest segment to a point visits O(log n) segments. Each
+// segment keeps the inward normals of its ends, averaged with the adjacent segments, so that
+// the side of the closest point also tells inside from outside at the polygon's corners.
+
+namespace {
+
+struct BoundarySegment
+{
+    float X0, Z0, X1, Z1;       // Start and end.
+    float NX, NZ;               // Unit inward normal of the segment.
+    float N0X, N0Z, N1X, N1Z;   // Inward normals of the start and end corners.
+};
+
+// Interior nodes have Count == 0 and their children at First and First + 1. Leaves hold the
+// segments [First, First + Count).
+struct BoundaryBvhNode
+{
+    float MinX, MinZ, MaxX, MaxZ;
+    int   First;
+    int   Count;
+};
+
+struct BoundaryFieldData
+{
+    std::vector<ovrVector3f>     Points;
+    std::vector<BoundarySegment> Segments;
+    std::vector<BoundaryBvhNode> Nodes;
+};
 
-    float result = 0.0f;
-    if (sizeInBits == 8)
-        // uint8_t is a special case, unsigned where 128 is zero
-        result = (*((uint8_t*)data) / (float)UCHAR_MAX) * 2.0f - 1.0f;
-    else if (sizeInBits == 16)
-        result = *((int16_t*)data) / (float)SHRT_MAX;
-    //else if (sizeInBits == 24) {
-    //    int value = data[0] | data[1] << 8 | data[2] << 16; // Need consider 2's complement
-    //    return value / 8388607.0f;
-    //}
-    else if (sizeInBits == 32)
-        result = *((int32_t*)data) / (float)INT_MAX;
+const int kBoundaryLeafSize = 4;
+const int kBoundaryMaxDepth = 64;
 
-    return std::max(-1.0f, result);
+void boundaryNormalize(float& x, float& z)
+{
+    float length = sqrtf(x * x + z * z);
+    if (length > 0.0f)
+    {
+        x /= length;
+        z /= length;
+    }
 }
 
-OVR_PUBLIC_FUNCTION(ovrResult) ovr_GenHapticsFromAudioData(ovrHapticsClip* outHapticsClip, const ovrAudioChannelData* audioChannel, ovrHapticsGenMode genMode)
+void boundaryBuildNode(BoundaryFieldData* data, std::vector<BoundarySegment>& segments, int nodeIndex,
+                       int first, int count, int depth)
+{
+    BoundaryBvhNode node;
+    node.MinX = node.MinZ = FLT_MAX;
+    node.MaxX = node.MaxZ = -FLT_MAX;
+    float centerMinX = FLT_MAX, centerMinZ = FLT_MAX, centerMaxX = -FLT_MAX, centerMaxZ = -FLT_MAX;
+    for (int i = first; i < first + count; ++i)
+    {
+        const BoundarySegment& segment = segments[i];
+        node.MinX = std::min(node.MinX, std::min(segment.X0, segment.X1));
+        node.MinZ = std::min(node.MinZ, std::min(segment.Z0, segment.Z1));
+        node.MaxX = std::max(node.MaxX, std::max(segment.X0, segment.X1));
+        node.MaxZ = std::max(node.MaxZ, std::max(segment.Z0, segment.Z1));
+
+        float centerX = segment.X0 + segment.X1;
+        float centerZ = segment.Z0 + segment.Z1;
+        centerMinX = std::min(centerMinX, centerX);
+        centerMinZ = std::min(centerMinZ, centerZ);
+        centerMaxX = std::max(centerMaxX, centerX);
+        centerMaxZ = std::max(centerMaxZ, centerZ);
+    }
+
+    if (count <= kBoundaryLeafSize || depth >= kBoundaryMaxDepth)
+    {
+        node.First = first;
+        node.Count = count;
+        data->Nodes[nodeIndex] = node;
+        return;
+    }
+
+    // Split at the median segment center along the longer axis.
+    bool splitX = (centerMaxX - centerMinX) >= (centerMaxZ - centerMinZ);
+    int half = count / 2;
+    std::nth_element(segments.begin() + first, segments.begin() + first + half, segments.begin() + first + count,
+        [splitX](const BoundarySegment& a, const BoundarySegment& b)
+        {
+            return splitX ? (a.X0 + a.X1) < (b.X0 + b.X1) : (a.Z0 + a.Z1) < (b.Z0 + b.Z1);
+        });
+
+    // Children are allocated next to each other.
+    node.First = (int)data->Nodes.size();
+    node.Count = 0;
+    data->Nodes[nodeIndex] = node;
+    data->Nodes.resize(node.First + 2);
+
+    boundaryBuildNode(data, segments, node.First, first, half, depth + 1);
+    boundaryBuildNode(data, segments, node.First + 1, first + half, count - half, depth + 1);
+}
+
+void boundaryBuild(BoundaryFieldData* data)
+{
+    const std::vector<ovrVector3f>& points = data->Points;
+    int pointsCount = (int)points.size();
+
+    // Points are documented as clockwise from above, but the winding is checked so that
+    // normals point inward either way.
+    float area = 0.0f;
+    for (int i = 0; i < pointsCount; ++i)
+    {
+        const ovrVector3f& a = points[i];
+        const ovrVector3f& b = points[(i + 1) % pointsCount];
+        area += a.x * b.z - b.x * a.z;
+    }
+    float side = (area >= 0.0f) ? 1.0f : -1.0f;
+
+    std::vector<BoundarySegment> segments(pointsCount);
+    for (int i = 0; i < pointsCount; ++i)
+    {
+        const ovrVector3f& a = points[i];
+        const ovrVector3f& b = points[(i + 1) % pointsCount];
+        BoundarySegment& segment = segments[i];
+        segment.X0 = a.x;
+        segment.Z0 = a.z;
+        segment.X1 = b.x;
+        segment.Z1 = b.z;
+        segment.NX = -(b.z - a.z) * side;
+        segment.NZ = (b.x - a.x) * side;
+        boundaryNormalize(segment.NX, segment.NZ);
+    }
+
+    for (int i = 0; i < pointsCount; ++i)
+    {
+        BoundarySegment& segment = segments[i];
+        const BoundarySegment& previous = segments[(i + pointsCount - 1) % pointsCount];
+        const BoundarySegment& next = segments[(i + 1) % pointsCount];
+        segment.N0X = segment.NX + previous.NX;
+        segment.N0Z = segment.NZ + previous.NZ;
+        segment.N1X = segment.NX + next.NX;
+        segment.N1Z = segment.NZ + next.NZ;
+        boundaryNormalize(segment.N0X, segment.N0Z);
+        boundaryNormalize(segment.N1X, segment.N1Z);
+    }
+
+    data->Nodes.clear();
+    if (pointsCount > 0)
+    {
+        data->Nodes.resize(1);
+        boundaryBuildNode(data, segments, 0, 0, pointsCount, 0);
+    }
+    data->Segments.swap(segments);
+}
+
+// Returns the squared distance from (x, z) to the segment, and the position of the closest point along it.
+float boundarySegmentDistanceSq(const BoundarySegment& segment, float x, float z, float* outT)
+{
+    float dx = segment.X1 - segment.X0;
+    float dz = segment.Z1 - segment.Z0;
+    float lengthSq = dx * dx + dz * dz;
+    float t = (lengthSq > 0.0f) ? ((x - segment.X0) * dx + (z - segment.Z0) * dz) / lengthSq : 0.0f;
+    t = std::max(0.0f, std::min(1.0f, t));
+
+    float ox = segment.X0 + t * dx - x;
+    float oz = segment.Z0 + t * dz - z;
+    *outT = t;
+    return ox * ox + oz * oz;
+}
+
+float boundaryBoxDistanceSq(const BoundaryBvhNode& node, float x, float z)
+{
+    float dx = std::max(0.0f, std::max(node.MinX - x, x - node.MaxX));
+    float dz = std::max(0.0f, std::max(node.MinZ - z, z - node.MaxZ));
+    return dx * dx + dz * dz;
+}
+
+// Finds the closest segment to (x, z), starting from a known candidate to prune early.
+int boundaryFindClosest(const BoundaryFieldData* data, float x, float z, int candidate, float* outT)
 {
-    if (!outHapticsClip || !audioChannel || genMode != ovrHapticsGenMode_PointSample)
+    float bestT = 0.0f;
+    float bestDistanceSq = boundarySegmentDistanceSq(data->Segments[candidate], x, z, &bestT);
+    int best = candidate;
+
+    int stack[kBoundaryMaxDepth + 2];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const BoundaryBvhNode& node = data->Nodes[stack[--stackSize]];
+        if (boundaryBoxDistanceSq(node, x, z) >= bestDistanceSq)
+            continue;
+
+        if (node.Count > 0)
+        {
+            for (int i = node.First; i < node.First + node.Count; ++i)
+            {
+                float t;
+                float distanceSq = boundarySegmentDistanceSq(data->Segments[i], x, z, &t);
+                if (distanceSq < bestDistanceSq)
+                {
+                    bestDistanceSq = distanceSq;
+                    bestT = t;
+                    best = i;
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first, so that it is popped first.
+        float nearDistanceSq = boundaryBoxDistanceSq(data->Nodes[node.First], x, z);
+        float farDistanceSq = boundaryBoxDistanceSq(data->Nodes[node.First + 1], x, z);
+        int nearChild = node.First;
+        if (farDistanceSq < nearDistanceSq)
+        {
+            std::swap(nearDistanceSq, farDistanceSq);
+            nearChild = node.First + 1;
+        }
+        if (farDistanceSq < bestDistanceSq)
+            stack[stackSize++] = (nearChild == node.First) ? node.First + 1 : node.First;
+        if (nearDistanceSq < bestDistanceSq)
+            stack[stackSize++] = nearChild;
+    }
+
+    *outT = bestT;
+    return best;
+}
+
+} // namespace
+
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_UpdateBoundaryField(ovrSession session, ovrBoundaryType boundaryType,
+    ovrBoundaryField* inOutField)
+{
+    if (!inOutField)
         return ovrError_InvalidParameter;
-    // Validate audio channel
-    if (audioChannel->Frequency <= 0 || audioChannel->SamplesCount <= 0 || audioChannel->Samples == nullptr)
+
+    int pointsCount = 0;
+    ovrResult result = ovr_GetBoundaryGeometry(session, boundaryType, nullptr, &pointsCount);
+    if (!OVR_SUCCESS(result))
+        return result;
+
+    std::vector<ovrVector3f> points(pointsCount);
+    if (pointsCount > 0)
+    {
+        result = ovr_GetBoundaryGeometry(session, boundaryType, points.data(), &pointsCount);
+        if (!OVR_SUCCESS(result))
+            return result;
+        points.resize(pointsCount);
+    }
+    if (result == ovrSuccess_BoundaryInvalid || points.empty())
+    {
+        points.clear();
+        result = ovrSuccess_BoundaryInvalid;
+    }
+
+    BoundaryFieldData* data = (BoundaryFieldData*)inOutField->Data;
+    if (!data)
+    {
+        data = new BoundaryFieldData;
+        inOutField->Data = data;
+    }
+    else if (inOutField->BoundaryType == boundaryType && data->Points.size() == points.size() &&
+             (points.empty() || memcmp(data->Points.data(), points.data(), points.size() * sizeof(ovrVector3f)) == 0))
+    {
+        return result;
+    }
+
+    data->Points.swap(points);
+    boundaryBuild(data);
+
+    inOutField->BoundaryType = boundaryType;
+    inOutField->PointsCount = (int)data->Points.size();
+    inOutField->Version++;
+
+    return result;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_TestBoundaryFieldPoints(const ovrBoundaryField* field, const ovrVector3f* points,
+    int pointsCount, ovrBoundaryTestResult* outTestResults, ovrBool* outIsInside)
+{
+    if (!field || (pointsCount > 0 && (!points || !outTestResults)) || pointsCount < 0)
         return ovrError_InvalidParameter;
 
-    const int32_t kHapticsFrequency = 320;
-    const int32_t kHapticsMaxAmplitude = 255;
-    float samplesPerStep = audioChannel->Frequency / (float)kHapticsFrequency;
-    int32_t hapticsSampleCount = (int32_t)ceil(audioChannel->SamplesCount / samplesPerStep);
-    
-    uint8_t* hapticsSamples = new uint8_t[hapticsSampleCount];
-    for (int32_t i = 0; i < hapticsSampleCount; ++i)
+    const BoundaryFieldData* data = (const BoundaryFieldData*)field->Data;
+    if (!data || data->Segments.empty())
+    {
+        memset(outTestResults, 0, pointsCount * sizeof(ovrBoundaryTestResult));
+        if (outIsInside)
+            memset(outIsInside, 0, pointsCount * sizeof(ovrBool));
+        return ovrSuccess_BoundaryInvalid;
+    }
+
+    // Consecutive points tend to be close, so the previous closest segment is a tight first guess.
+    int candidate = 0;
+    for (int i = 0; i < pointsCount; ++i)
+    {
+        const ovrVector3f& point = points[i];
+        float t;
+        candidate = boundaryFindClosest(data, point.x, point.z, candidate, &t);
+        const BoundarySegment& segment = data->Segments[candidate];
+
+        float closestX = segment.X0 + t * (segment.X1 - segment.X0);
+        float closestZ = segment.Z0 + t * (segment.Z1 - segment.Z0);
+        float offsetX = point.x - closestX;
+        float offsetZ = point.z - closestZ;
+
+        // At a corner the closest point is shared by two segments, so the side is taken from
+        // the corner's normal rather than from either segment's.
+        float sideX = (t <= 0.0f) ? segment.N0X : (t >= 1.0f) ? segment.N1X : segment.NX;
+        float sideZ = (t <= 0.0f) ? segment.N0Z : (t >= 1.0f) ? segment.N1Z : segment.NZ;
+        bool inside = (offsetX * sideX + offsetZ * sideZ) >= 0.0f;
+
+        // Like the runtime, report the distance as negative for points outside the boundary.
+        float distance = sqrtf(offsetX * offsetX + offsetZ * offsetZ);
+
+        ovrBoundaryTestResult& result = outTestResults[i];
+        result.ClosestDistance = inside ? distance : -distance;
+        result.ClosestPoint.x = closestX;
+        result.ClosestPoint.y = point.y;
+        result.ClosestPoint.z = closestZ;
+        result.ClosestPointNormal.x = segment.NX;
+        result.ClosestPointNormal.y = 0.0f;
+        result.ClosestPointNormal.z = segment.NZ;
+        result.IsTriggering = (result.ClosestDistance < field->TriggerDistance) ? ovrTrue : ovrFalse;
+
+        if (outIsInside)
+            outIsInside[i] = inside ? ovrTrue : ovrFalse;
+    }
+
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_ReleaseBoundaryField(ovrBoundaryField* field)
+{
+    if (field)
     {
-        float sample = audioChannel->Samples[(int32_t)(i * samplesPerStep)];
-        uint8_t hapticSample = (uint8_t)std::min(UCHAR_MAX, (int)round(abs(sample) * kHapticsMaxAmplitude));
-        hapticsSamples[i] = hapticSample;
+        delete (BoundaryFieldData*)field->Data;
+        memset(field, 0, sizeof(ovrBoundaryField));
     }
+}
+
+//-----------------------------------------------------------------------------------
+// ***** Wav decoding
+//
+// Samples are converted a whole channel at a time by a loop per sample format. Mono and
+// stereo 16 bit, 32 bit and float data is converted four samples at a time with SSE2.
+//
+// There's not a strong standard to convert 8/16/24/32b PCM to float.
+// For 16b: MSDN says range is [-32760, 32760], Pyton Scipy uses [-32767, 32767] and Audacity outputs the full range [-32768, 32767].
+// We use the same range on both sides and clamp to [-1, 1].
+
+namespace {
+
+// We don't support any format other than PCM and IEEE Float
+enum WavFormats {
+    kWavFormatUnknown     = 0x0000,
+    kWavFormatLPCM        = 0x0001,
+    kWavFormatFloatIEEE   = 0x0003,
+    kWavFormatExtensible  = 0xFFFE
+};
+
+// Layout of the "fmt " chunk. WAVE_FORMAT_EXTENSIBLE appends a sub-format, the first
+// two bytes of which are the actual WavFormats value.
+struct WavFormatChunk {
+    uint16_t Format;            // WavFormats: PCM or Float supported
+    uint16_t Channels;          // 1 = Mono, 2 = Stereo
+    uint32_t SampleRate;        // e.g. 44100
+    uint32_t BytesPerSec;       // SampleRate * BytesPerBlock
+    uint16_t BytesPerBlock;     // (NumChannels * BitsPerSample/8)
+    uint16_t BitsPerSample;     // 8, 16, 24, 32 (64 for float)
+};
+
+const size_t kWavFormatChunkSize           = 16;
+const size_t kWavExtensibleSubFormatOffset = 24;
+
+// TODO Support big-endian (RIFX)
+uint16_t wavReadUInt16(const uint8_t* data)
+{
+    uint16_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint32_t wavReadUInt32(const uint8_t* data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// Each converter reads one channel of frameCount frames of frameSize bytes. The SSE2 paths
+// handle frames of one or two samples, which covers mono and stereo data.
+
+void wavConvertPcm8(const uint8_t* frames, size_t frameSize, size_t channel, size_t frameCount, float* samples)
+{
+    // uint8_t is a special case, unsigned where 128 is zero
+    const uint8_t* data = frames + channel;
+    const float scale = 2.0f / UCHAR_MAX;
+
+    for (size_t i = 0; i < frameCount; ++i)
+        samples[i] = data[i * frameSize] * scale - 1.0f;
+}
+
+void wavConvertPcm16(const uint8_t* frames, size_t frameSize, size_t channel, size_t frameCount, float* samples)
+{
+    const float scale = 1.0f / SHRT_MAX;
+    size_t i = 0;
+
+#if defined(OVR_CAPI_UTIL_SSE2)
+    const __m128 scale4 = _mm_set1_ps(scale);
+    const __m128 min4 = _mm_set1_ps(-1.0f);
+
+    if (frameSize == 2)
+    {
+        for (; i + 8 <= frameCount; i += 8)
+        {
+            // Move each int16 into the high half of an int32 lane, then sign extend it.
+            const __m128i v = _mm_loadu_si128((const __m128i*)(frames + i * 2));
+            const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), v), 16);
+            const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(_mm_setzero_si128(), v), 16);
+            _mm_storeu_ps(samples + i,     _mm_max_ps(min4, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale4)));
+            _mm_storeu_ps(samples + i + 4, _mm_max_ps(min4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale4)));
+        }
+    }
+    else if (frameSize == 4)
+    {
+        for (; i + 4 <= frameCount; i += 4)
+        {
+            // Each int32 lane is a frame, with the left channel in its low half.
+            const __m128i v = _mm_loadu_si128((const __m128i*)(frames + i * 4));
+            const __m128i s = (channel == 0) ? _mm_srai_epi32(_mm_slli_epi32(v, 16), 16) : _mm_srai_epi32(v, 16);
+            _mm_storeu_ps(samples + i, _mm_max_ps(min4, _mm_mul_ps(_mm_cvtepi32_ps(s), scale4)));
+        }
+    }
+#endif
+
+    for (; i < frameCount; ++i)
+    {
+        int16_t value;
+        memcpy(&value, frames + i * frameSize + channel * 2, sizeof(value));
+        samples[i] = std::max(-1.0f, value * scale);
+    }
+}
+
+void wavConvertPcm24(const uint8_t* frames, size_t frameSize, size_t channel, size_t frameCount, float* samples)
+{
+    const uint8_t* data = frames + channel * 3;
+    const float scale = 1.0f / 8388607.0f;
+
+    for (size_t i = 0; i < frameCount; ++i, data += frameSize)
+    {
+        // Assemble the sample in the top 24 bits so that the shift sign extends it.
+        const int32_t value = (int32_t)(((uint32_t)data[0] << 8) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 24)) >> 8;
+        samples[i] = std::max(-1.0f, value * scale);
+    }
+}
+
+#if defined(OVR_CAPI_UTIL_SSE2)
+// Gets four consecutive samples of one channel of tightly packed 32 bit mono or stereo data.
+__m128 wavLoad32x4(const uint8_t* frames, size_t frameSize, size_t channel, size_t i)
+{
+    if (frameSize == 4)
+        return _mm_loadu_ps((const float*)(frames + i * 4));
+
+    const __m128 a = _mm_loadu_ps((const float*)(frames + i * 8));
+    const __m128 b = _mm_loadu_ps((const float*)(frames + i * 8 + 16));
+    return (channel == 0) ? _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)) : _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+#endif
+
+void wavConvertPcm32(const uint8_t* frames, size_t frameSize, size_t channel, size_t frameCount, float* samples)
+{
+    const float scale = 1.0f / INT_MAX;
+    size_t i = 0;
+
+#if defined(OVR_CAPI_UTIL_SSE2)
+    if ((frameSize == 4) || (frameSize == 8))
+    {
+        const __m128 scale4 = _mm_set1_ps(scale);
+        const __m128 min4 = _mm_set1_ps(-1.0f);
+
+        for (; i + 4 <= frameCount; i += 4)
+        {
+            const __m128i v = _mm_castps_si128(wavLoad32x4(frames, frameSize, channel, i));
+            _mm_storeu_ps(samples + i, _mm_max_ps(min4, _mm_mul_ps(_mm_cvtepi32_ps(v), scale4)));
+        }
+    }
+#endif
+
+    for (; i < frameCount; ++i)
+    {
+        int32_t value;
+        memcpy(&value, frames + i * frameSize + channel * 4, sizeof(value));
+        samples[i] = std::max(-1.0f, value * scale);
+    }
+}
+
+void wavConvertFloat32(const uint8_t* frames, size_t frameSize, size_t channel, size_t frameCount, float* samples)
+{
+    size_t i = 0;
+
+    if (frameSize == 4)
+    {
+        memcpy(samples, frames, frameCount * sizeof(float));
+        return;
+    }
+
+#if defined(OVR_CAPI_UTIL_SSE2)
+    if (frameSize == 8)
+    {
+        for (; i + 4 <= frameCount; i += 4)
+            _mm_storeu_ps(samples + i, wavLoad32x4(frames, frameSize, channel, i));
+    }
+#endif
+
+    for (; i < frameCount; ++i)
+        memcpy(samples + i, frames + i * frameSize + channel * 4, sizeof(float));
+}
+
+void wavConvertFloat64(const uint8_t* frames, size_t frameSize, size_t channel, size_t frameCount, float* samples)
+{
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        double value;
+        memcpy(&value, frames + i * frameSize + channel * 8, sizeof(value));
+        samples[i] = (float)value;
+    }
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------------
+// ***** Haptics generation
+
+namespace {
+
+const int32_t kHapticsFrequency = 320;
+const int32_t kHapticsMaxAmplitude = 255;
+
+// Release time of the envelope follower, in seconds.
+const double kHapticsEnvelopeRelease = 0.025;
+
+// The mean absolute value of a full scale sine wave is 2 / pi of its peak.
+const float kHapticsMeanToPeak = 1.57079633f;
+
+// Number of audio samples below which batches are generated on the calling thread.
+const int64_t kHapticsMinParallelSamples = 1 << 20;
+
+// Largest buffer passed to ovr_SubmitControllerVibration by ovr_SubmitHapticsRing.
+const int32_t kHapticsMaxSubmitSamples = 256;
+
+double hapticsSamplesPerStep(int32_t frequency)
+{
+    return frequency / (double)kHapticsFrequency;
+}
+
+float hapticsEnvelopeRelease()
+{
+    return (float)exp(-1.0 / (kHapticsFrequency * kHapticsEnvelopeRelease));
+}
+
+// Haptics sample i point samples audio sample hapticsStepBegin(i), and averages the audio
+// samples up to hapticsStepBegin(i + 1).
+int64_t hapticsStepBegin(int64_t i, double samplesPerStep)
+{
+    return (int64_t)(i * samplesPerStep);
+}
+
+int32_t hapticsSampleCount(const ovrAudioChannelData* audioChannel)
+{
+    return (int32_t)ceil(audioChannel->SamplesCount / hapticsSamplesPerStep(audioChannel->Frequency));
+}
+
+uint8_t hapticsAmplitude(float level)
+{
+    return (uint8_t)std::min((float)kHapticsMaxAmplitude, level * kHapticsMaxAmplitude + 0.5f);
+}
+
+// Follows rises immediately and lets the vibration die away over the release time.
+float hapticsFollowEnvelope(float envelope, float level, float release)
+{
+    return (level >= envelope) ? level : (level + (envelope - level) * release);
+}
+
+// Sums the absolute values of count samples.
+float hapticsSumAbs(const float* samples, int32_t count)
+{
+    float sum = 0.0f;
+    int32_t i = 0;
+
+#if defined(OVR_CAPI_UTIL_SSE2)
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 sum4 = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4)
+        sum4 = _mm_add_ps(sum4, _mm_and_ps(absMask, _mm_loadu_ps(samples + i)));
+
+    sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, _MM_SHUFFLE(1, 1, 1, 1)));
+    sum = _mm_cvtss_f32(sum4);
+#endif
+
+    for (; i < count; ++i)
+        sum += fabsf(samples[i]);
+
+    return sum;
+}
+
+void hapticsGenPointSample(uint8_t* hapticsSamples, int32_t hapticsCount, const ovrAudioChannelData* audioChannel)
+{
+    const double samplesPerStep = hapticsSamplesPerStep(audioChannel->Frequency);
+
+    for (int32_t i = 0; i < hapticsCount; ++i)
+    {
+        const int32_t index = std::min((int32_t)hapticsStepBegin(i, samplesPerStep), audioChannel->SamplesCount - 1);
+        hapticsSamples[i] = hapticsAmplitude(fabsf(audioChannel->Samples[index]));
+    }
+}
+
+void hapticsGenEnvelope(uint8_t* hapticsSamples, int32_t hapticsCount, const ovrAudioChannelData* audioChannel)
+{
+    const float release = hapticsEnvelopeRelease();
+    const double samplesPerStep = hapticsSamplesPerStep(audioChannel->Frequency);
+    float envelope = 0.0f;
+
+    for (int32_t i = 0; i < hapticsCount; ++i)
+    {
+        // Averaging the rectified signal over each output period filters it below the haptics
+        // Nyquist rate, so that loud high frequency content doesn't alias into the output.
+        const int32_t begin = (int32_t)hapticsStepBegin(i, samplesPerStep);
+        const int32_t end = (int32_t)std::min(hapticsStepBegin(i + 1, samplesPerStep), (int64_t)audioChannel->SamplesCount);
+        const int32_t count = std::max(end - begin, 1);
+        const float level = hapticsSumAbs(audioChannel->Samples + begin, std::min(count, audioChannel->SamplesCount - begin)) *
+                            kHapticsMeanToPeak / count;
+
+        envelope = hapticsFollowEnvelope(envelope, level, release);
+        hapticsSamples[i] = hapticsAmplitude(envelope);
+    }
+}
+
+bool hapticsIsValidInput(const ovrAudioChannelData* audioChannel, ovrHapticsGenMode genMode)
+{
+    return audioChannel && (genMode >= 0) && (genMode < ovrHapticsGenMode_Count) &&
+           (audioChannel->Frequency > 0) && (audioChannel->SamplesCount > 0) && (audioChannel->Samples != nullptr);
+}
+
+void hapticsGenerate(uint8_t* hapticsSamples, int32_t hapticsCount, const ovrAudioChannelData* audioChannel, ovrHapticsGenMode genMode)
+{
+    if (genMode == ovrHapticsGenMode_Envelope)
+        hapticsGenEnvelope(hapticsSamples, hapticsCount, audioChannel);
+    else
+        hapticsGenPointSample(hapticsSamples, hapticsCount, audioChannel);
+}
+
+} // namespace
+
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GenHapticsFromAudioData(ovrHapticsClip* outHapticsClip, const ovrAudioChannelData* audioChannel, ovrHapticsGenMode genMode)
+{
+    if (!outHapticsClip || !hapticsIsValidInput(audioChannel, genMode))
+        return ovrError_InvalidParameter;
+
+    int32_t hapticsCount = hapticsSampleCount(audioChannel);
+    uint8_t* hapticsSamples = new uint8_t[hapticsCount];
+    hapticsGenerate(hapticsSamples, hapticsCount, audioChannel, genMode);
 
     outHapticsClip->Samples = hapticsSamples;
-    outHapticsClip->SamplesCount = hapticsSampleCount;
+    outHapticsClip->SamplesCount = hapticsCount;
 
     return ovrSuccess;
 }
 
-OVR_PUBLIC_FUNCTION(ovrResult) ovr_ReadWavFromBuffer(ovrAudioChannelData* outAudioChannel, const void* inputData, int dataSizeInBytes, int stereoChannelToUse)
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GenHapticsFromAudioDataBatch(ovrHapticsClip* outHapticsClips, const ovrAudioChannelData* audioChannels,
+                                                                int clipCount, ovrHapticsGenMode genMode)
 {
-    // We don't support any format other than PCM and IEEE Float
-    enum WavFormats {
-        kWavFormatUnknown     = 0x0000,
-        kWavFormatLPCM        = 0x0001,
-        kWavFormatFloatIEEE   = 0x0003,
-        kWavFormatExtensible  = 0xFFFE
-    };
+    if (!outHapticsClips || !audioChannels || (clipCount < 0))
+        return ovrError_InvalidParameter;
 
-    struct WavHeader {
-        char RiffId[4];             // "RIFF" = little-endian, "RIFX" = big-endian
-        int32_t Size;               // 4 + (8 + FmtChunkSize) + (8 + DataChunkSize)
-        char WavId[4];              // Must be "WAVE"
-
-        char FmtChunckId[4];        // Must be "fmt "
-        uint32_t FmtChunkSize;      // Remaining size of this chunk (16B)
-        uint16_t Format;            // WavFormats: PCM or Float supported
-        uint16_t Channels;          // 1 = Mono, 2 = Stereo
-        uint32_t SampleRate;        // e.g. 44100
-        uint32_t BytesPerSec;       // SampleRate * BytesPerBlock
-        uint16_t BytesPerBlock;     // (NumChannels * BitsPerSample/8)
-        uint16_t BitsPerSample;     // 8, 16, 32
-
-        char DataChunckId[4];       // Must be "data"
-        uint32_t DataChunkSize;     // Remaining size of this chunk
+    int64_t totalSamples = 0;
+    for (int i = 0; i < clipCount; ++i)
+    {
+        if (!hapticsIsValidInput(&audioChannels[i], genMode))
+            return ovrError_InvalidParameter;
+        totalSamples += audioChannels[i].SamplesCount;
+    }
+
+    for (int i = 0; i < clipCount; ++i)
+    {
+        outHapticsClips[i].SamplesCount = hapticsSampleCount(&audioChannels[i]);
+        outHapticsClips[i].Samples = new uint8_t[outHapticsClips[i].SamplesCount];
+    }
+
+    // Workers take the next clip until none are left, so that long clips don't hold up the batch.
+    std::atomic<int> nextClip(0);
+    auto worker = [&]()
+    {
+        for (int i = nextClip++; i < clipCount; i = nextClip++)
+        {
+            hapticsGenerate((uint8_t*)outHapticsClips[i].Samples, outHapticsClips[i].SamplesCount, &audioChannels[i], genMode);
+        }
     };
 
-    const int32_t kMinWavFileSize = sizeof(WavHeader) + 1;
-    if (!outAudioChannel || !inputData || dataSizeInBytes < kMinWavFileSize)
+    int threadCount = 1;
+    if (totalSamples >= kHapticsMinParallelSamples)
+        threadCount = std::min(clipCount, std::max(1, (int)std::thread::hardware_concurrency()));
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; ++i)
+        threads.push_back(std::thread(worker));
+
+    worker();
+
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_InitHapticsStream(ovrHapticsStream* outStream, int frequency, ovrHapticsGenMode genMode)
+{
+    if (!outStream || frequency <= 0 || genMode < 0 || genMode >= ovrHapticsGenMode_Count)
         return ovrError_InvalidParameter;
 
-    WavHeader* header = (WavHeader*)inputData;
-    uint8_t* data = (uint8_t*)inputData + sizeof(WavHeader);
+    memset(outStream, 0, sizeof(ovrHapticsStream));
+    outStream->Frequency = frequency;
+    outStream->GenMode = genMode;
+    outStream->SamplesPerStep = hapticsSamplesPerStep(frequency);
+
+    return ovrSuccess;
+}
+
+static void hapticsRingPush(ovrHapticsRing* ring, uint8_t sample)
+{
+    if (ring->SamplesCount == ring->Capacity)
+    {
+        // Drop the oldest sample rather than fall further behind the audio.
+        ring->ReadIndex = (ring->ReadIndex + 1) % ring->Capacity;
+        --ring->SamplesCount;
+    }
+
+    ring->Samples[(ring->ReadIndex + ring->SamplesCount) % ring->Capacity] = sample;
+    ++ring->SamplesCount;
+}
+
+OVR_PUBLIC_FUNCTION(int) ovr_GenHapticsFromAudioStream(ovrHapticsStream* stream, const float* samples, int samplesCount, ovrHapticsRing* ring)
+{
+    if (!stream || stream->Frequency <= 0 || (!samples && samplesCount > 0) || samplesCount < 0 ||
+        !ring || !ring->Samples || ring->Capacity <= 0)
+        return ovrError_InvalidParameter;
+
+    // Block positions are absolute, so that Haptics periods straddling blocks line up with the batch generator.
+    const int64_t blockBegin = stream->AudioSamplesCount;
+    const int64_t blockEnd = blockBegin + samplesCount;
+    int generatedCount = 0;
+
+    if (stream->GenMode == ovrHapticsGenMode_Envelope)
+    {
+        const float release = hapticsEnvelopeRelease();
+        int64_t position = blockBegin;
+
+        while (position < blockEnd)
+        {
+            const int64_t stepBegin = hapticsStepBegin(stream->HapticsSamplesCount, stream->SamplesPerStep);
+            const int64_t stepEnd = hapticsStepBegin(stream->HapticsSamplesCount + 1, stream->SamplesPerStep);
+            const int64_t end = std::min(stepEnd, blockEnd);
+
+            stream->LevelSum += hapticsSumAbs(samples + (position - blockBegin), (int32_t)(end - position));
+            position = end;
+
+            if (position == stepEnd)
+            {
+                const float level = stream->LevelSum * kHapticsMeanToPeak / (float)std::max<int64_t>(stepEnd - stepBegin, 1);
+                stream->Envelope = hapticsFollowEnvelope(stream->Envelope, level, release);
+                stream->LevelSum = 0.0f;
+                ++stream->HapticsSamplesCount;
+
+                hapticsRingPush(ring, hapticsAmplitude(stream->Envelope));
+                ++generatedCount;
+            }
+        }
+    }
+    else
+    {
+        for (;;)
+        {
+            const int64_t index = hapticsStepBegin(stream->HapticsSamplesCount, stream->SamplesPerStep);
+            if (index >= blockEnd)
+                break;
+
+            ++stream->HapticsSamplesCount;
+
+            hapticsRingPush(ring, hapticsAmplitude(fabsf(samples[index - blockBegin])));
+            ++generatedCount;
+        }
+    }
+
+    stream->AudioSamplesCount = blockEnd;
+    return generatedCount;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitHapticsRing(ovrSession session, ovrControllerType controllerType, ovrHapticsRing* ring, int maxQueuedSamples)
+{
+    if (!ring || !ring->Samples || ring->Capacity <= 0)
+        return ovrError_InvalidParameter;
+
+    if (ring->SamplesCount == 0)
+        return ovrSuccess;
+
+    ovrHapticsPlaybackState state;
+    ovrResult result = ovr_GetControllerVibrationState(session, controllerType, &state);
+    if (OVR_FAILURE(result))
+        return result;
+
+    int32_t submitCount = std::min(std::min(state.RemainingQueueSpace, maxQueuedSamples - state.SamplesQueued), ring->SamplesCount);
+
+    // Copy to a contiguous buffer, since the samples may wrap around the end of the ring.
+    uint8_t buffer[kHapticsMaxSubmitSamples];
+
+    while (submitCount > 0)
+    {
+        const int32_t count = std::min(submitCount, kHapticsMaxSubmitSamples);
+        for (int32_t i = 0; i < count; ++i)
+            buffer[i] = ring->Samples[(ring->ReadIndex + i) % ring->Capacity];
+
+        ovrHapticsBuffer hapticsBuffer;
+        hapticsBuffer.Samples = buffer;
+        hapticsBuffer.SamplesCount = count;
+        hapticsBuffer.SubmitMode = ovrHapticsBufferSubmit_Enqueue;
+
+        result = ovr_SubmitControllerVibration(session, controllerType, &hapticsBuffer);
+        if (OVR_FAILURE(result))
+            return result;
+
+        ring->ReadIndex = (ring->ReadIndex + count) % ring->Capacity;
+        ring->SamplesCount -= count;
+        submitCount -= count;
+    }
+
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_ReadWavFromBuffer(ovrAudioChannelData* outAudioChannel, const void* inputData, int dataSizeInBytes, int stereoChannelToUse)
+{
+    const size_t kRiffHeaderSize = 12;
+    const size_t kChunkHeaderSize = 8;
+
+    if (!outAudioChannel || !inputData || dataSizeInBytes < (int)(kRiffHeaderSize + kChunkHeaderSize))
+        return ovrError_InvalidParameter;
+
+    const uint8_t* bytes = (const uint8_t*)inputData;
+    const size_t size = (size_t)dataSizeInBytes;
 
     // Validate
-    const char* wavId = header->RiffId;
     // TODO We need to support RIFX when supporting big endian formats
-    //bool isValidWav = (wavId[0] == 'R' && wavId[1] == 'I' && wavId[2] == 'F' && (wavId[3] == 'F' || wavId[3] == 'X')) &&
-    bool isValidWav = (wavId[0] == 'R' && wavId[1] == 'I' && wavId[2] == 'F' && wavId[3] == 'F') &&
-        memcmp(header->WavId, "WAVE", 4) == 0;
-    bool hasValidChunks = memcmp(header->FmtChunckId, "fmt ", 4) == 0 && 
-        memcmp(header->DataChunckId, "data ", 4) == 0;
-    if (!isValidWav || !hasValidChunks) {
+    bool isValidWav = memcmp(bytes, "RIFF", 4) == 0 && memcmp(bytes + 8, "WAVE", 4) == 0;
+    if (!isValidWav) {
+        return ovrError_InvalidOperation;
+    }
+
+    // Walk the chunks, skipping LIST, fact, cue and any others. The RIFF size is not trusted,
+    // since streaming encoders often leave it unset; the buffer bounds the chunks instead.
+    const uint8_t* formatChunk = nullptr;
+    size_t formatChunkSize = 0;
+    const uint8_t* data = nullptr;
+    size_t dataSize = 0;
+
+    for (size_t offset = kRiffHeaderSize; offset + kChunkHeaderSize <= size; )
+    {
+        const uint8_t* chunkId = bytes + offset;
+        const size_t chunkSize = wavReadUInt32(bytes + offset + 4);
+        const size_t available = size - offset - kChunkHeaderSize;
+
+        if (memcmp(chunkId, "fmt ", 4) == 0)
+        {
+            if (chunkSize < kWavFormatChunkSize || chunkSize > available)
+                return ovrError_InvalidOperation;
+            formatChunk = chunkId + kChunkHeaderSize;
+            formatChunkSize = chunkSize;
+        }
+        else if (memcmp(chunkId, "data", 4) == 0)
+        {
+            // Truncated files are read up to the end of the buffer.
+            data = chunkId + kChunkHeaderSize;
+            dataSize = std::min(chunkSize, available);
+            if (formatChunk)
+                break;
+        }
+
+        // Chunks are padded to an even size.
+        if (chunkSize > available)
+            break;
+        offset += kChunkHeaderSize + chunkSize + (chunkSize & 1);
+    }
+
+    if (!formatChunk || !data) {
         return ovrError_InvalidOperation;
     }
 
-    // We only support PCM
-    bool isSupported = (header->Format == kWavFormatLPCM || header->Format == kWavFormatFloatIEEE) &&
-        (header->Channels == 1 || header->Channels == 2) && 
-        (header->BitsPerSample == 8 || header->BitsPerSample == 16 || header->BitsPerSample == 32);
+    WavFormatChunk format;
+    format.Format        = wavReadUInt16(formatChunk);
+    format.Channels      = wavReadUInt16(formatChunk + 2);
+    format.SampleRate    = wavReadUInt32(formatChunk + 4);
+    format.BytesPerSec   = wavReadUInt32(formatChunk + 8);
+    format.BytesPerBlock = wavReadUInt16(formatChunk + 12);
+    format.BitsPerSample = wavReadUInt16(formatChunk + 14);
+
+    if (format.Format == kWavFormatExtensible && formatChunkSize >= kWavExtensibleSubFormatOffset + 2)
+        format.Format = wavReadUInt16(formatChunk + kWavExtensibleSubFormatOffset);
+
+    // We only support PCM and IEEE Float
+    void (*convert)(const uint8_t*, size_t, size_t, size_t, float*) = nullptr;
+    if (format.Format == kWavFormatLPCM)
+    {
+        switch (format.BitsPerSample)
+        {
+        case 8:  convert = wavConvertPcm8;  break;
+        case 16: convert = wavConvertPcm16; break;
+        case 24: convert = wavConvertPcm24; break;
+        case 32: convert = wavConvertPcm32; break;
+        }
+    }
+    else if (format.Format == kWavFormatFloatIEEE)
+    {
+        switch (format.BitsPerSample)
+        {
+        case 32: convert = wavConvertFloat32; break;
+        case 64: convert = wavConvertFloat64; break;
+        }
+    }
+
+    const size_t bytesPerSample = format.BitsPerSample / 8;
+    bool isSupported = convert && format.Channels >= 1 && format.SampleRate > 0 &&
+        format.BytesPerBlock >= format.Channels * bytesPerSample;
     if (!isSupported) {
         return ovrError_Unsupported;
     }
 
     // Channel selection
-    bool useSecondChannel = (header->Channels == 2 && stereoChannelToUse == 1);
-    int32_t channelOffset = (useSecondChannel)? header->BytesPerBlock / 2  : 0;
-    
-    // TODO Support big-endian
-    int32_t blockCount = header->DataChunkSize / header->BytesPerBlock;
+    size_t channel = (stereoChannelToUse > 0 && stereoChannelToUse < format.Channels) ? (size_t)stereoChannelToUse : 0;
+
+    size_t blockCount = dataSize / format.BytesPerBlock;
     float* samples = new float[blockCount];
 
-    for (int32_t i = 0; i < blockCount; i++) {
-        int32_t dataIndex = i * header->BytesPerBlock;
-        uint8_t* dataPtr = &data[dataIndex + channelOffset];
-        float sample = (header->Format == kWavFormatLPCM)?
-            wavPcmBytesToFloat(dataPtr, header->BitsPerSample, false) :
-            *(float*)dataPtr;
-        
-        samples[i] = sample;
-    }
+    convert(data, format.BytesPerBlock, channel, blockCount, samples);
 
     // Output
     outAudioChannel->Samples = samples;
-    outAudioChannel->SamplesCount = blockCount;
-    outAudioChannel->Frequency = header->SampleRate;
+    outAudioChannel->SamplesCount = (int)blockCount;
+    outAudioChannel->Frequency = format.SampleRate;
 
     return ovrSuccess;
 }
@@ -0,0 +1,2079 @@
+/************************************************************************************
+
+Filename    :   OVR_SimRuntime.cpp
+Content     :   Simulated LibOVRRT runtime for headless runs of LibOVR applications
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2014-2016 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.3 (the "License");
+you may not use the Oculus VR Rift SDK except in compliance with the License,
+which is provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.3
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+// This file builds on its own into a shared library that the LibOVR shim loads in place
+// of the real runtime, named as OVR_FindLibraryPath expects. For example on 64 bit Linux:
+//     g++ -std=c++11 -O2 -shared -fPIC -fvisibility=hidden -ILibOVR/Include -ILibOVR/Src
+//         LibOVR/Src/Sim/OVR_SimRuntime.cpp -o libOVRRT64.so.1
+// and on Windows it's built as LibOVRRT64_1.dll. Point LIBOVR_DLL_DIR at its directory.
+//
+// See Extras/OVR_CAPI_Sim.h for what is simulated and how to control it.
+
+#if !defined(OVR_DLL_BUILD)
+    #define OVR_DLL_BUILD
+#endif
+
+#if defined(_WIN32)
+    // Prevents <Windows.h> from defining min() and max() macro symbols.
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif
+
+    #include <windows.h>
+    #include <unknwn.h>
+#endif
+
+#include <OVR_CAPI.h>
+#include <OVR_CAPI_Keys.h>
+#include <OVR_Version.h>
+#include <Extras/OVR_CAPI_Sim.h>
+#include <Extras/OVR_Math.h>
+#include "OVR_CAPI_Prototypes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+    #pragma warning(disable: 4996) // 'getenv': This function or variable may be unsafe.
+#endif
+
+
+// Declare every entry point the shim resolves, so that a definition below that doesn't
+// match its prototype fails to compile rather than to load.
+#define OVR_SIM_DECLARE_API(ReturnType, FunctionName, OptionalVersion, Arguments) \
+    OVR_PUBLIC_FUNCTION(ReturnType) FunctionName##OptionalVersion Arguments;
+#define OVR_SIM_IGNORE_API(ReturnType, FunctionName, OptionalVersion, Arguments)
+
+OVR_LIST_APIS(OVR_SIM_DECLARE_API, OVR_SIM_IGNORE_API)
+
+#undef OVR_SIM_DECLARE_API
+#undef OVR_SIM_IGNORE_API
+
+
+using OVR::Posef;
+using OVR::Quatf;
+using OVR::Vector3f;
+
+
+//-----------------------------------------------------------------------------
+// Simulated device constants
+
+static const double StartTimeSeconds        = 1.0; // The clock starts here rather than at zero, which some apps treat as invalid.
+static const float  DefaultRefreshRate      = 90.f;
+static const int    EyeResolutionWidth      = 1080;
+static const int    EyeResolutionHeight     = 1200;
+static const float  PixelsPerTanAngle       = 625.f;
+static const float  InterpupillaryDistance  = 0.064f;
+static const int    SwapChainLength         = 3;
+static const int    HapticsSampleRateHz     = 320;
+static const int    HapticsQueueCapacity    = 256;
+static const float  PlayAreaWidth           = 2.0f;
+static const float  PlayAreaDepth           = 1.5f;
+static const float  OuterBoundaryMargin     = 0.5f;
+static const float  BoundaryTriggerDistance = 0.15f;
+static const int    MaxTraceMessageLength   = 1024;
+
+static const ovrFovPort DefaultEyeFov[ovrEye_Count] =
+{
+    { 1.3292f, 1.3292f, 1.0580f, 1.0924f }, // Up, Down, Left, Right
+    { 1.3292f, 1.3292f, 1.0924f, 1.0580f }
+};
+
+
+//-----------------------------------------------------------------------------
+// Session objects
+//
+// The opaque handle types of the API are defined here as the simulated objects.
+
+struct SimPoseTrack
+{
+    std::vector<ovrSimPoseSample> Samples;
+    bool                          Loop;
+
+    SimPoseTrack() : Samples(), Loop(true) { }
+};
+
+struct SimProperty
+{
+    bool                IsString;
+    std::vector<double> Values;
+    std::string         String;
+
+    SimProperty() : IsString(false), Values(), String() { }
+};
+
+struct SimHaptics
+{
+    int    SamplesQueued;
+    double LastUpdateTime;
+
+    SimHaptics() : SamplesQueued(0), LastUpdateTime(0.0) { }
+};
+
+struct ovrTextureSwapChainData
+{
+    ovrTextureSwapChainDesc Desc;
+    int                     Length;
+    int                     CurrentIndex;
+    int                     PendingCommits;
+    bool                    Committed;
+    size_t                  BufferSize;
+    std::vector<uint8_t>    Memory;
+    unsigned int            FirstTextureId;
+
+    uint8_t* GetBuffer(int index) { return Memory.data() + (BufferSize * index); }
+};
+
+struct ovrMirrorTextureData
+{
+    ovrMirrorTextureDesc    Desc;
+    std::vector<uint8_t>    Memory;
+    unsigned int            TextureId;
+};
+
+struct ovrHmdStruct
+{
+    ovrTrackingOrigin                  TrackingOrigin;
+    Posef                              RecenterPose;   // Eye level space pose of the recentered origin.
+    SimPoseTrack                       PoseTracks[ovrSimDevice_Count];
+
+    ovrSessionStatus                   Status;
+    bool                               BoundaryVisibleRequested;
+    unsigned int                       ConnectedControllerTypes;
+    std::map<unsigned int, ovrInputState> InputStates;
+    SimHaptics                         Haptics[ovrHand_Count];
+
+    std::map<std::string, SimProperty> Properties;
+
+    std::vector<ovrTextureSwapChainData*> SwapChains;
+    std::vector<ovrMirrorTextureData*>    MirrorTextures;
+
+    // Frame and performance statistics.
+    long long                          LastFrameIndex;
+    int                                SubmitCount;
+    int                                AppDroppedFrameCount;
+    int64_t                            LastSubmitVsync;
+    double                             LatencyMarkerTime;
+    std::chrono::steady_clock::time_point LastSubmitReturn;
+    int                                PerfStatsBaseSubmitCount;
+    std::vector<ovrPerfStatsPerCompositorFrame> PendingFrameStats; // Most recent last.
+    bool                               AnyFrameStatsDropped;
+};
+
+
+//-----------------------------------------------------------------------------
+// Global state
+//
+// A single lock protects all simulated state. The runtime does no real work, so
+// contention isn't a concern.
+
+static std::mutex                   SimLock;
+static int                          InitializeCount = 0;
+static ovrInitParams                InitParams;
+static std::vector<ovrHmdStruct*>   Sessions;
+static SimPoseTrack                 ReplayTracks[ovrSimDevice_Count]; // Loaded from OVR_SIM_POSE_FILE.
+static unsigned int                 NextTextureId = 1;
+
+static ovrSimClockMode              ClockMode = ovrSimClock_Deterministic;
+static double                       RefreshRate = DefaultRefreshRate;
+static double                       DeterministicTime = StartTimeSeconds;
+static std::chrono::steady_clock::time_point RealTimeOrigin;
+
+#if defined(_MSC_VER)
+    static __declspec(thread) ovrErrorInfo LastErrorInfo;
+#else
+    static __thread ovrErrorInfo LastErrorInfo;
+#endif
+
+
+static void logMessage(int level, const char* format, ...)
+{
+    if (!InitParams.LogCallback)
+        return;
+
+    char buffer[MaxTraceMessageLength];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    InitParams.LogCallback(InitParams.UserData, level, buffer);
+}
+
+// Records the error for ovr_GetLastErrorInfo and returns it.
+static ovrResult setError(ovrResult result, const char* format, ...)
+{
+    LastErrorInfo.Result = result;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(LastErrorInfo.ErrorString, sizeof(LastErrorInfo.ErrorString), format, args);
+    va_end(args);
+
+    logMessage(ovrLogLevel_Error, "%s", LastErrorInfo.ErrorString);
+    return result;
+}
+
+static ovrHmdStruct* findSession(ovrSession session)
+{
+    if (session && (std::find(Sessions.begin(), Sessions.end(), session) != Sessions.end()))
+        return session;
+    return nullptr;
+}
+
+static bool ownsSwapChain(ovrHmdStruct* session, ovrTextureSwapChain chain)
+{
+    return chain && (std::find(session->SwapChains.begin(), session->SwapChains.end(), chain) != session->SwapChains.end());
+}
+
+static bool ownsMirrorTexture(ovrHmdStruct* session, ovrMirrorTexture mirror)
+{
+    return mirror && (std::find(session->MirrorTextures.begin(), session->MirrorTextures.end(), mirror) != session->MirrorTextures.end());
+}
+
+
+//-----------------------------------------------------------------------------
+// Clock
+
+static double getPeriod()
+{
+    return 1.0 / RefreshRate;
+}
+
+static double getTime()
+{
+    if (ClockMode == ovrSimClock_RealTime)
+        return StartTimeSeconds + std::chrono::duration<double>(std::chrono::steady_clock::now() - RealTimeOrigin).count();
+    return DeterministicTime;
+}
+
+// Index of the last vsync at or before time.
+static int64_t getVsyncIndex(double time)
+{
+    // The tolerance keeps deterministic times, which sit exactly on vsyncs, from rounding down.
+    return (int64_t)floor(((time - StartTimeSeconds) * RefreshRate) + 1e-6);
+}
+
+static double getVsyncTime(int64_t vsyncIndex)
+{
+    return StartTimeSeconds + ((double)vsyncIndex * getPeriod());
+}
+
+static void resetClock(ovrSimClockMode mode, double refreshRate)
+{
+    ClockMode         = mode;
+    RefreshRate       = refreshRate;
+    DeterministicTime = StartTimeSeconds;
+    RealTimeOrigin    = std::chrono::steady_clock::now();
+}
+
+
+//-----------------------------------------------------------------------------
+// Tracking
+
+static float getEyeHeight(ovrHmdStruct* session)
+{
+    std::map<std::string, SimProperty>::const_iterator it = session->Properties.find(OVR_KEY_EYE_HEIGHT);
+    if ((it != session->Properties.end()) && !it->second.IsString && !it->second.Values.empty())
+        return (float)it->second.Values[0];
+    return OVR_DEFAULT_EYE_HEIGHT;
+}
+
+static float wave(double t, double frequency, double phase)
+{
+    return (float)sin((2.0 * MATH_DOUBLE_PI * frequency * t) + phase);
+}
+
+// Smooth, non-repeating-looking motion of someone looking and reaching around.
+static Posef getScriptedPose(int device, double t)
+{
+    const float yaw   = 0.6f  * wave(t, 0.05, 0.0) + 0.1f * wave(t, 0.31, 1.0);
+    const float pitch = 0.15f * wave(t, 0.11, 0.5);
+    const float roll  = 0.05f * wave(t, 0.07, 2.0);
+
+    const Quatf headYaw(Vector3f(0, 1, 0), yaw);
+    const Posef head(headYaw * Quatf(Vector3f(1, 0, 0), pitch) * Quatf(Vector3f(0, 0, 1), roll),
+                     Vector3f(0.10f * wave(t, 0.07, 0.0), 0.03f * wave(t, 0.19, 0.0), 0.08f * wave(t, 0.05, 1.0)));
+
+    if (device == ovrSimDevice_Head)
+        return head;
+
+    // Hands swing in front of the body, which follows the head's yaw.
+    const float  side  = (device == ovrSimDevice_LeftHand) ? -1.f : 1.f;
+    const double phase = (device == ovrSimDevice_LeftHand) ? 0.0 : 1.7;
+    const Vector3f offset(side * (0.20f + 0.05f * wave(t, 0.23, phase)),
+                          -0.35f + 0.10f * wave(t, 0.29, phase),
+                          -0.35f + 0.10f * wave(t, 0.17, phase));
+
+    return Posef(headYaw * Quatf(Vector3f(1, 0, 0), -0.3f + 0.2f * wave(t, 0.41, phase)),
+                 head.Translation + headYaw.Rotate(offset));
+}
+
+static Posef getTrackPose(const SimPoseTrack& track, double t)
+{
+    const std::vector<ovrSimPoseSample>& samples = track.Samples;
+    const double duration = samples.back().TimeInSeconds;
+
+    t -= StartTimeSeconds;
+    if (track.Loop && (duration > 0.0))
+        t = fmod(t, duration);
+
+    if (t <= samples.front().TimeInSeconds)
+        return Posef(samples.front().Pose);
+    if (t >= duration)
+        return Posef(samples.back().Pose);
+
+    const ovrSimPoseSample* next = &*std::upper_bound(samples.begin(), samples.end(), t,
+        [](double time, const ovrSimPoseSample& sample) { return time < sample.TimeInSeconds; });
+    const ovrSimPoseSample* prev = next - 1;
+
+    const double span = next->TimeInSeconds - prev->TimeInSeconds;
+    const float  s = (span > 0.0) ? (float)((t - prev->TimeInSeconds) / span) : 0.f;
+
+    return Posef(prev->Pose).Lerp(Posef(next->Pose), s);
+}
+
+// Pose of a device in the eye level space of an uncentered session.
+static Posef getRawPose(ovrHmdStruct* session, int device, double t)
+{
+    if (!session->PoseTracks[device].Samples.empty())
+        return getTrackPose(session->PoseTracks[device], t);
+    return getScriptedPose(device, t);
+}
+
+// Transform from the raw eye level space to the session's tracking space.
+static Posef getOriginTransform(ovrHmdStruct* session)
+{
+    Posef transform = session->RecenterPose.Inverted();
+
+    if (session->TrackingOrigin == ovrTrackingOrigin_FloorLevel)
+        transform.Translation.y += getEyeHeight(session);
+
+    return transform;
+}
+
+static ovrPoseStatef getPoseState(ovrHmdStruct* session, int device, double t)
+{
+    // Velocities and accelerations come from central differences, which are exact
+    // enough for the smooth scripted motion and consistent with replayed samples.
+    const double h = 0.001;
+    const Posef p0     = getRawPose(session, device, t);
+    const Posef pPrev  = getRawPose(session, device, t - h);
+    const Posef pNext  = getRawPose(session, device, t + h);
+
+    const Vector3f angularForward  = (pNext.Rotation * p0.Rotation.Inverted()).ToRotationVector() / (float)h;
+    const Vector3f angularBackward = (p0.Rotation * pPrev.Rotation.Inverted()).ToRotationVector() / (float)h;
+
+    const Posef transform = getOriginTransform(session);
+
+    ovrPoseStatef state;
+    memset(&state, 0, sizeof(state));
+    state.ThePose             = transform * p0;
+    state.AngularVelocity     = transform.Rotate((angularForward + angularBackward) * 0.5f);
+    state.AngularAcceleration = transform.Rotate((angularForward - angularBackward) / (float)h);
+    state.LinearVelocity      = transform.Rotate((pNext.Translation - pPrev.Translation) / (float)(2.0 * h));
+    state.LinearAcceleration  = transform.Rotate((pNext.Translation - (p0.Translation * 2.f) + pPrev.Translation) / (float)(h * h));
+    state.TimeInSeconds       = t;
+    return state;
+}
+
+static Posef getRawTrackerPose(unsigned int index)
+{
+    // Two sensors on the desk in front of the user, facing the center of the play area.
+    const float side = (index == 0) ? -1.f : 1.f;
+    const Vector3f position(side * 0.8f, 0.25f, -1.2f);
+    const float yaw = atan2f(position.x, position.z);
+
+    return Posef(Quatf(Vector3f(0, 1, 0), yaw) * Quatf(Vector3f(1, 0, 0), -0.2f), position);
+}
+
+static unsigned int getHandStatusFlags(ovrHmdStruct* session, int hand)
+{
+    const unsigned int touch = (hand == ovrHand_Left) ? ovrControllerType_LTouch : ovrControllerType_RTouch;
+    return (session->ConnectedControllerTypes & touch) ? (ovrStatus_OrientationTracked | ovrStatus_PositionTracked) : 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// Boundary
+
+// The play area is a rectangle centered on the uncentered origin, and the outer
+// boundary follows it at a fixed margin.
+static float getBoundaryHalfExtent(ovrBoundaryType boundaryType, int axis)
+{
+    const float extent = (axis == 0) ? PlayAreaWidth : PlayAreaDepth;
+    return (extent * 0.5f) + ((boundaryType == ovrBoundary_Outer) ? OuterBoundaryMargin : 0.f);
+}
+
+static void testBoundaryPoint(ovrHmdStruct* session, const Vector3f& point, ovrBoundaryType boundaryType, ovrBoundaryTestResult* result)
+{
+    const Posef    transform = getOriginTransform(session);
+    const Vector3f raw       = transform.InverseTransform(point);
+    const float    halfX     = getBoundaryHalfExtent(boundaryType, 0);
+    const float    halfZ     = getBoundaryHalfExtent(boundaryType, 1);
+
+    // Distances to the four walls; the nearest one wins.
+    const float distances[4] = { raw.x + halfX, halfX - raw.x, raw.z + halfZ, halfZ - raw.z };
+    const Vector3f normals[4] = { Vector3f(1, 0, 0), Vector3f(-1, 0, 0), Vector3f(0, 0, 1), Vector3f(0, 0, -1) };
+
+    int closest = 0;
+    for (int i = 1; i < 4; ++i)
+    {
+        if (fabsf(distances[i]) < fabsf(distances[closest]))
+            closest = i;
+    }
+
+    Vector3f closestPoint = raw;
+    if (closest < 2)
+        closestPoint.x = (closest == 0) ? -halfX : halfX;
+    else
+        closestPoint.z = (closest == 2) ? -halfZ : halfZ;
+    closestPoint.z = std::max(-halfZ, std::min(halfZ, closestPoint.z));
+    closestPoint.x = std::max(-halfX, std::min(halfX, closestPoint.x));
+
+    result->ClosestDistance    = fabsf(distances[closest]);
+    result->ClosestPoint       = transform.Transform(closestPoint);
+    result->ClosestPointNormal = transform.Rotate(normals[closest]);
+    result->IsTriggering       = (distances[closest] < BoundaryTriggerDistance) ? ovrTrue : ovrFalse;
+}
+
+
+//-----------------------------------------------------------------------------
+// Textures
+
+// Gets the size of a block of texels, which is a single texel for uncompressed formats.
+static int getFormatBlockBytes(ovrTextureFormat format, int* blockDimension)
+{
+    *blockDimension = 1;
+
+    switch (format)
+    {
+    case OVR_FORMAT_B5G6R5_UNORM:
+    case OVR_FORMAT_B5G5R5A1_UNORM:
+    case OVR_FORMAT_B4G4R4A4_UNORM:
+    case OVR_FORMAT_D16_UNORM:
+        return 2;
+
+    case OVR_FORMAT_R8G8B8A8_UNORM:
+    case OVR_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case OVR_FORMAT_B8G8R8A8_UNORM:
+    case OVR_FORMAT_B8G8R8A8_UNORM_SRGB:
+    case OVR_FORMAT_B8G8R8X8_UNORM:
+    case OVR_FORMAT_B8G8R8X8_UNORM_SRGB:
+    case OVR_FORMAT_R11G11B10_FLOAT:
+    case OVR_FORMAT_D24_UNORM_S8_UINT:
+    case OVR_FORMAT_D32_FLOAT:
+        return 4;
+
+    case OVR_FORMAT_R16G16B16A16_FLOAT:
+    case OVR_FORMAT_D32_FLOAT_S8X24_UINT:
+        return 8;
+
+    case OVR_FORMAT_BC1_UNORM:
+    case OVR_FORMAT_BC1_UNORM_SRGB:
+        *blockDimension = 4;
+        return 8;
+
+    case OVR_FORMAT_BC2_UNORM:
+    case OVR_FORMAT_BC2_UNORM_SRGB:
+    case OVR_FORMAT_BC3_UNORM:
+    case OVR_FORMAT_BC3_UNORM_SRGB:
+    case OVR_FORMAT_BC6H_UF16:
+    case OVR_FORMAT_BC6H_SF16:
+    case OVR_FORMAT_BC7_UNORM:
+    case OVR_FORMAT_BC7_UNORM_SRGB:
+        *blockDimension = 4;
+        return 16;
+
+    default:
+        return 0;
+    }
+}
+
+static bool isRedBlueSwapped(ovrTextureFormat format)
+{
+    return (format == OVR_FORMAT_B8G8R8A8_UNORM) || (format == OVR_FORMAT_B8G8R8A8_UNORM_SRGB) ||
+           (format == OVR_FORMAT_B8G8R8X8_UNORM) || (format == OVR_FORMAT_B8G8R8X8_UNORM_SRGB);
+}
+
+static bool isRgba8Format(ovrTextureFormat format)
+{
+    return (format == OVR_FORMAT_R8G8B8A8_UNORM) || (format == OVR_FORMAT_R8G8B8A8_UNORM_SRGB) || isRedBlueSwapped(format);
+}
+
+// Gets the size of one buffer of a texture swap chain, or 0 if the description is invalid.
+static size_t getSwapChainBufferSize(const ovrTextureSwapChainDesc& desc)
+{
+    int blockDimension;
+    const int blockBytes = getFormatBlockBytes(desc.Format, &blockDimension);
+
+    if ((blockBytes == 0) || (desc.Width <= 0) || (desc.Height <= 0) || (desc.MipLevels <= 0) ||
+        (desc.ArraySize <= 0) || ((desc.Type != ovrTexture_2D) && (desc.Type != ovrTexture_Cube)))
+    {
+        return 0;
+    }
+
+    size_t mipChainSize = 0;
+    for (int mip = 0; mip < desc.MipLevels; ++mip)
+    {
+        const size_t width  = std::max(desc.Width >> mip, 1);
+        const size_t height = std::max(desc.Height >> mip, 1);
+        mipChainSize += ((width + blockDimension - 1) / blockDimension) * ((height + blockDimension - 1) / blockDimension) * blockBytes;
+    }
+
+    const size_t faceCount = (desc.Type == ovrTexture_Cube) ? 6 : 1;
+    return mipChainSize * desc.ArraySize * faceCount * std::max(desc.SampleCount, 1);
+}
+
+// Copies the eye views of the first eye FOV layer into the mirror texture, side by side,
+// with nearest texel sampling.
+static void updateMirrorTexture(ovrMirrorTextureData* mirror, const ovrLayerEyeFov* layer)
+{
+    const int mirrorWidth  = mirror->Desc.Width;
+    const int mirrorHeight = mirror->Desc.Height;
+
+    for (int eye = 0; eye < ovrEye_Count; ++eye)
+    {
+        ovrTextureSwapChainData* chain = layer->ColorTexture[eye] ? layer->ColorTexture[eye] : layer->ColorTexture[0];
+
+        if (!isRgba8Format(chain->Desc.Format))
+            continue;
+
+        // The image submitted is the last one committed.
+        const uint8_t* source = chain->GetBuffer((chain->CurrentIndex + chain->Length - 1) % chain->Length);
+        const ovrRecti viewport = layer->Viewport[eye];
+        const bool swapRedBlue = isRedBlueSwapped(chain->Desc.Format) != isRedBlueSwapped(mirror->Desc.Format);
+
+        const int destX = (mirrorWidth / 2) * eye;
+        const int destWidth = mirrorWidth / 2;
+
+        for (int y = 0; y < mirrorHeight; ++y)
+        {
+            const int sourceY = std::min(viewport.Pos.y + (y * viewport.Size.h) / mirrorHeight, chain->Desc.Height - 1);
+            uint8_t* dest = mirror->Memory.data() + ((size_t)y * mirrorWidth + destX) * 4;
+
+            for (int x = 0; x < destWidth; ++x, dest += 4)
+            {
+                const int sourceX = std::min(viewport.Pos.x + (x * viewport.Size.w) / destWidth, chain->Desc.Width - 1);
+                const uint8_t* texel = source + ((size_t)std::max(sourceY, 0) * chain->Desc.Width + std::max(sourceX, 0)) * 4;
+
+                dest[0] = texel[swapRedBlue ? 2 : 0];
+                dest[1] = texel[1];
+                dest[2] = texel[swapRedBlue ? 0 : 2];
+                dest[3] = texel[3];
+            }
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Properties
+
+static SimProperty* findProperty(ovrHmdStruct* session, const char* propertyName)
+{
+    if (!session || !propertyName)
+        return nullptr;
+
+    std::map<std::string, SimProperty>::iterator it = session->Properties.find(propertyName);
+    return (it != session->Properties.end()) ? &it->second : nullptr;
+}
+
+static bool getPropertyNumber(ovrSession session, const char* propertyName, double* value)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    const SimProperty* property = findProperty(findSession(session), propertyName);
+    if (!property || property->IsString || property->Values.empty())
+        return false;
+
+    *value = property->Values[0];
+    return true;
+}
+
+static ovrBool setPropertyNumbers(ovrSession session, const char* propertyName, const double* values, unsigned int count)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession || !propertyName)
+        return ovrFalse;
+
+    SimProperty& property = simSession->Properties[propertyName];
+    property.IsString = false;
+    property.Values.assign(values, values + count);
+    property.String.clear();
+    return ovrTrue;
+}
+
+static void setDefaultProperties(ovrHmdStruct* session)
+{
+    const double numbers[] = { OVR_DEFAULT_PLAYER_HEIGHT, OVR_DEFAULT_EYE_HEIGHT,
+                               OVR_DEFAULT_NECK_TO_EYE_HORIZONTAL, OVR_DEFAULT_NECK_TO_EYE_VERTICAL };
+
+    session->Properties[OVR_KEY_PLAYER_HEIGHT].Values.assign(numbers, numbers + 1);
+    session->Properties[OVR_KEY_EYE_HEIGHT].Values.assign(numbers + 1, numbers + 2);
+    session->Properties[OVR_KEY_NECK_TO_EYE_DISTANCE].Values.assign(numbers + 2, numbers + 4);
+
+    const char* strings[][2] = { { OVR_KEY_USER, "" }, { OVR_KEY_NAME, "" }, { OVR_KEY_GENDER, OVR_DEFAULT_GENDER } };
+    for (size_t i = 0; i < sizeof(strings) / sizeof(strings[0]); ++i)
+    {
+        SimProperty& property = session->Properties[strings[i][0]];
+        property.IsString = true;
+        property.String = strings[i][1];
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Configuration
+
+static bool loadPoseFile(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return false;
+
+    const char* deviceNames[ovrSimDevice_Count] = { "head", "lhand", "rhand" };
+    bool valid = true;
+    char line[256];
+
+    for (int lineNumber = 1; valid && fgets(line, sizeof(line), file); ++lineNumber)
+    {
+        char deviceName[16];
+        ovrSimPoseSample sample;
+        memset(&sample, 0, sizeof(sample));
+
+        const int fields = sscanf(line, "%15s %lf %f %f %f %f %f %f %f", deviceName, &sample.TimeInSeconds,
+                                  &sample.Pose.Position.x, &sample.Pose.Position.y, &sample.Pose.Position.z,
+                                  &sample.Pose.Orientation.x, &sample.Pose.Orientation.y,
+                                  &sample.Pose.Orientation.z, &sample.Pose.Orientation.w);
+
+        if ((fields <= 0) || (deviceName[0] == '#')) // Blank line or comment.
+            continue;
+
+        int device = 0;
+        while ((device < ovrSimDevice_Count) && strcmp(deviceName, deviceNames[device]))
+            ++device;
+
+        std::vector<ovrSimPoseSample>& samples = ReplayTracks[(device < ovrSimDevice_Count) ? device : 0].Samples;
+
+        if ((fields != 9) || (device == ovrSimDevice_Count) ||
+            (!samples.empty() && (sample.TimeInSeconds < samples.back().TimeInSeconds)))
+        {
+            setError(ovrError_Initialize, "Invalid pose sample at %s:%d.", path, lineNumber);
+            valid = false;
+            break;
+        }
+
+        sample.Pose.Orientation = Quatf(sample.Pose.Orientation).Normalized();
+        samples.push_back(sample);
+    }
+
+    fclose(file);
+
+    // Make each device's samples start at zero.
+    for (int device = 0; device < ovrSimDevice_Count; ++device)
+    {
+        std::vector<ovrSimPoseSample>& samples = ReplayTracks[device].Samples;
+
+        if (!valid)
+            samples.clear();
+
+        for (size_t i = samples.size(); i-- > 0; )
+            samples[i].TimeInSeconds -= samples[0].TimeInSeconds;
+    }
+
+    return valid;
+}
+
+static ovrResult loadEnvironmentConfig()
+{
+    ovrSimClockMode mode = ovrSimClock_Deterministic;
+    double refreshRate = DefaultRefreshRate;
+
+    if (const char* clock = getenv("OVR_SIM_CLOCK"))
+    {
+        if (!strcmp(clock, "realtime"))
+            mode = ovrSimClock_RealTime;
+        else if (strcmp(clock, "deterministic"))
+            return setError(ovrError_Initialize, "OVR_SIM_CLOCK must be deterministic or realtime, not %s.", clock);
+    }
+
+    if (const char* rate = getenv("OVR_SIM_FRAME_RATE"))
+    {
+        refreshRate = atof(rate);
+        if (!(refreshRate > 0.0))
+            return setError(ovrError_Initialize, "OVR_SIM_FRAME_RATE must be positive, not %s.", rate);
+    }
+
+    resetClock(mode, refreshRate);
+
+    for (int device = 0; device < ovrSimDevice_Count; ++device)
+        ReplayTracks[device].Samples.clear();
+
+    if (const char* path = getenv("OVR_SIM_POSE_FILE"))
+    {
+        if (!loadPoseFile(path))
+        {
+            if (LastErrorInfo.Result != ovrError_Initialize)
+                return setError(ovrError_Initialize, "Couldn't open pose file %s.", path);
+            return ovrError_Initialize;
+        }
+    }
+
+    return ovrSuccess;
+}
+
+
+//-----------------------------------------------------------------------------
+// ovrSimRuntimeInterface
+
+static ovrResult OVR_CDECL sim_SetClockMode(ovrSimClockMode mode, float refreshRate)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    if (((mode != ovrSimClock_Deterministic) && (mode != ovrSimClock_RealTime)) || !(refreshRate > 0.f))
+        return setError(ovrError_InvalidParameter, "Invalid clock mode or refresh rate.");
+
+    resetClock(mode, refreshRate);
+    return ovrSuccess;
+}
+
+static ovrResult OVR_CDECL sim_AdvanceTime(double seconds)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    if (ClockMode != ovrSimClock_Deterministic)
+        return setError(ovrError_InvalidOperation, "Only a deterministic clock can be advanced.");
+    if (!(seconds >= 0.0))
+        return setError(ovrError_InvalidParameter, "Time can't go backward.");
+
+    DeterministicTime += seconds;
+    return ovrSuccess;
+}
+
+static ovrResult OVR_CDECL sim_SetPoseSamples(ovrSession session, ovrSimDevice device,
+                                              const ovrSimPoseSample* samples, unsigned int sampleCount, ovrBool loop)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if ((device < 0) || (device >= ovrSimDevice_Count) || (sampleCount && !samples))
+        return setError(ovrError_InvalidParameter, "Invalid device or samples.");
+
+    for (unsigned int i = 1; i < sampleCount; ++i)
+    {
+        if (samples[i].TimeInSeconds < samples[i - 1].TimeInSeconds)
+            return setError(ovrError_InvalidParameter, "Pose samples must be in time order.");
+    }
+
+    SimPoseTrack& track = simSession->PoseTracks[device];
+    track.Samples.assign(samples, samples + sampleCount);
+    track.Loop = (loop != ovrFalse);
+
+    for (size_t i = track.Samples.size(); i-- > 0; )
+        track.Samples[i].TimeInSeconds -= track.Samples[0].TimeInSeconds;
+
+    return ovrSuccess;
+}
+
+static ovrResult OVR_CDECL sim_SetConnectedControllerTypes(ovrSession session, unsigned int controllerTypes)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+
+    simSession->ConnectedControllerTypes = controllerTypes & (ovrControllerType_Touch | ovrControllerType_Remote | ovrControllerType_XBox);
+    return ovrSuccess;
+}
+
+static ovrResult OVR_CDECL sim_SetInputState(ovrSession session, ovrControllerType controllerType, const ovrInputState* inputState)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!inputState || (controllerType == ovrControllerType_None) || (controllerType == ovrControllerType_Active))
+        return setError(ovrError_InvalidParameter, "Input state requires a controller type and state.");
+
+    simSession->InputStates[controllerType] = *inputState;
+    return ovrSuccess;
+}
+
+static ovrResult OVR_CDECL sim_SetSessionStatus(ovrSession session, const ovrSessionStatus* sessionStatus)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!sessionStatus)
+        return setError(ovrError_InvalidParameter, "Null session status.");
+
+    simSession->Status = *sessionStatus;
+    return ovrSuccess;
+}
+
+static ovrResult OVR_CDECL sim_GetTextureSwapChainBufferData(ovrSession session, ovrTextureSwapChain chain,
+                                                             int index, void** outData, size_t* outSize)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!ownsSwapChain(simSession, chain) || (index < 0) || (index >= chain->Length) || !outData || !outSize)
+        return setError(ovrError_InvalidParameter, "Invalid texture swap chain buffer.");
+
+    *outData = chain->GetBuffer(index);
+    *outSize = chain->BufferSize;
+    return ovrSuccess;
+}
+
+static ovrResult OVR_CDECL sim_GetMirrorTextureData(ovrSession session, ovrMirrorTexture mirror, void** outData, size_t* outSize)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!ownsMirrorTexture(simSession, mirror) || !outData || !outSize)
+        return setError(ovrError_InvalidParameter, "Invalid mirror texture.");
+
+    *outData = mirror->Memory.data();
+    *outSize = mirror->Memory.size();
+    return ovrSuccess;
+}
+
+static ovrSimRuntimeInterface SimRuntimeInterface =
+{
+    OVR_SIM_RUNTIME_INTERFACE_VERSION,
+    sim_SetClockMode,
+    sim_AdvanceTime,
+    sim_SetPoseSamples,
+    sim_SetConnectedControllerTypes,
+    sim_SetInputState,
+    sim_SetSessionStatus,
+    sim_GetTextureSwapChainBufferData,
+    sim_GetMirrorTextureData
+};
+
+
+//-----------------------------------------------------------------------------
+// Initialization and sessions
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_Initialize(const ovrInitParams* params)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    if (params && (params->Flags & ovrInit_RequestVersion) && (params->RequestedMinorVersion > OVR_MINOR_VERSION))
+        return setError(ovrError_LibVersion, "Requested minor version %u is newer than %d.", params->RequestedMinorVersion, OVR_MINOR_VERSION);
+
+    if (InitializeCount++ > 0)
+        return ovrSuccess;
+
+    memset(&InitParams, 0, sizeof(InitParams));
+    if (params)
+        InitParams = *params;
+
+    const ovrResult result = loadEnvironmentConfig();
+    if (OVR_FAILURE(result))
+    {
+        InitializeCount = 0;
+        return result;
+    }
+
+    logMessage(ovrLogLevel_Info, "Simulated runtime %s initialized at %.1f Hz with a %s clock.", OVR_VERSION_STRING,
+               RefreshRate, (ClockMode == ovrSimClock_RealTime) ? "real time" : "deterministic");
+    return ovrSuccess;
+}
+
+static void destroySession(ovrHmdStruct* session)
+{
+    if (!session->SwapChains.empty() || !session->MirrorTextures.empty())
+    {
+        logMessage(ovrLogLevel_Error, "Session destroyed with %d texture swap chains and %d mirror textures.",
+                   (int)session->SwapChains.size(), (int)session->MirrorTextures.size());
+    }
+
+    for (size_t i = 0; i < session->SwapChains.size(); ++i)
+        delete session->SwapChains[i];
+    for (size_t i = 0; i < session->MirrorTextures.size(); ++i)
+        delete session->MirrorTextures[i];
+
+    Sessions.erase(std::remove(Sessions.begin(), Sessions.end(), session), Sessions.end());
+    delete session;
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_Shutdown()
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    if ((InitializeCount == 0) || (--InitializeCount > 0))
+        return;
+
+    while (!Sessions.empty())
+        destroySession(Sessions.back());
+
+    memset(&InitParams, 0, sizeof(InitParams));
+}
+
+OVR_PUBLIC_FUNCTION(const char*) ovr_GetVersionString()
+{
+    return OVR_VERSION_STRING;
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_GetLastErrorInfo(ovrErrorInfo* errorInfo)
+{
+    if (errorInfo)
+        *errorInfo = LastErrorInfo;
+}
+
+OVR_PUBLIC_FUNCTION(int) ovr_TraceMessage(int level, const char* message)
+{
+    if (!message)
+        return -1;
+
+    const size_t length = strlen(message);
+    if (length >= (size_t)MaxTraceMessageLength)
+        return -1;
+
+    std::lock_guard<std::mutex> lock(SimLock);
+    logMessage(level, "%s", message);
+    return (int)length;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_IdentifyClient(const char* identity)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+    logMessage(ovrLogLevel_Debug, "Client identity: %s", identity ? identity : "");
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_Lookup(const char* name, void** data)
+{
+    if (!name || !data)
+        return setError(ovrError_InvalidParameter, "Null lookup name or data.");
+
+    if (strcmp(name, OVR_SIM_RUNTIME_INTERFACE_NAME))
+        return setError(ovrError_Unsupported, "Unknown lookup name %s.", name);
+
+    *data = &SimRuntimeInterface;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrHmdDesc) ovr_GetHmdDesc(ovrSession session)
+{
+    (void)session; // Like the real runtime, the HMD can be described before a session exists.
+
+    ovrHmdDesc desc;
+    memset(&desc, 0, sizeof(desc));
+
+    desc.Type = ovrHmd_CV1;
+    snprintf(desc.ProductName, sizeof(desc.ProductName), "Oculus Rift (simulated)");
+    snprintf(desc.Manufacturer, sizeof(desc.Manufacturer), "Oculus VR");
+    snprintf(desc.SerialNumber, sizeof(desc.SerialNumber), "SIM000000000");
+    desc.VendorId              = 0x2833;
+    desc.ProductId             = 0x0031;
+    desc.FirmwareMajor         = 1;
+    desc.FirmwareMinor         = 0;
+    desc.AvailableHmdCaps      = ovrHmdCap_DebugDevice;
+    desc.DefaultHmdCaps        = ovrHmdCap_DebugDevice;
+    desc.AvailableTrackingCaps = ovrTrackingCap_Orientation | ovrTrackingCap_MagYawCorrection | ovrTrackingCap_Position;
+    desc.DefaultTrackingCaps   = desc.AvailableTrackingCaps;
+    desc.Resolution.w          = EyeResolutionWidth * 2;
+    desc.Resolution.h          = EyeResolutionHeight;
+
+    for (int eye = 0; eye < ovrEye_Count; ++eye)
+    {
+        desc.DefaultEyeFov[eye] = DefaultEyeFov[eye];
+        desc.MaxEyeFov[eye]     = DefaultEyeFov[eye];
+    }
+
+    std::lock_guard<std::mutex> lock(SimLock);
+    desc.DisplayRefreshRate = (float)RefreshRate;
+    return desc;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_Create(ovrSession* pSession, ovrGraphicsLuid* pLuid)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    if (InitializeCount == 0)
+        return setError(ovrError_NotInitialized, "ovr_Initialize hasn't been called.");
+    if (!pSession)
+        return setError(ovrError_InvalidParameter, "Null session pointer.");
+
+    ovrHmdStruct* session = new ovrHmdStruct;
+
+    session->TrackingOrigin = ovrTrackingOrigin_EyeLevel;
+    session->RecenterPose = Posef::Identity();
+    for (int device = 0; device < ovrSimDevice_Count; ++device)
+        session->PoseTracks[device] = ReplayTracks[device];
+
+    memset(&session->Status, 0, sizeof(session->Status));
+    session->Status.IsVisible  = ovrTrue;
+    session->Status.HmdPresent = ovrTrue;
+    session->Status.HmdMounted = ovrTrue;
+    session->BoundaryVisibleRequested = false;
+    session->ConnectedControllerTypes = ovrControllerType_Touch | ovrControllerType_Remote;
+
+    setDefaultProperties(session);
+
+    session->LastFrameIndex           = 0;
+    session->SubmitCount              = 0;
+    session->AppDroppedFrameCount     = 0;
+    session->LastSubmitVsync          = getVsyncIndex(getTime());
+    session->LatencyMarkerTime        = 0.0;
+    session->LastSubmitReturn         = std::chrono::steady_clock::now();
+    session->PerfStatsBaseSubmitCount = 0;
+    session->AnyFrameStatsDropped     = false;
+
+    for (int hand = 0; hand < ovrHand_Count; ++hand)
+        session->Haptics[hand].LastUpdateTime = getTime();
+
+    Sessions.push_back(session);
+
+    *pSession = session;
+    if (pLuid)
+        memset(pLuid, 0, sizeof(*pLuid));
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_Destroy(ovrSession session)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    if (ovrHmdStruct* simSession = findSession(session))
+        destroySession(simSession);
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetSessionStatus(ovrSession session, ovrSessionStatus* sessionStatus)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!sessionStatus)
+        return setError(ovrError_InvalidParameter, "Null session status.");
+
+    *sessionStatus = simSession->Status;
+    return ovrSuccess;
+}
+
+
+//-----------------------------------------------------------------------------
+// Tracking
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_SetTrackingOriginType(ovrSession session, ovrTrackingOrigin origin)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if ((origin != ovrTrackingOrigin_EyeLevel) && (origin != ovrTrackingOrigin_FloorLevel))
+        return setError(ovrError_InvalidParameter, "Invalid tracking origin.");
+
+    simSession->TrackingOrigin = origin;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrTrackingOrigin) ovr_GetTrackingOriginType(ovrSession session)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    return simSession ? simSession->TrackingOrigin : ovrTrackingOrigin_EyeLevel;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_RecenterTrackingOrigin(ovrSession session)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+
+    // The new origin is below or at the head, facing the head's yaw direction.
+    const Posef head = getRawPose(simSession, ovrSimDevice_Head, getTime());
+
+    float yaw, pitch, roll;
+    head.Rotation.GetYawPitchRoll(&yaw, &pitch, &roll);
+
+    Vector3f position = head.Translation;
+    if (simSession->TrackingOrigin == ovrTrackingOrigin_FloorLevel)
+        position.y = 0.f;
+
+    simSession->RecenterPose = Posef(Quatf(Vector3f(0, 1, 0), yaw), position);
+    simSession->Status.ShouldRecenter = ovrFalse;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_ClearShouldRecenterFlag(ovrSession session)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    if (ovrHmdStruct* simSession = findSession(session))
+        simSession->Status.ShouldRecenter = ovrFalse;
+}
+
+OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingState(ovrSession session, double absTime, ovrBool latencyMarker)
+{
+    ovrTrackingState state;
+    memset(&state, 0, sizeof(state));
+
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return state;
+
+    const double now = getTime();
+    if (absTime <= 0.0)
+        absTime = now;
+
+    if (latencyMarker)
+        simSession->LatencyMarkerTime = now;
+
+    state.HeadPose    = getPoseState(simSession, ovrSimDevice_Head, absTime);
+    state.StatusFlags = ovrStatus_OrientationTracked | ovrStatus_PositionTracked;
+
+    for (int hand = 0; hand < ovrHand_Count; ++hand)
+    {
+        state.HandStatusFlags[hand] = getHandStatusFlags(simSession, hand);
+
+        if (state.HandStatusFlags[hand])
+            state.HandPoses[hand] = getPoseState(simSession, ovrSimDevice_LeftHand + hand, absTime);
+        else
+            state.HandPoses[hand].ThePose.Orientation.w = 1.f;
+    }
+
+    state.CalibratedOrigin = getOriginTransform(simSession);
+    return state;
+}
+
+OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingStateWithSensorData(ovrSession session, double absTime, ovrBool latencyMarker, ovrSensorData* sensorData)
+{
+    (void)sensorData; // There are no raw sensors to report.
+    return ovr_GetTrackingState(session, absTime, latencyMarker);
+}
+
+OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetTrackerCount(ovrSession session)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+    return findSession(session) ? 2 : 0;
+}
+
+OVR_PUBLIC_FUNCTION(ovrTrackerDesc) ovr_GetTrackerDesc(ovrSession session, unsigned int trackerDescIndex)
+{
+    ovrTrackerDesc desc;
+    memset(&desc, 0, sizeof(desc));
+
+    if (ovr_GetTrackerCount(session) > trackerDescIndex)
+    {
+        desc.FrustumHFovInRadians = 1.745f; // 100 degrees
+        desc.FrustumVFovInRadians = 1.222f; // 70 degrees
+        desc.FrustumNearZInMeters = 0.4f;
+        desc.FrustumFarZInMeters  = 2.5f;
+    }
+
+    return desc;
+}
+
+OVR_PUBLIC_FUNCTION(ovrTrackerPose) ovr_GetTrackerPose(ovrSession session, unsigned int index)
+{
+    ovrTrackerPose pose;
+    memset(&pose, 0, sizeof(pose));
+
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession || (index >= 2))
+        return pose;
+
+    const Posef transform = getOriginTransform(simSession);
+    const Posef trackerPose = transform * getRawTrackerPose(index);
+
+    float yaw, pitch, roll;
+    trackerPose.Rotation.GetYawPitchRoll(&yaw, &pitch, &roll);
+
+    pose.TrackerFlags = ovrTracker_Connected | ovrTracker_PoseTracked;
+    pose.Pose         = trackerPose;
+    pose.LeveledPose  = Posef(Quatf(Vector3f(0, 1, 0), yaw), trackerPose.Translation);
+    return pose;
+}
+
+
+//-----------------------------------------------------------------------------
+// Input and haptics
+
+static ovrControllerType getActiveControllerType(ovrHmdStruct* session)
+{
+    const ovrControllerType candidates[] = { ovrControllerType_Touch, ovrControllerType_LTouch, ovrControllerType_RTouch,
+                                             ovrControllerType_XBox, ovrControllerType_Remote };
+
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); ++i)
+    {
+        if ((session->ConnectedControllerTypes & candidates[i]) == (unsigned int)candidates[i])
+            return candidates[i];
+    }
+
+    return ovrControllerType_None;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetInputState(ovrSession session, ovrControllerType controllerType, ovrInputState* inputState)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!inputState)
+        return setError(ovrError_InvalidParameter, "Null input state.");
+
+    memset(inputState, 0, sizeof(*inputState));
+    inputState->TimeInSeconds = getTime();
+
+    if (controllerType == ovrControllerType_Active)
+        controllerType = getActiveControllerType(simSession);
+
+    if ((controllerType == ovrControllerType_None) || !(simSession->ConnectedControllerTypes & controllerType))
+        return ovrSuccess_DeviceUnavailable;
+
+    std::map<unsigned int, ovrInputState>::const_iterator it = simSession->InputStates.find(controllerType);
+    if (it != simSession->InputStates.end())
+    {
+        *inputState = it->second;
+        inputState->TimeInSeconds = getTime();
+    }
+
+    inputState->ControllerType = controllerType;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetConnectedControllerTypes(ovrSession session)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    return simSession ? simSession->ConnectedControllerTypes : 0;
+}
+
+OVR_PUBLIC_FUNCTION(ovrTouchHapticsDesc) ovr_GetTouchHapticsDesc(ovrSession session, ovrControllerType controllerType)
+{
+    (void)session; (void)controllerType;
+
+    ovrTouchHapticsDesc desc;
+    desc.SampleRateHz                  = HapticsSampleRateHz;
+    desc.SampleSizeInBytes             = 1;
+    desc.QueueMinSizeToAvoidStarvation = 5;
+    desc.SubmitMinSamples              = 1;
+    desc.SubmitMaxSamples              = HapticsQueueCapacity;
+    desc.SubmitOptimalSamples          = 20;
+    return desc;
+}
+
+// Gets the haptics queue of a single Touch controller, after playing out the samples
+// that the clock has moved past.
+static SimHaptics* getHaptics(ovrHmdStruct* session, ovrControllerType controllerType)
+{
+    if ((controllerType != ovrControllerType_LTouch) && (controllerType != ovrControllerType_RTouch))
+        return nullptr;
+
+    SimHaptics& haptics = session->Haptics[(controllerType == ovrControllerType_LTouch) ? ovrHand_Left : ovrHand_Right];
+    const double now = getTime();
+    const int played = (int)((now - haptics.LastUpdateTime) * HapticsSampleRateHz);
+
+    haptics.LastUpdateTime = (played >= haptics.SamplesQueued) ? now : (haptics.LastUpdateTime + (double)played / HapticsSampleRateHz);
+    haptics.SamplesQueued  = std::max(haptics.SamplesQueued - played, 0);
+    return &haptics;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_SetControllerVibration(ovrSession session, ovrControllerType controllerType, float frequency, float amplitude)
+{
+    (void)frequency; (void)amplitude;
+
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+
+    return (simSession->ConnectedControllerTypes & controllerType) ? ovrSuccess : (ovrResult)ovrSuccess_DeviceUnavailable;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitControllerVibration(ovrSession session, ovrControllerType controllerType, const ovrHapticsBuffer* buffer)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+
+    SimHaptics* haptics = getHaptics(simSession, controllerType);
+    if (!haptics || !buffer || !buffer->Samples || (buffer->SamplesCount < 0))
+        return setError(ovrError_InvalidParameter, "Haptics buffers need a single Touch controller and samples.");
+    if (!(simSession->ConnectedControllerTypes & controllerType))
+        return ovrSuccess_DeviceUnavailable;
+    if (buffer->SamplesCount > (HapticsQueueCapacity - haptics->SamplesQueued))
+        return setError(ovrError_InvalidParameter, "Haptics buffer of %d samples doesn't fit the queue.", buffer->SamplesCount);
+
+    haptics->SamplesQueued += buffer->SamplesCount;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetControllerVibrationState(ovrSession session, ovrControllerType controllerType, ovrHapticsPlaybackState* outState)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+
+    SimHaptics* haptics = getHaptics(simSession, controllerType);
+    if (!haptics || !outState)
+        return setError(ovrError_InvalidParameter, "Haptics state needs a single Touch controller.");
+
+    outState->SamplesQueued       = haptics->SamplesQueued;
+    outState->RemainingQueueSpace = HapticsQueueCapacity - haptics->SamplesQueued;
+    return ovrSuccess;
+}
+
+
+//-----------------------------------------------------------------------------
+// Boundary
+
+static bool isValidBoundaryType(ovrBoundaryType boundaryType)
+{
+    return (boundaryType == ovrBoundary_Outer) || (boundaryType == ovrBoundary_PlayArea);
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_TestBoundary(ovrSession session, ovrTrackedDeviceType deviceBitmask, ovrBoundaryType singleBoundaryType, ovrBoundaryTestResult* outTestResult)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!isValidBoundaryType(singleBoundaryType) || !outTestResult)
+        return setError(ovrError_InvalidParameter, "Invalid boundary type or result.");
+
+    // Report the device closest to the boundary.
+    const ovrTrackedDeviceType devices[ovrSimDevice_Count] = { ovrTrackedDevice_HMD, ovrTrackedDevice_LTouch, ovrTrackedDevice_RTouch };
+    const Posef transform = getOriginTransform(simSession);
+    const double now = getTime();
+    bool tested = false;
+
+    for (int device = 0; device < ovrSimDevice_Count; ++device)
+    {
+        if (!(deviceBitmask & devices[device]) || ((device > 0) && !getHandStatusFlags(simSession, device - 1)))
+            continue;
+
+        ovrBoundaryTestResult result;
+        testBoundaryPoint(simSession, transform.Transform(getRawPose(simSession, device, now).Translation), singleBoundaryType, &result);
+
+        if (!tested || (result.ClosestDistance < outTestResult->ClosestDistance))
+            *outTestResult = result;
+        tested = true;
+    }
+
+    return tested ? ovrSuccess : (ovrResult)ovrSuccess_DeviceUnavailable;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_TestBoundaryPoint(ovrSession session, const ovrVector3f* point, ovrBoundaryType singleBoundaryType, ovrBoundaryTestResult* outTestResult)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!point || !isValidBoundaryType(singleBoundaryType) || !outTestResult)
+        return setError(ovrError_InvalidParameter, "Invalid point, boundary type or result.");
+
+    testBoundaryPoint(simSession, Vector3f(*point), singleBoundaryType, outTestResult);
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_SetBoundaryLookAndFeel(ovrSession session, const ovrBoundaryLookAndFeel* lookAndFeel)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    if (!findSession(session))
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!lookAndFeel)
+        return setError(ovrError_InvalidParameter, "Null boundary look and feel.");
+
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_ResetBoundaryLookAndFeel(ovrSession session)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+    return findSession(session) ? ovrSuccess : setError(ovrError_InvalidSession, "Invalid session.");
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetBoundaryGeometry(ovrSession session, ovrBoundaryType singleBoundaryType, ovrVector3f* outFloorPoints, int* outFloorPointsCount)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!isValidBoundaryType(singleBoundaryType) || !outFloorPointsCount)
+        return setError(ovrError_InvalidParameter, "Invalid boundary type or point count.");
+
+    *outFloorPointsCount = 4;
+
+    if (outFloorPoints)
+    {
+        // Corners on the floor, clockwise seen from above.
+        const Posef transform = getOriginTransform(simSession);
+        const float halfX = getBoundaryHalfExtent(singleBoundaryType, 0);
+        const float halfZ = getBoundaryHalfExtent(singleBoundaryType, 1);
+        const float floorY = -getEyeHeight(simSession);
+        const Vector3f corners[4] = { Vector3f(-halfX, floorY, -halfZ), Vector3f(halfX, floorY, -halfZ),
+                                      Vector3f(halfX, floorY, halfZ),   Vector3f(-halfX, floorY, halfZ) };
+
+        for (int i = 0; i < 4; ++i)
+            outFloorPoints[i] = transform.Transform(corners[i]);
+    }
+
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetBoundaryDimensions(ovrSession session, ovrBoundaryType singleBoundaryType, ovrVector3f* outDimension)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    if (!findSession(session))
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!isValidBoundaryType(singleBoundaryType) || !outDimension)
+        return setError(ovrError_InvalidParameter, "Invalid boundary type or dimension.");
+
+    outDimension->x = getBoundaryHalfExtent(singleBoundaryType, 0) * 2.f;
+    outDimension->y = 0.f;
+    outDimension->z = getBoundaryHalfExtent(singleBoundaryType, 1) * 2.f;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetBoundaryVisible(ovrSession session, ovrBool* outIsVisible)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!outIsVisible)
+        return setError(ovrError_InvalidParameter, "Null visibility.");
+
+    ovrBoundaryTestResult result;
+    testBoundaryPoint(simSession, getPoseState(simSession, ovrSimDevice_Head, getTime()).ThePose.Position, ovrBoundary_PlayArea, &result);
+
+    *outIsVisible = (simSession->BoundaryVisibleRequested || result.IsTriggering) ? ovrTrue : ovrFalse;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_RequestBoundaryVisible(ovrSession session, ovrBool visible)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+
+    simSession->BoundaryVisibleRequested = (visible != ovrFalse);
+    return ovrSuccess;
+}
+
+
+//-----------------------------------------------------------------------------
+// Rendering
+
+OVR_PUBLIC_FUNCTION(ovrSizei) ovr_GetFovTextureSize(ovrSession session, ovrEyeType eye, ovrFovPort fov, float pixelsPerDisplayPixel)
+{
+    (void)session; (void)eye;
+
+    const float pixelsPerTan = PixelsPerTanAngle * pixelsPerDisplayPixel;
+
+    ovrSizei size;
+    size.w = (int)ceilf((fov.LeftTan + fov.RightTan) * pixelsPerTan);
+    size.h = (int)ceilf((fov.UpTan + fov.DownTan) * pixelsPerTan);
+    return size;
+}
+
+OVR_PUBLIC_FUNCTION(ovrEyeRenderDesc) ovr_GetRenderDesc(ovrSession session, ovrEyeType eyeType, ovrFovPort fov)
+{
+    (void)session;
+
+    ovrEyeRenderDesc desc;
+    memset(&desc, 0, sizeof(desc));
+
+    desc.Eye                         = eyeType;
+    desc.Fov                         = fov;
+    desc.DistortedViewport.Pos.x     = (eyeType == ovrEye_Right) ? EyeResolutionWidth : 0;
+    desc.DistortedViewport.Size.w    = EyeResolutionWidth;
+    desc.DistortedViewport.Size.h    = EyeResolutionHeight;
+    desc.PixelsPerTanAngleAtCenter.x = PixelsPerTanAngle;
+    desc.PixelsPerTanAngleAtCenter.y = PixelsPerTanAngle;
+    desc.HmdToEyeOffset.x            = InterpupillaryDistance * ((eyeType == ovrEye_Right) ? 0.5f : -0.5f);
+    return desc;
+}
+
+OVR_PUBLIC_FUNCTION(double) ovr_GetPredictedDisplayTime(ovrSession session, long long frameIndex)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    const double now = getTime();
+
+    // Frame 0 means the next frame; later frames are displayed one refresh apart.
+    long long framesAhead = 1;
+    if (simSession && (frameIndex > simSession->LastFrameIndex))
+        framesAhead = frameIndex - simSession->LastFrameIndex;
+
+    return getVsyncTime(getVsyncIndex(now) + framesAhead);
+}
+
+OVR_PUBLIC_FUNCTION(double) ovr_GetTimeInSeconds()
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+    return getTime();
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateTextureSwapChainGL(ovrSession session, const ovrTextureSwapChainDesc* desc, ovrTextureSwapChain* outTextureChain)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!desc || !outTextureChain)
+        return setError(ovrError_InvalidParameter, "Null texture swap chain description or result.");
+
+    const size_t bufferSize = getSwapChainBufferSize(*desc);
+    if (bufferSize == 0)
+        return setError(ovrError_InvalidParameter, "Unsupported texture swap chain description.");
+
+    ovrTextureSwapChainData* chain = new ovrTextureSwapChainData;
+    chain->Desc           = *desc;
+    chain->Length         = desc->StaticImage ? 1 : SwapChainLength;
+    chain->CurrentIndex   = 0;
+    chain->PendingCommits = 0;
+    chain->Committed      = false;
+    chain->BufferSize     = bufferSize;
+    chain->Memory.resize(bufferSize * chain->Length);
+    chain->FirstTextureId = NextTextureId;
+    NextTextureId += chain->Length;
+
+    simSession->SwapChains.push_back(chain);
+    *outTextureChain = chain;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateMirrorTextureGL(ovrSession session, const ovrMirrorTextureDesc* desc, ovrMirrorTexture* outMirrorTexture)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!desc || !outMirrorTexture || (desc->Width <= 0) || (desc->Height <= 0) || !isRgba8Format(desc->Format))
+        return setError(ovrError_InvalidParameter, "Unsupported mirror texture description.");
+
+    ovrMirrorTextureData* mirror = new ovrMirrorTextureData;
+    mirror->Desc      = *desc;
+    mirror->Memory.resize((size_t)desc->Width * desc->Height * 4);
+    mirror->TextureId = NextTextureId++;
+
+    simSession->MirrorTextures.push_back(mirror);
+    *outMirrorTexture = mirror;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainBufferGL(ovrSession session, ovrTextureSwapChain chain, int index, unsigned int* texId)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!ownsSwapChain(simSession, chain) || (index < 0) || (index >= chain->Length) || !texId)
+        return setError(ovrError_InvalidParameter, "Invalid texture swap chain buffer.");
+
+    // There's no GL context here, so these are only distinct names for the buffers.
+    *texId = chain->FirstTextureId + index;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetMirrorTextureBufferGL(ovrSession session, ovrMirrorTexture mirror, unsigned int* texId)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!ownsMirrorTexture(simSession, mirror) || !texId)
+        return setError(ovrError_InvalidParameter, "Invalid mirror texture.");
+
+    *texId = mirror->TextureId;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainLength(ovrSession session, ovrTextureSwapChain chain, int* length)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!ownsSwapChain(simSession, chain) || !length)
+        return setError(ovrError_InvalidParameter, "Invalid texture swap chain.");
+
+    *length = chain->Length;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainCurrentIndex(ovrSession session, ovrTextureSwapChain chain, int* currentIndex)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!ownsSwapChain(simSession, chain) || !currentIndex)
+        return setError(ovrError_InvalidParameter, "Invalid texture swap chain.");
+
+    *currentIndex = chain->CurrentIndex;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainDesc(ovrSession session, ovrTextureSwapChain chain, ovrTextureSwapChainDesc* desc)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!ownsSwapChain(simSession, chain) || !desc)
+        return setError(ovrError_InvalidParameter, "Invalid texture swap chain.");
+
+    *desc = chain->Desc;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_CommitTextureSwapChain(ovrSession session, ovrTextureSwapChain chain)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!ownsSwapChain(simSession, chain))
+        return setError(ovrError_InvalidParameter, "Invalid texture swap chain.");
+
+    // A static image is committed once; other chains keep one buffer for the compositor.
+    if (chain->Desc.StaticImage ? chain->Committed : (chain->PendingCommits >= chain->Length - 1))
+        return setError(ovrError_TextureSwapChainFull, "Texture swap chain committed too many times without ovr_SubmitFrame.");
+
+    chain->CurrentIndex = (chain->CurrentIndex + 1) % chain->Length;
+    chain->PendingCommits++;
+    chain->Committed = true;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_DestroyTextureSwapChain(ovrSession session, ovrTextureSwapChain chain)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (simSession && ownsSwapChain(simSession, chain))
+    {
+        simSession->SwapChains.erase(std::remove(simSession->SwapChains.begin(), simSession->SwapChains.end(), chain), simSession->SwapChains.end());
+        delete chain;
+    }
+}
+
+OVR_PUBLIC_FUNCTION(void) ovr_DestroyMirrorTexture(ovrSession session, ovrMirrorTexture mirror)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (simSession && ownsMirrorTexture(simSession, mirror))
+    {
+        simSession->MirrorTextures.erase(std::remove(simSession->MirrorTextures.begin(), simSession->MirrorTextures.end(), mirror), simSession->MirrorTextures.end());
+        delete mirror;
+    }
+}
+
+// Checks a layer's texture swap chain and marks its commits as consumed.
+static ovrResult useLayerSwapChain(ovrHmdStruct* session, ovrTextureSwapChain chain, bool optional)
+{
+    if (!chain && optional)
+        return ovrSuccess;
+
+    if (!ownsSwapChain(session, chain))
+        return setError(ovrError_InvalidParameter, "Layer refers to an invalid texture swap chain.");
+    if (!chain->Committed)
+        return setError(ovrError_TextureSwapChainInvalid, "Layer refers to a texture swap chain that was never committed.");
+
+    chain->PendingCommits = 0;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long frameIndex, const ovrViewScaleDesc* viewScaleDesc,
+                                               ovrLayerHeader const * const * layerPtrList, unsigned int layerCount)
+{
+    (void)viewScaleDesc;
+
+    const std::chrono::steady_clock::time_point submitTime = std::chrono::steady_clock::now();
+    double waitUntil = 0.0;
+
+    {
+        std::lock_guard<std::mutex> lock(SimLock);
+
+        ovrHmdStruct* simSession = findSession(session);
+        if (!simSession)
+            return setError(ovrError_InvalidSession, "Invalid session.");
+        if ((layerCount > ovrMaxLayerCount) || (layerCount && !layerPtrList))
+            return setError(ovrError_InvalidParameter, "Invalid layer list.");
+
+        const ovrLayerEyeFov* mirrorLayer = nullptr;
+
+        for (unsigned int i = 0; i < layerCount; ++i)
+        {
+            const ovrLayerHeader* header = layerPtrList[i];
+            ovrResult result = ovrSuccess;
+
+            if (!header)
+                continue;
+
+            switch (header->Type)
+            {
+            case ovrLayerType_Disabled:
+                break;
+
+            case ovrLayerType_EyeFov:
+            case ovrLayerType_EyeMatrix:
+            {
+                // The two eye layer types share the layout of their textures.
+                const ovrLayerEyeFov* layer = reinterpret_cast<const ovrLayerEyeFov*>(header);
+                result = useLayerSwapChain(simSession, layer->ColorTexture[0], false);
+                if (OVR_SUCCESS(result))
+                    result = useLayerSwapChain(simSession, layer->ColorTexture[1], true);
+                if (!mirrorLayer && (header->Type == ovrLayerType_EyeFov))
+                    mirrorLayer = layer;
+                break;
+            }
+
+            case ovrLayerType_Quad:
+                result = useLayerSwapChain(simSession, reinterpret_cast<const ovrLayerQuad*>(header)->ColorTexture, false);
+                break;
+
+            default:
+                result = setError(ovrError_InvalidParameter, "Layer %u has unknown type %d.", i, (int)header->Type);
+                break;
+            }
+
+            if (OVR_FAILURE(result))
+                return result;
+        }
+
+        if (mirrorLayer)
+        {
+            for (size_t i = 0; i < simSession->MirrorTextures.size(); ++i)
+                updateMirrorTexture(simSession->MirrorTextures[i], mirrorLayer);
+        }
+
+        // Display the frame at the next vsync. A deterministic clock jumps there; a real
+        // time clock is waited on below, outside the lock.
+        const double now = getTime();
+        const int64_t displayVsync = getVsyncIndex(now) + 1;
+        const double displayTime = getVsyncTime(displayVsync);
+
+        if (ClockMode == ovrSimClock_Deterministic)
+            DeterministicTime = displayTime;
+        else
+            waitUntil = displayTime;
+
+        const int droppedFrames = (int)std::max<int64_t>(displayVsync - simSession->LastSubmitVsync - 1, 0);
+        simSession->AppDroppedFrameCount += (simSession->SubmitCount > 0) ? droppedFrames : 0;
+        simSession->LastSubmitVsync = displayVsync;
+        simSession->LastFrameIndex = (frameIndex > 0) ? frameIndex : (simSession->LastFrameIndex + 1);
+        simSession->SubmitCount++;
+
+        double sensorSampleTime = mirrorLayer ? mirrorLayer->SensorSampleTime : 0.0;
+        if (sensorSampleTime <= 0.0)
+            sensorSampleTime = simSession->LatencyMarkerTime;
+
+        ovrPerfStatsPerCompositorFrame stats;
+        memset(&stats, 0, sizeof(stats));
+        stats.HmdVsyncIndex                         = (int)displayVsync;
+        stats.AppFrameIndex                         = simSession->SubmitCount - simSession->PerfStatsBaseSubmitCount;
+        stats.AppDroppedFrameCount                  = simSession->AppDroppedFrameCount;
+        stats.AppMotionToPhotonLatency              = (sensorSampleTime > 0.0) ? (float)(displayTime - sensorSampleTime) : 0.f;
+        stats.AppCpuElapsedTime                     = std::chrono::duration<float>(submitTime - simSession->LastSubmitReturn).count();
+        stats.CompositorFrameIndex                  = (int)displayVsync;
+        stats.CompositorCpuStartToGpuEndElapsedTime = -1.f; // There's no GPU work to time.
+        stats.CompositorGpuEndToVsyncElapsedTime    = -1.f;
+
+        std::vector<ovrPerfStatsPerCompositorFrame>& pending = simSession->PendingFrameStats;
+        if (pending.size() == (size_t)ovrMaxProvidedFrameStats)
+        {
+            pending.erase(pending.begin());
+            simSession->AnyFrameStatsDropped = true;
+        }
+        pending.push_back(stats);
+    }
+
+    if (waitUntil > 0.0)
+    {
+        const double waitSeconds = waitUntil - ovr_GetTimeInSeconds();
+        if (waitSeconds > 0.0)
+            std::this_thread::sleep_for(std::chrono::duration<double>(waitSeconds));
+    }
+
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Session destroyed during ovr_SubmitFrame.");
+
+    simSession->LastSubmitReturn = std::chrono::steady_clock::now();
+    return simSession->Status.IsVisible ? ovrSuccess : (ovrResult)ovrSuccess_NotVisible;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetPerfStats(ovrSession session, ovrPerfStats* outPerfStats)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+    if (!outPerfStats)
+        return setError(ovrError_InvalidParameter, "Null perf stats.");
+
+    memset(outPerfStats, 0, sizeof(*outPerfStats));
+
+    // Most recent first.
+    std::vector<ovrPerfStatsPerCompositorFrame>& pending = simSession->PendingFrameStats;
+    std::copy(pending.rbegin(), pending.rend(), outPerfStats->FrameStats);
+
+    outPerfStats->FrameStatsCount             = (int)pending.size();
+    outPerfStats->AnyFrameStatsDropped        = simSession->AnyFrameStatsDropped ? ovrTrue : ovrFalse;
+    outPerfStats->AdaptiveGpuPerformanceScale = 1.f;
+
+    pending.clear();
+    simSession->AnyFrameStatsDropped = false;
+    return ovrSuccess;
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_ResetPerfStats(ovrSession session)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession)
+        return setError(ovrError_InvalidSession, "Invalid session.");
+
+    simSession->AppDroppedFrameCount     = 0;
+    simSession->PerfStatsBaseSubmitCount = simSession->SubmitCount;
+    simSession->PendingFrameStats.clear();
+    simSession->AnyFrameStatsDropped     = false;
+    return ovrSuccess;
+}
+
+
+//-----------------------------------------------------------------------------
+// Properties
+
+OVR_PUBLIC_FUNCTION(ovrBool) ovr_GetBool(ovrSession session, const char* propertyName, ovrBool defaultVal)
+{
+    double value;
+    return getPropertyNumber(session, propertyName, &value) ? ((value != 0.0) ? ovrTrue : ovrFalse) : defaultVal;
+}
+
+OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetBool(ovrSession session, const char* propertyName, ovrBool value)
+{
+    const double number = value ? 1.0 : 0.0;
+    return setPropertyNumbers(session, propertyName, &number, 1);
+}
+
+OVR_PUBLIC_FUNCTION(int) ovr_GetInt(ovrSession session, const char* propertyName, int defaultVal)
+{
+    double value;
+    return getPropertyNumber(session, propertyName, &value) ? (int)value : defaultVal;
+}
+
+OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetInt(ovrSession session, const char* propertyName, int value)
+{
+    const double number = value;
+    return setPropertyNumbers(session, propertyName, &number, 1);
+}
+
+OVR_PUBLIC_FUNCTION(float) ovr_GetFloat(ovrSession session, const char* propertyName, float defaultVal)
+{
+    double value;
+    return getPropertyNumber(session, propertyName, &value) ? (float)value : defaultVal;
+}
+
+OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetFloat(ovrSession session, const char* propertyName, float value)
+{
+    const double number = value;
+    return setPropertyNumbers(session, propertyName, &number, 1);
+}
+
+OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetFloatArray(ovrSession session, const char* propertyName, float values[], unsigned int arraySize)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    const SimProperty* property = findProperty(findSession(session), propertyName);
+    if (!property || property->IsString || !values)
+        return 0;
+
+    const unsigned int count = std::min(arraySize, (unsigned int)property->Values.size());
+    for (unsigned int i = 0; i < count; ++i)
+        values[i] = (float)property->Values[i];
+    return count;
+}
+
+OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetFloatArray(ovrSession session, const char* propertyName, const float values[], unsigned int arraySize)
+{
+    if (!values && arraySize)
+        return ovrFalse;
+
+    const std::vector<double> numbers(values, values + arraySize);
+    return setPropertyNumbers(session, propertyName, numbers.data(), arraySize);
+}
+
+OVR_PUBLIC_FUNCTION(const char*) ovr_GetString(ovrSession session, const char* propertyName, const char* defaultVal)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    // The returned string stays valid until the property is set again.
+    const SimProperty* property = findProperty(findSession(session), propertyName);
+    return (property && property->IsString) ? property->String.c_str() : defaultVal;
+}
+
+OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetString(ovrSession session, const char* propertyName, const char* value)
+{
+    std::lock_guard<std::mutex> lock(SimLock);
+
+    ovrHmdStruct* simSession = findSession(session);
+    if (!simSession || !propertyName || !value)
+        return ovrFalse;
+
+    SimProperty& property = simSession->Properties[propertyName];
+    property.IsString = true;
+    property.Values.clear();
+    property.String = value;
+    return ovrTrue;
+}
+
+
+//-----------------------------------------------------------------------------
+// Windows-only entry points
+//
+// There's no Direct3D device or audio hardware behind the simulation.
+
+#if defined(_WIN32)
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateTextureSwapChainDX(ovrSession session, IUnknown* d3dPtr, const ovrTextureSwapChainDesc* desc, ovrTextureSwapChain* outTextureChain)
+{
+    (void)session; (void)d3dPtr; (void)desc; (void)outTextureChain;
+    return setError(ovrError_Unsupported, "The simulated runtime only supports OpenGL texture swap chains.");
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateMirrorTextureDX(ovrSession session, IUnknown* d3dPtr, const ovrMirrorTextureDesc* desc, ovrMirrorTexture* outMirrorTexture)
+{
+    (void)session; (void)d3dPtr; (void)desc; (void)outMirrorTexture;
+    return setError(ovrError_Unsupported, "The simulated runtime only supports OpenGL mirror textures.");
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainBufferDX(ovrSession session, ovrTextureSwapChain chain, int index, IID iid, void** ppObject)
+{
+    (void)session; (void)chain; (void)index; (void)iid; (void)ppObject;
+    return setError(ovrError_Unsupported, "The simulated runtime only supports OpenGL texture swap chains.");
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetMirrorTextureBufferDX(ovrSession session, ovrMirrorTexture mirror, IID iid, void** ppObject)
+{
+    (void)session; (void)mirror; (void)iid; (void)ppObject;
+    return setError(ovrError_Unsupported, "The simulated runtime only supports OpenGL mirror textures.");
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceOutWaveId(UINT* deviceOutId)
+{
+    (void)deviceOutId;
+    return setError(ovrError_AudioDeviceNotFound, "The simulated HMD has no audio device.");
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceInWaveId(UINT* deviceInId)
+{
+    (void)deviceInId;
+    return setError(ovrError_AudioDeviceNotFound, "The simulated HMD has no audio device.");
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceOutGuidStr(WCHAR* deviceOutStrBuffer)
+{
+    (void)deviceOutStrBuffer;
+    return setError(ovrError_AudioDeviceNotFound, "The simulated HMD has no audio device.");
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceOutGuid(GUID* deviceOutGuid)
+{
+    (void)deviceOutGuid;
+    return setError(ovrError_AudioDeviceNotFound, "The simulated HMD has no audio device.");
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceInGuidStr(WCHAR* deviceInStrBuffer)
+{
+    (void)deviceInStrBuffer;
+    return setError(ovrError_AudioDeviceNotFound, "The simulated HMD has no audio device.");
+}
+
+OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetAudioDeviceInGuid(GUID* deviceInGuid)
+{
+    (void)deviceInGuid;
+    return setError(ovrError_AudioDeviceNotFound, "The simulated HMD has no audio device.");
+}
+
+#endif // defined(_WIN32)
@@ -677,6 +677,11 @@ limitations under the License.
             GLELoadProc(glRenderbufferStorage_Impl, glRenderbufferStorageEXT);
           //GLELoadProc(glRenderbufferStorageMultisample_Impl, glRenderbufferStorageMultisampleEXT (nonexistent));
         }
+
+        // GL_ARB_get_program_binary
+        GLELoadProc(glGetProgramBinary_Impl, glGetProgramBinary);
+        GLELoadProc(glProgramBinary_Impl, glProgramBinary);
+        GLELoadProc(glProgramParameteri_Impl, glProgramParameteri);
         
         // GL_ARB_texture_multisample
         GLELoadProc(glGetMultisamplefv_Impl, glGetMultisamplefv);
@@ -703,6 +708,11 @@ limitations under the License.
         GLELoadProc(glGetQueryObjectui64v_Impl, glGetQueryObjectui64v);
         GLELoadProc(glQueryCounter_Impl, glQueryCounter);
 
+        // GL_ARB_uniform_buffer_object
+        GLELoadProc(glGetUniformBlockIndex_Impl, glGetUniformBlockIndex);
+        GLELoadProc(glGetActiveUniformBlockiv_Impl, glGetActiveUniformBlockiv);
+        GLELoadProc(glUniformBlockBinding_Impl, glUniformBlockBinding);
+
         // GL_ARB_vertex_array_object
         GLELoadProc(glBindVertexArray_Impl, glBindVertexArray);
         GLELoadProc(glDeleteVertexArrays_Impl, glDeleteVertexArrays);
@@ -830,6 +840,7 @@ limitations under the License.
             { gle_ARB_framebuffer_object, "GL_ARB_framebuffer_object" },
             { gle_ARB_framebuffer_object, "GL_EXT_framebuffer_object" },    // We map glBindFramebuffer, etc. to glBindFramebufferEXT, etc. if necessary
             { gle_ARB_framebuffer_sRGB, "GL_ARB_framebuffer_sRGB" },
+            { gle_ARB_get_program_binary, "GL_ARB_get_program_binary" },
             { gle_ARB_texture_multisample, "GL_ARB_texture_multisample" },
             { gle_ARB_texture_non_power_of_two, "GL_ARB_texture_non_power_of_two" },
             { gle_ARB_texture_rectangle, "GL_ARB_texture_rectangle" },
@@ -838,6 +849,7 @@ limitations under the License.
             { gle_ARB_texture_storage, "GL_ARB_texture_storage" },
             { gle_ARB_texture_storage_multisample, "GL_ARB_texture_storage_multisample" },
             { gle_ARB_timer_query, "GL_ARB_timer_query" },
+            { gle_ARB_uniform_buffer_object, "GL_ARB_uniform_buffer_object" },
             { gle_ARB_vertex_array_object, "GL_ARB_vertex_array_object" },
             { gle_EXT_draw_buffers2, "GL_EXT_draw_buffers2" },
             { gle_EXT_texture_compression_s3tc, "GL_EXT_texture_compression_s3tc" },
@@ -913,6 +925,7 @@ limitations under the License.
                 gle_ARB_texture_multisample      = true;
                 gle_ARB_texture_non_power_of_two = true;
                 gle_ARB_texture_rectangle        = true;
+                gle_ARB_uniform_buffer_object    = true;
                 gle_ARB_vertex_array_object      = true;
             }
         #endif
@@ -6725,6 +6738,29 @@ limitations under the License.
         }
 
 
+        // GL_ARB_get_program_binary
+        void OVR::GLEContext::glGetProgramBinary_Hook(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary)
+        {
+            if(glGetProgramBinary_Impl)
+                glGetProgramBinary_Impl(program, bufSize, length, binaryFormat, binary);
+            PostHook(GLE_CURRENT_FUNCTION);
+        }
+
+        void OVR::GLEContext::glProgramBinary_Hook(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length)
+        {
+            if(glProgramBinary_Impl)
+                glProgramBinary_Impl(program, binaryFormat, binary, length);
+            PostHook(GLE_CURRENT_FUNCTION);
+        }
+
+        void OVR::GLEContext::glProgramParameteri_Hook(GLuint program, GLenum pname, GLint value)
+        {
+            if(glProgramParameteri_Impl)
+                glProgramParameteri_Impl(program, pname, value);
+            PostHook(GLE_CURRENT_FUNCTION);
+        }
+
+
         // GL_ARB_texture_multisample
         void OVR::GLEContext::glTexImage2DMultisample_Hook(GLenum target, GLsizei samples, GLint internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations)
         {
@@ -6852,6 +6888,31 @@ limitations under the License.
         }
 
 
+        // GL_ARB_uniform_buffer_object
+        GLuint OVR::GLEContext::glGetUniformBlockIndex_Hook(GLuint program, const GLchar *uniformBlockName)
+        {
+            GLuint i = GL_INVALID_INDEX;
+            if(glGetUniformBlockIndex_Impl)
+                i = glGetUniformBlockIndex_Impl(program, uniformBlockName);
+            PostHook(GLE_CURRENT_FUNCTION);
+            return i;
+        }
+
+        void OVR::GLEContext::glGetActiveUniformBlockiv_Hook(GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint *params)
+        {
+            if(glGetActiveUniformBlockiv_Impl)
+                glGetActiveUniformBlockiv_Impl(program, uniformBlockIndex, pname, params);
+            PostHook(GLE_CURRENT_FUNCTION);
+        }
+
+        void OVR::GLEContext::glUniformBlockBinding_Hook(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+        {
+            if(glUniformBlockBinding_Impl)
+                glUniformBlockBinding_Impl(program, uniformBlockIndex, uniformBlockBinding);
+            PostHook(GLE_CURRENT_FUNCTION);
+        }
+
+
         // GL_ARB_vertex_array_object
         void OVR::GLEContext::glBindVertexArray_Hook(GLuint array)
         {
@@ -1003,6 +1003,11 @@ namespace OVR
             void glRenderbufferStorageMultisample_Hook(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height);
             void glFramebufferTextureLayer_Hook(GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer);
 
+            // GL_ARB_get_program_binary
+            void glGetProgramBinary_Hook(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+            void glProgramBinary_Hook(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+            void glProgramParameteri_Hook(GLuint program, GLenum pname, GLint value);
+
             // GL_ARB_texture_multisample
             void glTexImage2DMultisample_Hook(GLenum target, GLsizei samples, GLint internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations);
             void glTexImage3DMultisample_Hook(GLenum target, GLsizei samples, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLboolean fixedsamplelocations);
@@ -1028,6 +1033,11 @@ namespace OVR
             void glGetQueryObjecti64v_Hook(GLuint id, GLenum pname, GLint64 *params);
             void glGetQueryObjectui64v_Hook(GLuint id, GLenum pname, GLuint64 *params);
 
+            // GL_ARB_uniform_buffer_object
+            GLuint glGetUniformBlockIndex_Hook(GLuint program, const GLchar *uniformBlockName);
+            void   glGetActiveUniformBlockiv_Hook(GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint *params);
+            void   glUniformBlockBinding_Hook(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+
             // GL_ARB_vertex_array_object
             void      glBindVertexArray_Hook(GLuint array);
             void      glDeleteVertexArrays_Hook(GLsizei n, const GLuint *arrays);
@@ -1696,6 +1706,11 @@ namespace OVR
         // GL_ARB_framebuffer_sRGB
         // (no functions)
 
+        // GL_ARB_get_program_binary
+        PFNGLGETPROGRAMBINARYPROC glGetProgramBinary_Impl;
+        PFNGLPROGRAMBINARYPROC glProgramBinary_Impl;
+        PFNGLPROGRAMPARAMETERIPROC glProgramParameteri_Impl;
+
         // GL_ARB_texture_multisample
         PFNGLGETMULTISAMPLEFVPROC glGetMultisamplefv_Impl;
         PFNGLSAMPLEMASKIPROC glSampleMaski_Impl;
@@ -1727,6 +1742,11 @@ namespace OVR
         PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v_Impl;
         PFNGLQUERYCOUNTERPROC glQueryCounter_Impl;
 
+        // GL_ARB_uniform_buffer_object
+        PFNGLGETUNIFORMBLOCKINDEXPROC glGetUniformBlockIndex_Impl;
+        PFNGLGETACTIVEUNIFORMBLOCKIVPROC glGetActiveUniformBlockiv_Impl;
+        PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding_Impl;
+
         // GL_ARB_vertex_array_object
         PFNGLBINDVERTEXARRAYPROC glBindVertexArray_Impl;
         PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays_Impl;
@@ -1987,12 +2007,14 @@ namespace OVR
         bool gle_ARB_ES2_compatibility;
         bool gle_ARB_framebuffer_object;
         bool gle_ARB_framebuffer_sRGB;
+        bool gle_ARB_get_program_binary;
         bool gle_ARB_texture_multisample;
         bool gle_ARB_texture_non_power_of_two;
         bool gle_ARB_texture_rectangle;
         bool gle_ARB_texture_storage;
         bool gle_ARB_texture_storage_multisample;
         bool gle_ARB_timer_query;
+        bool gle_ARB_uniform_buffer_object;
         bool gle_ARB_vertex_array_object;
       //bool gle_ARB_vertex_attrib_binding;
         bool gle_EXT_draw_buffers2;
@@ -2468,6 +2468,8 @@ extern "C" {
     #define glEndTransformFeedback GLEGetCurrentFunction(glEndTransformFeedback)
     #define glGetBooleani_v GLEGetCurrentFunction(glGetBooleani_v)
     #define glGetIntegeri_v GLEGetCurrentFunction(glGetIntegeri_v)
+    #define glBindBufferRange GLEGetCurrentFunction(glBindBufferRange)
+    #define glBindBufferBase GLEGetCurrentFunction(glBindBufferBase)
     #define glGetFragDataLocation GLEGetCurrentFunction(glGetFragDataLocation)
     #define glGetStringi GLEGetCurrentFunction(glGetStringi)
     #define glGetTexParameterIiv GLEGetCurrentFunction(glGetTexParameterIiv)
@@ -3521,6 +3523,28 @@ extern "C" {
 
 
 
+#ifndef GL_ARB_get_program_binary
+    #define GL_ARB_get_program_binary 1
+
+    // GL_ARB_get_program_binary is part of the OpenGL 4.1 core profile.
+    #define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+    #define GL_PROGRAM_BINARY_LENGTH 0x8741
+    #define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+    #define GL_PROGRAM_BINARY_FORMATS 0x87FF
+
+    typedef void (GLAPIENTRY * PFNGLGETPROGRAMBINARYPROC) (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+    typedef void (GLAPIENTRY * PFNGLPROGRAMBINARYPROC) (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+    typedef void (GLAPIENTRY * PFNGLPROGRAMPARAMETERIPROC) (GLuint program, GLenum pname, GLint value);
+
+    #define glGetProgramBinary  GLEGetCurrentFunction(glGetProgramBinary)
+    #define glProgramBinary     GLEGetCurrentFunction(glProgramBinary)
+    #define glProgramParameteri GLEGetCurrentFunction(glProgramParameteri)
+
+    #define GLE_ARB_get_program_binary GLEGetCurrentVariable(gle_ARB_get_program_binary)
+#endif
+
+
+
 #ifndef GL_ARB_texture_multisample
     #define GL_ARB_texture_multisample 1
 
@@ -3651,6 +3675,35 @@ extern "C" {
 
 
 
+#ifndef GL_ARB_uniform_buffer_object
+    #define GL_ARB_uniform_buffer_object 1
+
+    // GL_ARB_uniform_buffer_object is part of the OpenGL 3.1 core profile.
+    // glBindBufferRange and glBindBufferBase are declared with GL_VERSION_3_0.
+    #define GL_UNIFORM_BUFFER 0x8A11
+    #define GL_UNIFORM_BUFFER_BINDING 0x8A28
+    #define GL_UNIFORM_BUFFER_START 0x8A29
+    #define GL_UNIFORM_BUFFER_SIZE 0x8A2A
+    #define GL_MAX_VERTEX_UNIFORM_BLOCKS 0x8A2B
+    #define GL_MAX_UNIFORM_BUFFER_BINDINGS 0x8A2F
+    #define GL_MAX_UNIFORM_BLOCK_SIZE 0x8A30
+    #define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8A34
+    #define GL_UNIFORM_BLOCK_DATA_SIZE 0x8A40
+    #define GL_INVALID_INDEX 0xFFFFFFFFu
+
+    typedef GLuint (GLAPIENTRY * PFNGLGETUNIFORMBLOCKINDEXPROC) (GLuint program, const GLchar* uniformBlockName);
+    typedef void   (GLAPIENTRY * PFNGLGETACTIVEUNIFORMBLOCKIVPROC) (GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint* params);
+    typedef void   (GLAPIENTRY * PFNGLUNIFORMBLOCKBINDINGPROC) (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+
+    #define glGetUniformBlockIndex    GLEGetCurrentFunction(glGetUniformBlockIndex)
+    #define glGetActiveUniformBlockiv GLEGetCurrentFunction(glGetActiveUniformBlockiv)
+    #define glUniformBlockBinding     GLEGetCurrentFunction(glUniformBlockBinding)
+
+    #define GLE_ARB_uniform_buffer_object GLEGetCurrentVariable(gle_ARB_uniform_buffer_object)
+#endif
+
+
+
 #ifndef GL_ARB_vertex_array_object
     #define GL_ARB_vertex_array_object 1
 
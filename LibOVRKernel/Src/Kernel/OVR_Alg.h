@@ -187,59 +187,189 @@ template<class T> struct OperatorLess
 
 
 //-----------------------------------------------------------------------------------
-// ***** QuickSortSliced
+// ***** HeapSiftDown
+//
+// Moves arr[start + root] down the max-heap stored in arr[start .. start + count).
+template<class Array, class Less>
+void HeapSiftDown(Array& arr, size_t start, size_t root, size_t count, Less less)
+{
+    for(;;)
+    {
+        size_t child = 2 * root + 1;
+        if(child >= count)
+        {
+            break;
+        }
+        if(child + 1 < count && less(arr[start + child], arr[start + child + 1]))
+        {
+            child++;
+        }
+        if(!less(arr[start + root], arr[start + child]))
+        {
+            break;
+        }
+        Swap(arr[start + root], arr[start + child]);
+        root = child;
+    }
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** HeapSortSliced
 //
 // Sort any part of any array: plain, Array, ArrayPaged, ArrayUnsafe.
 // The range is specified with start, end, where "end" is exclusive!
 // The comparison predicate must be specified.
-template<class Array, class Less> 
-void QuickSortSliced(Array& arr, size_t start, size_t end, Less less)
+// Heap Sort is slower than Quick Sort on average, but it is O(n log n) in the
+// worst case. QuickSortSliced falls back to it when its partitions degenerate.
+template<class Array, class Less>
+void HeapSortSliced(Array& arr, size_t start, size_t end, Less less)
 {
-    enum 
+    size_t count = end - start;
+    if(count < 2) return;
+
+    for(size_t i = count / 2; i-- > 0; )
     {
-        Threshold = 9
-    };
+        HeapSiftDown(arr, start, i, count, less);
+    }
+    for(size_t n = count - 1; n > 0; n--)
+    {
+        Swap(arr[start], arr[start + n]);
+        HeapSiftDown(arr, start, 0, n, less);
+    }
+}
 
-    if(end - start <  2) return;
 
-    intptr_t  stack[80];
-    intptr_t* top   = stack; 
-    intptr_t  base  = (intptr_t)start;
-    intptr_t  limit = (intptr_t)end;
+//-----------------------------------------------------------------------------------
+// ***** QuickSort helpers
+//
+enum
+{
+    QuickSortThreshold        = 16,  // Sub-arrays up to this size are insertion sorted.
+    QuickSortNintherThreshold = 128  // Larger ones take the pivot from 9 samples instead of 3.
+};
+
+// Returns the depth of nested partitions after which QuickSortSliced
+// gives up on a sub-array and heap sorts it instead.
+inline int QuickSortDepthLimit(size_t count)
+{
+    int depth = 0;
+    for(; count > 1; count >>= 1)
+    {
+        depth += 2;
+    }
+    return depth;
+}
+
+// Orders the three elements so that arr[b] is their median.
+template<class Array, class Less>
+void QuickSortMedian3(Array& arr, intptr_t a, intptr_t b, intptr_t c, Less less)
+{
+    if(less(arr[b], arr[a])) Swap(arr[a], arr[b]);
+    if(less(arr[c], arr[b]))
+    {
+        Swap(arr[b], arr[c]);
+        if(less(arr[b], arr[a])) Swap(arr[a], arr[b]);
+    }
+}
+
+// Returns the index of the pivot for [base, limit): the middle element, or
+// for large sub-arrays the median of three medians spread over the sub-array
+// (Tukey's ninther), which is moved to the middle.
+template<class Array, class Less>
+intptr_t QuickSortSelectPivot(Array& arr, intptr_t base, intptr_t limit, Less less)
+{
+    intptr_t len   = limit - base;
+    intptr_t pivot = base + len / 2;
+    if(len > QuickSortNintherThreshold)
+    {
+        intptr_t step = len / 8;
+        QuickSortMedian3(arr, base,                 base + step,      base + 2 * step,  less);
+        QuickSortMedian3(arr, pivot - step,         pivot,            pivot + step,     less);
+        QuickSortMedian3(arr, limit - 1 - 2 * step, limit - 1 - step, limit - 1,        less);
+        QuickSortMedian3(arr, base + step,          pivot,            limit - 1 - step, less);
+    }
+    return pivot;
+}
+
+// The partitioning step of QuickSortSliced, exposed for sorts that schedule
+// the sub-arrays themselves (e.g. Util::JobSystem::ParallelSort).
+// Rearranges [start, end) around a pivot so that every element of [start, leftEnd)
+// is <= the pivot and every element of [rightStart, end) is >= it, with the pivot
+// itself in between. The range must hold more than QuickSortThreshold elements.
+template<class Array, class Less>
+void QuickSortPartition(Array& arr, size_t start, size_t end, Less less,
+                        size_t& leftEnd, size_t& rightStart)
+{
+    intptr_t base  = (intptr_t)start;
+    intptr_t limit = (intptr_t)end;
+    intptr_t i, j, pivot;
+
+    pivot = QuickSortSelectPivot(arr, base, limit, less);
+    Swap(arr[base], arr[pivot]);
+
+    i = base + 1;
+    j = limit - 1;
+
+    // now ensure that *i <= *base <= *j 
+    if(less(arr[j],    arr[i])) Swap(arr[j],    arr[i]);
+    if(less(arr[base], arr[i])) Swap(arr[base], arr[i]);
+    if(less(arr[j], arr[base])) Swap(arr[j], arr[base]);
 
     for(;;)
     {
-        intptr_t len = limit - base;
-        intptr_t i, j, pivot;
+        do i++; while( less(arr[i], arr[base]) );
+        do j--; while( less(arr[base], arr[j]) );
 
-        if(len > Threshold)
+        if( i > j )
         {
-            // we use base + len/2 as the pivot
-            pivot = base + len / 2;
-            Swap(arr[base], arr[pivot]);
+            break;
+        }
 
-            i = base + 1;
-            j = limit - 1;
+        Swap(arr[i], arr[j]);
+    }
 
-            // now ensure that *i <= *base <= *j 
-            if(less(arr[j],    arr[i])) Swap(arr[j],    arr[i]);
-            if(less(arr[base], arr[i])) Swap(arr[base], arr[i]);
-            if(less(arr[j], arr[base])) Swap(arr[j], arr[base]);
+    Swap(arr[base], arr[j]);
 
-            for(;;)
-            {
-                do i++; while( less(arr[i], arr[base]) );
-                do j--; while( less(arr[base], arr[j]) );
+    leftEnd    = (size_t)j;
+    rightStart = (size_t)i;
+}
 
-                if( i > j )
-                {
-                    break;
-                }
 
-                Swap(arr[i], arr[j]);
-            }
+//-----------------------------------------------------------------------------------
+// ***** QuickSortSliced
+//
+// Sort any part of any array: plain, Array, ArrayPaged, ArrayUnsafe.
+// The range is specified with start, end, where "end" is exclusive!
+// The comparison predicate must be specified.
+// This is an introsort: sub-arrays that are still large after QuickSortDepthLimit
+// levels of partitioning are heap sorted, so adversarial inputs can't make it
+// quadratic, and small sub-arrays are insertion sorted.
+template<class Array, class Less> 
+void QuickSortSliced(Array& arr, size_t start, size_t end, Less less)
+{
+    if(end - start <  2) return;
 
-            Swap(arr[base], arr[j]);
+    // The smaller sub-array is always sorted first, so the stack never holds more
+    // than log2(size) entries of base, limit and remaining depth.
+    intptr_t  stack[3 * 64];
+    intptr_t* top   = stack; 
+    intptr_t  base  = (intptr_t)start;
+    intptr_t  limit = (intptr_t)end;
+    intptr_t  depth = QuickSortDepthLimit(end - start);
+
+    for(;;)
+    {
+        intptr_t len = limit - base;
+        intptr_t i, j;
+
+        if(len > QuickSortThreshold && depth > 0)
+        {
+            size_t leftEnd, rightStart;
+            QuickSortPartition(arr, (size_t)base, (size_t)limit, less, leftEnd, rightStart);
+            j = (intptr_t)leftEnd;
+            i = (intptr_t)rightStart;
+            depth--;
 
             // now, push the largest sub-array
             if(j - base > limit - i)
@@ -254,30 +384,41 @@ void QuickSortSliced(Array& arr, size_t start, size_t end, Less less)
                 top[1] = limit;
                 limit  = j;
             }
-            top += 2;
+            top[2] = depth;
+            top += 3;
         }
         else
         {
-            // the sub-array is small, perform insertion sort
-            j = base;
-            i = j + 1;
-
-            for(; i < limit; j = i, i++)
+            if(len > QuickSortThreshold)
             {
-                for(; less(arr[j + 1], arr[j]); j--)
+                // the partitions keep coming out lopsided, switch to heap sort
+                HeapSortSliced(arr, (size_t)base, (size_t)limit, less);
+            }
+            else
+            {
+                // the sub-array is small, perform insertion sort,
+                // shifting the larger elements up instead of swapping
+                for(i = base + 1; i < limit; i++)
                 {
-                    Swap(arr[j + 1], arr[j]);
-                    if(j == base)
+                    if(less(arr[i], arr[i - 1]))
                     {
-                        break;
+                        auto value = arr[i];
+                        j = i;
+                        do
+                        {
+                            arr[j] = arr[j - 1];
+                            j--;
+                        } while(j > base && less(value, arr[j - 1]));
+                        arr[j] = value;
                     }
                 }
             }
             if(top > stack)
             {
-                top  -= 2;
+                top  -= 3;
                 base  = top[0];
                 limit = top[1];
+                depth = top[2];
             }
             else
             {
@@ -306,27 +447,22 @@ void QuickSortSliced(Array& arr, size_t start, size_t end)
 template<class Array, class Less> 
 bool QuickSortSlicedSafe(Array& arr, size_t start, size_t end, Less less)
 {
-    enum 
-    {
-        Threshold = 9
-    };
-
     if(end - start <  2) return true;
 
-    intptr_t  stack[80];
+    intptr_t  stack[3 * 64];
     intptr_t* top   = stack; 
     intptr_t  base  = (intptr_t)start;
     intptr_t  limit = (intptr_t)end;
+    intptr_t  depth = QuickSortDepthLimit(end - start);
 
     for(;;)
     {
         intptr_t len = limit - base;
         intptr_t i, j, pivot;
 
-        if(len > Threshold)
+        if(len > QuickSortThreshold && depth > 0)
         {
-            // we use base + len/2 as the pivot
-            pivot = base + len / 2;
+            pivot = QuickSortSelectPivot(arr, base, limit, less);
             Swap(arr[base], arr[pivot]);
 
             i = base + 1;
@@ -361,6 +497,7 @@ bool QuickSortSlicedSafe(Array& arr, size_t start, size_t end, Less less)
             }
 
             Swap(arr[base], arr[j]);
+            depth--;
 
             // now, push the largest sub-array
             if(j - base > limit - i)
@@ -375,30 +512,40 @@ bool QuickSortSlicedSafe(Array& arr, size_t start, size_t end, Less less)
                 top[1] = limit;
                 limit  = j;
             }
-            top += 2;
+            top[2] = depth;
+            top += 3;
         }
         else
         {
-            // the sub-array is small, perform insertion sort
-            j = base;
-            i = j + 1;
-
-            for(; i < limit; j = i, i++)
+            if(len > QuickSortThreshold)
             {
-                for(; less(arr[j + 1], arr[j]); j--)
+                // heap sort never indexes outside the sub-array, whatever the comparator does
+                HeapSortSliced(arr, (size_t)base, (size_t)limit, less);
+            }
+            else
+            {
+                // the sub-array is small, perform insertion sort
+                j = base;
+                i = j + 1;
+
+                for(; i < limit; j = i, i++)
                 {
-                    Swap(arr[j + 1], arr[j]);
-                    if(j == base)
+                    for(; less(arr[j + 1], arr[j]); j--)
                     {
-                        break;
+                        Swap(arr[j + 1], arr[j]);
+                        if(j == base)
+                        {
+                            break;
+                        }
                     }
                 }
             }
             if(top > stack)
             {
-                top  -= 2;
+                top  -= 3;
                 base  = top[0];
                 limit = top[1];
+                depth = top[2];
             }
             else
             {
@@ -527,6 +674,184 @@ void InsertionSort(Array& arr)
     InsertionSortSliced(arr, 0, arr.GetSize(), OperatorLess<ValueType>::Compare);
 }
 
+//-----------------------------------------------------------------------------------
+// ***** RadixKey
+//
+// Maps a key type to an unsigned integer with the same ordering, for RadixSort.
+// Negative floating point values sort before positive ones and -0 before +0.
+template<class T> struct RadixKey;
+
+template<> struct RadixKey<uint8_t>
+{
+    typedef uint8_t KeyType;
+    static KeyType Get(uint8_t v) { return v; }
+};
+
+template<> struct RadixKey<uint16_t>
+{
+    typedef uint16_t KeyType;
+    static KeyType Get(uint16_t v) { return v; }
+};
+
+template<> struct RadixKey<uint32_t>
+{
+    typedef uint32_t KeyType;
+    static KeyType Get(uint32_t v) { return v; }
+};
+
+template<> struct RadixKey<uint64_t>
+{
+    typedef uint64_t KeyType;
+    static KeyType Get(uint64_t v) { return v; }
+};
+
+template<> struct RadixKey<int8_t>
+{
+    typedef uint8_t KeyType;
+    static KeyType Get(int8_t v) { return (KeyType)((KeyType)v ^ 0x80u); }
+};
+
+template<> struct RadixKey<int16_t>
+{
+    typedef uint16_t KeyType;
+    static KeyType Get(int16_t v) { return (KeyType)((KeyType)v ^ 0x8000u); }
+};
+
+template<> struct RadixKey<int32_t>
+{
+    typedef uint32_t KeyType;
+    static KeyType Get(int32_t v) { return (KeyType)v ^ 0x80000000u; }
+};
+
+template<> struct RadixKey<int64_t>
+{
+    typedef uint64_t KeyType;
+    static KeyType Get(int64_t v) { return (KeyType)v ^ 0x8000000000000000ull; }
+};
+
+template<> struct RadixKey<float>
+{
+    typedef uint32_t KeyType;
+    static KeyType Get(float v)
+    {
+        // Flip all the bits of negative values, which are stored as sign and magnitude,
+        // and only the sign bit of positive ones.
+        KeyType bits;
+        memcpy(&bits, &v, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+};
+
+template<> struct RadixKey<double>
+{
+    typedef uint64_t KeyType;
+    static KeyType Get(double v)
+    {
+        KeyType bits;
+        memcpy(&bits, &v, sizeof(bits));
+        return (bits & 0x8000000000000000ull) ? ~bits : (bits | 0x8000000000000000ull);
+    }
+};
+
+
+//-----------------------------------------------------------------------------------
+// ***** RadixSortKeyed
+//
+// Sort a plain array of count elements by the unsigned integer key(element), with a
+// stable least significant digit radix sort of one byte per pass. Passes where all
+// the keys have the same byte are skipped, so e.g. 64-bit draw call sort keys that
+// use few of their bits take few passes.
+// scratch must have room for count elements. The elements are copied around with
+// assignment, so this is meant for keys and small structs holding a key; sort
+// anything heavier through an array of (key, index) pairs.
+enum
+{
+    RadixSortThreshold = 64 // Fewer elements than this are insertion sorted.
+};
+
+template<class T, class KeyFunc>
+void RadixSortKeyed(T* data, T* scratch, size_t count, KeyFunc key)
+{
+    typedef decltype(key(*data)) KeyType;
+    enum { Passes = sizeof(KeyType) };
+
+    if(count < RadixSortThreshold)
+    {
+        for(size_t i = 1; i < count; i++)
+        {
+            T value = data[i];
+            KeyType k = key(value);
+            size_t j = i;
+            for(; j > 0 && k < key(data[j - 1]); j--)
+            {
+                data[j] = data[j - 1];
+            }
+            data[j] = value;
+        }
+        return;
+    }
+
+    // Histograms of all the bytes are built in one read of the data.
+    size_t histograms[Passes][256];
+    memset(histograms, 0, sizeof(histograms));
+
+    for(size_t i = 0; i < count; i++)
+    {
+        KeyType k = key(data[i]);
+        for(int pass = 0; pass < Passes; pass++)
+        {
+            histograms[pass][(k >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    T* src = data;
+    T* dst = scratch;
+
+    for(int pass = 0; pass < Passes; pass++)
+    {
+        size_t* offsets = histograms[pass];
+        if(offsets[(key(src[0]) >> (pass * 8)) & 0xFF] == count)
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for(int digit = 0; digit < 256; digit++)
+        {
+            size_t digitCount = offsets[digit];
+            offsets[digit] = offset;
+            offset += digitCount;
+        }
+
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[offsets[(key(src[i]) >> (pass * 8)) & 0xFF]++] = src[i];
+        }
+
+        Swap(src, dst);
+    }
+
+    if(src != data)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            data[i] = src[i];
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** RadixSort
+//
+// Sort a plain array of integer or floating point values, which must have a
+// RadixKey specialization. scratch must have room for count elements.
+template<class T>
+void RadixSort(T* data, T* scratch, size_t count)
+{
+    RadixSortKeyed(data, scratch, count, RadixKey<T>::Get);
+}
+
 //-----------------------------------------------------------------------------------
 // ***** Median
 // Returns a median value of the input array.
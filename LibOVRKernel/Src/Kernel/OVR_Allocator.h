@@ -41,6 +41,7 @@ OVR_DISABLE_ALL_MSVC_WARNINGS()
 #include <map>
 #include <exception>
 #include <new>
+#include <utility>
 #include <atomic>
 OVR_RESTORE_ALL_MSVC_WARNINGS()
 #if defined(_WIN32)
@@ -200,6 +201,20 @@ OVR_FORCE_INLINE T*  ConstructAlt(void *p, const S1& src1, const S2& src2)
     return ::new(p) T(src1, src2);
 }
 
+// Move-constructs from source, leaving it in its moved-from state.
+template <class T>
+OVR_FORCE_INLINE T*  ConstructMove(void *p, T&& source)
+{
+    return ::new(p) T(std::move(source));
+}
+
+// Constructs in place from any constructor arguments.
+template <class T, class... Args>
+OVR_FORCE_INLINE T*  ConstructEmplace(void *p, Args&&... args)
+{
+    return ::new(p) T(std::forward<Args>(args)...);
+}
+
 // Note: These ConstructArray functions don't properly support the case of a C++ exception occurring midway 
 // during construction, as they don't deconstruct the successfully constructed array elements before returning.
 template <class T>
@@ -28,6 +28,7 @@ limitations under the License.
 #define OVR_Array_h
 
 #include "OVR_ContainerAllocator.h"
+#include <type_traits>
 
 namespace OVR {
 
@@ -38,6 +39,8 @@ namespace OVR {
 // Shrinking as needed. ArrayConstPolicy actually is the same as 
 // ArrayDefaultPolicy, but parametrized with constants. 
 // This struct is used only in order to reduce the template "matroska".
+// A policy may also provide storage for the first elements inside
+// the array object itself, see ArrayInlinePolicy.
 struct ArrayDefaultPolicy
 {
     ArrayDefaultPolicy() : Capacity(0) {}
@@ -47,6 +50,9 @@ struct ArrayDefaultPolicy
     size_t GetGranularity() const { return 4; }
     bool  NeverShrinking() const { return 1; }
 
+    void*  GetInlineData()     const { return 0; }
+    size_t GetInlineCapacity() const { return 0; }
+
     size_t GetCapacity()    const      { return Capacity; }
     void  SetCapacity(size_t capacity) { Capacity = capacity; }
 private:
@@ -71,12 +77,45 @@ struct ArrayConstPolicy
     size_t GetGranularity() const { return Granularity; }
     bool  NeverShrinking() const { return NeverShrink; }
 
+    void*  GetInlineData()     const { return 0; }
+    size_t GetInlineCapacity() const { return 0; }
+
     size_t GetCapacity()    const      { return Capacity; }
     void  SetCapacity(size_t capacity) { Capacity = capacity; }
 private:
     size_t Capacity;
 };
 
+//-----------------------------------------------------------------------------------
+// ***** ArrayInlinePolicy
+//
+// Resizing behavior of SmallArray: like ArrayDefaultPolicy, but the first
+// InlineCount elements are kept in a buffer inside the policy, so small
+// arrays never touch the heap. The buffer belongs to the array object and
+// is neither copied nor assigned along with the policy.
+template<class T, int InlineCount>
+struct ArrayInlinePolicy
+{
+    typedef ArrayInlinePolicy<T, InlineCount> SelfType;
+
+    ArrayInlinePolicy() : Capacity(0) {}
+    ArrayInlinePolicy(const SelfType&) : Capacity(0) {}
+    SelfType& operator=(const SelfType&) { return *this; }
+
+    size_t GetMinCapacity() const { return 0; }
+    size_t GetGranularity() const { return 4; }
+    bool  NeverShrinking() const { return 1; }
+
+    void*  GetInlineData()     const { return (void*)&Buffer; }
+    size_t GetInlineCapacity() const { return InlineCount; }
+
+    size_t GetCapacity()    const      { return Capacity; }
+    void  SetCapacity(size_t capacity) { Capacity = capacity; }
+private:
+    size_t Capacity;
+    typename std::aligned_storage<sizeof(T) * InlineCount, OVR_ALIGNOF(T)>::type Buffer;
+};
+
 //-----------------------------------------------------------------------------------
 // ***** ArrayDataBase
 //
@@ -101,7 +140,7 @@ struct ArrayDataBase
         if (Data)
         {
             Allocator::DestructArray(Data, Size);
-            Allocator::Free(Data);
+            FreeData();
         }
     }
 
@@ -110,12 +149,24 @@ struct ArrayDataBase
         return Policy.GetCapacity(); 
     }
 
+    // Is Data the buffer inside the policy rather than a heap block?
+    bool IsInlineData() const
+    {
+        return Policy.GetInlineCapacity() && (Data == (T*)Policy.GetInlineData());
+    }
+
+    void FreeData()
+    {
+        if (!IsInlineData())
+            Allocator::Free(Data);
+    }
+
     void ClearAndRelease()
     {
         if (Data)
         {
             Allocator::DestructArray(Data, Size);
-            Allocator::Free(Data);
+            FreeData();
             Data = 0;
         }
         Size = 0;
@@ -127,6 +178,9 @@ struct ArrayDataBase
         if (Policy.NeverShrinking() && newCapacity < GetCapacity())
             return;
 
+        // When shrinking, the caller has already destructed the elements past newCapacity.
+        size_t liveCount = (Size < newCapacity) ? Size : newCapacity;
+
         if (newCapacity < Policy.GetMinCapacity())
             newCapacity = Policy.GetMinCapacity();
 
@@ -135,43 +189,43 @@ struct ArrayDataBase
         {
             if (Data)
             {
-                Allocator::Free(Data);
+                FreeData();
                 Data = 0;
             }
             Policy.SetCapacity(0);
         }
-        else
+        else if (newCapacity <= Policy.GetInlineCapacity())
         {
-            size_t gran = Policy.GetGranularity();
-            newCapacity = (newCapacity + gran - 1) / gran * gran;
-            if (Data)
+            T* inlineData = (T*)Policy.GetInlineData();
+            if (Data != inlineData)
             {
-                if (Allocator::IsMovable())
-                {
-                    Data = (T*)Allocator::Realloc(Data, sizeof(T) * newCapacity);
-                }
-                else
+                if (Data)
                 {
-                    T* newData = (T*)Allocator::Alloc(sizeof(T) * newCapacity);
-                    size_t i, s;
-                    s = (Size < newCapacity) ? Size : newCapacity;
-                    for (i = 0; i < s; ++i)
-                    {
-                        Allocator::Construct(&newData[i], Data[i]);
-                        Allocator::Destruct(&Data[i]);
-                    }
-                    for (i = s; i < Size; ++i)
-                    {
-                        Allocator::Destruct(&Data[i]);
-                    }
+                    Allocator::RelocateArray(inlineData, Data, liveCount);
                     Allocator::Free(Data);
-                    Data = newData;
                 }
+                Data = inlineData;
+            }
+            Policy.SetCapacity(Policy.GetInlineCapacity());
+        }
+        else
+        {
+            size_t gran = Policy.GetGranularity();
+            newCapacity = (newCapacity + gran - 1) / gran * gran;
+            if (Data && Allocator::IsMovable() && !IsInlineData())
+            {
+                Data = (T*)Allocator::Realloc(Data, sizeof(T) * newCapacity);
             }
             else
             {
-                Data = (T*)Allocator::Alloc(sizeof(T) * newCapacity);
-                //memset(Buffer, 0, (sizeof(ValueType) * newSize)); // Do we need this?
+                // Leaving the inline buffer, or elements that must be move-constructed.
+                T* newData = (T*)Allocator::Alloc(sizeof(T) * newCapacity);
+                if (Data)
+                {
+                    Allocator::RelocateArray(newData, Data, liveCount);
+                    FreeData();
+                }
+                Data = newData;
             }
             Policy.SetCapacity(newCapacity);
             // OVR_ASSERT(Data); // need to throw (or something) on alloc failure!
@@ -193,9 +247,10 @@ struct ArrayDataBase
                 Reserve(newSize);
             }
         }
-        else if(newSize >= Policy.GetCapacity())
+        else if(newSize > Policy.GetCapacity())
         {
-            Reserve(newSize + (newSize >> 2));
+            // Grow geometrically, so that a sequence of PushBacks costs amortized O(1).
+            Reserve(newSize + (newSize >> 1));
         }
         //! IMPORTANT to modify Size only after Reserve completes, because garbage collectable
         // array may use this array and may traverse it during Reserve (in the case, if 
@@ -249,6 +304,21 @@ struct ArrayData : ArrayDataBase<T, Allocator, SizePolicy>
         Allocator::Construct(this->Data + this->Size - 1, val);
     }
 
+    void PushBack(ValueType&& val)
+    {
+        BaseType::ResizeNoConstruct(this->Size + 1);
+        OVR_ASSERT(this->Data != NULL);
+        Allocator::ConstructMove(this->Data + this->Size - 1, std::move(val));
+    }
+
+    template<class... Args>
+    void EmplaceBack(Args&&... args)
+    {
+        BaseType::ResizeNoConstruct(this->Size + 1);
+        OVR_ASSERT(this->Data != NULL);
+        Allocator::Emplace(this->Data + this->Size - 1, std::forward<Args>(args)...);
+    }
+
     template<class S>
     void PushBackAlt(const S& val)
     {
@@ -308,6 +378,19 @@ struct ArrayDataCC : ArrayDataBase<T, Allocator, SizePolicy>
         Allocator::Construct(this->Data + this->Size - 1, val);
     }
 
+    void PushBack(ValueType&& val)
+    {
+        BaseType::ResizeNoConstruct(this->Size + 1);
+        Allocator::ConstructMove(this->Data + this->Size - 1, std::move(val));
+    }
+
+    template<class... Args>
+    void EmplaceBack(Args&&... args)
+    {
+        BaseType::ResizeNoConstruct(this->Size + 1);
+        Allocator::Emplace(this->Data + this->Size - 1, std::forward<Args>(args)...);
+    }
+
     template<class S>
     void PushBackAlt(const S& val)
     {
@@ -440,6 +523,21 @@ public:
         Data.PushBack(val);
     }
 
+    void    PushBack(ValueType&& val)
+    {
+        Data.PushBack(std::move(val));
+    }
+
+    // Construct a new element at the end of the array from the given constructor
+    // arguments. The same warning as for PushBack applies to arguments that refer
+    // to elements of this array.
+    template<class... Args>
+    ValueType& EmplaceBack(Args&&... args)
+    {
+        Data.EmplaceBack(std::forward<Args>(args)...);
+        return Back();
+    }
+
     template<class S>
     void PushBackAlt(const S& val)
     {
@@ -548,7 +646,7 @@ public:
             if (index < lastElemIndex)
             {
                 AllocatorType::Destruct(Data.Data + index);
-                AllocatorType::Construct(Data.Data + index, Data.Data[lastElemIndex]);
+                AllocatorType::ConstructMove(Data.Data + index, std::move(Data.Data[lastElemIndex]));
             }
             AllocatorType::Destruct(Data.Data + lastElemIndex);
             --Data.Size;
@@ -820,6 +918,29 @@ public:
 };
 
 
+// ***** SmallArray
+//
+// General purpose array for movable objects, like Array, that keeps up to
+// InlineCount elements inside the array object and only goes to the heap
+// when it grows past that. Use it for short arrays that are created and
+// grown often, e.g. listener lists.
+template<class T, int InlineCount>
+class SmallArray : public ArrayBase<ArrayData<T, ContainerAllocator<T>, ArrayInlinePolicy<T, InlineCount> > >
+{
+public:
+    typedef T                                                                                   ValueType;
+    typedef ContainerAllocator<T>                                                               AllocatorType;
+    typedef ArrayInlinePolicy<T, InlineCount>                                                   SizePolicyType;
+    typedef SmallArray<T, InlineCount>                                                          SelfType;
+    typedef ArrayBase<ArrayData<T, ContainerAllocator<T>, ArrayInlinePolicy<T, InlineCount> > > BaseType;
+
+    SmallArray() : BaseType() {}
+    explicit SmallArray(size_t size) : BaseType(size) {}
+    SmallArray(const SelfType& a) : BaseType(a) {}
+    const SelfType& operator=(const SelfType& a) { BaseType::operator=(a); return *this; }
+};
+
+
 // ***** ArrayCC
 //
 // A modification of the array that uses the given default value to
@@ -48,47 +48,56 @@ template<class DelegateT> class CallbackListener;
 //-----------------------------------------------------------------------------
 // FloatingCallbackEmitter
 //
-// The Call() function is not thread-safe.
-// TBD: Should we add a thread-safe Call() option to constructor?
-
-class CallbackEmitterBase
-{
-protected:
-    static Lock* GetEmitterLock();
-};
+// AddListener(), OnListenerCancel() and Shutdown() are serialized by a lock owned by
+// the emitter, so unrelated emitters never contend.  Each change publishes a new
+// immutable snapshot of the listener array through an atomic pointer, and Call()
+// reads the current snapshot without taking a lock or allocating memory.
+//
+// Replaced snapshots are retired rather than freed, since a concurrent Call() may
+// still be walking them.  Reclamation is epoch based: each Call() counts itself in
+// ActiveCalls[Epoch & 1] for as long as it holds a snapshot.  A change flips the epoch
+// so that new calls count themselves on the other side, and the snapshots retired
+// before the flip are freed once the old side has drained.  Calls that never stop
+// arriving therefore can't hold retired snapshots back; only a call that started
+// before the flip can, and only until it returns.
 
 template<class DelegateT>
-class FloatingCallbackEmitter : public CallbackEmitterBase, public RefCountBase< FloatingCallbackEmitter<DelegateT> >
+class FloatingCallbackEmitter : public RefCountBase< FloatingCallbackEmitter<DelegateT> >
 {
     friend class CallbackEmitter<DelegateT>;
 
     FloatingCallbackEmitter() :
+        EmitterLock(),
         IsShutdown(false),
-#if !defined(OVR_CC_MSVC) || (OVR_CC_VERSION > 1600) // Newer than VS2010
+        Listeners(),
         ListenersExist(false),
-#endif
-        DirtyListenersCache(0)
+        Snapshot(nullptr),
+        Epoch(0),
+        RetiredSnapshots(nullptr),
+        DrainingSnapshots(nullptr),
+        Drained(true)
     {
+        ActiveCalls[0].store(0);
+        ActiveCalls[1].store(0);
     }
 
 public:
-    typedef Array< Ptr< FloatingCallbackListener<DelegateT> > > ListenerPtrArray;
+    typedef SmallArray< Ptr< FloatingCallbackListener<DelegateT> >, 4 > ListenerPtrArray;
 
     ~FloatingCallbackEmitter()
     {
         OVR_ASSERT(Listeners.GetSizeI() == 0);
-        // ListenersCache will be emptied here.
+        OVR_ASSERT(ActiveCalls[0].load() == 0 && ActiveCalls[1].load() == 0);
+
+        freeSnapshots(Snapshot.exchange(nullptr));
+        freeSnapshots(RetiredSnapshots);
+        freeSnapshots(DrainingSnapshots);
     }
 
     bool AddListener(FloatingCallbackListener<DelegateT>* listener);
     bool HasListeners() const
     {
-#if !defined(OVR_CC_MSVC) || (OVR_CC_VERSION > 1600) // Newer than VS2010
         return ListenersExist.load(std::memory_order_relaxed);
-#else
-        // This code still has a data race
-        return (Listeners.GetSizeI() > 0);
-#endif
     }
     void Shutdown();
 
@@ -118,38 +127,114 @@ public:
     void Call(Param1& p1, Param2& p2, Param3& p3);
 
 protected:
+    // Immutable copy of the listener array as of the last change, used by Call().
+    struct ListenerSnapshot : public NewOverrideBase
+    {
+        ListenerSnapshot(const ListenerPtrArray& listeners) :
+            Listeners(listeners),
+            pNextRetired(nullptr)
+        {
+        }
+
+        ListenerPtrArray  Listeners;
+        ListenerSnapshot* pNextRetired;
+    };
+
+    // Serializes changes to the listeners of this emitter.
+    Lock EmitterLock;
+
     // Is the emitter shut down?  This prevents more listeners from being added during shutdown.
     bool IsShutdown;
 
-    // Array of added listeners.
+    // Array of added listeners.  Protected by EmitterLock.
     ListenerPtrArray Listeners;
 
-#if !defined(OVR_CC_MSVC) || (OVR_CC_VERSION > 1600) // Newer than VS2010
     std::atomic<bool> ListenersExist;
-#endif
 
-    // Is the cache dirty?  This avoids locking and memory allocation in steady state.
-    std::atomic<uint32_t> DirtyListenersCache = { 0 };
+    // Current snapshot, or null if there are no listeners.
+    std::atomic<ListenerSnapshot*> Snapshot;
+
+    // Only the low bit is used, to pick the ActiveCalls entry that new Call() functions count in.
+    std::atomic<uint32_t> Epoch;
+
+    // Number of Call() functions currently using a snapshot, by the epoch they started in.
+    std::atomic<uint32_t> ActiveCalls[2];
+
+    // Snapshots replaced during the current epoch.  Protected by EmitterLock.
+    ListenerSnapshot* RetiredSnapshots;
 
-    // Cache of listeners used by the Call() function.
-    ListenerPtrArray ListenersCacheForCalls;
+    // Snapshots replaced during the previous epoch, waiting for its calls to drain.
+    // Protected by EmitterLock.
+    ListenerSnapshot* DrainingSnapshots;
 
-    // Update the ListenersCache array in response to an insertion or removal.
-    // This is how AddListener() insertions get rolled into the listeners array.
-    // This is how RemoveListener() removals get purged from the cache.
-    void updateListenersCache()
+    // Have the calls of the previous epoch been seen to drain?  The epoch may only be
+    // flipped again once they have.  Protected by EmitterLock.
+    bool Drained;
+
+    // Publish a snapshot of the Listeners array in response to an insertion or removal.
+    // EmitterLock must be held.
+    void publishSnapshot()
     {
-        if (DirtyListenersCache != 0)
+        ListenerSnapshot* snapshot = nullptr;
+        if (Listeners.GetSizeI() > 0)
         {
-            Lock::Locker locker(GetEmitterLock());
+            snapshot = new ListenerSnapshot(Listeners);
+        }
 
-            // TBD: Should memory allocation be further reduced here?
-            ListenersCacheForCalls = Listeners;
-            DirtyListenersCache = 0;
+        ListenerSnapshot* replaced = Snapshot.exchange(snapshot);
+        if (replaced)
+        {
+            replaced->pNextRetired = RetiredSnapshots;
+            RetiredSnapshots = replaced;
         }
+
+        ListenersExist.store(snapshot != nullptr, std::memory_order_relaxed);
+
+        reclaimSnapshots();
     }
 
-    // Without holding a lock, find and remove the given listener from the array of listeners.
+    // Free the retired snapshots that no Call() can still hold.  EmitterLock must be held.
+    //
+    // A Call() checks that the epoch did not change while it counted itself and loaded
+    // the snapshot, so a call that holds a snapshot retired during epoch E is counted on
+    // the side of E or of an earlier epoch.  Calls of earlier epochs were seen to drain
+    // before the flip to E + 1, and those of E are waited for below after that flip.
+    void reclaimSnapshots()
+    {
+        for (;;)
+        {
+            if (!Drained)
+            {
+                const uint32_t previous = Epoch.load() - 1;
+                if (ActiveCalls[previous & 1].load() != 0)
+                    return;
+
+                freeSnapshots(DrainingSnapshots);
+                DrainingSnapshots = nullptr;
+                Drained = true;
+            }
+
+            if (!RetiredSnapshots)
+                return;
+
+            DrainingSnapshots = RetiredSnapshots;
+            RetiredSnapshots = nullptr;
+            Drained = false;
+            Epoch.fetch_add(1);
+        }
+    }
+
+    static void freeSnapshots(ListenerSnapshot* snapshot)
+    {
+        while (snapshot)
+        {
+            ListenerSnapshot* next = snapshot->pNextRetired;
+            delete snapshot;
+            snapshot = next;
+        }
+    }
+
+    // With EmitterLock held, find and remove the given listener from the array of listeners.
     void noLockFindAndRemoveListener(FloatingCallbackListener<DelegateT>* listener)
     {
         const int count = Listeners.GetSizeI();
@@ -159,20 +244,12 @@ protected:
             {
                 Listeners.RemoveAt(i);
 
-                // After removing it from the array, set the dirty flag.
-                // Note: Because the flag is atomic, a portable memory fence is implied.
-                DirtyListenersCache = 1;
+                publishSnapshot();
 
                 break;
             }
 
         }
-#if !defined(OVR_CC_MSVC) || (OVR_CC_VERSION > 1600) // Newer than VS2010
-        if (Listeners.GetSizeI() < 1)
-        {
-            ListenersExist.store(false, std::memory_order_relaxed);
-        }
-#endif
     }
 };
 
@@ -211,7 +288,7 @@ public:
 template<class DelegateT>
 bool FloatingCallbackEmitter<DelegateT>::AddListener(FloatingCallbackListener<DelegateT>* listener)
 {
-    Lock::Locker locker(GetEmitterLock());
+    Lock::Locker locker(&EmitterLock);
 
     if (IsShutdown)
     {
@@ -221,13 +298,8 @@ bool FloatingCallbackEmitter<DelegateT>::AddListener(FloatingCallbackListener<De
     // Add the listener to our list
     Listeners.PushBack(listener);
 
-    // After adding it to the array, set the dirty flag.
-    // Note: Because the flag is atomic, a portable memory fence is implied.
-    DirtyListenersCache = 1;
-
-#if !defined(OVR_CC_MSVC) || (OVR_CC_VERSION > 1600) // Newer than VS2010
-    ListenersExist.store(true, std::memory_order_relaxed);
-#endif
+    // After adding it to the array, publish it to Call().
+    publishSnapshot();
 
     return true;
 }
@@ -237,7 +309,7 @@ bool FloatingCallbackEmitter<DelegateT>::AddListener(FloatingCallbackListener<De
 template<class DelegateT>
 void FloatingCallbackEmitter<DelegateT>::OnListenerCancel(FloatingCallbackListener<DelegateT>* listener)
 {
-    Lock::Locker locker(GetEmitterLock());
+    Lock::Locker locker(&EmitterLock);
 
     // If not shut down,
     // Note that if it is shut down then there will be no listeners in the array.
@@ -251,39 +323,49 @@ void FloatingCallbackEmitter<DelegateT>::OnListenerCancel(FloatingCallbackListen
 template<class DelegateT>
 void FloatingCallbackEmitter<DelegateT>::Shutdown()
 {
-    Lock::Locker locker(GetEmitterLock());
+    Lock::Locker locker(&EmitterLock);
 
     IsShutdown = true;
 
     Listeners.ClearAndRelease();
 
-    // Note: Because the flag is atomic, a portable memory fence is implied.
-    DirtyListenersCache = 1;
-
-#if !defined(OVR_CC_MSVC) || (OVR_CC_VERSION > 1600) // Newer than VS2010
-    ListenersExist.store(false, std::memory_order_relaxed);
-#endif
+    publishSnapshot();
 }
 
 //-----------------------------------------------------------------------------
 // Call function
 //
-// (1) Update the cache of listener references, if it has changed.
+// (1) Count this call in ActiveCalls for the current epoch and load the current listener
+//     snapshot, retrying if the epoch changed meanwhile.
 // (2) For each listener,
 //    (a) Hold ListenerLock.
 //    (b) If listener handler is valid, call the handler.
+// (3) Release the snapshot.
 #define OVR_EMITTER_CALL_BODY(params) \
-    updateListenersCache(); \
-    if (IsShutdown) return; /* Pure optimization.  It is fine if this races. */ \
-    const int count = ListenersCacheForCalls.GetSizeI(); \
-    for (int i = 0; i < count; ++i) \
+    uint32_t epoch = Epoch.load(); \
+    ActiveCalls[epoch & 1].fetch_add(1); \
+    const ListenerSnapshot* snapshot = Snapshot.load(); \
+    while (Epoch.load() != epoch) \
+    { \
+        ActiveCalls[epoch & 1].fetch_sub(1); \
+        epoch = Epoch.load(); \
+        ActiveCalls[epoch & 1].fetch_add(1); \
+        snapshot = Snapshot.load(); \
+    } \
+    if (snapshot) \
     { \
-        Lock::Locker locker(&ListenersCacheForCalls[i]->ListenerLock); \
-        if (ListenersCacheForCalls[i]->Handler.IsValid()) \
+        const int count = snapshot->Listeners.GetSizeI(); \
+        for (int i = 0; i < count; ++i) \
         { \
-            ListenersCacheForCalls[i]->Handler params; /* Using a macro for this line. */ \
+            FloatingCallbackListener<DelegateT>* listener = snapshot->Listeners[i]; \
+            Lock::Locker locker(&listener->ListenerLock); \
+            if (listener->Handler.IsValid()) \
+            { \
+                listener->Handler params; /* Using a macro for this line. */ \
+            } \
         } \
-    }
+    } \
+    ActiveCalls[epoch & 1].fetch_sub(1);
 
 template<class DelegateT>
 void FloatingCallbackEmitter<DelegateT>::Call()
@@ -377,6 +377,28 @@ limitations under the License.
 #endif
 
 
+//-----------------------------------------------------------------------------------
+// ***** OVR_NO_SANITIZE_ADDRESS
+//
+// Excludes a function from AddressSanitizer instrumentation. This is for code that
+// deliberately reads memory it doesn't own but which can't fault, such as aligned
+// SIMD loads that run past the terminator of a string within the same page.
+// Expands to nothing when the compiler doesn't support it.
+//
+// Example usage:
+//     OVR_NO_SANITIZE_ADDRESS size_t FindTerminator(const char* str);
+//
+#if !defined(OVR_NO_SANITIZE_ADDRESS)
+    #if defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 8))))
+        #define OVR_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+    #elif defined(_MSC_VER) && defined(__SANITIZE_ADDRESS__)
+        #define OVR_NO_SANITIZE_ADDRESS __declspec(no_sanitize_address)
+    #else
+        #define OVR_NO_SANITIZE_ADDRESS
+    #endif
+#endif
+
+
 //-----------------------------------------------------------------------------------
 // ***** OVR_CPP11_ENABLED / OVR_CPP_CPP14_ENABLED
 //
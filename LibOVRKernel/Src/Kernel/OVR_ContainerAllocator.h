@@ -79,6 +79,17 @@ public:
         *(T*)p = source;
     }
 
+    static void ConstructMove(void *p, T&& source)
+    {
+        *(T*)p = source;
+    }
+
+    template <class... Args>
+    static void Emplace(void *p, Args&&... args)
+    {
+        OVR::ConstructEmplace<T>(p, std::forward<Args>(args)...);
+    }
+
     static void ConstructArray(void*, size_t)
     {}
 
@@ -110,6 +121,13 @@ public:
         memmove(dst, src, count * sizeof(T));
     }
 
+    // Moves count elements to uninitialized memory at dst, ending the lifetime of the sources.
+    // Bitwise relocation is intended here; the void casts keep -Wclass-memaccess quiet.
+    static void RelocateArray(T* dst, T* src, size_t count)
+    {
+        memcpy((void*)dst, (const void*)src, count * sizeof(T));
+    }
+
     static bool IsMovable()
     { return true; }
 };
@@ -140,6 +158,17 @@ public:
         OVR::ConstructAlt<T,S>(p, source);
     }
 
+    static void ConstructMove(void* p, T&& source)
+    {
+        OVR::ConstructMove<T>(p, std::move(source));
+    }
+
+    template <class... Args>
+    static void Emplace(void* p, Args&&... args)
+    {
+        OVR::ConstructEmplace<T>(p, std::forward<Args>(args)...);
+    }
+
     static void ConstructArray(void* p, size_t count)
     {
         uint8_t* pdata = (uint8_t*)p;
@@ -183,6 +212,14 @@ public:
         memmove(dst, src, count * sizeof(T));
     }
 
+    // Moves count elements to uninitialized memory at dst, ending the lifetime of the sources.
+    // Movable objects are trivially relocatable, so the bitwise copy is intended; the void
+    // casts keep -Wclass-memaccess quiet.
+    static void RelocateArray(T* dst, T* src, size_t count)
+    {
+        memcpy((void*)dst, (const void*)src, count * sizeof(T));
+    }
+
     static bool IsMovable()
     { return true; }
 };
@@ -213,6 +250,17 @@ public:
         OVR::ConstructAlt<T,S>(p, source);        
     }
 
+    static void ConstructMove(void* p, T&& source)
+    {
+        OVR::ConstructMove<T>(p, std::move(source));
+    }
+
+    template <class... Args>
+    static void Emplace(void* p, Args&&... args)
+    {
+        OVR::ConstructEmplace<T>(p, std::forward<Args>(args)...);
+    }
+
     static void ConstructArray(void* p, size_t count)
     {
         uint8_t* pdata = (uint8_t*)p;
@@ -258,6 +306,17 @@ public:
             dst[i-1] = src[i-1];
     }
 
+    // Moves count elements to uninitialized memory at dst, ending the lifetime of the sources.
+    // These objects can't be moved bitwise, so each one is move-constructed and destroyed.
+    static void RelocateArray(T* dst, T* src, size_t count)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            OVR::ConstructMove<T>(dst + i, std::move(src[i]));
+            src[i].~T();
+        }
+    }
+
     static bool IsMovable()
     { return false; }
 };
@@ -85,7 +85,24 @@ static char* PrintInt(int valueint)
     str = (char*)OVR_ALLOC(21);    // 2^64+1 can be represented in 21 chars.
     if (str)
     {
-        snprintf(str, 21, "%d", valueint);
+        // Write the digits backwards into a scratch buffer; this is called for every
+        // integral number we print, so it avoids the overhead of snprintf.
+        char     digits[12];
+        char*    p = digits;
+        unsigned magnitude = (valueint < 0) ? (0u - (unsigned)valueint) : (unsigned)valueint;
+
+        do
+        {
+            *p++ = (char)('0' + (magnitude % 10));
+            magnitude /= 10;
+        } while (magnitude);
+
+        char* out = str;
+        if (valueint < 0)
+            *out++ = '-';
+        while (p != digits)
+            *out++ = *--p;
+        *out = '\0';
     }
     return str;
 }
@@ -95,56 +112,15 @@ static char* PrintInt(int valueint)
 // Render the number from the given item into a string.
 static char* PrintNumber(double d)
 {
-    char *str;
-    int valueint = (int)d;
+    if ((d <= INT_MAX) && (d >= INT_MIN) && ((double)(int)d == d))
+        return PrintInt((int)d);
 
-    if ((fabs(((double)valueint)-d) <= DBL_EPSILON) && (d <= INT_MAX) && (d >= INT_MIN))
-    {
-        return PrintInt(valueint);
-    }
-    else
-    {
-        const size_t kCapacity = 64;
-
-        str=(char*)OVR_ALLOC(kCapacity);    // This is a nice tradeoff.
-        if (str)
-        {
-            // The JSON Standard, section 7.8.3, specifies that decimals are always expressed with '.' and 
-            // not some locale-specific decimal such as ',' or ' '. However, since we are using the C standard
-            // library below to write a floating point number, we need to make sure that it's writing a '.' 
-            // and not something else. We can't change the locale (even temporarily) here, as it will affect 
-            // the whole process by default. That are compiler-specific ways to change this per-thread, but 
-            // below we implement the simple solution of simply fixing the decimal after the string was written.
-
-            if ((fabs(floor(d) - d) <= DBL_EPSILON) && (fabs(d) < 1.0e60))
-            {
-                // Write integral values with no decimals
-                snprintf(str, kCapacity, "%.0f", d);
-            }
-            else if ((fabs(d) < 1.0) || (fabs(d) > 1.0e9))
-            {
-                // Write numbers < 1 or larger than 1e9 with 7 significant digits
-                snprintf(str, kCapacity, "%.7g", d);
-            }
-            else
-            {
-                // Write numbers >= 1 and <= 1e9 with 6 decimals (7 to 15 sig digits)
-                snprintf(str, kCapacity, "%.6f", d);
-            }
-
-            // Convert any found ',' or ''' char to '.'. This will happen only if the locale was set to write a ',' 
-            // instead of a '.' for the decimal point. Decimal points are represented only by one of these
-            // three characters in practice.
-            for(char* p = str; *p; p++)
-            {
-                if((*p == ',') || (*p == '\''))
-                {
-                    *p = '.';
-                    break;
-                }
-            }
-        }
-    }
+    // OVR_dtoa writes the shortest digits which read back as the identical double, and always
+    // uses '.' as the decimal separator, as the JSON Standard (section 7.8.3) requires regardless
+    // of the current locale.
+    char* str = (char*)OVR_ALLOC(OVR_dtoaMaxSize);
+    if (str)
+        OVR_dtoa(d, str, OVR_dtoaMaxSize);
     return str;
 }
 
@@ -185,74 +161,44 @@ JSON::~JSON()
 const char* JSON::parseNumber(const char *num)
 {
     const char* num_start = num;
-    double      n=0, scale=0;
-    int         subscale     = 0,
-                signsubscale = 1;
-    bool        positiveSign = true;
     const char  decimalSeparator = '.';  // The JSON standard specifies that numbers use '.' regardless of locale.
 
-    // Could use sscanf for this?
+    // Find the end of the number, following the JSON grammar.
     if (*num == '-')
-    {
-        positiveSign = false;
         num++;    // Has sign?
-    }
+
     if (*num == '0')
     {
         num++;            // is zero
     }
-
-    if (*num>='1' && *num<='9')    
+    else
     {
-        do
-        {
-            n = (n*10.0) + (*num++ - '0');
-        }
-        while (*num>='0' && *num<='9');    // Number?
+        while (*num>='0' && *num<='9')
+            num++;    // Number?
     }
 
-    if ((*num=='.' || *num==decimalSeparator) && num[1]>='0' && num[1]<='9')
+    if (*num==decimalSeparator && num[1]>='0' && num[1]<='9')
     {
-        num++;
-        do
-        {
-            n=(n*10.0)+(*num++ -'0');
-            scale--;
-        }
-        while (*num>='0' && *num<='9');  // Fractional part?
+        num += 2;
+        while (*num>='0' && *num<='9')
+            num++;  // Fractional part?
     }
 
     if (*num=='e' || *num=='E')        // Exponent?
     {
         num++;
-        if (*num == '+')
-        {
-            num++;
-        }
-        else if (*num=='-')
-        {
-            signsubscale=-1;
+        if (*num=='+' || *num=='-')
             num++;        // With sign?
-        }
-
-        while (*num >= '0' && *num <= '9')
-        {
-            subscale = (subscale * 10) + (*num++ - '0');    // Number?
-        }
-    }
 
-    // Number = +/- number.fraction * 10^+/- exponent
-    n *= pow(10.0, (scale + subscale*signsubscale));
-
-    if (!positiveSign)
-    {
-        n = -n;
+        while (*num>='0' && *num<='9')
+            num++;
     }
 
-    // Assign parsed value.
+    // Assign parsed value. Converting the copied token rather than the input keeps OVR_strtod
+    // from accepting forms JSON doesn't allow, such as hex or "inf".
     Type = JSON_Number;
-    dValue = n;
     Value.AssignString(num_start, num - num_start);
+    dValue = OVR_strtod(Value.ToCStr(), nullptr);
 
     return num;
 }
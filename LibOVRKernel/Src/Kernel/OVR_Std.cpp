@@ -27,8 +27,9 @@ limitations under the License.
 #include "OVR_Std.h"
 #include "OVR_Alg.h"
 
-// localeconv() call in OVR_strtod()
-#include <locale.h>
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
 
 namespace OVR {
 
@@ -328,48 +329,1256 @@ int OVR_CDECL OVR_wcsicmp(const wchar_t* a, const wchar_t* b)
 #endif
 }
 
-// This function is not inline because of dependency on <locale.h>
-double OVR_CDECL OVR_strtod(const char* str, char** tailptr)
+//-----------------------------------------------------------------------------
+// Number conversion
+//
+// The CRT conversions depend on the decimal separator of the current C locale, which
+// breaks reading our data files under e.g. a German locale. The versions below always
+// use '.', parse in place and never allocate.
+
+namespace {
+
+bool IsConversionSpace(char c)
+{
+    return (c == ' ') || ((c >= '\t') && (c <= '\r'));
+}
+
+// Returns the value of c as a digit in bases up to 36, or 36 if it isn't one.
+unsigned DigitValue(char c)
 {
-#if !defined(OVR_OS_ANDROID) // The Android C library doesn't have localeconv.
-    const char s = *localeconv()->decimal_point;
+    if ((unsigned)(c - '0') < 10)
+        return (unsigned)(c - '0');
+    if ((unsigned)((c | 0x20) - 'a') < 26)
+        return (unsigned)((c | 0x20) - 'a') + 10;
+    return 36;
+}
 
-    // Always do the locale switch to spot problem files early.
+// Case-insensitively matches the lower case word at str.
+bool MatchWord(const char* str, const char* word)
+{
+    for (; *word; ++str, ++word)
     {
-        // I don't know why 347, that's just what was in this code before I got here.
-        const int MaxStringLength = 347;
-        OVR_ASSERT ( OVR_strlen ( str ) <= MaxStringLength );
-        char buffer[MaxStringLength + 1];
-        OVR_strcpy(buffer, sizeof(buffer), str);
+        if ((*str | 0x20) != *word)
+            return false;
+    }
+    return true;
+}
+
+// 1e0 - 1e22 are exactly representable; the rest are correctly rounded by the compiler.
+const double PowersOf10[32] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22, 1e23,
+    1e24, 1e25, 1e26, 1e27, 1e28, 1e29, 1e30, 1e31
+};
 
-        // Ensure null-termination of string
-        buffer[sizeof(buffer)-1] = '\0';
+const double PowersOf10By32[10] =
+{
+    1e0, 1e32, 1e64, 1e96, 1e128, 1e160, 1e192, 1e224, 1e256, 1e288
+};
+
+const double NegativePowersOf10By32[10] =
+{
+    1e0, 1e-32, 1e-64, 1e-96, 1e-128, 1e-160, 1e-192, 1e-224, 1e-256, 1e-288
+};
+
+const int      MaxExactPowerOf10 = 22;
+const uint64_t MaxExactMantissa  = (uint64_t(1) << 53);
+
+// Doubles are handled below as Mantissa * 2^Exponent, with Mantissa < 2^53 and
+// Exponent >= -1074. Mantissa >= 2^52 for normal numbers, so that stepping
+// Mantissa by one always moves to the adjacent double, and infinity is 2^52 * 2^972.
+const uint64_t HiddenBit       = (uint64_t(1) << 52);
+const int      MinExponent     = -1074;
+const int      InfinityExponent = 972;
 
-        for (char* c = buffer; *c != '\0'; ++c)
+void DoubleToParts(double d, uint64_t& mantissa, int& exponent)
+{
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+
+    int biasedExponent = (int)((bits >> 52) & 0x7FF);
+    mantissa = bits & (HiddenBit - 1);
+
+    if (biasedExponent == 0)
+    {
+        exponent = MinExponent;
+    }
+    else
+    {
+        mantissa |= HiddenBit;
+        exponent  = biasedExponent - 1075;
+    }
+}
+
+double PartsToDouble(uint64_t mantissa, int exponent, bool negative)
+{
+    uint64_t bits = (mantissa < HiddenBit) ? mantissa :
+                    ((uint64_t)(exponent + 1075) << 52) | (mantissa & (HiddenBit - 1));
+    if (negative)
+        bits |= (uint64_t(1) << 63);
+
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+// Rounds mantissa * 2^exponent to the nearest double (ties to even). sticky means
+// that nonzero bits below mantissa were dropped, so ties round up.
+void RoundBinary(uint64_t& mantissa, int& exponent, bool sticky)
+{
+    if (mantissa == 0)
+    {
+        exponent = MinExponent;
+        return;
+    }
+
+    int bits = 64;
+    while (!(mantissa & (uint64_t(1) << (bits - 1))))
+        --bits;
+
+    int shift = bits - 53;
+    if ((exponent + shift) < MinExponent)
+        shift = MinExponent - exponent;
+
+    if (shift <= 0)
+    {
+        // Exact; shift is bounded by the 53 bit normalization above.
+        mantissa <<= -shift;
+        exponent += shift;
+    }
+    else if (shift >= 64)
+    {
+        // Everything is below half of the smallest subnormal, except for mantissa >= 2^63
+        // exactly at shift 64, which is half of it and rounds to even (zero) unless sticky.
+        bool roundUp = (shift == 64) && (mantissa > (uint64_t(1) << 63) ||
+                                         ((mantissa == (uint64_t(1) << 63)) && sticky));
+        mantissa = roundUp ? 1 : 0;
+        exponent = MinExponent;
+    }
+    else
+    {
+        uint64_t dropped = mantissa & ((uint64_t(1) << shift) - 1);
+        uint64_t half    = uint64_t(1) << (shift - 1);
+
+        mantissa >>= shift;
+        exponent += shift;
+
+        if ((dropped > half) || ((dropped == half) && (sticky || (mantissa & 1))))
         {
-            if (*c == '.')
+            if (++mantissa == MaxExactMantissa)
             {
-                *c = s;
-                break;
+                mantissa = HiddenBit;
+                exponent++;
+            }
+        }
+    }
+
+    if (exponent >= InfinityExponent)
+    {
+        mantissa = HiddenBit;
+        exponent = InfinityExponent;
+    }
+}
+
+
+// Splits a into two halves of at most 26 significant bits, whose products are exact (Dekker).
+void SplitDouble(double a, double& hi, double& lo)
+{
+    double c = 134217729.0 * a; // 2^27 + 1
+    hi = c - (c - a);
+    lo = a - hi;
+}
+
+// Computes product + error == a * b exactly.
+void TwoProduct(double a, double b, double& product, double& error)
+{
+    double ah, al, bh, bl;
+    product = a * b;
+    SplitDouble(a, ah, al);
+    SplitDouble(b, bh, bl);
+    error = ((ah * bh - product) + ah * bl + al * bh) + al * bl;
+}
+
+// Converts mantissa * 10^exponent10 for 19 digit mantissas, which are too long for the
+// exact fast path, using double-double arithmetic. This is accurate to about 2^-90, so
+// it decides the rounding unless the value is within that of a midpoint between doubles.
+// Returns false in that case.
+bool DecimalToDoubleExtended(uint64_t mantissa, int exponent10, double& result)
+{
+    if ((exponent10 < -MaxExactPowerOf10) || (exponent10 > MaxExactPowerOf10))
+        return false;
+
+    // mantissa == hi + lo exactly, with |lo| <= 2^10.
+    double hi    = (double)mantissa;
+    double lo    = (double)(int64_t)(mantissa - (uint64_t)hi);
+    double power = PowersOf10[(exponent10 < 0) ? -exponent10 : exponent10];
+    double approx, correction;
+
+    if (exponent10 >= 0)
+    {
+        double error;
+        TwoProduct(hi, power, approx, error);
+        correction = error + lo * power;
+    }
+    else
+    {
+        // The remainder of hi / power is exact up to the rounding of error.
+        double product, error;
+        approx = hi / power;
+        TwoProduct(approx, power, product, error);
+        correction = (((hi - product) - error) + lo) / power;
+    }
+
+    double sum           = approx + correction;
+    double roundingError = correction - (sum - approx);
+
+    uint64_t m;
+    int      e;
+    DoubleToParts(sum, m, e);
+
+    // Below a power of two the half ulp is smaller; just leave those to the exact path.
+    if ((m == HiddenBit) && (roundingError < 0))
+        return false;
+
+    const double Tolerance = 8.0779356694631609e-28; // 2^-90
+    double       halfUlp   = PartsToDouble(HiddenBit, e - 53, false);
+
+    if (fabs(roundingError) >= (halfUlp - sum * Tolerance))
+        return false;
+
+    result = sum;
+    return true;
+}
+
+
+// Fixed capacity unsigned big integer, enough for the exact comparisons in OVR_strtod.
+// The largest operand there is about 4700 bits.
+class DecimalBigInt
+{
+public:
+    enum { MaxLimbs = 200 };
+
+    DecimalBigInt() : Count(0) { }
+
+    void Set(uint64_t value)
+    {
+        Count = 0;
+        while (value)
+        {
+            Limbs[Count++] = (uint32_t)value;
+            value >>= 32;
+        }
+    }
+
+    // this = this * multiplier + addend
+    void MulAdd(uint32_t multiplier, uint32_t addend)
+    {
+        uint64_t carry = addend;
+        for (int i = 0; i < Count; ++i)
+        {
+            uint64_t product = (uint64_t)Limbs[i] * multiplier + carry;
+            Limbs[i] = (uint32_t)product;
+            carry    = product >> 32;
+        }
+        if (carry)
+            Append((uint32_t)carry);
+    }
+
+    void MulPow5(int power)
+    {
+        const uint32_t Pow5_13 = 1220703125; // Largest power of 5 which fits in 32 bits.
+        const uint32_t SmallPowersOf5[13] =
+        {
+            1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625
+        };
+
+        for (; power >= 13; power -= 13)
+            MulAdd(Pow5_13, 0);
+        if (power > 0)
+            MulAdd(SmallPowersOf5[power], 0);
+    }
+
+    void ShiftLeft(int bits)
+    {
+        if (Count == 0)
+            return;
+
+        int limbShift = bits / 32;
+        int bitShift  = bits % 32;
+
+        if (bitShift)
+        {
+            uint32_t carry = 0;
+            for (int i = 0; i < Count; ++i)
+            {
+                uint32_t limb = Limbs[i];
+                Limbs[i] = (limb << bitShift) | carry;
+                carry    = limb >> (32 - bitShift);
+            }
+            if (carry)
+                Append(carry);
+        }
+
+        if (limbShift)
+        {
+            OVR_ASSERT((Count + limbShift) <= MaxLimbs);
+            memmove(Limbs + limbShift, Limbs, Count * sizeof(uint32_t));
+            memset(Limbs, 0, limbShift * sizeof(uint32_t));
+            Count += limbShift;
+        }
+    }
+
+    static int Compare(const DecimalBigInt& a, const DecimalBigInt& b)
+    {
+        if (a.Count != b.Count)
+            return (a.Count < b.Count) ? -1 : 1;
+
+        for (int i = a.Count - 1; i >= 0; --i)
+        {
+            if (a.Limbs[i] != b.Limbs[i])
+                return (a.Limbs[i] < b.Limbs[i]) ? -1 : 1;
+        }
+        return 0;
+    }
+
+private:
+    void Append(uint32_t limb)
+    {
+        OVR_ASSERT(Count < MaxLimbs);
+        if (Count < MaxLimbs)
+            Limbs[Count++] = limb;
+    }
+
+    uint32_t Limbs[MaxLimbs];
+    int      Count;
+};
+
+// Compares digits * 10^power10 with the midpoint between mantissa * 2^exponent and
+// the next double up.
+int CompareToMidpoint(const DecimalBigInt& digits, int power10, uint64_t mantissa, int exponent)
+{
+    DecimalBigInt lhs(digits), rhs;
+    rhs.Set(2 * mantissa + 1);
+
+    if (power10 >= 0)
+        lhs.MulPow5(power10);
+    else
+        rhs.MulPow5(-power10);
+
+    int power2 = power10 - (exponent - 1);
+    if (power2 >= 0)
+        lhs.ShiftLeft(power2);
+    else
+        rhs.ShiftLeft(-power2);
+
+    return DecimalBigInt::Compare(lhs, rhs);
+}
+
+// Decimal significands longer than this are truncated, remembering whether any nonzero
+// digit was dropped. Midpoints between doubles have at most 767 significant digits, so
+// this doesn't change which side of a midpoint the value lies on.
+const int MaxDecimalDigits = 780;
+
+// Parses the decimal number at str (after the sign), returning the end of it, or str
+// if there are no digits.
+const char* ParseDecimal(const char* str, bool negative, double& result)
+{
+    const uint64_t MaxMantissaBeforeAppend = 1000000000000000000ULL; // 10^18
+
+    const char* p = str;
+    uint64_t    mantissa = 0;       // The first (up to) 19 significant digits.
+    int         mantissaDigits = 0;
+    int         exponent10 = 0;     // Of the last digit in mantissa.
+    int         significantDigits = 0;
+    bool        truncated = false;  // Nonzero digits were dropped from mantissa.
+    bool        anyDigits = false;
+
+    const char* digitsBegin = NULL; // First significant digit, for the exact path.
+
+    for (; (unsigned)(*p - '0') < 10; ++p)
+    {
+        anyDigits = true;
+        if (mantissa == 0 && *p == '0')
+            continue;
+
+        if (!digitsBegin)
+            digitsBegin = p;
+        significantDigits++;
+
+        if (mantissa < MaxMantissaBeforeAppend)
+        {
+            mantissa = (mantissa * 10) + (unsigned)(*p - '0');
+            mantissaDigits++;
+        }
+        else
+        {
+            exponent10++;
+            truncated |= (*p != '0');
+        }
+    }
+
+    if (*p == '.')
+    {
+        const char* fraction = p + 1;
+        if (anyDigits || ((unsigned)(*fraction - '0') < 10))
+        {
+            p = fraction;
+            for (; (unsigned)(*p - '0') < 10; ++p)
+            {
+                anyDigits = true;
+                if (mantissa == 0 && *p == '0')
+                {
+                    exponent10--;
+                    continue;
+                }
+
+                if (!digitsBegin)
+                    digitsBegin = p;
+                significantDigits++;
+
+                if (mantissa < MaxMantissaBeforeAppend)
+                {
+                    mantissa = (mantissa * 10) + (unsigned)(*p - '0');
+                    mantissaDigits++;
+                    exponent10--;
+                }
+                else
+                {
+                    truncated |= (*p != '0');
+                }
+            }
+        }
+    }
+
+    if (!anyDigits)
+        return str;
+
+    if ((*p | 0x20) == 'e')
+    {
+        const char* e = p + 1;
+        bool        negativeExponent = false;
+
+        if (*e == '+' || *e == '-')
+            negativeExponent = (*e++ == '-');
+
+        if ((unsigned)(*e - '0') < 10)
+        {
+            int explicitExponent = 0;
+            for (; (unsigned)(*e - '0') < 10; ++e)
+            {
+                if (explicitExponent < 100000) // Anything larger is already out of double range.
+                    explicitExponent = (explicitExponent * 10) + (*e - '0');
+            }
+            exponent10 += negativeExponent ? -explicitExponent : explicitExponent;
+            p = e;
+        }
+    }
+
+    if (mantissa == 0)
+    {
+        result = negative ? -0.0 : 0.0;
+        return p;
+    }
+
+    // Fast path: the mantissa and power of ten are both exact doubles, so a single
+    // multiply or divide gives the correctly rounded result (Clinger's algorithm).
+    if (!truncated && (mantissa <= MaxExactMantissa))
+    {
+        double n = (double)mantissa;
+        bool   exact = true;
+
+        if (exponent10 < 0)
+        {
+            if (exponent10 >= -MaxExactPowerOf10)
+                n /= PowersOf10[-exponent10];
+            else
+                exact = false;
+        }
+        else if (exponent10 <= MaxExactPowerOf10)
+        {
+            n *= PowersOf10[exponent10];
+        }
+        else
+        {
+            // Values such as 12e30 are still exact if the excess power of ten can be
+            // moved into the mantissa without exceeding 2^53.
+            int excess = exponent10 - MaxExactPowerOf10;
+            if ((excess <= 15) && (mantissa <= (MaxExactMantissa / (uint64_t)PowersOf10[excess])))
+                n = (double)(mantissa * (uint64_t)PowersOf10[excess]) * PowersOf10[MaxExactPowerOf10];
+            else
+                exact = false;
+        }
+
+        if (exact)
+        {
+            result = negative ? -n : n;
+            return p;
+        }
+    }
+
+    if (!truncated && DecimalToDoubleExtended(mantissa, exponent10, result))
+    {
+        if (negative)
+            result = -result;
+        return p;
+    }
+
+    // The leading digit is at 10^leadExponent. Beyond these bounds the value is
+    // certainly below half of the smallest subnormal, or above the largest double.
+    int leadExponent = exponent10 + mantissaDigits - 1;
+    if (leadExponent < -325)
+    {
+        result = negative ? -0.0 : 0.0;
+        errno = ERANGE;
+        return p;
+    }
+    if (leadExponent > 309)
+    {
+        result = negative ? -HUGE_VAL : HUGE_VAL;
+        errno = ERANGE;
+        return p;
+    }
+
+    // Estimate the result from the first 19 digits. The few roundings in here leave it
+    // within a couple of units in the last place of the correct result.
+    double estimate = (double)mantissa;
+    if (exponent10 >= 0)
+    {
+        estimate *= PowersOf10[exponent10 % 32];
+        estimate *= PowersOf10By32[exponent10 / 32];
+    }
+    else
+    {
+        int power = -exponent10;
+        estimate /= PowersOf10[power % 32];
+        if (power >= 320)
+        {
+            estimate *= NegativePowersOf10By32[9];
+            power    -= 288;
+        }
+        estimate *= NegativePowersOf10By32[power / 32];
+    }
+
+    // Load the exact (or, past MaxDecimalDigits, truncated) significand.
+    DecimalBigInt digits;
+    int           power10 = exponent10 + (mantissaDigits - Alg::Min(significantDigits, MaxDecimalDigits));
+    bool          sticky  = false;
+
+    {
+        uint32_t chunk = 0, chunkMultiplier = 1;
+        int      loaded = 0;
+
+        for (const char* d = digitsBegin; (loaded < significantDigits); ++d)
+        {
+            if (*d == '.')
+                continue;
+
+            if (loaded >= MaxDecimalDigits)
+            {
+                sticky |= (*d != '0');
+                ++loaded;
+                continue;
+            }
+
+            chunk = (chunk * 10) + (unsigned)(*d - '0');
+            chunkMultiplier *= 10;
+            ++loaded;
+
+            if (chunkMultiplier == 1000000000)
+            {
+                digits.MulAdd(chunkMultiplier, chunk);
+                chunk = 0;
+                chunkMultiplier = 1;
+            }
+        }
+
+        if (chunkMultiplier != 1)
+            digits.MulAdd(chunkMultiplier, chunk);
+    }
+
+    // Step the estimate to the double whose rounding interval contains the value.
+    uint64_t m;
+    int      e;
+    DoubleToParts(estimate, m, e);
+
+    for (;;)
+    {
+        if (e < InfinityExponent)
+        {
+            int c = CompareToMidpoint(digits, power10, m, e);
+            if ((c > 0) || ((c == 0) && (sticky || (m & 1))))
+            {
+                if (++m == MaxExactMantissa)
+                {
+                    m = HiddenBit;
+                    e++;
+                }
+                continue;
+            }
+        }
+
+        if (m != 0)
+        {
+            uint64_t downMantissa = m - 1;
+            int      downExponent = e;
+            if ((downMantissa < HiddenBit) && (e > MinExponent))
+            {
+                downMantissa = MaxExactMantissa - 1;
+                downExponent = e - 1;
+            }
+
+            int c = CompareToMidpoint(digits, power10, downMantissa, downExponent);
+            if ((c < 0) || ((c == 0) && !sticky && (m & 1)))
+            {
+                m = downMantissa;
+                e = downExponent;
+                continue;
             }
         }
 
-        char *nextPtr = NULL;
-        double retval = strtod(buffer, &nextPtr);
+        break;
+    }
+
+    if ((e >= InfinityExponent) || (m < HiddenBit))
+        errno = ERANGE;
+
+    result = PartsToDouble(m, e, negative);
+    return p;
+}
+
+// Parses the hexadecimal floating point number at str (after the "0x"), returning the
+// end of it, or str if there are no digits.
+const char* ParseHexadecimal(const char* str, bool negative, double& result)
+{
+    const char* p = str;
+    uint64_t    mantissa = 0;
+    int         exponent2 = 0;
+    bool        sticky = false;
+    bool        anyDigits = false;
+    bool        fraction = false;
+
+    for (;; ++p)
+    {
+        if (*p == '.' && !fraction)
+        {
+            fraction = true;
+            continue;
+        }
+
+        unsigned digit = DigitValue(*p);
+        if (digit >= 16)
+            break;
+
+        anyDigits = true;
+        if (mantissa < (uint64_t(1) << 60))
+        {
+            mantissa = (mantissa << 4) | digit;
+            if (fraction)
+                exponent2 -= 4;
+        }
+        else
+        {
+            sticky |= (digit != 0);
+            if (!fraction)
+                exponent2 += 4;
+        }
+    }
+
+    if (!anyDigits)
+        return str;
+
+    if ((*p | 0x20) == 'p')
+    {
+        const char* e = p + 1;
+        bool        negativeExponent = false;
+
+        if (*e == '+' || *e == '-')
+            negativeExponent = (*e++ == '-');
+
+        if ((unsigned)(*e - '0') < 10)
+        {
+            int explicitExponent = 0;
+            for (; (unsigned)(*e - '0') < 10; ++e)
+            {
+                if (explicitExponent < 100000)
+                    explicitExponent = (explicitExponent * 10) + (*e - '0');
+            }
+            exponent2 += negativeExponent ? -explicitExponent : explicitExponent;
+            p = e;
+        }
+    }
 
-        // If a tail pointer is requested,
+    bool nonzero = (mantissa != 0) || sticky;
+
+    // Keep the exponent well inside int range for RoundBinary.
+    if (mantissa && (exponent2 > 2000))
+    {
+        mantissa  = HiddenBit;
+        exponent2 = InfinityExponent;
+    }
+    else if (mantissa && (exponent2 < -2000))
+    {
+        mantissa  = 0;
+    }
+
+    RoundBinary(mantissa, exponent2, sticky);
+
+    if ((exponent2 >= InfinityExponent) || (nonzero && (mantissa < HiddenBit)))
+        errno = ERANGE;
+
+    result = PartsToDouble(mantissa, exponent2, negative);
+    return p;
+}
+
+// Shared by the integer parsers. Returns the magnitude, saturated at UINT64_MAX.
+uint64_t ParseInteger(const char* str, char** tailptr, int radix, bool& negative, bool& overflow)
+{
+    const char* p = str;
+    negative = false;
+    overflow = false;
+
+    while (IsConversionSpace(*p))
+        ++p;
+
+    if (*p == '+' || *p == '-')
+        negative = (*p++ == '-');
+
+    if ((radix == 0 || radix == 16) && (p[0] == '0') && ((p[1] | 0x20) == 'x') && (DigitValue(p[2]) < 16))
+    {
+        p += 2;
+        radix = 16;
+    }
+    else if (radix == 0)
+    {
+        radix = (*p == '0') ? 8 : 10;
+    }
+
+    const char* digitsBegin = p;
+    uint64_t    value = 0;
+
+    if ((radix >= 2) && (radix <= 36))
+    {
+        const uint64_t maxBeforeMultiply = UINT64_MAX / (unsigned)radix;
+        const unsigned maxLastDigit      = (unsigned)(UINT64_MAX % (unsigned)radix);
+
+        for (unsigned digit; (digit = DigitValue(*p)) < (unsigned)radix; ++p)
+        {
+            if ((value < maxBeforeMultiply) || ((value == maxBeforeMultiply) && (digit <= maxLastDigit)))
+                value = (value * (unsigned)radix) + digit;
+            else
+                overflow = true;
+        }
+    }
+
+    if (p == digitsBegin)
+    {
+        // No conversion could be performed.
         if (tailptr)
+            *tailptr = const_cast<char*>(str);
+        negative = false;
+        return 0;
+    }
+
+    if (tailptr)
+        *tailptr = const_cast<char*>(p);
+
+    if (overflow)
+        value = UINT64_MAX;
+    return value;
+}
+
+template <typename T>
+T ParseSigned(const char* str, char** tailptr, int radix, T minValue, T maxValue)
+{
+    bool     negative, overflow;
+    uint64_t magnitude = ParseInteger(str, tailptr, radix, negative, overflow);
+    uint64_t limit     = negative ? ((uint64_t)-(minValue + 1) + 1) : (uint64_t)maxValue;
+
+    if (overflow || (magnitude > limit))
+    {
+        errno = ERANGE;
+        return negative ? minValue : maxValue;
+    }
+
+    return negative ? (T)(0 - magnitude) : (T)magnitude;
+}
+
+template <typename T>
+T ParseUnsigned(const char* str, char** tailptr, int radix, T maxValue)
+{
+    bool     negative, overflow;
+    uint64_t magnitude = ParseInteger(str, tailptr, radix, negative, overflow);
+
+    if (overflow || (magnitude > (uint64_t)maxValue))
+    {
+        errno = ERANGE;
+        return maxValue;
+    }
+
+    // Like strtoul, a leading '-' negates the result in the unsigned type.
+    return negative ? (T)(0 - (T)magnitude) : (T)magnitude;
+}
+
+// Writes the digits of magnitude, with a leading '-' if negative. Writes an empty
+// string if radix is invalid or dest is too small.
+char* FormatInteger(uint64_t magnitude, bool negative, char* dest, size_t destsize, int radix)
+{
+    static const char DigitChars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    static const char DigitPairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    char  buffer[66]; // 64 binary digits, sign and null terminator.
+    char* p = buffer + sizeof(buffer);
+    *--p = '\0';
+
+    if ((radix < 2) || (radix > 36))
+    {
+        p = buffer + sizeof(buffer) - 1;
+    }
+    else if (radix == 10)
+    {
+        // Two digits per division.
+        while (magnitude >= 100)
+        {
+            unsigned pair = (unsigned)(magnitude % 100);
+            magnitude /= 100;
+            *--p = DigitPairs[pair * 2 + 1];
+            *--p = DigitPairs[pair * 2];
+        }
+        if (magnitude >= 10)
         {
-            // Return a tail pointer that points to the same offset as nextPtr, in the orig string
-            *tailptr = !nextPtr ? NULL : (char*)str + (int)(nextPtr - buffer);
+            *--p = DigitPairs[magnitude * 2 + 1];
+            *--p = DigitPairs[magnitude * 2];
+        }
+        else
+        {
+            *--p = (char)('0' + magnitude);
         }
 
-        return retval;
+        if (negative)
+            *--p = '-';
     }
-#else
-    return strtod(str, tailptr);
-#endif
+    else
+    {
+        do
+        {
+            *--p = DigitChars[magnitude % (unsigned)radix];
+            magnitude /= (unsigned)radix;
+        } while (magnitude);
+
+        if (negative)
+            *--p = '-';
+    }
+
+    size_t size = (size_t)(buffer + sizeof(buffer) - p); // Including the null terminator.
+
+    if (size <= destsize)
+        memcpy(dest, p, size);
+    else if (destsize > 0)
+        dest[0] = '\0';
+
+    return dest;
+}
+
+//-----------------------------------------------------------------------------
+// Shortest round-trip double formatting, using Florian Loitsch's Grisu2 ("Printing
+// Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010). The digits
+// always read back as the same double, and for about 99.9% of doubles they are also
+// the shortest digits which do; the rest get one digit more than necessary.
+
+// Floating point value F * 2^E without an implicit bit.
+struct DiyFp
+{
+    uint64_t F;
+    int      E;
+
+    DiyFp(uint64_t f, int e) : F(f), E(e) {}
+};
+
+DiyFp Normalize(DiyFp v)
+{
+    while (!(v.F & (uint64_t(1) << 63)))
+    {
+        v.F <<= 1;
+        v.E--;
+    }
+    return v;
+}
+
+// Returns the upper 64 bits of the 128-bit product, rounded.
+DiyFp Multiply(const DiyFp& x, const DiyFp& y)
+{
+    const uint64_t M32 = 0xFFFFFFFFu;
+    uint64_t a = x.F >> 32, b = x.F & M32;
+    uint64_t c = y.F >> 32, d = y.F & M32;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t mid = (bd >> 32) + (ad & M32) + (bc & M32) + (uint64_t(1) << 31);
+    return DiyFp(ac + (ad >> 32) + (bc >> 32) + (mid >> 32), x.E + y.E + 64);
+}
 
+// Normalized 10^k for k = -348, -340, ..., 340, rounded to 64 bits.
+const struct { uint64_t F; int E; } CachedPowersOf10[] =
+{
+    { 0xFA8FD5A0081C0288ULL, -1220 }, { 0xBAAEE17FA23EBF76ULL, -1193 },
+    { 0x8B16FB203055AC76ULL, -1166 }, { 0xCF42894A5DCE35EAULL, -1140 },
+    { 0x9A6BB0AA55653B2DULL, -1113 }, { 0xE61ACF033D1A45DFULL, -1087 },
+    { 0xAB70FE17C79AC6CAULL, -1060 }, { 0xFF77B1FCBEBCDC4FULL, -1034 },
+    { 0xBE5691EF416BD60CULL, -1007 }, { 0x8DD01FAD907FFC3CULL,  -980 },
+    { 0xD3515C2831559A83ULL,  -954 }, { 0x9D71AC8FADA6C9B5ULL,  -927 },
+    { 0xEA9C227723EE8BCBULL,  -901 }, { 0xAECC49914078536DULL,  -874 },
+    { 0x823C12795DB6CE57ULL,  -847 }, { 0xC21094364DFB5637ULL,  -821 },
+    { 0x9096EA6F3848984FULL,  -794 }, { 0xD77485CB25823AC7ULL,  -768 },
+    { 0xA086CFCD97BF97F4ULL,  -741 }, { 0xEF340A98172AACE5ULL,  -715 },
+    { 0xB23867FB2A35B28EULL,  -688 }, { 0x84C8D4DFD2C63F3BULL,  -661 },
+    { 0xC5DD44271AD3CDBAULL,  -635 }, { 0x936B9FCEBB25C996ULL,  -608 },
+    { 0xDBAC6C247D62A584ULL,  -582 }, { 0xA3AB66580D5FDAF6ULL,  -555 },
+    { 0xF3E2F893DEC3F126ULL,  -529 }, { 0xB5B5ADA8AAFF80B8ULL,  -502 },
+    { 0x87625F056C7C4A8BULL,  -475 }, { 0xC9BCFF6034C13053ULL,  -449 },
+    { 0x964E858C91BA2655ULL,  -422 }, { 0xDFF9772470297EBDULL,  -396 },
+    { 0xA6DFBD9FB8E5B88FULL,  -369 }, { 0xF8A95FCF88747D94ULL,  -343 },
+    { 0xB94470938FA89BCFULL,  -316 }, { 0x8A08F0F8BF0F156BULL,  -289 },
+    { 0xCDB02555653131B6ULL,  -263 }, { 0x993FE2C6D07B7FACULL,  -236 },
+    { 0xE45C10C42A2B3B06ULL,  -210 }, { 0xAA242499697392D3ULL,  -183 },
+    { 0xFD87B5F28300CA0EULL,  -157 }, { 0xBCE5086492111AEBULL,  -130 },
+    { 0x8CBCCC096F5088CCULL,  -103 }, { 0xD1B71758E219652CULL,   -77 },
+    { 0x9C40000000000000ULL,   -50 }, { 0xE8D4A51000000000ULL,   -24 },
+    { 0xAD78EBC5AC620000ULL,     3 }, { 0x813F3978F8940984ULL,    30 },
+    { 0xC097CE7BC90715B3ULL,    56 }, { 0x8F7E32CE7BEA5C70ULL,    83 },
+    { 0xD5D238A4ABE98068ULL,   109 }, { 0x9F4F2726179A2245ULL,   136 },
+    { 0xED63A231D4C4FB27ULL,   162 }, { 0xB0DE65388CC8ADA8ULL,   189 },
+    { 0x83C7088E1AAB65DBULL,   216 }, { 0xC45D1DF942711D9AULL,   242 },
+    { 0x924D692CA61BE758ULL,   269 }, { 0xDA01EE641A708DEAULL,   295 },
+    { 0xA26DA3999AEF774AULL,   322 }, { 0xF209787BB47D6B85ULL,   348 },
+    { 0xB454E4A179DD1877ULL,   375 }, { 0x865B86925B9BC5C2ULL,   402 },
+    { 0xC83553C5C8965D3DULL,   428 }, { 0x952AB45CFA97A0B3ULL,   455 },
+    { 0xDE469FBD99A05FE3ULL,   481 }, { 0xA59BC234DB398C25ULL,   508 },
+    { 0xF6C69A72A3989F5CULL,   534 }, { 0xB7DCBF5354E9BECEULL,   561 },
+    { 0x88FCF317F22241E2ULL,   588 }, { 0xCC20CE9BD35C78A5ULL,   614 },
+    { 0x98165AF37B2153DFULL,   641 }, { 0xE2A0B5DC971F303AULL,   667 },
+    { 0xA8D9D1535CE3B396ULL,   694 }, { 0xFB9B7CD9A4A7443CULL,   720 },
+    { 0xBB764C4CA7A44410ULL,   747 }, { 0x8BAB8EEFB6409C1AULL,   774 },
+    { 0xD01FEF10A657842CULL,   800 }, { 0x9B10A4E5E9913129ULL,   827 },
+    { 0xE7109BFBA19C0C9DULL,   853 }, { 0xAC2820D9623BF429ULL,   880 },
+    { 0x80444B5E7AA7CF85ULL,   907 }, { 0xBF21E44003ACDD2DULL,   933 },
+    { 0x8E679C2F5E44FF8FULL,   960 }, { 0xD433179D9C8CB841ULL,   986 },
+    { 0x9E19DB92B4E31BA9ULL,  1013 }, { 0xEB96BF6EBADF77D9ULL,  1039 },
+    { 0xAF87023B9BF0EE6BULL,  1066 }
+};
+
+const int CachedPowerMinK    = -348;
+const int CachedPowerKStep   = 8;
+
+// Returns a cached 10^-K which brings a normalized value with binary exponent e into
+// the range where DigitGen can split it into 32-bit integral and fractional parts.
+DiyFp GetCachedPower(int e, int& K)
+{
+    double dk = (-61 - e) * 0.30102999566398114 + 347; // log10(2), and 347 = -CachedPowerMinK - 1.
+    int    k  = (int)dk;
+    if (dk - k > 0.0)
+        k++;
+
+    unsigned index = (unsigned)((k >> 3) + 1);
+    K = -(CachedPowerMinK + (int)index * CachedPowerKStep);
+    OVR_ASSERT(index < OVR_ARRAY_COUNT(CachedPowersOf10));
+    return DiyFp(CachedPowersOf10[index].F, CachedPowersOf10[index].E);
+}
+
+const uint64_t Pow10U64[20] =
+{
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+// Moves the last digit towards the exact value while the result stays within the
+// rounding interval.
+void GrisuRound(char* buffer, int length, uint64_t delta, uint64_t rest, uint64_t tenKappa, uint64_t distance)
+{
+    while ((rest < distance) && (delta - rest >= tenKappa) &&
+           ((rest + tenKappa < distance) || (distance - rest > rest + tenKappa - distance)))
+    {
+        buffer[length - 1]--;
+        rest += tenKappa;
+    }
+}
+
+// Generates the shortest digits of a value within (upper - delta, upper), closest to w.
+void DigitGen(const DiyFp& w, const DiyFp& upper, uint64_t delta, char* buffer, int& length, int& K)
+{
+    const DiyFp    one(uint64_t(1) << -upper.E, upper.E);
+    const uint64_t distance = upper.F - w.F;
+    uint32_t       p1 = (uint32_t)(upper.F >> -one.E);
+    uint64_t       p2 = upper.F & (one.F - 1);
+
+    int kappa = 1;
+    while ((kappa < 10) && (p1 >= Pow10U64[kappa]))
+        kappa++;
+
+    length = 0;
+    while (kappa > 0)
+    {
+        uint32_t divisor = (uint32_t)Pow10U64[kappa - 1];
+        uint32_t d = p1 / divisor;
+        p1 %= divisor;
+        if (d || length)
+            buffer[length++] = (char)('0' + d);
+        kappa--;
+
+        uint64_t rest = ((uint64_t)p1 << -one.E) + p2;
+        if (rest <= delta)
+        {
+            K += kappa;
+            GrisuRound(buffer, length, delta, rest, Pow10U64[kappa] << -one.E, distance);
+            return;
+        }
+    }
+
+    for (;;)
+    {
+        p2    *= 10;
+        delta *= 10;
+        char d = (char)(p2 >> -one.E);
+        if (d || length)
+            buffer[length++] = (char)('0' + d);
+        p2 &= one.F - 1;
+        kappa--;
+
+        if (p2 < delta)
+        {
+            K += kappa;
+            GrisuRound(buffer, length, delta, p2, one.F, distance * ((-kappa < 20) ? Pow10U64[-kappa] : 0));
+            return;
+        }
+    }
+}
+
+// Writes the digits of a finite, positive double to buffer, such that it equals
+// buffer * 10^K. Returns the number of digits, at most 17.
+int Grisu2(double value, char* buffer, int& K)
+{
+    uint64_t mantissa;
+    int      exponent;
+    DoubleToParts(value, mantissa, exponent);
+
+    // The neighbouring doubles are half an ulp away, except below a power of two, where
+    // the double below is only a quarter of an ulp away.
+    DiyFp upper = Normalize(DiyFp((mantissa << 1) + 1, exponent - 1));
+    DiyFp lower = (mantissa == HiddenBit) ? DiyFp((mantissa << 2) - 1, exponent - 2) :
+                                            DiyFp((mantissa << 1) - 1, exponent - 1);
+    lower.F <<= (lower.E - upper.E);
+    lower.E   = upper.E;
+
+    const DiyFp cachedPower = GetCachedPower(upper.E, K);
+    DiyFp w  = Multiply(Normalize(DiyFp(mantissa, exponent)), cachedPower);
+    DiyFp wp = Multiply(upper, cachedPower);
+    DiyFp wm = Multiply(lower, cachedPower);
+
+    // Shrink the interval by the multiplication error, so that every value in it reads
+    // back as the input.
+    wm.F++;
+    wp.F--;
+
+    int length;
+    DigitGen(w, wp, wp.F - wm.F, buffer, length, K);
+    return length;
+}
+
+// Formats the digits * 10^K as a plain decimal when it fits in 21 digits or needs at most
+// five leading zeros (like JavaScript's Number.toString), and otherwise in exponent
+// notation. Returns the end of the written text; buffer needs room for 26 characters.
+char* FormatDecimalDigits(char* buffer, int length, int K)
+{
+    const int kk = length + K; // 10^(kk - 1) <= value < 10^kk
+
+    if ((K >= 0) && (kk <= 21))
+    {
+        // 1234e7 -> 12340000000
+        for (int i = length; i < kk; i++)
+            buffer[i] = '0';
+        return buffer + kk;
+    }
+    if ((kk > 0) && (kk <= 21))
+    {
+        // 1234e-2 -> 12.34
+        memmove(buffer + kk + 1, buffer + kk, (size_t)(length - kk));
+        buffer[kk] = '.';
+        return buffer + length + 1;
+    }
+    if ((kk > -6) && (kk <= 0))
+    {
+        // 1234e-6 -> 0.001234
+        const int offset = 2 - kk;
+        memmove(buffer + offset, buffer, (size_t)length);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        for (int i = 2; i < offset; i++)
+            buffer[i] = '0';
+        return buffer + length + offset;
+    }
+
+    // 1e30, 1234e30 -> 1.234e+33
+    char* p = buffer + 1;
+    if (length > 1)
+    {
+        memmove(buffer + 2, buffer + 1, (size_t)(length - 1));
+        buffer[1] = '.';
+        p = buffer + length + 1;
+    }
+
+    int exponent = kk - 1;
+    *p++ = 'e';
+    *p++ = (exponent < 0) ? '-' : '+';
+    if (exponent < 0)
+        exponent = -exponent;
+    if (exponent >= 100)
+        *p++ = (char)('0' + exponent / 100);
+    if (exponent >= 10)
+        *p++ = (char)('0' + (exponent / 10) % 10);
+    *p++ = (char)('0' + exponent % 10);
+    return p;
+}
+
+} // namespace
+
+
+double OVR_CDECL OVR_strtod(const char* str, char** tailptr)
+{
+    const char* p = str;
+    const char* end = NULL;
+    bool        negative = false;
+    double      result = 0.0;
+
+    while (IsConversionSpace(*p))
+        ++p;
+
+    if (*p == '+' || *p == '-')
+        negative = (*p++ == '-');
+
+    if ((p[0] == '0') && ((p[1] | 0x20) == 'x'))
+    {
+        end = ParseHexadecimal(p + 2, negative, result);
+        if (end == (p + 2))
+            end = NULL; // Just a "0", followed by an 'x' which isn't part of the number.
+    }
+
+    if (!end)
+    {
+        end = ParseDecimal(p, negative, result);
+
+        if (end != p)
+        {
+            // Decimal number.
+        }
+        else if (MatchWord(p, "inf"))
+        {
+            end    = p + (MatchWord(p, "infinity") ? 8 : 3);
+            result = negative ? -HUGE_VAL : HUGE_VAL;
+        }
+        else if (MatchWord(p, "nan"))
+        {
+            end = p + 3;
+            if (*end == '(')
+            {
+                const char* close = end + 1;
+                while ((DigitValue(*close) < 36) || (*close == '_'))
+                    ++close;
+                if (*close == ')')
+                    end = close + 1;
+            }
+
+            uint64_t bits = negative ? 0xFFF8000000000000ULL : 0x7FF8000000000000ULL;
+            memcpy(&result, &bits, sizeof(result));
+        }
+        else
+        {
+            // No conversion could be performed.
+            end = str;
+        }
+    }
+
+    if (tailptr)
+        *tailptr = const_cast<char*>(end);
+
+    return result;
+}
+
+long OVR_CDECL OVR_strtol(const char* str, char** tailptr, int radix)
+{
+    return ParseSigned<long>(str, tailptr, radix, LONG_MIN, LONG_MAX);
+}
+
+unsigned long OVR_CDECL OVR_strtoul(const char* str, char** tailptr, int radix)
+{
+    return ParseUnsigned<unsigned long>(str, tailptr, radix, ULONG_MAX);
+}
+
+int64_t OVR_CDECL OVR_strtoq(const char* str, char** tailptr, int radix)
+{
+    return ParseSigned<int64_t>(str, tailptr, radix, INT64_MIN, INT64_MAX);
+}
+
+uint64_t OVR_CDECL OVR_strtouq(const char* str, char** tailptr, int radix)
+{
+    return ParseUnsigned<uint64_t>(str, tailptr, radix, UINT64_MAX);
+}
+
+
+char* OVR_CDECL OVR_i64toa(int64_t val, char* dest, size_t destsize, int radix)
+{
+    // Like _i64toa_s, only base 10 gets a sign; other bases write the two's complement.
+    bool negative = (val < 0) && (radix == 10);
+    return FormatInteger(negative ? (0 - (uint64_t)val) : (uint64_t)val, negative, dest, destsize, radix);
+}
+
+char* OVR_CDECL OVR_u64toa(uint64_t val, char* dest, size_t destsize, int radix)
+{
+    return FormatInteger(val, false, dest, destsize, radix);
+}
+
+char* OVR_CDECL OVR_dtoa(double val, char* dest, size_t destsize)
+{
+    char  buffer[32];
+    char* p = buffer;
+
+    uint64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    if ((bits >> 63) && (val == val)) // The sign of a NaN carries no meaning.
+        *p++ = '-';
+
+    if (val != val)
+    {
+        memcpy(p, "nan", 3);
+        p += 3;
+    }
+    else if ((val == HUGE_VAL) || (val == -HUGE_VAL))
+    {
+        memcpy(p, "inf", 3);
+        p += 3;
+    }
+    else if (val == 0.0)
+    {
+        *p++ = '0';
+    }
+    else
+    {
+        int K;
+        int length = Grisu2((val < 0) ? -val : val, p, K);
+        p = FormatDecimalDigits(p, length, K);
+    }
+
+    *p++ = '\0';
+
+    size_t size = (size_t)(p - buffer);
+    if (size <= destsize)
+        memcpy(dest, buffer, size);
+    else if (destsize > 0)
+        dest[0] = '\0';
+
+    return dest;
 }
 
 
@@ -45,102 +45,29 @@ limitations under the License.
 
 namespace OVR {
 
+// Same behavior as _i64toa_s / _ui64toa_s: only base 10 output is signed. Writes an
+// empty string if destsize is too small for the result.
+// Return value: Pointer to the resulting null-terminated string, same as parameter dest.
+char* OVR_CDECL OVR_i64toa(int64_t val, char* dest, size_t destsize, int radix);
+char* OVR_CDECL OVR_u64toa(uint64_t val, char* dest, size_t destsize, int radix);
+
+// Writes the shortest decimal text which OVR_strtod reads back as exactly val (using
+// '.' regardless of locale), in the style of "0.1", "123.5" or "1.5e-300". Writes
+// "inf", "-inf" or "nan" for non-finite values. OVR_dtoaMaxSize is always enough;
+// writes an empty string if destsize is too small for the result.
+// Return value: Pointer to the resulting null-terminated string, same as parameter dest.
+const size_t OVR_dtoaMaxSize = 32;
+char* OVR_CDECL OVR_dtoa(double val, char* dest, size_t destsize);
+
 // Has the same behavior as itoa aside from also having a dest size argument.
 // Return value: Pointer to the resulting null-terminated string, same as parameter str.
-#if defined(OVR_OS_MS)
-inline char* OVR_CDECL OVR_itoa(int val, char *dest, size_t destsize, int radix)
+inline char* OVR_CDECL OVR_itoa(int val, char* dest, size_t destsize, int radix)
 {
-#if defined(OVR_MSVC_SAFESTRING)
-    _itoa_s(val, dest, destsize, radix);
-    return dest;
-#else
-    OVR_UNUSED(destsize);
-    return itoa(val, dest, radix);
-#endif
-}
-#else // OVR_OS_MS
-inline char* OVR_itoa(int val, char* dest, size_t len, int radix)
-{
-    if (val == 0)
-    {
-        if (len > 1)
-        {
-            dest[0] = '0';
-            dest[1] = '\0';
-        }
-        else if(len > 0)
-            dest[0] = '\0';
-        return dest;
-    }
-
-    // FIXME: Fix the following code to avoid memory write overruns when len is in sufficient.
-    int cur = val;
-    size_t i    = 0;
-    size_t sign = 0;
-
-    if (val < 0)
-    {
-        val = -val;
-        sign = 1;
-    }
-
-    while ((val != 0) && (i < (len - 1 - sign)))
-    {
-        cur    = val % radix;
-        val   /= radix;
-
-        if (radix == 16)
-        {
-            switch(cur)
-            {
-            case 10:
-                dest[i] = 'a';
-                break;
-            case 11:
-                dest[i] = 'b';
-                break;
-            case 12:
-                dest[i] = 'c';
-                break;
-            case 13:
-                dest[i] = 'd';
-                break;
-            case 14:
-                dest[i] = 'e';
-                break;
-            case 15:
-                dest[i] = 'f';
-                break;
-            default:
-                dest[i] = (char)('0' + cur);
-                break;
-            }
-        }
-        else
-        {
-            dest[i] = (char)('0' + cur);
-        }
-        ++i;
-    }
-
-    if (sign)
-    {
-        dest[i++] = '-';
-    }
-
-    for (size_t j = 0; j < i / 2; ++j)
-    {
-        char tmp        = dest[j];
-        dest[j]         = dest[i - 1 - j];
-        dest[i - 1 - j] = tmp;
-    }
-    dest[i] = '\0';
-
-    return dest;
+    if (radix == 10)
+        return OVR_i64toa(val, dest, destsize, radix);
+    return OVR_u64toa((unsigned)val, dest, destsize, radix);
 }
 
-#endif
-
 
 // String functions
 
@@ -280,49 +207,23 @@ inline const uint8_t* OVR_CDECL OVR_memrchr(const uint8_t* str, size_t size, uin
 }
 
 
+// Same behavior as the CRT functions of the same names, except that they don't depend
+// on the C locale: OVR_strtod always uses '.' as the decimal separator. OVR_strtod is
+// correctly rounded, and none of these allocate or copy the string.
 double OVR_CDECL OVR_strtod(const char* string, char** tailptr);
-
-inline long OVR_CDECL OVR_strtol(const char* string, char** tailptr, int radix)
-{
-    return strtol(string, tailptr, radix);
-}
-
-inline unsigned long OVR_CDECL OVR_strtoul(const char* string, char** tailptr, int radix)
-{
-    return strtoul(string, tailptr, radix);
-}
+long OVR_CDECL OVR_strtol(const char* string, char** tailptr, int radix);
+unsigned long OVR_CDECL OVR_strtoul(const char* string, char** tailptr, int radix);
+int64_t OVR_CDECL OVR_strtoq(const char* string, char** tailptr, int radix);
+uint64_t OVR_CDECL OVR_strtouq(const char* string, char** tailptr, int radix);
 
 inline int OVR_CDECL OVR_strncmp(const char* ws1, const char* ws2, size_t size)
 {
     return strncmp(ws1, ws2, size);
 }
 
-inline uint64_t OVR_CDECL OVR_strtouq(const char *nptr, char **endptr, int base)
-{
-#if defined(OVR_CC_MSVC)
-    return _strtoui64(nptr, endptr, base);
-#else
-    return strtoull(nptr, endptr, base);
-#endif
-}
-
-inline int64_t OVR_CDECL OVR_strtoq(const char *nptr, char **endptr, int base)
-{
-#if defined(OVR_CC_MSVC)
-    return _strtoi64(nptr, endptr, base);
-#else
-    return strtoll(nptr, endptr, base);
-#endif
-}
-
-
 inline int64_t OVR_CDECL OVR_atoq(const char* string)
 {
-#if defined(OVR_CC_MSVC)
-    return _atoi64(string);
-#else
-    return atoll(string);
-#endif
+    return OVR_strtoq(string, NULL, 10);
 }
 
 inline uint64_t OVR_CDECL OVR_atouq(const char* string)
@@ -72,19 +72,16 @@ static size_t StringStrlcpy(wchar_t* pDestUCS, size_t destCharCountNotIncludingN
 
 #define String_LengthIsSize (size_t(1) << String::Flag_LengthIsSizeShift)
 
-String::DataDesc String::NullData = { String_LengthIsSize, {1}, {0} };
-
 String::String()
 {
-    pData = &NullData;
-    pData->AddRef();
+    InitData(0, 0);
 };
 
 String::String(const char* pdata)
 {
     // Obtain length in bytes; it doesn't matter if _data is UTF8.
     size_t size = pdata ? OVR_strlen(pdata) : 0; 
-    pData = AllocDataCopy1(size, 0, pdata, size);
+    InitDataCopy1(size, 0, pdata, size);
 };
 
 String::String(const char* pdata1, const char* pdata2, const char* pdata3)
@@ -94,97 +91,201 @@ String::String(const char* pdata1, const char* pdata2, const char* pdata3)
     size_t size2 = pdata2 ? OVR_strlen(pdata2) : 0; 
     size_t size3 = pdata3 ? OVR_strlen(pdata3) : 0; 
 
-    DataDesc *pdataDesc = AllocDataCopy2(size1 + size2 + size3, 0,
-                                         pdata1, size1, pdata2, size2);
-    memcpy(pdataDesc->Data + size1 + size2, pdata3, size3);   
-    pData = pdataDesc;    
+    char* pbuffer = InitDataCopy2(size1 + size2 + size3, 0,
+                                  pdata1, size1, pdata2, size2);
+    memcpy(pbuffer + size1 + size2, pdata3, size3);   
 }
 
 String::String(const char* pdata, size_t size)
 {
     OVR_ASSERT((size == 0) || (pdata != 0));
-    pData = AllocDataCopy1(size, 0, pdata, size);
+    InitDataCopy1(size, 0, pdata, size);
 };
 
 
 String::String(const InitStruct& src, size_t size)
 {
-    pData = AllocData(size, 0);
-    src.InitString(GetData()->Data, size);
+    src.InitString(InitData(size, 0), size);
 }
 
 String::String(const String& src)
 {    
-    pData = src.GetData();
-    pData->AddRef();
+    // Copies either the inline characters or the DataDesc pointer along with the marker.
+    memcpy(Local, src.Local, LocalBufferSize);
+    if (!IsLocal())
+        pData->AddRef();
 }
 
 String::String(const StringBuffer& src)
 {
-    pData = AllocDataCopy1(src.GetSize(), 0, src.ToCStr(), src.GetSize());
+    InitDataCopy1(src.GetSize(), 0, src.ToCStr(), src.GetSize());
 }
 
 String::String(const wchar_t* data)
 {
-    pData = &NullData;
-    pData->AddRef();
+    InitData(0, 0);
     // Simplified logic for wchar_t constructor.
     if (data)    
         *this = data;    
 }
 
 
-String::DataDesc* String::AllocData(size_t size, size_t lengthIsSize)
+char* String::InitData(size_t size, size_t lengthIsSize)
 {
-    String::DataDesc* pdesc;
-
-    if (size == 0)
+    if (size <= LocalCapacity)
     {
-        pdesc = &NullData;
-        pdesc->AddRef();
-        return pdesc;
+        Local[size] = 0;
+        Local[LocalCapacity] = (char)(LocalCapacity - size);
+        return Local;
     }
 
-    pdesc = (DataDesc*)OVR_ALLOC(sizeof(DataDesc)+ size);
+    DataDesc* pdesc = (DataDesc*)OVR_ALLOC(sizeof(DataDesc)+ size);
     pdesc->Data[size] = 0;
     pdesc->RefCount = 1;
     pdesc->Size     = size | lengthIsSize;  
-    return pdesc;
+    pdesc->pCharIndex = NULL;
+
+    pData = pdesc;
+    Local[LocalCapacity] = (char)HeapMarker;
+    return pdesc->Data;
+}
+
+
+char* String::InitDataCopy1(size_t size, size_t lengthIsSize,
+                            const char* pdata, size_t copySize)
+{
+    char* pbuffer = InitData(size, lengthIsSize);
+    memcpy(pbuffer, pdata, copySize);
+    return pbuffer;
+}
+
+char* String::InitDataCopy2(size_t size, size_t lengthIsSize,
+                            const char* pdata1, size_t copySize1,
+                            const char* pdata2, size_t copySize2)
+{
+    char* pbuffer = InitData(size, lengthIsSize);
+    memcpy(pbuffer, pdata1, copySize1);
+    memcpy(pbuffer + copySize1, pdata2, copySize2);
+    return pbuffer;
 }
 
+void String::Swap(String& other)
+{
+    char temp[LocalBufferSize];
+    memcpy(temp, Local, LocalBufferSize);
+    memcpy(Local, other.Local, LocalBufferSize);
+    memcpy(other.Local, temp, LocalBufferSize);
+}
+
+
+const String::CharIndex* String::GetCharIndex(bool build) const
+{
+    if (IsLocal() || pData->LengthIsSize() || (pData->GetSize() < CharIndexMinSize))
+        return NULL;
+
+    CharIndex* pindex = pData->pCharIndex.load(std::memory_order_acquire);
+
+    if (!pindex && build)
+    {
+        const char* pdata    = pData->Data;
+        size_t      size     = pData->GetSize();
+        size_t      maxCount = (size + CharIndexStride - 1) / CharIndexStride;
+
+        pindex = (CharIndex*)OVR_ALLOC(sizeof(CharIndex) + (maxCount - 1) * sizeof(size_t));
+        pindex->Length = 0;
+        pindex->Count  = 0;
 
-String::DataDesc* String::AllocDataCopy1(size_t size, size_t lengthIsSize,
-                                         const char* pdata, size_t copySize)
+        // Strings with embedded null characters are left unindexed, as the null-terminated
+        // GetByteIndex stops at them while the size-bounded functions don't.
+        if (!memchr(pdata, 0, size))
+        {
+            size_t offset = 0;
+            while (offset < size)
+            {
+                pindex->Offsets[pindex->Count++] = offset;
+                offset += (size_t)UTF8Util::GetByteIndex(CharIndexStride, pdata + offset, (intptr_t)(size - offset));
+            }
+
+            size_t lastOffset = pindex->Offsets[pindex->Count - 1];
+            pindex->Length = (pindex->Count - 1) * CharIndexStride +
+                             (size_t)UTF8Util::GetLength(pdata + lastOffset, (intptr_t)(size - lastOffset));
+
+            if (pindex->Length == size)
+            {
+                // Plain ASCII; the length flag makes indexing direct without an index.
+                OVR_FREE(pindex);
+                pData->Size |= String_LengthIsSize;
+                return NULL;
+            }
+        }
+
+        // Another thread may have built the index in the meantime, in which case we use theirs.
+        CharIndex* pexisting = NULL;
+        if (!pData->pCharIndex.compare_exchange_strong(pexisting, pindex, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            OVR_FREE(pindex);
+            pindex = pexisting;
+        }
+    }
+
+    return (pindex && pindex->Count) ? pindex : NULL;
+}
+
+size_t String::GetByteIndexBounded(size_t index) const
 {
-    String::DataDesc* pdesc = AllocData(size, lengthIsSize);
-    memcpy(pdesc->Data, pdata, copySize);
-    return pdesc;
+    const char* pdata = ToCStr();
+    size_t      size  = GetSize();
+
+    if (LengthIsSize())
+        return Alg::Min(index, size);
+
+    const CharIndex* pindex = GetCharIndex(false);
+    if (pindex && ((intptr_t)index >= 0))
+    {
+        if (index >= pindex->Length)
+            return size;
+
+        size_t offset = pindex->Offsets[index / CharIndexStride];
+        return offset + (size_t)UTF8Util::GetByteIndex(index % CharIndexStride, pdata + offset, (intptr_t)(size - offset));
+    }
+
+    return (size_t)UTF8Util::GetByteIndex(index, pdata, size);
 }
 
-String::DataDesc* String::AllocDataCopy2(size_t size, size_t lengthIsSize,
-                                         const char* pdata1, size_t copySize1,
-                                         const char* pdata2, size_t copySize2)
+size_t String::GetByteIndex(size_t index) const
 {
-    String::DataDesc* pdesc = AllocData(size, lengthIsSize);
-    memcpy(pdesc->Data, pdata1, copySize1);
-    memcpy(pdesc->Data + copySize1, pdata2, copySize2);
-    return pdesc;
+    const char* pdata = ToCStr();
+
+    const CharIndex* pindex = GetCharIndex(true);
+    if (pindex && ((intptr_t)index >= 0))
+    {
+        // Offsets only differ from the null-terminated walk past the end of the string, so
+        // finishing with it from the nearest entry gives the same result as a full scan.
+        size_t entry  = Alg::Min(index / CharIndexStride, pindex->Count - 1);
+        size_t offset = pindex->Offsets[entry];
+        return offset + (size_t)UTF8Util::GetByteIndex(index - entry * CharIndexStride, pdata + offset);
+    }
+
+    return (size_t)UTF8Util::GetByteIndex(index, pdata);
 }
 
 
 size_t String::GetLength() const 
 {
     // Optimize length accesses for non-UTF8 character strings. 
-    DataDesc* pdata = GetData();
-    size_t    length, size = pdata->GetSize();
+    const char* pdata = ToCStr();
+    size_t      length, size = GetSize();
     
-    if (pdata->LengthIsSize())
+    if (LengthIsSize())
         return size;    
+
+    if (const CharIndex* pindex = GetCharIndex(false))
+        return pindex->Length;
     
-    length = (size_t)UTF8Util::GetLength(pdata->Data, size);
+    length = (size_t)UTF8Util::GetLength(pdata, size);
     
-    if (length == size)
-        pdata->Size |= String_LengthIsSize;
+    if ((length == size) && !IsLocal())
+        pData->Size |= String_LengthIsSize;
     
     return length;
 }
@@ -193,27 +294,33 @@ size_t String::GetLength() const
 uint32_t String::GetCharAt(size_t index) const 
 {  
     intptr_t    i = (intptr_t) index;
-    DataDesc*   pdata = GetData();
-    const char* buf = pdata->Data;
+    const char* buf = ToCStr();
     uint32_t    c;
     
-    if (pdata->LengthIsSize())
+    if (LengthIsSize())
     {
-        OVR_ASSERT(index < pdata->GetSize());
+        OVR_ASSERT(index < GetSize());
         buf += i;
         return UTF8Util::DecodeNextChar_Advance0(&buf);
     }
 
-    c = UTF8Util::GetCharAt(index, buf, pdata->GetSize());
+    if (const CharIndex* pindex = GetCharIndex(true))
+    {
+        // Past the end, this still decodes to the last character like the full scan does.
+        size_t entry  = Alg::Min(index / CharIndexStride, pindex->Count - 1);
+        size_t offset = pindex->Offsets[entry];
+        return UTF8Util::GetCharAt((intptr_t)(index - entry * CharIndexStride), buf + offset, (intptr_t)(GetSize() - offset));
+    }
+
+    c = UTF8Util::GetCharAt(index, buf, GetSize());
     return c;
 }
 
 uint32_t String::GetFirstCharAt(size_t index, const char** offset) const
 {
-    DataDesc*   pdata = GetData();
     intptr_t    i = (intptr_t) index;
-    const char* buf = pdata->Data;
-    const char* end = buf + pdata->GetSize();
+    const char* buf = ToCStr();
+    const char* end = buf + GetSize();
     uint32_t    c;
 
     do 
@@ -243,8 +350,7 @@ uint32_t String::GetNextChar(const char** offset) const
 
 void String::AppendChar(uint32_t ch)
 {
-    DataDesc*   pdata = GetData();
-    size_t      size = pdata->GetSize();
+    size_t      size = GetSize();
     char        buff[8];
     intptr_t    encodeSize = 0;
 
@@ -252,9 +358,10 @@ void String::AppendChar(uint32_t ch)
     UTF8Util::EncodeChar(buff, &encodeSize, ch);
     OVR_ASSERT(encodeSize >= 0);
 
-    SetData(AllocDataCopy2(size + (size_t)encodeSize, 0,
-                           pdata->Data, size, buff, (size_t)encodeSize));
-    pdata->Release();
+    String result((NoConstructor()));
+    result.InitDataCopy2(size + (size_t)encodeSize, 0,
+                         ToCStr(), size, buff, (size_t)encodeSize);
+    Swap(result);
 }
 
 
@@ -267,14 +374,13 @@ void String::AppendString(const wchar_t* pstr, size_t len)
     if (encodeSize == 0)
         return;
 
-    DataDesc*   pdata = GetData();
-    size_t      oldSize = pdata->GetSize();    
-    DataDesc*   pnewData = AllocDataCopy1(oldSize + encodeSize, 0, pdata->Data, oldSize);
+    size_t      oldSize = GetSize();    
+    String      result((NoConstructor()));
+    char*       pbuffer = result.InitDataCopy1(oldSize + encodeSize, 0, ToCStr(), oldSize);
 
-    StringStrlcpy(pnewData->Data + oldSize, encodeSize, pstr, len);
+    StringStrlcpy(pbuffer + oldSize, encodeSize, pstr, len);
 
-    SetData(pnewData);
-    pdata->Release();
+    Swap(result);
 }
 
 
@@ -285,27 +391,25 @@ void String::AppendString(const char* putf8str, size_t utf8StrSz)
     if (utf8StrSz == StringIsNullTerminated)
         utf8StrSz = OVR_strlen(putf8str);
 
-    DataDesc*   pdata = GetData();
-    size_t      oldSize = pdata->GetSize();
+    size_t      oldSize = GetSize();
+    String      result((NoConstructor()));
 
-    SetData(AllocDataCopy2(oldSize + utf8StrSz, 0, pdata->Data, oldSize, putf8str, utf8StrSz));
-    pdata->Release();
+    result.InitDataCopy2(oldSize + utf8StrSz, 0, ToCStr(), oldSize, putf8str, utf8StrSz);
+    Swap(result);
 }
 
 void    String::AssignString(const InitStruct& src, size_t size)
 {
-    DataDesc*   poldData = GetData();
-    DataDesc*   pnewData = AllocData(size, 0);
-    src.InitString(pnewData->Data, size);
-    SetData(pnewData);
-    poldData->Release();
+    String result((NoConstructor()));
+    src.InitString(result.InitData(size, 0), size);
+    Swap(result);
 }
 
 void    String::AssignString(const char* putf8str, size_t size)
 {
-    DataDesc* poldData = GetData();
-    SetData(AllocDataCopy1(size, 0, putf8str, size));
-    poldData->Release();
+    String result((NoConstructor()));
+    result.InitDataCopy1(size, 0, putf8str, size);
+    Swap(result);
 }
 
 void    String::operator = (const char* pstr)
@@ -323,45 +427,36 @@ void    String::operator = (const wchar_t* pwstr)
         return;
     }
 
-    DataDesc*   poldData = GetData();
-    DataDesc*   pnewData = AllocData(size, 0);
-
-    StringStrlcpy(pnewData->Data, size, pwstr);
-
-    SetData(pnewData);
-    poldData->Release();
+    String result((NoConstructor()));
+    StringStrlcpy(result.InitData(size, 0), size, pwstr);
+    Swap(result);
 }
 
 
 void    String::operator = (const String& src)
 {     
-    DataDesc*    psdata = src.GetData();
-    DataDesc*    pdata = GetData();    
-
-    SetData(psdata);
-    psdata->AddRef();
-    pdata->Release();
+    String result(src);
+    Swap(result);
 }
 
 
 void    String::operator = (const StringBuffer& src)
 { 
-    DataDesc* polddata = GetData();    
-    SetData(AllocDataCopy1(src.GetSize(), 0, src.ToCStr(), src.GetSize()));
-    polddata->Release();
+    String result((NoConstructor()));
+    result.InitDataCopy1(src.GetSize(), 0, src.ToCStr(), src.GetSize());
+    Swap(result);
 }
 
 void    String::operator += (const String& src)
 {
-    DataDesc   *pourData = GetData(),
-               *psrcData = src.GetData();
-    size_t      ourSize  = pourData->GetSize(),
-                srcSize  = psrcData->GetSize();
-    size_t      lflag    = pourData->GetLengthFlag() & psrcData->GetLengthFlag();
+    size_t      ourSize  = GetSize(),
+                srcSize  = src.GetSize();
+    size_t      lflag    = GetLengthFlag() & src.GetLengthFlag();
+    String      result((NoConstructor()));
 
-    SetData(AllocDataCopy2(ourSize + srcSize, lflag,
-                           pourData->Data, ourSize, psrcData->Data, srcSize));
-    pourData->Release();
+    result.InitDataCopy2(ourSize + srcSize, lflag,
+                         ToCStr(), ourSize, src.ToCStr(), srcSize);
+    Swap(result);
 }
 
 
@@ -381,8 +476,8 @@ String   String::operator + (const String& src) const
 
 void    String::Remove(size_t posAt, size_t removeLength)
 {
-    DataDesc*   pdata = GetData();
-    size_t      oldSize = pdata->GetSize();    
+    const char* pdata = ToCStr();
+    size_t      oldSize = GetSize();    
     // Length indicates the number of characters to remove. 
     size_t      length = GetLength();
 
@@ -394,13 +489,14 @@ void    String::Remove(size_t posAt, size_t removeLength)
         removeLength = length - posAt;
 
     // Get the byte position of the UTF8 char at position posAt.
-    intptr_t bytePos    = UTF8Util::GetByteIndex(posAt, pdata->Data, oldSize);
-    intptr_t removeSize = UTF8Util::GetByteIndex(removeLength, pdata->Data + bytePos, oldSize - bytePos);
+    intptr_t bytePos    = (intptr_t)GetByteIndexBounded(posAt);
+    intptr_t removeSize = (intptr_t)GetByteIndexBounded(posAt + removeLength) - bytePos;
 
-    SetData(AllocDataCopy2(oldSize - removeSize, pdata->GetLengthFlag(),
-                           pdata->Data, bytePos,
-                           pData->Data + bytePos + removeSize, (oldSize - bytePos - removeSize)));
-    pdata->Release();
+    String result((NoConstructor()));
+    result.InitDataCopy2(oldSize - removeSize, GetLengthFlag(),
+                         pdata, bytePos,
+                         pdata + bytePos + removeSize, (oldSize - bytePos - removeSize));
+    Swap(result);
 }
 
 
@@ -412,34 +508,34 @@ String   String::Substring(size_t start, size_t end) const
     if (end > length)
         end = length;
 
-    DataDesc* pdata = GetData();
+    const char* pdata = ToCStr();
     
     // If size matches, we know the exact index range.
-    if (pdata->LengthIsSize())
-        return String(pdata->Data + start, end - start);
+    if (LengthIsSize())
+        return String(pdata + start, end - start);
     
     // Get position of starting character and size
-    intptr_t byteStart = UTF8Util::GetByteIndex(start, pdata->Data, pdata->GetSize());
-    intptr_t byteSize  = UTF8Util::GetByteIndex(end - start, pdata->Data + byteStart, pdata->GetSize() - byteStart);
+    intptr_t byteStart = (intptr_t)GetByteIndexBounded(start);
+    intptr_t byteSize  = (intptr_t)GetByteIndexBounded(end) - byteStart;
 
     OVR_ASSERT((byteStart >= 0) && (byteSize >= 0));
 
-    return String(pdata->Data + byteStart, (size_t)byteSize);
+    return String(pdata + byteStart, (size_t)byteSize);
 }
 
 void String::Clear()
 {   
-    NullData.AddRef();
-    GetData()->Release();
-    SetData(&NullData);
+    if (!IsLocal())
+        pData->Release();
+    InitData(0, 0);
 }
 
 
 String   String::ToUpper() const 
 {       
     uint32_t    c;
-    const char* psource = GetData()->Data;
-    const char* pend = psource + GetData()->GetSize();
+    const char* psource = ToCStr();
+    const char* pend = psource + GetSize();
     String      str;
     intptr_t    bufferOffset = 0;
     char        buffer[512];
@@ -462,8 +558,8 @@ String   String::ToUpper() const
 String   String::ToLower() const 
 {
     uint32_t    c;
-    const char* psource = GetData()->Data;
-    const char* pend = psource + GetData()->GetSize();
+    const char* psource = ToCStr();
+    const char* pend = psource + GetSize();
     String      str;
     intptr_t    bufferOffset = 0;
     char        buffer[512];
@@ -487,22 +583,21 @@ String   String::ToLower() const
 
 String& String::Insert(const char* substr, size_t posAt, size_t strSize)
 {
-    DataDesc* poldData   = GetData();
-    size_t    oldSize    = poldData->GetSize();
-    size_t    insertSize = (strSize == StringIsNullTerminated) ? OVR_strlen(substr) : strSize;
-    size_t    byteIndex  =  (poldData->LengthIsSize()) ?
-                            posAt : (size_t)UTF8Util::GetByteIndex(posAt, poldData->Data, oldSize);
+    const char* pdata      = ToCStr();
+    size_t      oldSize    = GetSize();
+    size_t      insertSize = (strSize == StringIsNullTerminated) ? OVR_strlen(substr) : strSize;
+    size_t      byteIndex  =  GetByteIndexBounded(posAt);
 
     // Insert past end of string degrades into AppendString to match UTF8Util::GetByteIndex case
     if (byteIndex > oldSize)
         byteIndex = oldSize;
     
-    DataDesc* pnewData = AllocDataCopy2(oldSize + insertSize, 0,
-                                        poldData->Data, byteIndex, substr, insertSize);
-    memcpy(pnewData->Data + byteIndex + insertSize,
-           poldData->Data + byteIndex, oldSize - byteIndex);
-    SetData(pnewData);
-    poldData->Release();
+    String result((NoConstructor()));
+    char*  pbuffer = result.InitDataCopy2(oldSize + insertSize, 0,
+                                          pdata, byteIndex, substr, insertSize);
+    memcpy(pbuffer + byteIndex + insertSize,
+           pdata + byteIndex, oldSize - byteIndex);
+    Swap(result);
     return *this;
 }
 
@@ -553,6 +648,78 @@ size_t String::BernsteinHashFunctionCIS(const void* pdataIn, size_t size, size_t
 
 
 
+// ***** InternedString
+
+static const size_t InternTableSize = 4096;    // Must be a power of two.
+
+static std::atomic<InternedString::Node*> InternTable[InternTableSize];
+
+static const InternedString::Node InternEmptyNode = { nullptr, 5381, 0, { 0 } };
+
+InternedString::InternedString()
+  : pNode(&InternEmptyNode)
+{
+}
+
+InternedString::InternedString(const char* str)
+  : pNode(Intern(str, str ? OVR_strlen(str) : 0))
+{
+}
+
+InternedString::InternedString(const char* str, size_t size)
+  : pNode(Intern(str, size))
+{
+}
+
+InternedString::InternedString(const String& str)
+  : pNode(Intern(str.ToCStr(), str.GetSize()))
+{
+}
+
+const InternedString::Node* InternedString::Intern(const char* str, size_t size)
+{
+    if (size == 0)
+        return &InternEmptyNode;
+
+    const size_t        hash    = String::BernsteinHashFunction(str, size);
+    std::atomic<Node*>& bucket  = InternTable[hash & (InternTableSize - 1)];
+    Node*               head    = bucket.load(std::memory_order_acquire);
+    Node*               newNode = nullptr;
+
+    for (;;)
+    {
+        for (Node* node = head; node; node = node->pNext)
+        {
+            if ((node->Hash == hash) && (node->Size == size) && (memcmp(node->Data, str, size) == 0))
+            {
+                // Another thread may have published the same string while we were preparing ours.
+                if (newNode)
+                    SysMemFree(newNode, sizeof(Node) + size);
+                return node;
+            }
+        }
+
+        if (!newNode)
+        {
+            // Interned strings live for the duration of the process, so they come from system
+            // memory rather than the tracked default heap, which would report them as leaks.
+            newNode = (Node*)SysMemAlloc(sizeof(Node) + size);
+            newNode->Hash = hash;
+            newNode->Size = size;
+            memcpy(newNode->Data, str, size);
+            newNode->Data[size] = 0;
+        }
+
+        newNode->pNext = head;
+
+        // On failure, head is reloaded with the current bucket head and we search again.
+        if (bucket.compare_exchange_weak(head, newNode, std::memory_order_release, std::memory_order_acquire))
+            return newNode;
+    }
+}
+
+
+
 // ***** String Buffer used for Building Strings
 
 
@@ -54,7 +54,7 @@ class StringBuffer;
 // ***** String Class 
 
 // String is UTF8 based string class with copy-on-write implementation
-// for assignment.
+// for assignment. Short strings are stored inline without a heap allocation.
 
 class String
 {
@@ -69,6 +69,21 @@ protected:
     };
 
 
+    // Sparse map from character index to byte offset for long UTF8 strings, so that
+    // repeated GetCharAt / GetByteIndex calls don't rescan from the start each time.
+    enum CharIndexConstants
+    {
+        CharIndexStride  = 64,  // Characters between Offsets entries.
+        CharIndexMinSize = 256  // Strings shorter than this (in bytes) aren't indexed.
+    };
+
+    struct CharIndex
+    {
+        size_t  Length;     // Number of characters in the string.
+        size_t  Count;      // Number of Offsets; 0 if the string can't be indexed.
+        size_t  Offsets[1]; // Byte offset of character i * CharIndexStride.
+    };
+
     // Internal structure to hold string data
     struct DataDesc
     {
@@ -76,6 +91,9 @@ protected:
         // are ascii, may not be equal to number of chars in case string data is UTF8.
         size_t  Size;       
         std::atomic<int32_t> RefCount;
+        // Built on demand. Data never changes once shared, so the index stays valid
+        // until the DataDesc is freed.
+        std::atomic<CharIndex*> pCharIndex;
         // Note: Data[] must be the last data element, and the [1] accounts for
         // null-termination in allocations
         char    Data[1];
@@ -97,7 +115,11 @@ protected:
         void    Release()
         {
             if (RefCount.fetch_add(-1, std::memory_order_relaxed) - 1 == 0)
+            {
+                if (CharIndex* pindex = pCharIndex.load(std::memory_order_acquire))
+                    OVR_FREE(pindex);
                 OVR_FREE(this);
+            }
         }
 
         static size_t GetLengthFlagBit()    { return size_t(1) << Flag_LengthIsSizeShift; }
@@ -106,49 +128,48 @@ protected:
         bool        LengthIsSize() const    { return GetLengthFlag() != 0; }
     };
 
-    // Heap type of the string is encoded in the lower bits.
-    enum HeapType
+    // Short strings are stored inline in the String object itself, which avoids the
+    // DataDesc heap allocation and the atomic reference counting on copy for things
+    // like JSON keys and menu labels. The last byte of Local holds the number of unused
+    // inline bytes, so that it doubles as the null terminator for a full buffer, or
+    // HeapMarker when the string data lives in a shared DataDesc instead.
+    enum LocalConstants
     {
-        HT_Global   = 0,    // Heap is global.
-        HT_Local    = 1,    // SF::String_loc: Heap is determined based on string's address.
-        HT_Dynamic  = 2,    // SF::String_temp: Heap is stored as a part of the class.
-        HT_Mask     = 3
+        LocalBufferSize = 3 * sizeof(void*),
+        LocalCapacity   = LocalBufferSize - 1,
+        HeapMarker      = 0xFF
     };
 
-    union {
+    union
+    {
         DataDesc* pData;
-        size_t    HeapTypeBits;
+        char      Local[LocalBufferSize];
     };
-    typedef union {
-        DataDesc* pData;
-        size_t    HeapTypeBits;
-    } DataDescUnion;
 
-    inline HeapType    GetHeapType() const { return (HeapType) (HeapTypeBits & HT_Mask); }
+    inline bool        IsLocal() const { return (uint8_t)Local[LocalCapacity] != HeapMarker; }
 
-    inline DataDesc*   GetData() const
-    {
-        DataDescUnion u;
-        u.pData    = pData;
-        u.HeapTypeBits = (u.HeapTypeBits & ~(size_t)HT_Mask);
-        return u.pData;
-    }
-    
-    inline void        SetData(DataDesc* pdesc)
-    {
-        HeapType ht = GetHeapType();
-        pData = pdesc;
-        OVR_ASSERT((HeapTypeBits & HT_Mask) == 0);
-        HeapTypeBits |= ht;        
-    }
+    inline size_t      GetLengthFlag() const { return IsLocal() ? 0 : pData->GetLengthFlag(); }
+    inline bool        LengthIsSize() const  { return GetLengthFlag() != 0; }
 
-    
-    DataDesc*   AllocData(size_t size, size_t lengthIsSize);
-    DataDesc*   AllocDataCopy1(size_t size, size_t lengthIsSize,
-                               const char* pdata, size_t copySize);
-    DataDesc*   AllocDataCopy2(size_t size, size_t lengthIsSize,
-                               const char* pdata1, size_t copySize1,
-                               const char* pdata2, size_t copySize2);
+    // Returns the character index of a long heap string, building it first if build is
+    // true. Returns NULL for strings that aren't (or can't be) indexed.
+    const CharIndex* GetCharIndex(bool build) const;
+    // Same as UTF8Util::GetByteIndex(index, ToCStr(), GetSize()), but starts from the
+    // character index if one has already been built.
+    size_t      GetByteIndexBounded(size_t index) const;
+
+    // These initialize the data of a String whose storage is currently uninitialized,
+    // and return the buffer of size bytes (plus null terminator) to be filled in.
+    char*       InitData(size_t size, size_t lengthIsSize);
+    char*       InitDataCopy1(size_t size, size_t lengthIsSize,
+                              const char* pdata, size_t copySize);
+    char*       InitDataCopy2(size_t size, size_t lengthIsSize,
+                              const char* pdata1, size_t copySize1,
+                              const char* pdata2, size_t copySize2);
+
+    // Exchanges the data of two strings. Neither representation refers to the address of
+    // the String itself, so this is a plain byte swap.
+    void        Swap(String& other);
 
     // Special constructor to avoid data initalization when used in derived class.
     struct NoConstructor { };
@@ -177,24 +198,22 @@ public:
     // Destructor (Captain Obvious guarantees!)
     ~String()
     {
-        GetData()->Release();
+        if (!IsLocal())
+            pData->Release();
     }
 
-    // Declaration of NullString
-    static DataDesc NullData;
-
 
     // *** General Functions
 
     void        Clear();
 
     // For casting to a pointer to char.
-    operator const char*() const        { return GetData()->Data; }
+    operator const char*() const        { return ToCStr(); }
     // Pointer to raw buffer.
-    const char* ToCStr() const          { return GetData()->Data; }
+    const char* ToCStr() const          { return IsLocal() ? Local : pData->Data; }
 
     // Returns number of bytes
-    size_t      GetSize() const         { return GetData()->GetSize() ; }
+    size_t      GetSize() const         { return IsLocal() ? (LocalCapacity - (size_t)(uint8_t)Local[LocalCapacity]) : pData->GetSize(); }
     // Tells whether or not the string is empty
     bool        IsEmpty() const         { return GetSize() == 0; }
 
@@ -246,7 +265,7 @@ public:
     size_t      InsertCharAt(uint32_t c, size_t posAt);
 
     // Get Byte index of the character at position = index, returns StringIndexOutOfBounds on index out of bounds
-    size_t      GetByteIndex(size_t index) const { return (size_t)UTF8Util::GetByteIndex(index, GetData()->Data); }
+    size_t      GetByteIndex(size_t index) const;
 
     // Utility: case-insensitive string compare.  stricmp() & strnicmp() are not
     // ANSI or POSIX, do not seem to appear in Linux.
@@ -309,7 +328,7 @@ public:
     // Comparison
     bool        operator == (const String& str) const
     {
-        return (OVR_strcmp(GetData()->Data, str.GetData()->Data)== 0);
+        return (OVR_strcmp(ToCStr(), str.ToCStr())== 0);
     }
 
     bool        operator != (const String& str) const
@@ -319,7 +338,7 @@ public:
 
     bool        operator == (const char* str) const
     {
-        return OVR_strcmp(GetData()->Data, str) == 0;
+        return OVR_strcmp(ToCStr(), str) == 0;
     }
 
     bool        operator != (const char* str) const
@@ -329,47 +348,47 @@ public:
 
     bool        operator <  (const char* pstr) const
     {
-        return OVR_strcmp(GetData()->Data, pstr) < 0;
+        return OVR_strcmp(ToCStr(), pstr) < 0;
     }
 
     bool        operator <  (const String& str) const
     {
-        return *this < str.GetData()->Data;
+        return *this < str.ToCStr();
     }
 
     bool        operator >  (const char* pstr) const
     {
-        return OVR_strcmp(GetData()->Data, pstr) > 0;
+        return OVR_strcmp(ToCStr(), pstr) > 0;
     }
 
     bool        operator >  (const String& str) const
     {
-        return *this > str.GetData()->Data;
+        return *this > str.ToCStr();
     }
 
     int CompareNoCase(const char* pstr) const
     {
-        return CompareNoCase(GetData()->Data, pstr);
+        return CompareNoCase(ToCStr(), pstr);
     }
     int CompareNoCase(const String& str) const
     {
-        return CompareNoCase(GetData()->Data, str.ToCStr());
+        return CompareNoCase(ToCStr(), str.ToCStr());
     }
     int CompareNoCaseStartsWith(const String& str) const
     {
-        return CompareNoCase(GetData()->Data, str.ToCStr(), str.GetLength());
+        return CompareNoCase(ToCStr(), str.ToCStr(), str.GetLength());
     }
 
     // Accesses raw bytes
     const char&     operator [] (int index) const
     {
         OVR_ASSERT(index >= 0 && (size_t)index < GetSize());
-        return GetData()->Data[index];
+        return ToCStr()[index];
     }
     const char&     operator [] (size_t index) const
     {
         OVR_ASSERT(index < GetSize());
-        return GetData()->Data[index];
+        return ToCStr()[index];
     }
 
 
@@ -418,6 +437,59 @@ public:
 };
 
 
+//-----------------------------------------------------------------------------------
+// ***** InternedString
+
+// InternedString refers to a single, process-wide copy of its characters, so that
+// equality and hashing are pointer operations. It's intended for names that are
+// compared or looked up far more often than they are created, such as keys,
+// channel names and labels. Interned data is never freed.
+//
+// Interning is lock-free: the global table is a fixed array of buckets, each of
+// which is a singly-linked list that only ever grows at its head via compare-exchange.
+
+class InternedString
+{
+public:
+    InternedString();
+    explicit InternedString(const char* str);
+    InternedString(const char* str, size_t size);
+    explicit InternedString(const String& str);
+
+    operator const char*() const        { return pNode->Data; }
+    const char* ToCStr() const          { return pNode->Data; }
+    size_t      GetSize() const         { return pNode->Size; }
+    bool        IsEmpty() const         { return pNode->Size == 0; }
+
+    // Same value as String::BernsteinHashFunction of the characters.
+    size_t      GetHash() const         { return pNode->Hash; }
+
+    bool        operator == (const InternedString& other) const { return pNode == other.pNode; }
+    bool        operator != (const InternedString& other) const { return pNode != other.pNode; }
+
+    struct HashFunctor
+    {
+        size_t operator()(const InternedString& data) const
+        {
+            return data.GetHash();
+        }
+    };
+
+    struct Node
+    {
+        Node*   pNext;
+        size_t  Hash;
+        size_t  Size;
+        char    Data[1];    // Null-terminated.
+    };
+
+protected:
+    static const Node* Intern(const char* str, size_t size);
+
+    const Node* pNode;
+};
+
+
 //-----------------------------------------------------------------------------------
 // ***** String Buffer used for Building Strings
 
@@ -28,9 +28,15 @@ limitations under the License.
 
 
 #include "OVR_UTF8Util.h"
+#include "OVR_Alg.h"
 #include <wchar.h>
 #include <string.h>
 
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define OVR_UTF8_SSE2
+#endif
+
 
 // sizeof(wchar_t) in preprocessor-accessible form.
 #ifndef OVR_WCHAR_SIZE
@@ -54,6 +60,147 @@ limitations under the License.
 namespace OVR { namespace UTF8Util {
 
 
+// *** ASCII run helpers
+//
+// 7-bit ASCII bytes each decode to exactly one character, so the functions below
+// skip whole runs of them at once and only fall back to DecodeNextChar_Advance0 for
+// multi-byte (or invalid) sequences. This keeps their results identical to decoding
+// every character, including the U+FFFD substitution for invalid input.
+
+// Returns the number of leading bytes of putf8str[0, length) which are below 0x80.
+// Zero bytes are included, as the length-bounded functions treat them as characters.
+static size_t GetAsciiRunLength(const char* putf8str, size_t length)
+{
+    size_t i = 0;
+
+    #if defined(OVR_UTF8_SSE2)
+        for (; (i + 16) <= length; i += 16)
+        {
+            int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(putf8str + i)));
+            if (mask)
+                return i + (size_t)Alg::CountTrailing0Bits((uint16_t)mask);
+        }
+    #else
+        for (; (i + 8) <= length; i += 8)
+        {
+            uint64_t word;
+            memcpy(&word, putf8str + i, sizeof(word));
+            if (word & 0x8080808080808080ULL)
+                break;
+        }
+    #endif
+
+    while ((i < length) && !(putf8str[i] & 0x80))
+        ++i;
+    return i;
+}
+
+// Returns the number of leading bytes of a null-terminated putf8str which are in
+// [1, 0x80), stopping at the terminator and after at most maxLength bytes.
+// The aligned loads may read past the terminator, which ASan would report.
+OVR_NO_SANITIZE_ADDRESS static size_t GetNonNullAsciiRunLength(const char* putf8str, size_t maxLength)
+{
+    size_t i = 0;
+
+    #if defined(OVR_UTF8_SSE2)
+        // Only aligned blocks are read past the start, as those can't straddle into
+        // an unmapped page beyond the terminator.
+        while ((i < maxLength) && (((uintptr_t)(putf8str + i) & 15) != 0))
+        {
+            char c = putf8str[i];
+            if ((c == 0) || (c & 0x80))
+                return i;
+            ++i;
+        }
+
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; i < maxLength; i += 16)
+        {
+            __m128i block = _mm_load_si128((const __m128i*)(putf8str + i));
+            int     mask  = _mm_movemask_epi8(block) | _mm_movemask_epi8(_mm_cmpeq_epi8(block, zero));
+            if (mask)
+                return Alg::Min(i + (size_t)Alg::CountTrailing0Bits((uint16_t)mask), maxLength);
+        }
+        return maxLength;
+    #else
+        while ((i < maxLength) && (putf8str[i] != 0) && !(putf8str[i] & 0x80))
+            ++i;
+        return i;
+    #endif
+}
+
+// Widens count ASCII bytes to wchar_t.
+static void WidenAscii(wchar_t* pDestUCS, const char* pSrcUTF8, size_t count)
+{
+    size_t i = 0;
+
+    #if defined(OVR_UTF8_SSE2) && ((OVR_WCHAR_SIZE == 2) || (OVR_WCHAR_SIZE == 4))
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; (i + 16) <= count; i += 16)
+        {
+            __m128i bytes = _mm_loadu_si128((const __m128i*)(pSrcUTF8 + i));
+            __m128i lo    = _mm_unpacklo_epi8(bytes, zero);
+            __m128i hi    = _mm_unpackhi_epi8(bytes, zero);
+
+            #if (OVR_WCHAR_SIZE == 2)
+                _mm_storeu_si128((__m128i*)(pDestUCS + i),     lo);
+                _mm_storeu_si128((__m128i*)(pDestUCS + i + 8), hi);
+            #else
+                _mm_storeu_si128((__m128i*)(pDestUCS + i),      _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128((__m128i*)(pDestUCS + i + 4),  _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128((__m128i*)(pDestUCS + i + 8),  _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128((__m128i*)(pDestUCS + i + 12), _mm_unpackhi_epi16(hi, zero));
+            #endif
+        }
+    #endif
+
+    for (; i < count; ++i)
+        pDestUCS[i] = wchar_t((uint8_t)pSrcUTF8[i]);
+}
+
+// Narrows the leading run of characters below 0x80 in pSrcUCS[0, maxCount) to bytes.
+// Returns the number of characters written.
+static size_t NarrowAsciiRun(char* pDestUTF8, const wchar_t* pSrcUCS, size_t maxCount)
+{
+    size_t i = 0;
+
+    #if defined(OVR_UTF8_SSE2) && (OVR_WCHAR_SIZE == 2)
+        const __m128i highMask = _mm_set1_epi16((short)0xFF80);
+        const __m128i zero     = _mm_setzero_si128();
+
+        for (; (i + 8) <= maxCount; i += 8)
+        {
+            __m128i chars = _mm_loadu_si128((const __m128i*)(pSrcUCS + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(chars, highMask), zero)) != 0xFFFF)
+                break;
+            _mm_storel_epi64((__m128i*)(pDestUTF8 + i), _mm_packus_epi16(chars, chars));
+        }
+    #elif defined(OVR_UTF8_SSE2) && (OVR_WCHAR_SIZE == 4)
+        const __m128i highMask = _mm_set1_epi32((int)0xFFFFFF80);
+        const __m128i zero     = _mm_setzero_si128();
+
+        for (; (i + 8) <= maxCount; i += 8)
+        {
+            __m128i chars0 = _mm_loadu_si128((const __m128i*)(pSrcUCS + i));
+            __m128i chars1 = _mm_loadu_si128((const __m128i*)(pSrcUCS + i + 4));
+            __m128i high   = _mm_or_si128(_mm_and_si128(chars0, highMask), _mm_and_si128(chars1, highMask));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF)
+                break;
+            __m128i words = _mm_packs_epi32(chars0, chars1);
+            _mm_storel_epi64((__m128i*)(pDestUTF8 + i), _mm_packus_epi16(words, words));
+        }
+    #endif
+
+    for (; (i < maxCount) && ((uint32_t)pSrcUCS[i] < 0x80); ++i)
+        pDestUTF8[i] = (char)pSrcUCS[i];
+
+    return i;
+}
+
+
+
 size_t Strlcpy(char* pDestUTF8, size_t destCharCount, const wchar_t* pSrcUCS, size_t sourceLength)
 {
     if (sourceLength == (size_t)-1)
@@ -61,9 +208,18 @@ size_t Strlcpy(char* pDestUTF8, size_t destCharCount, const wchar_t* pSrcUCS, si
 
     size_t destLength = 0;
 
-    size_t i;
-    for (i = 0; i < sourceLength; ++i)
+    size_t i = 0;
+    while (i < sourceLength)
     {
+        // Copy ASCII runs directly, as far as they fit (leaving room for the trailing '\0').
+        size_t room = (destLength < destCharCount) ? (destCharCount - destLength - 1) : 0;
+        size_t run  = NarrowAsciiRun(pDestUTF8 + destLength, pSrcUCS + i, Alg::Min(sourceLength - i, room));
+        destLength += run;
+        i += run;
+
+        if (i == sourceLength)
+            break;
+
         char     buff[6]; // longest utf8 encoding just to be safe
         intptr_t count = 0;
 
@@ -75,6 +231,7 @@ size_t Strlcpy(char* pDestUTF8, size_t destCharCount, const wchar_t* pSrcUCS, si
 
         memcpy(pDestUTF8 + destLength, buff, count);
         destLength += (size_t)count;
+        ++i;
     }
 
     // Should be true for all cases other than destCharCount == 0.
@@ -102,6 +259,19 @@ size_t Strlcpy(wchar_t* pDestUCS, size_t destCharCount, const char* pSrcUTF8, si
     
     for (const char* pSrcUTF8End = (pSrcUTF8 + sourceLength); pSrcUTF8 < pSrcUTF8End; )
     {
+        size_t run = GetAsciiRunLength(pSrcUTF8, (size_t)(pSrcUTF8End - pSrcUTF8));
+        if (run)
+        {
+            size_t room = (destLength < destCharCount) ? (destCharCount - destLength - 1) : 0;
+            size_t copy = Alg::Min(run, room);
+
+            WidenAscii(pDestUCS + destLength, pSrcUTF8, copy);
+            destLength     += copy;
+            requiredLength += run;
+            pSrcUTF8       += run;
+            continue;
+        }
+
         uint32_t c = DecodeNextChar_Advance0(&pSrcUTF8);
         OVR_ASSERT_M(pSrcUTF8 <= (pSrcUTF8 + sourceLength), "Strlcpy sourceLength was not on a UTF8 boundary.");
 
@@ -135,17 +305,34 @@ intptr_t GetLength(const char* buf, intptr_t buflen)
 
     if (buflen != -1)
     {
-        while (p - buf < buflen)
+        const char* end = buf + buflen;
+
+        while (p < end)
         {
+            size_t run = GetAsciiRunLength(p, (size_t)(end - p));
+            p      += run;
+            length += (intptr_t)run;
+
             // We should be able to have ASStrings with 0 in the middle.
-            UTF8Util::DecodeNextChar_Advance0(&p);
-            length++;
+            if (p < end)
+            {
+                UTF8Util::DecodeNextChar_Advance0(&p);
+                length++;
+            }
         }
     }
     else
     {
-        while (UTF8Util::DecodeNextChar_Advance0(&p))
+        for (;;)
+        {
+            size_t run = GetNonNullAsciiRunLength(p, (size_t)-1);
+            p      += run;
+            length += (intptr_t)run;
+
+            if (!UTF8Util::DecodeNextChar_Advance0(&p))
+                break;
             length++;
+        }
     }
     
     return length;
@@ -158,8 +345,25 @@ uint32_t GetCharAt(intptr_t index, const char* putf8str, intptr_t length)
 
     if (length != -1)
     {
-        while (buf - putf8str < length)
-        {           
+        const char* end = putf8str + length;
+
+        // A negative index never matches, which returns the last character.
+        if (index < 0)
+            index = (intptr_t)((uintptr_t)-1 >> 1);
+
+        while (buf < end)
+        {
+            size_t run = GetAsciiRunLength(buf, Alg::Min((size_t)(end - buf), (size_t)index + 1));
+            if (run)
+            {
+                if (index < (intptr_t)run)
+                    return (uint8_t)buf[index];
+                buf   += run;
+                index -= (intptr_t)run;
+                c = (uint8_t)buf[-1];
+                continue;
+            }
+
             c = UTF8Util::DecodeNextChar_Advance0(&buf);
             if (index == 0)
                 return c;
@@ -169,8 +373,18 @@ uint32_t GetCharAt(intptr_t index, const char* putf8str, intptr_t length)
         return c;
     }
 
-    do 
+    // A negative index returns the first character.
+    if (index < 0)
+        index = 0;
+
+    for (;;)
     {
+        size_t run = GetNonNullAsciiRunLength(buf, (size_t)index + 1);
+        if (index < (intptr_t)run)
+            return (uint8_t)buf[index];
+        buf   += run;
+        index -= (intptr_t)run;
+
         c = UTF8Util::DecodeNextChar_Advance0(&buf);
         index--;
 
@@ -180,9 +394,10 @@ uint32_t GetCharAt(intptr_t index, const char* putf8str, intptr_t length)
             OVR_ASSERT(index == 0);
             return c;
         }
-    } while (index >= 0);
 
-    return c;
+        if (index < 0)
+            return c;
+    }
 }
 
 intptr_t GetByteIndex(intptr_t index, const char *putf8str, intptr_t byteLength)
@@ -191,9 +406,18 @@ intptr_t GetByteIndex(intptr_t index, const char *putf8str, intptr_t byteLength)
 
     if (byteLength >= 0)
     {
+        const char* end = putf8str + byteLength;
         const char* lastValid = putf8str;
-        while ((buf - putf8str) < byteLength && index > 0)
+        while (buf < end && index > 0)
         {
+            size_t run = GetAsciiRunLength(buf, Alg::Min((size_t)(end - buf), (size_t)index));
+            if (run)
+            {
+                buf   += run;
+                index -= (intptr_t)run;
+                continue;
+            }
+
             lastValid = buf;
             // XXX this may read up to 5 bytes past byteLength
             UTF8Util::DecodeNextChar_Advance0(&buf);
@@ -209,6 +433,12 @@ intptr_t GetByteIndex(intptr_t index, const char *putf8str, intptr_t byteLength)
 
     while (index > 0) 
     {
+        size_t run = GetNonNullAsciiRunLength(buf, (size_t)index);
+        buf   += run;
+        index -= (intptr_t)run;
+        if (index == 0)
+            break;
+
         uint32_t c = UTF8Util::DecodeNextChar(&buf);
         index--;
 
@@ -230,8 +460,17 @@ intptr_t GetByteIndexChecked(intptr_t index, const char *putf8str, intptr_t byte
 
     if (byteLength >= 0)
     {
-        while ((buf - putf8str) < byteLength && index > 0)
+        const char* end = putf8str + byteLength;
+        while (buf < end && index > 0)
         {
+            size_t run = GetAsciiRunLength(buf, Alg::Min((size_t)(end - buf), (size_t)index));
+            if (run)
+            {
+                buf   += run;
+                index -= (intptr_t)run;
+                continue;
+            }
+
             // XXX this may read up to 5 bytes past byteLength
             UTF8Util::DecodeNextChar_Advance0(&buf);
             index--;
@@ -245,6 +484,12 @@ intptr_t GetByteIndexChecked(intptr_t index, const char *putf8str, intptr_t byte
     {
         while (index > 0) 
         {
+            size_t run = GetNonNullAsciiRunLength(buf, (size_t)index);
+            buf   += run;
+            index -= (intptr_t)run;
+            if (index == 0)
+                break;
+
             uint32_t c = UTF8Util::DecodeNextChar_Advance0(&buf);
             index--;
 
@@ -0,0 +1,474 @@
+/************************************************************************************
+
+Filename    :   Util_JobSystem.cpp
+Content     :   Work-stealing job system shared by all subsystems
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2014-2016 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.3 (the "License");
+you may not use the Oculus VR Rift SDK except in compliance with the License,
+which is provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.3
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "Util_JobSystem.h"
+#include "Util_Watchdog.h"
+#include "Kernel/OVR_Std.h"
+
+OVR_DEFINE_SINGLETON(OVR::Util::JobSystem);
+
+namespace OVR { namespace Util {
+
+// Index of the pool worker running on this thread, or -1 for threads outside the pool.
+static OVR_THREAD_LOCAL int CurrentWorkerIndex = -1;
+
+// How long an idle worker sleeps before re-checking for work and feeding its watchdog.
+static const int IdleWakeupIntervalMsec = 100;
+
+
+//-----------------------------------------------------------------------------
+// Job
+
+class Job : public NewOverrideBase, public ListNode<Job>
+{
+public:
+    Job(JobSystem::JobFunc&& func, JobCounter* counter) :
+        Func(std::move(func)),
+        Counter(counter)
+    {
+    }
+
+    JobSystem::JobFunc Func;
+    JobCounter*        Counter;
+};
+
+
+//-----------------------------------------------------------------------------
+// JobDeque
+
+// Fixed-capacity Chase-Lev work-stealing deque, using the C11 memory orderings from
+// Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak
+// Memory Models" (PPoPP 2013). Push and Pop may only be called by the owning worker;
+// Steal may be called from any thread.
+
+class JobDeque
+{
+public:
+    static const int64_t Capacity = 4096; // Must be a power of two.
+
+    JobDeque() : Top(0), Bottom(0)
+    {
+        for (int64_t i = 0; i < Capacity; ++i)
+            Buffer[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    // Returns false if the deque is full.
+    bool Push(Job* job)
+    {
+        const int64_t b = Bottom.load(std::memory_order_relaxed);
+        const int64_t t = Top.load(std::memory_order_acquire);
+
+        if (b - t >= Capacity)
+            return false;
+
+        Buffer[b & (Capacity - 1)].store(job, std::memory_order_relaxed);
+        Bottom.store(b + 1, std::memory_order_release); // Publishes the job to thieves.
+        return true;
+    }
+
+    Job* Pop()
+    {
+        const int64_t b = Bottom.load(std::memory_order_relaxed) - 1;
+        Bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = Top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // Empty.
+            Bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = Buffer[b & (Capacity - 1)].load(std::memory_order_relaxed);
+
+        if (t == b)
+        {
+            // Last element; race against thieves for it.
+            if (!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            Bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        return job;
+    }
+
+    Job* Steal()
+    {
+        int64_t t = Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = Bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+            return nullptr;
+
+        Job* job = Buffer[t & (Capacity - 1)].load(std::memory_order_relaxed);
+
+        if (!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr; // Lost the race to another thief or the owner.
+
+        return job;
+    }
+
+protected:
+    std::atomic<int64_t> Top;
+    std::atomic<int64_t> Bottom;
+    std::atomic<Job*>    Buffer[Capacity];
+};
+
+
+//-----------------------------------------------------------------------------
+// JobWorker
+
+class JobWorker : public NewOverrideBase
+{
+public:
+    JobDeque                     Queue;
+    std::unique_ptr<std::thread> ThreadHandle;
+};
+
+
+//-----------------------------------------------------------------------------
+// JobCounter
+
+JobCounter::~JobCounter()
+{
+    // The thread that took Pending to zero may still be inside WaitersLock; let it leave
+    // before the lock is destroyed.
+    Lock::Locker locker(&WaitersLock);
+    OVR_ASSERT(IsDone() && Waiters.IsEmpty());
+}
+
+
+//-----------------------------------------------------------------------------
+// JobSystem
+
+JobSystem::JobSystem() :
+    WorkerCount(0),
+    Workers(),
+    InjectionLock(),
+    InjectionQueue(),
+    InjectionCount(0),
+    WorkSignal(0),
+    SleepingCount(0),
+    Terminated(false)
+{
+    // Leave one hardware thread for the thread that submits and waits on jobs.
+    const int hardwareThreads = (int)std::thread::hardware_concurrency();
+    WorkerCount = (hardwareThreads > 2) ? (hardwareThreads - 1) : 1;
+
+    Workers.Resize(WorkerCount);
+    for (int i = 0; i < WorkerCount; ++i)
+        Workers[i] = new JobWorker;
+
+    // Start the threads only once every deque exists, since workers steal from each other.
+    for (int i = 0; i < WorkerCount; ++i)
+        Workers[i]->ThreadHandle = std::make_unique<std::thread>([this, i] { this->RunWorker(i); });
+
+    // Must be at end of function
+    PushDestroyCallbacks();
+}
+
+JobSystem::~JobSystem()
+{
+    OVR_ASSERT(InjectionQueue.IsEmpty());
+
+    for (int i = 0; i < WorkerCount; ++i)
+    {
+        OVR_ASSERT(!Workers[i]->ThreadHandle->joinable());
+        delete Workers[i];
+    }
+}
+
+void JobSystem::OnThreadDestroy()
+{
+    Terminated.store(true, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(WakeMutex);
+        WorkSignal.fetch_add(1);
+    }
+    WakeCondition.notify_all();
+
+    for (int i = 0; i < WorkerCount; ++i)
+        Workers[i]->ThreadHandle->join();
+
+    // The workers only drain their own deques. Run what is left in the injection queue
+    // here, including anything those last jobs submitted, so that counters still reach zero.
+    while (runOneJob(-1))
+        ;
+}
+
+void JobSystem::OnSystemDestroy()
+{
+    delete this;
+}
+
+void JobSystem::Run(JobFunc func, JobCounter* counter, JobCounter* dependency)
+{
+    Job* job = new Job(std::move(func), counter);
+
+    if (counter)
+        counter->Pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (dependency)
+    {
+        Lock::Locker locker(&dependency->WaitersLock);
+
+        // finish() drains Waiters under the same lock after the count reaches zero,
+        // so the job is either queued here or picked up there, never lost.
+        if (!dependency->IsDone())
+        {
+            dependency->Waiters.PushBack(job);
+            return;
+        }
+    }
+
+    schedule(job);
+}
+
+void JobSystem::schedule(Job* job)
+{
+    const int workerIndex = CurrentWorkerIndex;
+
+    if ((workerIndex < 0) || !Workers[workerIndex]->Queue.Push(job))
+    {
+        // Submitted from outside the pool, or the worker's deque is full.
+        Lock::Locker locker(&InjectionLock);
+        InjectionQueue.PushBack(job);
+        InjectionCount.fetch_add(1, std::memory_order_release);
+    }
+
+    signalWork();
+}
+
+void JobSystem::signalWork()
+{
+    WorkSignal.fetch_add(1);
+
+    // Sleeping workers increment SleepingCount before they re-check WorkSignal, so
+    // with sequentially consistent ordering either they see the new signal or we see them.
+    if (SleepingCount.load() > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(WakeMutex);
+        }
+        WakeCondition.notify_one();
+    }
+}
+
+void JobSystem::finish(Job* job)
+{
+    JobCounter* counter = job->Counter;
+    delete job;
+
+    if (!counter)
+        return;
+
+    // Decrements that can't reach zero don't need the lock.
+    int pending = counter->Pending.load(std::memory_order_acquire);
+    while ((pending > 1) && !counter->Pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        ;
+
+    if (pending <= 1)
+    {
+        // Possibly the last job. Reach zero under WaitersLock, so that dependent jobs
+        // added by Run() are either already listed or will see the counter as done.
+        List<Job> ready;
+
+        bool done = false;
+
+        {
+            Lock::Locker locker(&counter->WaitersLock);
+            if (counter->Pending.fetch_sub(1) == 1)
+            {
+                ready.PushListToBack(counter->Waiters);
+                done = true;
+            }
+        }
+
+        // Wake threads blocked in Wait(). As with signalWork(), the sequentially consistent
+        // decrement above and SleepingCount increment in Wait() can't both be missed.
+        if (done && (SleepingCount.load() > 0))
+        {
+            {
+                std::lock_guard<std::mutex> lock(WakeMutex);
+            }
+            WakeCondition.notify_all();
+        }
+
+        while (!ready.IsEmpty())
+        {
+            Job* waiter = ready.GetFirst();
+            waiter->RemoveNode();
+            schedule(waiter);
+        }
+    }
+}
+
+Job* JobSystem::findJob(int workerIndex)
+{
+    Job* job = nullptr;
+
+    if (workerIndex >= 0)
+    {
+        job = Workers[workerIndex]->Queue.Pop();
+        if (job)
+            return job;
+    }
+
+    if (InjectionCount.load(std::memory_order_acquire) > 0)
+    {
+        Lock::Locker locker(&InjectionLock);
+
+        if (!InjectionQueue.IsEmpty())
+        {
+            job = InjectionQueue.GetFirst();
+            job->RemoveNode();
+            InjectionCount.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    // Steal, starting with the worker after ours so thieves spread across victims.
+    for (int i = 1; i <= WorkerCount; ++i)
+    {
+        const int victim = (workerIndex + i + WorkerCount) % WorkerCount;
+
+        if (victim != workerIndex)
+        {
+            job = Workers[victim]->Queue.Steal();
+            if (job)
+                return job;
+        }
+    }
+
+    return nullptr;
+}
+
+bool JobSystem::runOneJob(int workerIndex)
+{
+    Job* job = findJob(workerIndex);
+
+    if (!job)
+        return false;
+
+    job->Func();
+    finish(job);
+    return true;
+}
+
+void JobSystem::Wait(JobCounter* counter)
+{
+    const int workerIndex = CurrentWorkerIndex;
+
+    while (!counter->IsDone())
+    {
+        // Capture the signal before looking for work, as in RunWorker().
+        const uint32_t signal = WorkSignal.load();
+
+        if (runOneJob(workerIndex))
+            continue;
+
+        // Nothing to help with: sleep until the counter is done, or new work that we
+        // could run shows up, instead of spinning on a core.
+        std::unique_lock<std::mutex> lock(WakeMutex);
+        SleepingCount.fetch_add(1);
+        WakeCondition.wait_for(lock, std::chrono::milliseconds(IdleWakeupIntervalMsec), [this, counter, signal]
+        {
+            return (counter->Pending.load() == 0) || (WorkSignal.load() != signal);
+        });
+        SleepingCount.fetch_sub(1);
+    }
+}
+
+void JobSystem::ParallelFor(int begin, int end, int grainSize, const RangeFunc& func)
+{
+    if (grainSize < 1)
+        grainSize = 1;
+
+    if (end - begin <= grainSize)
+    {
+        if (end > begin)
+            func(begin, end);
+        return;
+    }
+
+    JobCounter counter;
+
+    // Leave the first range for this thread, which would otherwise just be waiting.
+    for (int rangeBegin = begin + grainSize; rangeBegin < end; rangeBegin += grainSize)
+    {
+        const int rangeEnd = Alg::Min(rangeBegin + grainSize, end);
+        Run([&func, rangeBegin, rangeEnd] { func(rangeBegin, rangeEnd); }, &counter);
+    }
+
+    func(begin, begin + grainSize);
+
+    Wait(&counter);
+}
+
+void JobSystem::RunWorker(int workerIndex)
+{
+    char threadName[32];
+    snprintf(threadName, sizeof(threadName), "JobWorker %d", workerIndex);
+
+    Thread::SetCurrentThreadName(threadName);
+    WatchDog watchdog(threadName);
+
+    CurrentWorkerIndex = workerIndex;
+
+    while (!Terminated.load(std::memory_order_acquire))
+    {
+        // Capture the signal before looking for work, so that work submitted after
+        // our search comes up empty is guaranteed to change it.
+        const uint32_t signal = WorkSignal.load();
+
+        watchdog.Feed(StuckJobThresholdMsec);
+
+        if (runOneJob(workerIndex))
+            continue;
+
+        std::unique_lock<std::mutex> lock(WakeMutex);
+        SleepingCount.fetch_add(1);
+        WakeCondition.wait_for(lock, std::chrono::milliseconds(IdleWakeupIntervalMsec), [this, signal]
+        {
+            return (WorkSignal.load() != signal) || Terminated.load(std::memory_order_acquire);
+        });
+        SleepingCount.fetch_sub(1);
+    }
+
+    // Drain whatever remains in our deque so that counters still reach zero.
+    while (Job* job = Workers[workerIndex]->Queue.Pop())
+    {
+        job->Func();
+        finish(job);
+    }
+
+    CurrentWorkerIndex = -1;
+}
+
+
+}} // namespace OVR::Util
@@ -0,0 +1,206 @@
+/************************************************************************************
+
+Filename    :   Util_JobSystem.h
+Content     :   Work-stealing job system shared by all subsystems
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2014-2016 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.3 (the "License");
+you may not use the Oculus VR Rift SDK except in compliance with the License,
+which is provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.3
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#ifndef OVR_Util_JobSystem_h
+#define OVR_Util_JobSystem_h
+
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Atomic.h"
+#include "Kernel/OVR_Allocator.h"
+#include "Kernel/OVR_List.h"
+#include "Kernel/OVR_System.h"
+#include "Kernel/OVR_Threads.h"
+#include <functional>
+#include <thread>
+
+namespace OVR { namespace Util {
+
+class Job;
+class JobWorker;
+
+
+//-----------------------------------------------------------------------------
+// JobCounter
+
+// Counts the outstanding jobs of a group. A counter is passed to JobSystem::Run
+// to be incremented on submission and decremented when the job finishes, and it
+// can be waited on or used as the dependency of later jobs.
+//
+// A counter must outlive all the jobs that refer to it.
+
+class JobCounter : public NewOverrideBase
+{
+    friend class JobSystem;
+
+public:
+    JobCounter() : Pending(0) { }
+    ~JobCounter();
+
+    bool IsDone() const { return Pending.load(std::memory_order_acquire) == 0; }
+
+protected:
+    std::atomic<int> Pending;
+
+    // Jobs that depend on this counter and are waiting for it to reach zero.
+    Lock             WaitersLock;
+    List<Job>        Waiters;
+};
+
+
+//-----------------------------------------------------------------------------
+// JobSystem
+
+// Runs jobs on a pool of worker threads, one per hardware thread less one for the
+// caller. Each worker owns a Chase-Lev deque; it pushes and pops its own jobs at
+// one end without locking while idle workers steal from the other end. Jobs submitted
+// from threads outside the pool go through a shared injection queue.
+//
+// Every worker feeds a WatchDog before running each job, so a job that stays stuck
+// for longer than StuckJobThresholdMsec is reported like any other long cycle.
+//
+// Example:
+//     JobSystem* jobs = JobSystem::GetInstance();
+//     JobCounter loaded, culled;
+//     jobs->Run([&] { LoadScene(); }, &loaded);
+//     jobs->Run([&] { CullScene(); }, &culled, &loaded); // Starts after LoadScene.
+//     jobs->ParallelFor(0, nodeCount, 64, [&](int begin, int end) { UpdateNodes(begin, end); });
+//     jobs->ParallelSort(drawCalls, DrawCall::SortKeyLess);
+//     jobs->Wait(&culled);
+
+class JobSystem : public SystemSingletonBase<JobSystem>
+{
+    OVR_DECLARE_SINGLETON(JobSystem);
+    virtual void OnThreadDestroy() override;
+
+    friend class JobWorker;
+
+public:
+    typedef std::function<void()>         JobFunc;
+    typedef std::function<void(int, int)> RangeFunc;
+
+    static const int StuckJobThresholdMsec = 10000; // milliseconds
+    static const int ParallelSortGrainSize = 8192;  // elements
+
+    // Schedules func to run on the pool. If counter is non-null it is incremented now and
+    // decremented after func returns. If dependency is non-null, func won't start until
+    // the dependency counter has reached zero.
+    void Run(JobFunc func, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+    // Returns once the counter has reached zero. The calling thread runs pending
+    // jobs while it waits, so waiting from within a job doesn't deadlock the pool,
+    // and sleeps when there is nothing it can run.
+    void Wait(JobCounter* counter);
+
+    // Calls func(rangeBegin, rangeEnd) on consecutive subranges of [begin, end) of at most
+    // grainSize elements, in parallel, and returns once all of them are done.
+    void ParallelFor(int begin, int end, int grainSize, const RangeFunc& func);
+
+    // Sorts an Array, ArrayPOD, ArrayUnsafe etc. in place like Alg::QuickSort. The top
+    // partitions are split on the calling thread and their sub-arrays sorted as parallel
+    // jobs, down to sub-arrays of grainSize elements which are sorted sequentially.
+    template<class ArrayType, class Less>
+    void ParallelSort(ArrayType& arr, Less less, size_t grainSize = ParallelSortGrainSize);
+
+    template<class ArrayType>
+    void ParallelSort(ArrayType& arr)
+    {
+        typedef typename ArrayType::ValueType ValueType;
+        ParallelSort(arr, Alg::OperatorLess<ValueType>::Compare);
+    }
+
+    // Number of worker threads in the pool.
+    int GetWorkerCount() const { return WorkerCount; }
+
+protected:
+    int                        WorkerCount;
+    Array<JobWorker*>          Workers;
+
+    Lock                       InjectionLock;
+    List<Job>                  InjectionQueue;
+    std::atomic<int>           InjectionCount;
+
+    // Idle workers sleep on WakeCondition until WorkSignal changes.
+    std::mutex                 WakeMutex;
+    std::condition_variable    WakeCondition;
+    std::atomic<uint32_t>      WorkSignal;
+    std::atomic<int>           SleepingCount;
+
+    std::atomic<bool>          Terminated;
+
+    void schedule(Job* job);
+    void signalWork();
+    void finish(Job* job);
+    Job* findJob(int workerIndex);
+    bool runOneJob(int workerIndex);
+
+    void RunWorker(int workerIndex);
+
+    template<class ArrayType, class Less>
+    void parallelSortRange(ArrayType& arr, size_t start, size_t end, Less less,
+                           size_t grainSize, int depth, JobCounter* counter);
+};
+
+
+template<class ArrayType, class Less>
+void JobSystem::ParallelSort(ArrayType& arr, Less less, size_t grainSize)
+{
+    const size_t size = arr.GetSize();
+
+    if (grainSize < Alg::QuickSortThreshold + 1)
+        grainSize = Alg::QuickSortThreshold + 1;
+
+    JobCounter counter;
+    parallelSortRange(arr, 0, size, less, grainSize, Alg::QuickSortDepthLimit(size), &counter);
+    Wait(&counter);
+}
+
+template<class ArrayType, class Less>
+void JobSystem::parallelSortRange(ArrayType& arr, size_t start, size_t end, Less less,
+                                  size_t grainSize, int depth, JobCounter* counter)
+{
+    // Hand the right sub-array of each partition to another job and keep splitting the left one here.
+    while (end - start > grainSize && depth > 0)
+    {
+        size_t leftEnd, rightStart;
+        Alg::QuickSortPartition(arr, start, end, less, leftEnd, rightStart);
+        depth--;
+
+        Run([this, &arr, rightStart, end, less, grainSize, depth, counter]
+            { parallelSortRange(arr, rightStart, end, less, grainSize, depth, counter); }, counter);
+
+        end = leftEnd;
+    }
+
+    // Like QuickSortSliced, don't keep partitioning a sub-array that only gets lopsided splits.
+    if (end - start > grainSize)
+        Alg::HeapSortSliced(arr, start, end, less);
+    else
+        Alg::QuickSortSliced(arr, start, end, less);
+}
+
+
+}} // namespace OVR::Util
+
+#endif // OVR_Util_JobSystem_h
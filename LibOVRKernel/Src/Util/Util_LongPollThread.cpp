@@ -32,14 +32,155 @@ OVR_DEFINE_SINGLETON(OVR::Util::LongPollThread);
 namespace OVR { namespace Util {
 
 
+// The watchdog is fed at least this often even when no timer is due.
+static const int MaxSleepInterval = 5000; // milliseconds
+
+static uint64_t GetCurrentTimerTick()
+{
+    return Timer::GetTicksNanos() / (LongPollThread::TimerResolution * 1000000ULL);
+}
+
+static uint64_t MsecToTimerTicks(int msec)
+{
+    // Round up so timers never fire early.
+    return ((uint64_t)Alg::Max(msec, 0) + LongPollThread::TimerResolution - 1) / LongPollThread::TimerResolution;
+}
+
+
+//-----------------------------------------------------------------------------
+// PollTimer
+
+PollTimer::PollTimer() :
+    Handler(),
+    PeriodTicks(0),
+    Due(false),
+    Pending(false)
+{
+}
+
+PollTimer::PollTimer(LongPollThread::PollFunc handler) :
+    Handler(handler),
+    PeriodTicks(0),
+    Due(false),
+    Pending(false)
+{
+}
+
+PollTimer::~PollTimer()
+{
+    Cancel();
+}
+
+void PollTimer::SetHandler(LongPollThread::PollFunc handler)
+{
+    OVR_ASSERT(!IsPending());
+    Handler = handler;
+}
+
+void PollTimer::Cancel()
+{
+    // Timers that aren't pending can't be touched by the poll thread, which
+    // also keeps this from recreating the LongPollThread after shutdown.
+    if (IsPending())
+        LongPollThread::GetInstance()->RemoveTimer(this);
+}
+
+
+//-----------------------------------------------------------------------------
+// LongPollThread
+
 void LongPollThread::AddPollFunc(CallbackListener<PollFunc>* func)
 {
     PollSubject.AddListener(func);
+
+    bool wake = false;
+
+    {
+        std::lock_guard<std::mutex> locker(TimerLock);
+
+        if (!PollSubjectTimer->IsPending())
+            wake = schedule(PollSubjectTimer.get(), 0, WakeupInterval);
+    }
+
+    if (wake)
+        WakeEvent.SetEvent();
+}
+
+void LongPollThread::AddTimer(PollTimer* timer, int delayMsec, int periodMsec)
+{
+    bool wake = false;
+
+    {
+        std::lock_guard<std::mutex> locker(TimerLock);
+
+        wake = schedule(timer, delayMsec, periodMsec);
+    }
+
+    // The new deadline is earlier than the one the thread is sleeping towards.
+    if (wake)
+        WakeEvent.SetEvent();
+}
+
+void LongPollThread::RemoveTimer(PollTimer* timer)
+{
+    std::unique_lock<std::mutex> locker(TimerLock);
+
+    unschedule(timer);
+
+    // Wait for a handler running on the poll thread to return, unless we're being
+    // called from a handler, which would wait for itself.
+    if (std::this_thread::get_id() != LongPollThreadHandle->get_id())
+        HandlerDone.wait(locker, [this, timer] { return RunningTimer != timer; });
+}
+
+bool LongPollThread::schedule(PollTimer* timer, int delayMsec, int periodMsec)
+{
+    unschedule(timer);
+
+    const uint64_t now = GetCurrentTimerTick();
+    const uint64_t expireTick = now + MsecToTimerTicks(delayMsec);
+
+    uint64_t nextTick = 0;
+    const bool wake = !Timers.GetNextExpireTick(nextTick) || (expireTick < nextTick);
+
+    timer->PeriodTicks = (periodMsec > 0) ? Alg::Max(MsecToTimerTicks(periodMsec), (uint64_t)1) : 0;
+    timer->Pending.store(true, std::memory_order_release);
+    Timers.Insert(timer, expireTick);
+
+    return wake;
+}
+
+void LongPollThread::unschedule(PollTimer* timer)
+{
+    if (timer->Due)
+    {
+        timer->RemoveNode();
+        timer->Due = false;
+    }
+    else
+    {
+        Timers.Remove(timer);
+    }
+
+    timer->Pending.store(false, std::memory_order_release);
+
+    if (FiringTimer == timer)
+        FiringTimer = nullptr;
 }
 
 LongPollThread::LongPollThread() :
+    PollSubject(),
+    PollSubjectTimer(),
+    PollRequested(false),
+    TimerLock(),
+    Timers(GetCurrentTimerTick()),
+    FiringTimer(nullptr),
+    RunningTimer(nullptr),
+    HandlerDone(),
     Terminated(false)
 {
+    PollSubjectTimer = std::make_unique<PollTimer>(PollFunc::FromMember<LongPollThread, &LongPollThread::firePollSubject>(this));
+
     LongPollThreadHandle = std::make_unique<std::thread>([this] { this->Run(); });
 
     // Must be at end of function
@@ -56,17 +197,32 @@ void LongPollThread::OnThreadDestroy()
     fireTermination();
 
     LongPollThreadHandle->join();
+
+    // Leave any timers that outlive us unscheduled, so that destroying them later doesn't
+    // reach back into this object.
+    std::lock_guard<std::mutex> locker(TimerLock);
+
+    List<TimerWheelEntry> remaining;
+    Timers.Clear(&remaining);
+
+    while (!remaining.IsEmpty())
+    {
+        PollTimer* timer = static_cast<PollTimer*>(remaining.GetFirst());
+        timer->RemoveNode();
+        timer->Pending.store(false, std::memory_order_release);
+    }
 }
 
 void LongPollThread::Wake()
 {
+    PollRequested.store(true, std::memory_order_release);
     WakeEvent.SetEvent();
 }
 
 void LongPollThread::fireTermination()
 {
     Terminated.store(true, std::memory_order_relaxed);
-    Wake();
+    WakeEvent.SetEvent();
 }
 
 void LongPollThread::OnSystemDestroy()
@@ -75,6 +231,83 @@ void LongPollThread::OnSystemDestroy()
     delete this;
 }
 
+void LongPollThread::firePollSubject()
+{
+    PollSubject.Call();
+}
+
+int LongPollThread::fireTimers()
+{
+    if (PollRequested.exchange(false, std::memory_order_acq_rel))
+    {
+        // Wake() runs the poll functions right away and restarts their interval.
+        firePollSubject();
+
+        std::lock_guard<std::mutex> locker(TimerLock);
+
+        if (PollSubjectTimer->IsPending())
+            schedule(PollSubjectTimer.get(), WakeupInterval, WakeupInterval);
+    }
+
+    std::unique_lock<std::mutex> locker(TimerLock);
+
+    const uint64_t now = GetCurrentTimerTick();
+
+    List<TimerWheelEntry> due;
+    Timers.Advance(now, due);
+
+    for (TimerWheelEntry* entry = due.GetFirst(); !due.IsNull(entry); entry = due.GetNext(entry))
+        static_cast<PollTimer*>(entry)->Due = true;
+
+    // Handlers may add or remove any timer, including ones still waiting in the due list.
+    while (!due.IsEmpty())
+    {
+        PollTimer* timer = static_cast<PollTimer*>(due.GetFirst());
+        timer->RemoveNode();
+        timer->Due = false;
+
+        if (timer->PeriodTicks > 0)
+        {
+            // Keep repeating timers on their original phase, skipping any periods that were missed.
+            uint64_t nextTick = timer->GetExpireTick() + timer->PeriodTicks;
+            if (nextTick <= now)
+                nextTick += ((now - nextTick) / timer->PeriodTicks + 1) * timer->PeriodTicks;
+
+            Timers.Insert(timer, nextTick);
+        }
+
+        FiringTimer = timer;
+        RunningTimer = timer;
+        PollFunc handler = timer->Handler;
+
+        locker.unlock();
+        handler();
+        locker.lock();
+
+        // One-shot timers stay pending until their handler returns. If the timer was
+        // removed meanwhile it may already be destroyed, so leave it alone.
+        if ((FiringTimer == timer) && !timer->IsScheduled())
+            timer->Pending.store(false, std::memory_order_release);
+
+        FiringTimer = nullptr;
+        RunningTimer = nullptr;
+        HandlerDone.notify_all();
+    }
+
+    uint64_t nextTick = 0;
+    if (!Timers.GetNextExpireTick(nextTick))
+        return MaxSleepInterval;
+
+    // Sleep until the start of the deadline's tick.
+    const uint64_t nowMsec = Timer::GetTicksNanos() / 1000000;
+    const uint64_t nextMsec = nextTick * TimerResolution;
+
+    if (nextMsec <= nowMsec)
+        return 0;
+
+    return (int)Alg::Min(nextMsec - nowMsec, (uint64_t)MaxSleepInterval);
+}
+
 void LongPollThread::Run()
 {
     Thread::SetCurrentThreadName("LongPoll");
@@ -85,10 +318,13 @@ void LongPollThread::Run()
     {
         watchdog.Feed(10000);
 
-        PollSubject.Call();
-
-        WakeEvent.Wait(WakeupInterval);
+        // Reset before firing, so that timers added while we fire aren't missed.
         WakeEvent.ResetEvent();
+
+        const int sleepMsec = fireTimers();
+
+        if (sleepMsec > 0)
+            WakeEvent.Wait(sleepMsec);
     } while (!Terminated.load(std::memory_order_acquire));
 }
 
@@ -34,41 +34,118 @@ limitations under the License.
 #include "Kernel/OVR_System.h"
 #include "Kernel/OVR_Threads.h"
 #include "Kernel/OVR_Callbacks.h"
+#include "Util_TimerWheel.h"
+#include <thread>
 
 namespace OVR { namespace Util {
 
+class PollTimer;
+
 
 //-----------------------------------------------------------------------------
 // LongPollThread
 
 // This thread runs long-polling subsystems that wake up every second or so
 // The motivation is to reduce the number of threads that are running to minimize the risk of deadlock
+//
+// Each subsystem schedules its own PollTimer with its own period or deadline, and the thread
+// sleeps until the earliest one is due instead of waking at a fixed interval. Deadlines are
+// kept on a TimerWheel with TimerResolution granularity, so timers due within the same
+// tick are coalesced into a single wakeup.
 class LongPollThread : public SystemSingletonBase<LongPollThread>
 {
     OVR_DECLARE_SINGLETON(LongPollThread);
     virtual void OnThreadDestroy() override;
 
+    friend class PollTimer;
+
 public:
     typedef Delegate0<void> PollFunc;
     static const int WakeupInterval = 1000; // milliseconds
+    static const int TimerResolution = 10; // milliseconds
 
+    // Calls func every WakeupInterval, and whenever Wake() is called.
     void AddPollFunc(CallbackListener<PollFunc>* func);
 
+    // Schedules timer to call its handler on this thread after delayMsec, then every
+    // periodMsec if periodMsec is positive. Rescheduling a scheduled timer replaces its
+    // previous schedule.
+    void AddTimer(PollTimer* timer, int delayMsec, int periodMsec = 0);
+
+    // Unschedules timer. Once this returns, the timer's handler is not running and won't be called.
+    void RemoveTimer(PollTimer* timer);
+
     void Wake();
 
 protected:
     CallbackEmitter<PollFunc> PollSubject;
+    std::unique_ptr<PollTimer> PollSubjectTimer;
+    std::atomic<bool> PollRequested;
+
+    // Guards the wheel and the scheduling state of the timers. It is not held while
+    // handlers run, so they are free to wait on threads that schedule timers.
+    std::mutex TimerLock;
+    TimerWheel Timers;
+    PollTimer* FiringTimer;  // Cleared if the timer is removed while its handler runs.
+    PollTimer* RunningTimer; // Timer whose handler is running; RemoveTimer waits on HandlerDone for it.
+    std::condition_variable HandlerDone;
 
     std::atomic<bool> Terminated;
     Event WakeEvent;
     std::unique_ptr<std::thread> LongPollThreadHandle;
 
     void fireTermination();
+    void firePollSubject();
+    void unschedule(PollTimer* timer);
+
+    // Inserts timer into the wheel. TimerLock must be held. Returns true if the
+    // thread has to be woken because the timer is due before its next wakeup.
+    bool schedule(PollTimer* timer, int delayMsec, int periodMsec);
+
+    // Calls the handlers of all the timers that are due and returns the number of
+    // milliseconds until the next one is.
+    int fireTimers();
 
     void Run();
 };
 
 
+//-----------------------------------------------------------------------------
+// PollTimer
+
+// A one-shot or repeating timer run by LongPollThread. The timer is unscheduled
+// when it is destroyed.
+//
+// Example:
+//     PollTimer RefreshTimer;
+//     RefreshTimer.SetHandler(LongPollThread::PollFunc::FromMember<Foo, &Foo::Refresh>(this));
+//     LongPollThread::GetInstance()->AddTimer(&RefreshTimer, 0, 250);
+class PollTimer : public TimerWheelEntry, public NewOverrideBase
+{
+    friend class LongPollThread;
+
+public:
+    PollTimer();
+    explicit PollTimer(LongPollThread::PollFunc handler);
+    ~PollTimer();
+
+    // Must not be called while the timer is scheduled.
+    void SetHandler(LongPollThread::PollFunc handler);
+
+    bool IsPending() const { return Pending.load(std::memory_order_acquire); }
+
+    void Cancel();
+
+protected:
+    LongPollThread::PollFunc Handler;
+    uint64_t PeriodTicks;
+    bool Due; // Taken off the wheel and waiting in fireTimers() to be called.
+
+    // Mirrors whether the timer is in the wheel, so it can be checked without TimerLock.
+    std::atomic<bool> Pending;
+};
+
+
 }} // namespace OVR::Util
 
 #endif // OVR_Util_LongPollThread_h
@@ -0,0 +1,220 @@
+/************************************************************************************
+
+Filename    :   Util_TimerWheel.cpp
+Content     :   Hierarchical timer wheel for scheduling many deadlines cheaply
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2014-2016 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.3 (the "License");
+you may not use the Oculus VR Rift SDK except in compliance with the License,
+which is provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.3
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#include "Util_TimerWheel.h"
+#include "Kernel/OVR_Alg.h"
+
+namespace OVR { namespace Util {
+
+
+static const uint64_t SlotMask = TimerWheel::SlotCount - 1;
+
+// Number of ticks covered by all the levels together.
+static const uint64_t WheelSpan = (uint64_t)1 << (TimerWheel::SlotBits * TimerWheel::LevelCount);
+
+
+TimerWheel::TimerWheel(uint64_t currentTick) :
+    CurrentTick(currentTick),
+    EntryCount(0)
+{
+    for (int level = 0; level < LevelCount; ++level)
+        LevelEntryCount[level] = 0;
+}
+
+TimerWheel::~TimerWheel()
+{
+    Clear();
+}
+
+void TimerWheel::Insert(TimerWheelEntry* entry, uint64_t expireTick)
+{
+    OVR_ASSERT(!entry->IsScheduled());
+
+    entry->ExpireTick = Alg::Max(expireTick, CurrentTick);
+    place(entry);
+    ++EntryCount;
+}
+
+void TimerWheel::Remove(TimerWheelEntry* entry)
+{
+    if (entry->IsScheduled())
+    {
+        entry->RemoveNode();
+        --LevelEntryCount[entry->Level];
+        --EntryCount;
+    }
+}
+
+void TimerWheel::place(TimerWheelEntry* entry)
+{
+    const uint64_t delta = entry->ExpireTick - CurrentTick;
+
+    // Deadlines beyond the wheel's span wait in the furthest slot and are re-filed from there.
+    const uint64_t slotTick = (delta < WheelSpan) ? entry->ExpireTick : (CurrentTick + WheelSpan - 1);
+
+    int level = 0;
+    while ((level < LevelCount - 1) && (delta >= ((uint64_t)1 << (SlotBits * (level + 1)))))
+        ++level;
+
+    entry->Level = level;
+    Slots[level][(slotTick >> (SlotBits * level)) & SlotMask].PushBack(entry);
+    ++LevelEntryCount[level];
+}
+
+void TimerWheel::cascade(int level)
+{
+    List<TimerWheelEntry>& slot = Slots[level][(CurrentTick >> (SlotBits * level)) & SlotMask];
+
+    while (!slot.IsEmpty())
+    {
+        TimerWheelEntry* entry = slot.GetFirst();
+        entry->RemoveNode();
+        --LevelEntryCount[level];
+        place(entry);
+    }
+}
+
+void TimerWheel::Advance(uint64_t tick, List<TimerWheelEntry>& expired)
+{
+    for (;;)
+    {
+        // Every entry in the current level 0 slot expires at CurrentTick.
+        List<TimerWheelEntry>& slot = Slots[0][CurrentTick & SlotMask];
+
+        while (!slot.IsEmpty())
+        {
+            TimerWheelEntry* entry = slot.GetFirst();
+            entry->RemoveNode();
+            --LevelEntryCount[0];
+            --EntryCount;
+            expired.PushBack(entry);
+        }
+
+        if (CurrentTick >= tick)
+            break;
+
+        if (EntryCount == 0)
+        {
+            CurrentTick = tick;
+            break;
+        }
+
+        if (LevelEntryCount[0] == 0)
+        {
+            // Nothing can expire before the next level 0 rotation, so skip straight to it.
+            const uint64_t rotationTick = (CurrentTick | SlotMask) + 1;
+
+            if (rotationTick > tick)
+            {
+                CurrentTick = tick;
+                break;
+            }
+
+            CurrentTick = rotationTick;
+        }
+        else
+        {
+            ++CurrentTick;
+        }
+
+        // Refill the lower levels from the top down, so entries cascading out of a
+        // higher level land in lower-level slots that haven't been emptied yet.
+        int topLevel = 0;
+        while ((topLevel < LevelCount - 1) && ((CurrentTick & (((uint64_t)1 << (SlotBits * (topLevel + 1))) - 1)) == 0))
+            ++topLevel;
+
+        for (int level = topLevel; level > 0; --level)
+            cascade(level);
+    }
+}
+
+bool TimerWheel::GetNextExpireTick(uint64_t& tick) const
+{
+    if (EntryCount == 0)
+        return false;
+
+    bool found = false;
+    uint64_t earliest = 0;
+
+    for (int level = 0; level < LevelCount; ++level)
+    {
+        if (LevelEntryCount[level] == 0)
+            continue;
+
+        // Slots are visited in time order starting from the current one, so the first
+        // non-empty slot holds this level's earliest entries. The exception is the last
+        // level, where parked entries are filed earlier than their real deadline.
+        const uint64_t currentSlot = (CurrentTick >> (SlotBits * level)) & SlotMask;
+
+        for (uint64_t i = 0; i < (uint64_t)SlotCount; ++i)
+        {
+            // The current slot of a higher level holds entries a full rotation away.
+            const uint64_t offset = (level == 0) ? i : ((i + 1) & SlotMask);
+            const List<TimerWheelEntry>& slot = Slots[level][(currentSlot + offset) & SlotMask];
+
+            if (slot.IsEmpty())
+                continue;
+
+            for (const TimerWheelEntry* entry = slot.GetFirst(); !slot.IsNull(entry); entry = slot.GetNext(entry))
+            {
+                if (!found || (entry->ExpireTick < earliest))
+                {
+                    earliest = entry->ExpireTick;
+                    found = true;
+                }
+            }
+
+            if (level < LevelCount - 1)
+                break;
+        }
+    }
+
+    tick = earliest;
+    return found;
+}
+
+void TimerWheel::Clear(List<TimerWheelEntry>* removed)
+{
+    for (int level = 0; level < LevelCount; ++level)
+    {
+        for (int i = 0; i < SlotCount; ++i)
+        {
+            List<TimerWheelEntry>& slot = Slots[level][i];
+
+            if (removed)
+                removed->PushListToBack(slot);
+
+            while (!slot.IsEmpty())
+                slot.GetFirst()->RemoveNode();
+        }
+
+        LevelEntryCount[level] = 0;
+    }
+
+    EntryCount = 0;
+}
+
+
+}} // namespace OVR::Util
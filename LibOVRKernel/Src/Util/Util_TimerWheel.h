@@ -0,0 +1,114 @@
+/************************************************************************************
+
+Filename    :   Util_TimerWheel.h
+Content     :   Hierarchical timer wheel for scheduling many deadlines cheaply
+Created     :   October 18, 2026
+
+Copyright   :   Copyright 2014-2016 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.3 (the "License");
+you may not use the Oculus VR Rift SDK except in compliance with the License,
+which is provided at the time of installation or download, or which
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.3
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*************************************************************************************/
+
+#ifndef OVR_Util_TimerWheel_h
+#define OVR_Util_TimerWheel_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_List.h"
+
+namespace OVR { namespace Util {
+
+
+//-----------------------------------------------------------------------------
+// TimerWheelEntry
+
+// Base class for anything scheduled on a TimerWheel. An entry is in at most one
+// wheel at a time and is linked directly into the wheel's slot lists.
+
+class TimerWheelEntry : public ListNode<TimerWheelEntry>
+{
+    friend class TimerWheel;
+
+public:
+    TimerWheelEntry() : ExpireTick(0), Level(0) { }
+
+    bool     IsScheduled()   { return IsInList(); }
+    uint64_t GetExpireTick() const { return ExpireTick; }
+
+protected:
+    uint64_t ExpireTick;
+    int      Level;
+};
+
+
+//-----------------------------------------------------------------------------
+// TimerWheel
+
+// Hashed hierarchical timer wheel (Varghese and Lauck) of LevelCount levels with
+// SlotCount slots each. Level 0 covers the next SlotCount ticks one tick per slot,
+// and each higher level covers SlotCount times the span of the level below. Entries
+// move down a level when the wheel reaches their slot, so insertion and removal are
+// O(1) and advancing costs O(1) per tick plus the entries that expire.
+//
+// Ticks are in whatever unit the owner chooses; deadlines that fall in the same tick
+// expire together. Deadlines further out than the wheel's span are parked in the last
+// level and re-filed when reached. The wheel does no locking of its own.
+
+class TimerWheel
+{
+public:
+    static const int LevelCount = 4;
+    static const int SlotBits   = 6;
+    static const int SlotCount  = (1 << SlotBits);
+
+    TimerWheel(uint64_t currentTick = 0);
+    ~TimerWheel();
+
+    uint64_t GetCurrentTick() const { return CurrentTick; }
+    bool     IsEmpty() const        { return EntryCount == 0; }
+
+    // Schedules entry to expire at expireTick. Ticks in the past expire on the next Advance.
+    // The entry must not already be scheduled.
+    void Insert(TimerWheelEntry* entry, uint64_t expireTick);
+
+    // Unschedules entry. Does nothing if the entry isn't in a list.
+    void Remove(TimerWheelEntry* entry);
+
+    // Moves the wheel forward to tick and moves every entry that expired at or before
+    // it to expired, in expiry order. The caller must unlink them from expired before
+    // scheduling them again.
+    void Advance(uint64_t tick, List<TimerWheelEntry>& expired);
+
+    // Gets the tick of the earliest scheduled entry. Returns false if the wheel is empty.
+    bool GetNextExpireTick(uint64_t& tick) const;
+
+    // Unschedules all entries, moving them to removed if it is non-null.
+    void Clear(List<TimerWheelEntry>* removed = nullptr);
+
+protected:
+    uint64_t              CurrentTick;
+    int                   EntryCount;
+    int                   LevelEntryCount[LevelCount];
+    List<TimerWheelEntry> Slots[LevelCount][SlotCount];
+
+    void place(TimerWheelEntry* entry);
+    void cascade(int level);
+};
+
+
+}} // namespace OVR::Util
+
+#endif // OVR_Util_TimerWheel_h
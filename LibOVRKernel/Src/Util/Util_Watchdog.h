@@ -102,7 +102,7 @@ public:
 
 protected:
     Lock ListLock;
-    Array< WatchDog* > DogList;
+    SmallArray< WatchDog*, 8 > DogList;
 
     // This indicates that EnableReporting() was requested
     bool IsReporting = false;
@@ -0,0 +1,116 @@
+/************************************************************************************
+
+Filename    :   KernelTests.cpp
+Content     :   Entry point of the LibOVRKernel correctness tests and benchmarks
+Created     :   October 18, 2026
+Notes       :
+
+Copyright   :   Copyright 2014-2016 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.3 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.3 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "KernelTests.h"
+#include "Kernel/OVR_Std.h"
+#include "Kernel/OVR_System.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace OVR { namespace KernelTests {
+
+static int FailureCount = 0;
+
+bool Check(bool condition, const char* expression, const char* file, int line)
+{
+    if (!condition)
+    {
+        if (++FailureCount <= 50) // Don't flood the output when a fuzz test goes wrong.
+            printf("FAILED: %s (%s:%d)\n", expression, file, line);
+    }
+    return condition;
+}
+
+void ReportBenchmark(const char* name, double seconds, double itemCount)
+{
+    printf("  %-48s %10.1f ns\n", name, (seconds * 1e9) / itemCount);
+}
+
+double Random::NextFiniteDouble()
+{
+    for (;;)
+    {
+        uint64_t bits = Next();
+        if (((bits >> 52) & 0x7FF) != 0x7FF)
+        {
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            return d;
+        }
+    }
+}
+
+}} // namespace OVR::KernelTests
+
+
+// Usage: LibOVRKernelTests [-bench] [suite name...]
+// Runs all suites if none are named. Returns nonzero if any check failed.
+int main(int argc, char** argv)
+{
+    using namespace OVR::KernelTests;
+
+    static const struct
+    {
+        const char* Name;
+        void (*Run)(bool benchmark);
+    } Suites[] =
+    {
+        { "Std",  TestStd },
+        { "JSON", TestJSON },
+        { "Sort", TestSort }
+    };
+
+    bool benchmark = false;
+    int  suiteArgs = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-bench") == 0)
+            benchmark = true;
+        else
+            suiteArgs++;
+    }
+
+    OVR::System::Init();
+
+    for (size_t s = 0; s < OVR_ARRAY_COUNT(Suites); ++s)
+    {
+        bool selected = (suiteArgs == 0);
+        for (int i = 1; i < argc; ++i)
+            selected |= (OVR::OVR_stricmp(argv[i], Suites[s].Name) == 0);
+
+        if (selected)
+        {
+            printf("%s\n", Suites[s].Name);
+            Suites[s].Run(benchmark);
+        }
+    }
+
+    OVR::System::Destroy();
+
+    printf("%d check(s) failed\n", FailureCount);
+    return (FailureCount == 0) ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+/************************************************************************************
+
+Filename    :   KernelTests.h
+Content     :   Minimal check and benchmark helpers for the LibOVRKernel tests
+Created     :   October 18, 2026
+Notes       :
+
+Copyright   :   Copyright 2014-2016 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.3 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.3 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#ifndef OVR_KernelTests_h
+#define OVR_KernelTests_h
+
+#include "Kernel/OVR_Types.h"
+
+namespace OVR { namespace KernelTests {
+
+// Reports a failed check without stopping the test, and counts it towards the exit code.
+// Returns condition.
+bool Check(bool condition, const char* expression, const char* file, int line);
+
+#define OVR_TEST_CHECK(expression) OVR::KernelTests::Check(!!(expression), #expression, __FILE__, __LINE__)
+
+// Prints one benchmark result line, as the time per item in nanoseconds.
+void ReportBenchmark(const char* name, double seconds, double itemCount);
+
+// Deterministic xorshift64* generator, so that a failing input can be reproduced from
+// the seed printed by the test.
+class Random
+{
+public:
+    explicit Random(uint64_t seed) : State(seed ? seed : 0x9E3779B97F4A7C15ULL) {}
+
+    uint64_t Next()
+    {
+        State ^= State >> 12;
+        State ^= State << 25;
+        State ^= State >> 27;
+        return State * 0x2545F4914F6CDD1DULL;
+    }
+
+    // Uniform in [0, range).
+    uint32_t NextUInt(uint32_t range) { return (uint32_t)(((Next() >> 32) * range) >> 32); }
+
+    // Any finite double, with all bit patterns equally likely.
+    double NextFiniteDouble();
+
+protected:
+    uint64_t State;
+};
+
+// Test suites. When benchmark is true, the suite also times its hot paths.
+void TestJSON(bool benchmark);
+void TestStd(bool benchmark);
+void TestSort(bool benchmark);
+
+}} // namespace OVR::KernelTests
+
+#endif // OVR_KernelTests_h
@@ -0,0 +1,259 @@
+/************************************************************************************
+
+Filename    :   Test_JSON.cpp
+Content     :   Round-trip fuzz test and number formatting benchmark for OVR::JSON
+Created     :   October 18, 2026
+Notes       :
+
+Copyright   :   Copyright 2014-2016 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.3 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.3 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "KernelTests.h"
+#include "Kernel/OVR_JSON.h"
+#include "Kernel/OVR_Std.h"
+#include "Kernel/OVR_Timer.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace OVR { namespace KernelTests {
+
+static bool SameDouble(double a, double b)
+{
+    // The JSON printer writes integral values as ints, so -0 comes back as 0.
+    return (memcmp(&a, &b, sizeof(a)) == 0) || ((a == 0.0) && (b == 0.0));
+}
+
+static int CountSignificantDigits(const char* text)
+{
+    int digits  = 0;
+    int pending = 0; // Zeros which only count if a nonzero digit follows.
+
+    for (const char* p = text; *p && (*p != 'e'); ++p)
+    {
+        if (*p == '0')
+        {
+            pending += (digits > 0) ? 1 : 0;
+        }
+        else if ((*p >= '1') && (*p <= '9'))
+        {
+            digits += pending + 1;
+            pending = 0;
+        }
+    }
+    return digits;
+}
+
+// Values like the ones in our calibration and settings files: short decimals, floats
+// widened to double, small integers, and arbitrary bit patterns.
+static double NextTestNumber(Random& random)
+{
+    switch (random.NextUInt(4))
+    {
+        case 0:
+        {
+            static const double Scales[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7 };
+            double n = (double)random.NextUInt(100000000) / Scales[random.NextUInt(8)];
+            return random.NextUInt(2) ? -n : n;
+        }
+        case 1:
+            return (double)(float)((double)(int32_t)random.Next() * 1e-9);
+        case 2:
+            return (double)(int32_t)random.Next() * 4.0; // Mostly outside the int range of the printer.
+        default:
+            return random.NextFiniteDouble();
+    }
+}
+
+static void TestNumberFormatting()
+{
+    static const struct
+    {
+        double      Value;
+        const char* Text;
+    } Cases[] =
+    {
+        { 0.0,                     "0" },
+        { -0.0,                    "-0" },
+        { 0.1,                     "0.1" },
+        { 0.3,                     "0.3" },
+        { 1.0 / 3.0,               "0.3333333333333333" },
+        { -42.25,                  "-42.25" },
+        { 1.5e-6,                  "0.0000015" },
+        { 1e-7,                    "1e-7" },
+        { 1e20,                    "100000000000000000000" },
+        { 1e21,                    "1e+21" },
+        { 5e-324,                  "5e-324" },
+        { 2.2250738585072014e-308, "2.2250738585072014e-308" },
+        { 1.7976931348623157e308,  "1.7976931348623157e+308" }
+    };
+
+    char buffer[OVR_dtoaMaxSize];
+
+    for (size_t i = 0; i < OVR_ARRAY_COUNT(Cases); ++i)
+    {
+        if (!OVR_TEST_CHECK(strcmp(OVR_dtoa(Cases[i].Value, buffer, sizeof(buffer)), Cases[i].Text) == 0))
+            printf("  expected %s, got %s\n", Cases[i].Text, buffer);
+    }
+
+    OVR_TEST_CHECK(strcmp(OVR_dtoa(-HUGE_VAL, buffer, sizeof(buffer)), "-inf") == 0);
+    OVR_TEST_CHECK(strcmp(OVR_dtoa(OVR_strtod("nan", nullptr), buffer, sizeof(buffer)), "nan") == 0);
+    OVR_TEST_CHECK(strcmp(OVR_dtoa(123.5, buffer, 5), "") == 0);
+    OVR_TEST_CHECK(strcmp(OVR_dtoa(123.5, buffer, 6), "123.5") == 0);
+}
+
+// Every finite double must print as at most 17 significant digits which read back as
+// the identical double.
+static void FuzzNumberRoundTrip(uint64_t seed, int count)
+{
+    Random random(seed);
+    char   buffer[OVR_dtoaMaxSize];
+
+    for (int i = 0; i < count; ++i)
+    {
+        double d = (i & 1) ? random.NextFiniteDouble() : NextTestNumber(random);
+        OVR_dtoa(d, buffer, sizeof(buffer));
+
+        char*  end;
+        double readBack = OVR_strtod(buffer, &end);
+
+        if (!OVR_TEST_CHECK(SameDouble(readBack, d) && (*end == '\0') && (CountSignificantDigits(buffer) <= 17)))
+            printf("  seed %llu: %.17g printed as %s\n", (unsigned long long)seed, d, buffer);
+    }
+}
+
+// Whole documents written by AddNumberArray must parse back to the identical values.
+static void FuzzDocumentRoundTrip(uint64_t seed, int documentCount, int numbersPerDocument)
+{
+    Random  random(seed);
+    double* values   = new double[numbersPerDocument];
+    double* readBack = new double[numbersPerDocument];
+
+    for (int doc = 0; doc < documentCount; ++doc)
+    {
+        for (int i = 0; i < numbersPerDocument; ++i)
+            values[i] = NextTestNumber(random);
+
+        JSON* root = JSON::CreateObject();
+        root->AddNumberArray("Values", values, numbersPerDocument);
+
+        char* text   = root->PrintValue((doc & 1) != 0); // Alternate between formatted and compact output.
+        JSON* parsed = text ? JSON::Parse(text) : nullptr;
+
+        if (OVR_TEST_CHECK(parsed != nullptr))
+        {
+            OVR_TEST_CHECK(parsed->GetArrayByName<double>("Values", readBack, numbersPerDocument) == numbersPerDocument);
+
+            for (int i = 0; i < numbersPerDocument; ++i)
+            {
+                if (!OVR_TEST_CHECK(SameDouble(readBack[i], values[i])))
+                    printf("  seed %llu, document %d: %.17g read back as %.17g\n", (unsigned long long)seed, doc, values[i], readBack[i]);
+            }
+            parsed->Release();
+        }
+
+        OVR_FREE(text);
+        root->Release();
+    }
+
+    delete[] values;
+    delete[] readBack;
+}
+
+// Writes and reads back a document shaped like our calibration files: a few dozen float
+// arrays of a few hundred entries each, stored with AddNumberArray.
+static void BenchmarkNumberArrays()
+{
+    const int ArrayCount  = 64;
+    const int ArraySize   = 512;
+    const int Repetitions = 20;
+    const double NumberCount = (double)ArrayCount * ArraySize * Repetitions;
+
+    Random random(26);
+    float* samples = new float[ArraySize];
+
+    JSON* root = JSON::CreateObject();
+    for (int a = 0; a < ArrayCount; ++a)
+    {
+        for (int i = 0; i < ArraySize; ++i)
+            samples[i] = (float)((double)(int32_t)random.Next() * 1e-9);
+
+        char name[32];
+        snprintf(name, sizeof(name), "Calibration%d", a);
+        root->AddNumberArray(name, samples, ArraySize);
+    }
+
+    double start = Timer::GetSeconds();
+    char*  text  = nullptr;
+    for (int r = 0; r < Repetitions; ++r)
+    {
+        OVR_FREE(text);
+        text = root->PrintValue(false);
+    }
+    ReportBenchmark("JSON::PrintValue, AddNumberArray floats", Timer::GetSeconds() - start, NumberCount);
+
+    start = Timer::GetSeconds();
+    for (int r = 0; r < Repetitions; ++r)
+    {
+        JSON* parsed = JSON::Parse(text);
+        OVR_TEST_CHECK(parsed != nullptr);
+        if (parsed)
+            parsed->Release();
+    }
+    ReportBenchmark("JSON::Parse, AddNumberArray floats", Timer::GetSeconds() - start, NumberCount);
+
+    // The formatting alone, against the CRT formatting it replaced.
+    char   buffer[OVR_dtoaMaxSize];
+    size_t checksum = 0;
+
+    start = Timer::GetSeconds();
+    for (int r = 0; r < Repetitions; ++r)
+    {
+        for (int i = 0; i < ArraySize * ArrayCount; ++i)
+            checksum += strlen(OVR_dtoa((double)samples[i % ArraySize] * (i + 1), buffer, sizeof(buffer)));
+    }
+    ReportBenchmark("OVR_dtoa", Timer::GetSeconds() - start, NumberCount);
+
+    start = Timer::GetSeconds();
+    for (int r = 0; r < Repetitions; ++r)
+    {
+        for (int i = 0; i < ArraySize * ArrayCount; ++i)
+            checksum += (size_t)snprintf(buffer, sizeof(buffer), "%.17g", (double)samples[i % ArraySize] * (i + 1));
+    }
+    ReportBenchmark("snprintf(\"%.17g\")", Timer::GetSeconds() - start, NumberCount);
+
+    printf("  (%u bytes of JSON, checksum %u)\n", (unsigned)strlen(text), (unsigned)checksum);
+
+    OVR_FREE(text);
+    root->Release();
+    delete[] samples;
+}
+
+void TestJSON(bool benchmark)
+{
+    TestNumberFormatting();
+    FuzzNumberRoundTrip(1, 1000000);
+    FuzzDocumentRoundTrip(2, 200, 1000);
+
+    if (benchmark)
+        BenchmarkNumberArrays();
+}
+
+}} // namespace OVR::KernelTests
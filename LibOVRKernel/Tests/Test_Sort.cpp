@@ -0,0 +1,297 @@
+/************************************************************************************
+
+Filename    :   Test_Sort.cpp
+Content     :   Sort checks and benchmarks for OVR_Alg and JobSystem::ParallelSort
+Created     :   October 18, 2026
+Notes       :
+
+Copyright   :   Copyright 2014-2016 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.3 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.3 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "KernelTests.h"
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_Timer.h"
+#include "Util/Util_JobSystem.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+namespace OVR { namespace KernelTests {
+
+enum SortPattern
+{
+    Pattern_Random,
+    Pattern_Sorted,
+    Pattern_Reversed,
+    Pattern_FewUnique,
+    Pattern_Equal,
+    Pattern_Sawtooth,
+    Pattern_OrganPipe,
+    Pattern_NearlySorted,
+    Pattern_Count
+};
+
+static const char* const SortPatternNames[Pattern_Count] =
+{
+    "random", "sorted", "reversed", "few unique", "equal", "sawtooth", "organ pipe", "nearly sorted"
+};
+
+static void FillPattern(Array<int>& arr, SortPattern pattern, size_t count, Random& random)
+{
+    arr.Resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        switch (pattern)
+        {
+            case Pattern_Random:       arr[i] = (int)random.Next(); break;
+            case Pattern_Sorted:       arr[i] = (int)i; break;
+            case Pattern_Reversed:     arr[i] = (int)(count - i); break;
+            case Pattern_FewUnique:    arr[i] = (int)random.NextUInt(8); break;
+            case Pattern_Equal:        arr[i] = 7; break;
+            case Pattern_Sawtooth:     arr[i] = (int)(i % 100); break;
+            case Pattern_OrganPipe:    arr[i] = (int)((i < count / 2) ? i : (count - i)); break;
+            case Pattern_NearlySorted: arr[i] = (random.NextUInt(100) == 0) ? (int)random.Next() : (int)i; break;
+            default:                   break;
+        }
+    }
+}
+
+static bool SameElements(const Array<int>& a, const Array<int>& b)
+{
+    return (a.GetSize() == b.GetSize()) &&
+           ((a.GetSize() == 0) || (memcmp(a.GetDataPtr(), b.GetDataPtr(), a.GetSize() * sizeof(int)) == 0));
+}
+
+//-----------------------------------------------------------------------------
+// McIlroy's adversary ("A Killer Adversary for Quicksort", 1999). The values start out
+// unknown ("gas") and are only fixed when the sort compares two of them, always in the
+// way which hurts the sort most. Sorting the indices 0..n-1 with Less both counts the
+// comparisons and leaves behind, in Values, a concrete input that replays the same
+// worst case for the sort when sorted as plain ints.
+
+class McIlroyAdversary
+{
+public:
+    explicit McIlroyAdversary(size_t count) : Gas((int)count), Solid(0), Candidate(0), Comparisons(0)
+    {
+        Values.Resize(count);
+        for (size_t i = 0; i < count; ++i)
+            Values[i] = Gas;
+    }
+
+    struct Less
+    {
+        McIlroyAdversary* Adversary;
+
+        bool operator()(const int& x, const int& y) const
+        {
+            return Adversary->compare(x, y);
+        }
+    };
+
+    Less GetLess() { Less less = { this }; return less; }
+
+    Array<int> Values;
+    int        Gas;
+    int        Solid;
+    int        Candidate;
+    uint64_t   Comparisons;
+
+protected:
+    bool compare(int x, int y)
+    {
+        Comparisons++;
+        if ((Values[x] == Gas) && (Values[y] == Gas))
+        {
+            if (x == Candidate)
+                Values[x] = Solid++;
+            else
+                Values[y] = Solid++;
+        }
+
+        if (Values[x] == Gas)
+            Candidate = x;
+        else if (Values[y] == Gas)
+            Candidate = y;
+
+        return Values[x] < Values[y];
+    }
+};
+
+// Builds the killer input for QuickSort of the given size.
+static void FillMcIlroyAdversary(Array<int>& arr, size_t count, uint64_t* comparisons)
+{
+    McIlroyAdversary adversary(count);
+
+    Array<int> indices;
+    indices.Resize(count);
+    for (size_t i = 0; i < count; ++i)
+        indices[i] = (int)i;
+
+    Alg::QuickSort(indices, adversary.GetLess());
+
+    arr.Resize(count);
+    for (size_t i = 0; i < count; ++i)
+        arr[i] = adversary.Values[i];
+
+    if (comparisons)
+        *comparisons = adversary.Comparisons;
+}
+
+//-----------------------------------------------------------------------------
+
+static void TestSortPatterns(Random& random)
+{
+    static const size_t Sizes[] = { 0, 1, 2, 3, 16, 17, 100, 129, 1000, 4097, 100000 };
+
+    Util::JobSystem* jobs = Util::JobSystem::GetInstance();
+    Array<int> input, expected, sorted, scratch;
+
+    for (int pattern = 0; pattern < Pattern_Count; ++pattern)
+    {
+        for (size_t s = 0; s < OVR_ARRAY_COUNT(Sizes); ++s)
+        {
+            const size_t count = Sizes[s];
+            FillPattern(input, (SortPattern)pattern, count, random);
+            expected = input;
+            std::sort(expected.GetDataPtr(), expected.GetDataPtr() + count);
+
+            sorted = input;
+            Alg::QuickSort(sorted);
+            if (!OVR_TEST_CHECK(SameElements(sorted, expected)))
+                printf("  QuickSort, %s, %u elements\n", SortPatternNames[pattern], (unsigned)count);
+
+            sorted = input;
+            OVR_TEST_CHECK(Alg::QuickSortSafe(sorted) && SameElements(sorted, expected));
+
+            sorted = input;
+            jobs->ParallelSort(sorted, Alg::OperatorLess<int>::Compare, 1000);
+            if (!OVR_TEST_CHECK(SameElements(sorted, expected)))
+                printf("  ParallelSort, %s, %u elements\n", SortPatternNames[pattern], (unsigned)count);
+
+            sorted = input;
+            scratch.Resize(count);
+            Alg::RadixSort(sorted.GetDataPtr(), scratch.GetDataPtr(), count);
+            if (!OVR_TEST_CHECK(SameElements(sorted, expected)))
+                printf("  RadixSort, %s, %u elements\n", SortPatternNames[pattern], (unsigned)count);
+
+            if (count > 6)
+            {
+                // Only the slice may change.
+                sorted = input;
+                expected = input;
+                std::sort(expected.GetDataPtr() + 3, expected.GetDataPtr() + count - 3);
+                Alg::QuickSortSliced(sorted, 3, count - 3);
+                OVR_TEST_CHECK(SameElements(sorted, expected));
+            }
+        }
+    }
+}
+
+// The adversary drives a plain quicksort to n^2 / 2 comparisons; the introsort depth
+// limit must keep QuickSort within a small multiple of n log n.
+static void TestSortAdversary()
+{
+    static const size_t Sizes[] = { 1000, 10000, 100000 };
+
+    for (size_t s = 0; s < OVR_ARRAY_COUNT(Sizes); ++s)
+    {
+        uint64_t   comparisons = 0;
+        Array<int> killer;
+        FillMcIlroyAdversary(killer, Sizes[s], &comparisons);
+
+        const double n     = (double)Sizes[s];
+        const double nLogN = n * log(n) / log(2.0);
+        if (!OVR_TEST_CHECK((double)comparisons < 4.0 * nLogN))
+            printf("  %u elements took %.1f n log n comparisons\n", (unsigned)Sizes[s], (double)comparisons / nLogN);
+
+        Array<int> expected = killer;
+        std::sort(expected.GetDataPtr(), expected.GetDataPtr() + expected.GetSize());
+        Alg::QuickSort(killer);
+        OVR_TEST_CHECK(SameElements(killer, expected));
+    }
+}
+
+static void BenchmarkSorts(Random& random)
+{
+    const size_t Count = 1000000;
+
+    Util::JobSystem* jobs = Util::JobSystem::GetInstance();
+    Array<int> input, sorted, scratch;
+    scratch.Resize(Count);
+
+    printf("  %u ints, ns per element (%d job workers)\n", (unsigned)Count, jobs->GetWorkerCount());
+
+    for (int pattern = 0; pattern <= Pattern_Count; ++pattern)
+    {
+        const char* patternName;
+        if (pattern < Pattern_Count)
+        {
+            FillPattern(input, (SortPattern)pattern, Count, random);
+            patternName = SortPatternNames[pattern];
+        }
+        else
+        {
+            FillMcIlroyAdversary(input, Count, nullptr);
+            patternName = "McIlroy adversary";
+        }
+
+        double times[4];
+
+        sorted = input;
+        double start = Timer::GetSeconds();
+        Alg::QuickSort(sorted);
+        times[0] = Timer::GetSeconds() - start;
+
+        sorted = input;
+        start = Timer::GetSeconds();
+        std::sort(sorted.GetDataPtr(), sorted.GetDataPtr() + Count);
+        times[1] = Timer::GetSeconds() - start;
+
+        sorted = input;
+        start = Timer::GetSeconds();
+        jobs->ParallelSort(sorted);
+        times[2] = Timer::GetSeconds() - start;
+
+        sorted = input;
+        start = Timer::GetSeconds();
+        Alg::RadixSort(sorted.GetDataPtr(), scratch.GetDataPtr(), Count);
+        times[3] = Timer::GetSeconds() - start;
+
+        const double nsPerElement = 1e9 / (double)Count;
+        printf("  %-18s QuickSort %6.1f  std::sort %6.1f  ParallelSort %6.1f  RadixSort %6.1f\n", patternName,
+               times[0] * nsPerElement, times[1] * nsPerElement, times[2] * nsPerElement, times[3] * nsPerElement);
+    }
+}
+
+void TestSort(bool benchmark)
+{
+    Random random(49);
+
+    TestSortPatterns(random);
+    TestSortAdversary();
+
+    if (benchmark)
+        BenchmarkSorts(random);
+}
+
+}} // namespace OVR::KernelTests
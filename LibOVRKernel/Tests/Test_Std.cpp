@@ -0,0 +1,447 @@
+/************************************************************************************
+
+Filename    :   Test_Std.cpp
+Content     :   Round-trip tests and microbenchmarks for the OVR_Std number conversions
+Created     :   October 18, 2026
+Notes       :
+
+Copyright   :   Copyright 2014-2016 Oculus VR, LLC All Rights reserved.
+
+Licensed under the Oculus VR Rift SDK License Version 3.3 (the "License"); 
+you may not use the Oculus VR Rift SDK except in compliance with the License, 
+which is provided at the time of installation or download, or which 
+otherwise accompanies this software in either electronic or hard copy form.
+
+You may obtain a copy of the License at
+
+http://www.oculusvr.com/licenses/LICENSE-3.3 
+
+Unless required by applicable law or agreed to in writing, the Oculus VR SDK 
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+#include "KernelTests.h"
+#include "Kernel/OVR_Std.h"
+#include "Kernel/OVR_Timer.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace OVR { namespace KernelTests {
+
+static uint64_t DoubleBits(double d)
+{
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+static double BitsDouble(uint64_t bits)
+{
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+static void TestStrtodCases()
+{
+    static const struct
+    {
+        const char* Text;
+        uint64_t    Bits;
+        int         Consumed;
+    } Cases[] =
+    {
+        { "0",                                   0x0000000000000000ULL, 1 },
+        { "-0",                                  0x8000000000000000ULL, 2 },
+        { "1e400",                               0x7FF0000000000000ULL, 5 },
+        { "-1e400",                              0xFFF0000000000000ULL, 6 },
+        { "1e-400",                              0x0000000000000000ULL, 6 },
+        { "1e-1000000000000",                    0x0000000000000000ULL, 16 },
+        { "4.9e-324",                            0x0000000000000001ULL, 8 },
+        { "2.4703282292062327e-324",             0x0000000000000000ULL, 23 }, // Just below half the smallest denormal.
+        { "2.4703282292062328e-324",             0x0000000000000001ULL, 23 },
+        { "2.2250738585072011e-308",             0x000FFFFFFFFFFFFFULL, 23 },
+        { "2.2250738585072014e-308",             0x0010000000000000ULL, 23 },
+        { "1.7976931348623157e308",              0x7FEFFFFFFFFFFFFFULL, 22 },
+        { "1.7976931348623158e308",              0x7FEFFFFFFFFFFFFFULL, 22 },
+        { "1.7976931348623159e308",              0x7FF0000000000000ULL, 22 },
+        { "9007199254740993",                    0x4340000000000000ULL, 16 }, // Halfway, ties to even.
+        { "9007199254740993.0000000000000000001", 0x4340000000000001ULL, 36 },
+        { "1e23",                                0x44B52D02C7E14AF6ULL, 4 },
+        { "3.14159265358979323846264338327950288419716939937510", 0x400921FB54442D18ULL, 52 },
+        { "0x1p-1074",                           0x0000000000000001ULL, 9 },
+        { "0x1.fffffffffffffp1023",              0x7FEFFFFFFFFFFFFFULL, 22 },
+        { "0x",                                  0x0000000000000000ULL, 1 },
+        { "  12.5abc",                           0x4029000000000000ULL, 6 },
+        { ".5",                                  0x3FE0000000000000ULL, 2 },
+        { "5.",                                  0x4014000000000000ULL, 2 },
+        { "1,5",                                 0x3FF0000000000000ULL, 1 }, // Never the locale's separator.
+        { "1e",                                  0x3FF0000000000000ULL, 1 },
+        { "1e+",                                 0x3FF0000000000000ULL, 1 },
+        { "infinity",                            0x7FF0000000000000ULL, 8 },
+        { "-INF",                                0xFFF0000000000000ULL, 4 },
+        { "infinit",                             0x7FF0000000000000ULL, 3 },
+        { "-",                                   0x0000000000000000ULL, 0 },
+        { "",                                    0x0000000000000000ULL, 0 }
+    };
+
+    for (size_t i = 0; i < OVR_ARRAY_COUNT(Cases); ++i)
+    {
+        char*  end;
+        double d = OVR_strtod(Cases[i].Text, &end);
+        if (!OVR_TEST_CHECK((DoubleBits(d) == Cases[i].Bits) && ((end - Cases[i].Text) == Cases[i].Consumed)))
+            printf("  \"%s\" read as %.17g, %d characters\n", Cases[i].Text, d, (int)(end - Cases[i].Text));
+    }
+
+    char*  end;
+    double notANumber = OVR_strtod("nan(123)", &end);
+    OVR_TEST_CHECK((notANumber != notANumber) && (*end == '\0'));
+}
+
+// Big integer in base 10^9 limbs, least significant first, just large enough to hold the
+// exact decimal expansion of any value halfway between two doubles.
+struct ExactDecimal
+{
+    uint32_t Limbs[100];
+    int      Count;
+    int      Exponent; // Value = Limbs * 10^Exponent
+
+    ExactDecimal(uint64_t n) : Count(0), Exponent(0)
+    {
+        do
+        {
+            Limbs[Count++] = (uint32_t)(n % 1000000000);
+            n /= 1000000000;
+        } while (n);
+    }
+
+    void Multiply(uint32_t factor)
+    {
+        uint64_t carry = 0;
+        for (int i = 0; i < Count; ++i)
+        {
+            uint64_t product = (uint64_t)Limbs[i] * factor + carry;
+            Limbs[i] = (uint32_t)(product % 1000000000);
+            carry    = product / 1000000000;
+        }
+        for (; carry; carry /= 1000000000)
+            Limbs[Count++] = (uint32_t)(carry % 1000000000);
+    }
+
+    // Value *= 2^binaryExponent, keeping the result exact by using 2^-n = 5^n * 10^-n.
+    void ScaleByPowerOf2(int binaryExponent)
+    {
+        for (int n = binaryExponent; n > 0; n -= 29)
+            Multiply(1u << ((n < 29) ? n : 29));
+
+        for (int n = -binaryExponent; n > 0; n -= 13)
+        {
+            uint32_t power = 1;
+            for (int k = 0; k < ((n < 13) ? n : 13); ++k)
+                power *= 5;
+            Multiply(power);
+            Exponent -= (n < 13) ? n : 13;
+        }
+    }
+
+    // Appends a digit 1, moving the value up by a tenth of its last digit.
+    void AddTiny()
+    {
+        Multiply(10);
+        Exponent--;
+        Limbs[0] += 1;
+    }
+
+    // Appends a digit 9 after decrementing the last digit, moving the value down by a tenth
+    // of its last digit.
+    void SubtractTiny()
+    {
+        Multiply(10);
+        Exponent--;
+        int i = 0;
+        for (; Limbs[i] == 0; ++i)
+            Limbs[i] = 999999999;
+        Limbs[i]--;
+    }
+
+    void Format(char* buffer, size_t size) const
+    {
+        int length = snprintf(buffer, size, "%u", Limbs[Count - 1]);
+        for (int i = Count - 2; i >= 0; --i)
+            length += snprintf(buffer + length, size - (size_t)length, "%09u", Limbs[i]);
+        snprintf(buffer + length, size - (size_t)length, "e%d", Exponent);
+    }
+};
+
+// Reads the exact decimal value halfway between a random double and the next one up, and
+// values just above and below that point. Only correct rounding gets all three right.
+static void TestStrtodHalfway(uint64_t seed, int count)
+{
+    Random random(seed);
+    char   buffer[1024];
+
+    for (int i = 0; i < count; ++i)
+    {
+        double   d    = fabs(random.NextFiniteDouble());
+        uint64_t bits = DoubleBits(d);
+
+        uint64_t mantissa = bits & ((uint64_t(1) << 52) - 1);
+        int      exponent = (int)(bits >> 52);
+        if (exponent == 0)
+        {
+            exponent = -1074;
+        }
+        else
+        {
+            mantissa |= (uint64_t(1) << 52);
+            exponent -= 1075;
+        }
+
+        const double below = d;
+        const double above = BitsDouble(bits + 1); // Infinity above the largest double.
+        const double tie   = (mantissa & 1) ? above : below;
+
+        ExactDecimal halfway((mantissa << 1) + 1);
+        halfway.ScaleByPowerOf2(exponent - 1);
+
+        halfway.Format(buffer, sizeof(buffer));
+        if (!OVR_TEST_CHECK(DoubleBits(OVR_strtod(buffer, nullptr)) == DoubleBits(tie)))
+            printf("  seed %llu: halfway above %.17g misread\n", (unsigned long long)seed, d);
+
+        ExactDecimal justAbove(halfway);
+        justAbove.AddTiny();
+        justAbove.Format(buffer, sizeof(buffer));
+        if (!OVR_TEST_CHECK(DoubleBits(OVR_strtod(buffer, nullptr)) == DoubleBits(above)))
+            printf("  seed %llu: just above halfway above %.17g misread\n", (unsigned long long)seed, d);
+
+        ExactDecimal justBelow(halfway);
+        justBelow.SubtractTiny();
+        justBelow.Format(buffer, sizeof(buffer));
+        if (!OVR_TEST_CHECK(DoubleBits(OVR_strtod(buffer, nullptr)) == DoubleBits(below)))
+            printf("  seed %llu: just below halfway above %.17g misread\n", (unsigned long long)seed, d);
+    }
+}
+
+// Widened floats are the most common doubles in our data. Sweeps the float range with a
+// stride, checking that each one survives OVR_dtoa and OVR_strtod as well as 17 digits of
+// the CRT's formatting.
+static void TestFloatRoundTrip(uint32_t stride)
+{
+    char buffer[64];
+
+    for (uint64_t bits = 0; bits < 0x7F800000u; bits += stride)
+    {
+        float f;
+        uint32_t floatBits = (uint32_t)bits;
+        memcpy(&f, &floatBits, sizeof(f));
+
+        const double d = f;
+        if (!OVR_TEST_CHECK(OVR_strtod(OVR_dtoa(d, buffer, sizeof(buffer)), nullptr) == d))
+            printf("  float %.9g printed as %s\n", d, buffer);
+
+        snprintf(buffer, sizeof(buffer), "%.17g", -d);
+        if (!OVR_TEST_CHECK(OVR_strtod(buffer, nullptr) == -d))
+            printf("  float %s misread\n", buffer);
+    }
+}
+
+// Integer parsing is checked against the CRT, whose behavior for these inputs is fully
+// specified by the C standard.
+static void CheckIntegerParse(const char* text, int radix)
+{
+    char* end;
+    char* crtEnd;
+
+    errno = 0;
+    long value = OVR_strtol(text, &end, radix);
+    int  error = errno;
+    errno = 0;
+    long crtValue = strtol(text, &crtEnd, radix);
+    if (!OVR_TEST_CHECK((value == crtValue) && (end == crtEnd) && (error == errno)))
+        printf("  OVR_strtol(\"%s\", %d) = %ld, CRT %ld\n", text, radix, value, crtValue);
+
+    errno = 0;
+    unsigned long uvalue = OVR_strtoul(text, &end, radix);
+    error = errno;
+    errno = 0;
+    unsigned long crtUValue = strtoul(text, &crtEnd, radix);
+    if (!OVR_TEST_CHECK((uvalue == crtUValue) && (end == crtEnd) && (error == errno)))
+        printf("  OVR_strtoul(\"%s\", %d) = %lu, CRT %lu\n", text, radix, uvalue, crtUValue);
+}
+
+static void TestIntegerParsing(uint64_t seed, int count)
+{
+    static const struct
+    {
+        const char* Text;
+        int         Radix;
+        int64_t     Value;
+        int         Consumed;
+        bool        OutOfRange;
+    } Cases[] =
+    {
+        { "0x1f",                  0,  31,        4,  false },
+        { "0x",                    16, 0,         1,  false },
+        { "0xg",                   0,  0,         1,  false },
+        { "  -0x80000000",         0,  -2147483647 - 1, 13, false },
+        { "077",                   0,  63,        3,  false },
+        { "08",                    0,  0,         1,  false },
+        { "0b101",                 0,  0,         1,  false },
+        { "zz",                    36, 1295,      2,  false },
+        { "+5",                    10, 5,         2,  false },
+        { " 12 ",                  10, 12,        3,  false },
+        { "12abc",                 10, 12,        2,  false },
+        { "-",                     10, 0,         0,  false },
+        { "9223372036854775807",   10, INT64_MAX, 19, false },
+        { "9223372036854775808",   10, INT64_MAX, 19, true },
+        { "-9223372036854775808",  10, INT64_MIN, 20, false },
+        { "-9223372036854775809",  10, INT64_MIN, 20, true }
+    };
+
+    for (size_t i = 0; i < OVR_ARRAY_COUNT(Cases); ++i)
+    {
+        char* end;
+        errno = 0;
+        int64_t value = OVR_strtoq(Cases[i].Text, &end, Cases[i].Radix);
+        if (!OVR_TEST_CHECK((value == Cases[i].Value) && ((end - Cases[i].Text) == Cases[i].Consumed) &&
+                            ((errno == ERANGE) == Cases[i].OutOfRange)))
+            printf("  OVR_strtoq(\"%s\", %d) = %lld\n", Cases[i].Text, Cases[i].Radix, (long long)value);
+    }
+
+    char* end;
+    errno = 0;
+    OVR_TEST_CHECK((OVR_strtouq("18446744073709551615", &end, 10) == UINT64_MAX) && (errno == 0));
+    OVR_TEST_CHECK((OVR_strtouq("18446744073709551616", &end, 10) == UINT64_MAX) && (errno == ERANGE));
+    errno = 0;
+    OVR_TEST_CHECK((OVR_strtouq("-1", &end, 10) == UINT64_MAX) && (errno == 0));
+
+    // Random digit strings in random bases, kept clear of the "0x" prefix whose handling
+    // without following hex digits differs between CRTs.
+    static const char Digits[] = "0123456789abcdefghijklmnopqrstuvwyzABZ";
+    static const int  Radixes[] = { 0, 2, 8, 10, 16, 36 };
+    Random random(seed);
+    char   text[32];
+
+    for (int i = 0; i < count; ++i)
+    {
+        int length = 0;
+        if (random.NextUInt(3) == 0)
+            text[length++] = '-';
+        const int digitCount = 1 + (int)random.NextUInt(24);
+        for (int k = 0; k < digitCount; ++k)
+            text[length++] = Digits[random.NextUInt(sizeof(Digits) - 1)];
+        text[length] = '\0';
+
+        CheckIntegerParse(text, Radixes[random.NextUInt(OVR_ARRAY_COUNT(Radixes))]);
+    }
+}
+
+static void TestIntegerFormatting(uint64_t seed, int count)
+{
+    Random random(seed);
+    char   text[72];
+    char   expected[72];
+
+    for (int i = 0; i < count; ++i)
+    {
+        int64_t value = (int64_t)random.Next() >> random.NextUInt(64);
+
+        OVR_i64toa(value, text, sizeof(text), 10);
+        snprintf(expected, sizeof(expected), "%lld", (long long)value);
+        if (!OVR_TEST_CHECK(strcmp(text, expected) == 0))
+            printf("  OVR_i64toa wrote %s for %s\n", text, expected);
+
+        OVR_u64toa((uint64_t)value, text, sizeof(text), 16);
+        snprintf(expected, sizeof(expected), "%llx", (unsigned long long)value);
+        if (!OVR_TEST_CHECK(strcmp(text, expected) == 0))
+            printf("  OVR_u64toa wrote %s for %s\n", text, expected);
+
+        char*   end;
+        int64_t readBack = OVR_strtoq(OVR_i64toa(value, text, sizeof(text), 10), &end, 10);
+        OVR_TEST_CHECK((readBack == value) && (*end == '\0'));
+    }
+
+    OVR_TEST_CHECK(strcmp(OVR_i64toa(INT64_MIN, text, sizeof(text), 10), "-9223372036854775808") == 0);
+    OVR_TEST_CHECK(strcmp(OVR_i64toa(12345, text, 5, 10), "") == 0);
+    OVR_TEST_CHECK(strcmp(OVR_i64toa(12345, text, 6, 10), "12345") == 0);
+}
+
+static void BenchmarkConversions()
+{
+    const int Count = 200000;
+    char (*texts)[32] = new char[Count][32];
+    Random random(48);
+    double sum = 0;
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        // Short decimals as found in text assets, then full 17 digit values.
+        for (int i = 0; i < Count; ++i)
+        {
+            double d = (pass == 0) ? (double)(float)((double)(int32_t)random.Next() * 1e-6) : random.NextFiniteDouble();
+            snprintf(texts[i], sizeof(texts[i]), (pass == 0) ? "%.6g" : "%.17g", d);
+        }
+
+        double start = Timer::GetSeconds();
+        for (int i = 0; i < Count; ++i)
+            sum += OVR_strtod(texts[i], nullptr);
+        ReportBenchmark((pass == 0) ? "OVR_strtod, 6 digits" : "OVR_strtod, 17 digits", Timer::GetSeconds() - start, Count);
+
+        start = Timer::GetSeconds();
+        for (int i = 0; i < Count; ++i)
+            sum += strtod(texts[i], nullptr);
+        ReportBenchmark((pass == 0) ? "strtod, 6 digits" : "strtod, 17 digits", Timer::GetSeconds() - start, Count);
+    }
+
+    for (int i = 0; i < Count; ++i)
+        snprintf(texts[i], sizeof(texts[i]), "%d", (int32_t)random.Next() >> random.NextUInt(32));
+
+    double start = Timer::GetSeconds();
+    for (int i = 0; i < Count; ++i)
+        sum += (double)OVR_strtol(texts[i], nullptr, 10);
+    ReportBenchmark("OVR_strtol", Timer::GetSeconds() - start, Count);
+
+    start = Timer::GetSeconds();
+    for (int i = 0; i < Count; ++i)
+        sum += (double)strtol(texts[i], nullptr, 10);
+    ReportBenchmark("strtol", Timer::GetSeconds() - start, Count);
+
+    char   buffer[32];
+    size_t length = 0;
+
+    start = Timer::GetSeconds();
+    for (int i = 0; i < Count; ++i)
+        length += strlen(OVR_i64toa((int64_t)i * 7919 - 1000000, buffer, sizeof(buffer), 10));
+    ReportBenchmark("OVR_i64toa", Timer::GetSeconds() - start, Count);
+
+    start = Timer::GetSeconds();
+    for (int i = 0; i < Count; ++i)
+        length += (size_t)snprintf(buffer, sizeof(buffer), "%lld", (long long)i * 7919 - 1000000);
+    ReportBenchmark("snprintf(\"%lld\")", Timer::GetSeconds() - start, Count);
+
+    printf("  (checksum %g, %u)\n", sum, (unsigned)length);
+    delete[] texts;
+}
+
+void TestStd(bool benchmark)
+{
+    TestStrtodCases();
+    TestStrtodHalfway(3, 20000);
+    TestFloatRoundTrip(997);
+    TestIntegerParsing(4, 300000);
+    TestIntegerFormatting(5, 300000);
+
+    if (benchmark)
+        BenchmarkConversions();
+}
+
+}} // namespace OVR::KernelTests
@@ -304,6 +304,7 @@ RenderDevice::RenderDevice(ovrSession session, const RendererParams& p, HWND win
     Window(window),
     Device(),
     Context(),
+    Context1(),
     SwapChain(),
     Adapter(),
     FullscreenOutput(),
@@ -551,6 +552,20 @@ RenderDevice::RenderDevice(ovrSession session, const RendererParams& p, HWND win
     }
 
     Context->QueryInterface(IID_PPV_ARGS(&UserAnnotation.GetRawRef()));
+
+    // Binding constant buffer ranges and writing them with NO_OVERWRITE need the D3D11.1
+    // runtime and driver support. Without them each draw updates its own constant buffer.
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options;
+    memset(&options, 0, sizeof(options));
+    if (SUCCEEDED(Device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) &&
+        options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer)
+    {
+        if (SUCCEEDED(Context->QueryInterface(IID_PPV_ARGS(&Context1.GetRawRef()))))
+        {
+            // Offsets and sizes are in units of 16 constants.
+            UniformRingAlignment = 16 * 16;
+        }
+    }
 }
 
 RenderDevice::~RenderDevice()
@@ -1897,35 +1912,16 @@ Texture* RenderDevice::CreateTexture(int format, int width, int height, const vo
                     {
                         // TODO: Just call GenerateMips() instead
                         OVR_ASSERT((textureFormat) == Texture_RGBA);
-                        int srcw = width, srch = height;
-                        int level = 0;
-                        uint8_t* mipmaps = NULL;
-                        do
-                        {
-                            level++;
-                            int mipw = srcw >> 1;
-                            if (mipw < 1)
-                            {
-                                mipw = 1;
-                            }
-                            int miph = srch >> 1;
-                            if (miph < 1)
-                            {
-                                miph = 1;
-                            }
-                            if (mipmaps == NULL)
-                            {
-                                mipmaps = (uint8_t*)OVR_ALLOC(mipw * miph * 4);
-                            }
-                            FilterRgba2x2(level == 1 ? (const uint8_t*)data : mipmaps, srcw, srch, mipmaps);
-                            Context->UpdateSubresource(tex, level, NULL, mipmaps, mipw * bpp, miph * bpp);
-                            srcw = mipw;
-                            srch = miph;
-                        } while (srcw > 1 || srch > 1);
-
-                        if (mipmaps != NULL)
+                        MipChainDesc mipDesc;
+                        mipDesc.SRGB = (format & Texture_SRGB) != 0;
+                        MipChain mips;
+                        mips.Build((const uint8_t*)data, width, height, mipDesc);
+
+                        for (int level = 1; level < mips.GetLevelCount(); level++)
                         {
-                            OVR_FREE(mipmaps);
+                            int mipw = mips.GetLevelWidth(level);
+                            int miph = mips.GetLevelHeight(level);
+                            Context->UpdateSubresource(tex, level, NULL, mips.GetLevelData(level), mipw * bpp, mipw * miph * bpp);
                         }
                     }
                 }
@@ -2149,11 +2145,22 @@ void RenderDevice::Render(const Fill* fill, Render::Buffer* vertices, Render::Bu
             stdUniforms->GlobalTint = StdUniforms.GlobalTint;
         }
 
-        if (!UniformBuffers[Shader_Vertex]->Data(Buffer_Uniform, vertexData, vshader->UniformsSize))
+        int ringOffset = PushUniforms(vertexData, vshader->UniformsSize);
+        if (ringOffset >= 0)
         {
-            OVR_ASSERT(false);
+            UINT firstConstant = ringOffset / 16;
+            UINT numConstants  = (UINT)((vshader->UniformsSize + UniformRingAlignment - 1) / UniformRingAlignment * UniformRingAlignment) / 16;
+            Context1->VSSetConstantBuffers1(0, 1, &((Buffer*)pUniformRingBuffer.GetPtr())->D3DBuffer.GetRawRef(),
+                                            &firstConstant, &numConstants);
+        }
+        else
+        {
+            if (!UniformBuffers[Shader_Vertex]->Data(Buffer_Uniform, vertexData, vshader->UniformsSize))
+            {
+                OVR_ASSERT(false);
+            }
+            vshader->SetUniformBuffer(UniformBuffers[Shader_Vertex]);
         }
-        vshader->SetUniformBuffer(UniformBuffers[Shader_Vertex]);
     }
 
     for (int i = Shader_Vertex + 1; i < Shader_Count; i++)
@@ -2250,6 +2257,8 @@ void RenderDevice::Flush()
 
 void RenderDevice::FillRect(float left, float top, float right, float bottom, Color c, const Matrix4f* view)
 {
+    // Queued text goes below, and drawing it resets the blend state.
+    FlushTextBatch();
     Context->OMSetBlendState(BlendStatePreMulAlpha, NULL, 0xffffffff);
     OVR::Render::RenderDevice::FillRect(left, top, right, bottom, c, view);
     Context->OMSetBlendState(NULL, NULL, 0xffffffff);
@@ -2264,6 +2273,7 @@ void RenderDevice::RenderText(const struct Font* font, const char* str, float x,
 
 void RenderDevice::FillGradientRect(float left, float top, float right, float bottom, Color col_top, Color col_btm, const Matrix4f* view)
 {
+    FlushTextBatch();
 	Context->OMSetBlendState(BlendStatePreMulAlpha, NULL, 0xffffffff);
     OVR::Render::RenderDevice::FillGradientRect(left, top, right, bottom, col_top, col_btm, view);
     Context->OMSetBlendState(NULL, NULL, 0xffffffff);
@@ -2271,6 +2281,7 @@ void RenderDevice::FillGradientRect(float left, float top, float right, float bo
 
 void RenderDevice::RenderImage(float left, float top, float right, float bottom, ShaderFill* image, unsigned char alpha, const Matrix4f* view)
 {
+    FlushTextBatch();
 	Context->OMSetBlendState(BlendStatePreMulAlpha, NULL, 0xffffffff);
     OVR::Render::RenderDevice::RenderImage(left, top, right, bottom, image, alpha, view);
     Context->OMSetBlendState(NULL, NULL, 0xffffffff);
@@ -230,6 +230,7 @@ public:
 
     Ptr<ID3D11Device>               Device;
     Ptr<ID3D11DeviceContext>        Context;
+    Ptr<ID3D11DeviceContext1>       Context1;   // Set when vertex constants come from the uniform ring.
     Ptr<IDXGISwapChain>             SwapChain;
     Ptr<IDXGIAdapter>               Adapter;
     Ptr<IDXGIOutput>                FullscreenOutput;
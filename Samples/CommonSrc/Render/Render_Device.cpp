@@ -23,6 +23,9 @@ limitations under the License.
 
 #include "../Render/Render_Device.h"
 #include "../Render/Render_Font.h"
+#include "Util/Util_JobSystem.h"
+
+#include <algorithm>
 
 
 namespace OVR { namespace Render {
@@ -46,6 +49,290 @@ namespace OVR { namespace Render {
         }
     }
 
+    size_t WorldContainer::Add(Node* n, const Posed& worldPose)
+    {
+        ChildEntry entry;
+        entry.Child = n;
+        entry.WorldPose = worldPose;
+        entry.Dirty = true;
+        Children.push_back(entry);
+        DirtyIndices.push_back(Children.size() - 1);
+        return Children.size() - 1;
+    }
+
+    void WorldContainer::SetWorldPose(size_t index, const Posed& worldPose)
+    {
+        ChildEntry& entry = Children[index];
+        entry.WorldPose = worldPose;
+        if (!entry.Dirty)
+        {
+            entry.Dirty = true;
+            DirtyIndices.push_back(index);
+        }
+    }
+
+    void WorldContainer::SetOrigin(const Vector3d& origin)
+    {
+        if (OriginValid && origin == Origin)
+            return;
+
+        Origin = origin;
+        OriginValid = true;
+
+        DirtyIndices.clear();
+        for (size_t i = 0; i < Children.size(); i++)
+        {
+            Children[i].Dirty = true;
+            DirtyIndices.push_back(i);
+        }
+    }
+
+    void WorldContainer::RebaseDirty()
+    {
+        // The translation is made relative to the origin in double precision, so only the
+        // small remainder is rounded to float.
+        for (size_t i = 0; i < DirtyIndices.size(); i++)
+        {
+            ChildEntry& entry = Children[DirtyIndices[i]];
+            Posef relativePose(Quatf(entry.WorldPose.Rotation), Vector3f(entry.WorldPose.Translation - Origin));
+            entry.OriginToChild = Matrix4f(relativePose);
+            entry.Dirty = false;
+        }
+        DirtyIndices.clear();
+    }
+
+    void WorldContainer::Render(const Posed& eyeWorldPose, RenderDevice* ren)
+    {
+        const Vector3d& eyePos = eyeWorldPose.Translation;
+        SetOrigin(Vector3d(floor(eyePos.x / OriginCellSize) * OriginCellSize,
+                           floor(eyePos.y / OriginCellSize) * OriginCellSize,
+                           floor(eyePos.z / OriginCellSize) * OriginCellSize));
+        RebaseDirty();
+
+        Posef eyeFromOrigin = Posef(Quatf(eyeWorldPose.Rotation), Vector3f(eyePos - Origin)).Inverted();
+        Matrix4f view = Matrix4f(eyeFromOrigin);
+        for (size_t i = 0; i < Children.size(); i++)
+        {
+            Children[i].Child->Render(view * Children[i].OriginToChild, ren);
+        }
+    }
+
+    void WorldContainer::Render(const Matrix4f& ltw, RenderDevice* ren)
+    {
+        SetOrigin(Vector3d(0.0, 0.0, 0.0));
+        RebaseDirty();
+
+        Matrix4f m = ltw * GetMatrix();
+        for (size_t i = 0; i < Children.size(); i++)
+        {
+            Children[i].Child->Render(m * Children[i].OriginToChild, ren);
+        }
+    }
+
+    void Node::NotifyCache()
+    {
+        Cache->MarkDirty(CacheIndex);
+    }
+
+    void TransformCache::Build(Container* root)
+    {
+        Clear();
+        addNode(root, -1);
+
+        // Rebuild stale local matrices now, since Update only rebuilds those of moved nodes
+        // before reading the others from jobs.
+        for (size_t i = 0; i < Nodes.size(); i++)
+        {
+            Nodes[i]->GetMatrix();
+        }
+
+        WorldMatrices.resize(Nodes.size());
+        DirtyFlags.assign(Nodes.size(), 0);
+        MarkDirty(0);
+    }
+
+    void TransformCache::addNode(Node* node, int parent)
+    {
+        int index = (int)Nodes.size();
+        Nodes.push_back(node);
+        Parents.push_back(parent);
+        SubtreeEnds.push_back(index + 1);
+        NextAliases.push_back(-1);
+
+        // A node added to several containers is stored once per container, and the indices
+        // are chained so that moving the node dirties all of them.
+        if (!node->Cache)
+        {
+            node->Cache = this;
+            node->CacheIndex = index;
+        }
+        else if (node->Cache == this)
+        {
+            int alias = node->CacheIndex;
+            while (NextAliases[alias] >= 0)
+                alias = NextAliases[alias];
+            NextAliases[alias] = index;
+        }
+        else
+        {
+            ForeignIndices.push_back(index);
+        }
+
+        if (node->GetType() == Node::Node_Container)
+        {
+            Container* container = static_cast<Container*>(node);
+            for (size_t i = 0; i < container->Nodes.size(); i++)
+            {
+                addNode(container->Nodes[i], index);
+            }
+            SubtreeEnds[index] = (int)Nodes.size();
+        }
+    }
+
+    void TransformCache::Clear()
+    {
+        for (size_t i = 0; i < Nodes.size(); i++)
+        {
+            if (Nodes[i]->Cache == this)
+            {
+                Nodes[i]->Cache = nullptr;
+                Nodes[i]->CacheIndex = -1;
+            }
+        }
+
+        Nodes.clear();
+        Parents.clear();
+        SubtreeEnds.clear();
+        NextAliases.clear();
+        WorldMatrices.clear();
+        DirtyFlags.clear();
+        DirtyIndices.clear();
+        ForeignIndices.clear();
+    }
+
+    void TransformCache::MarkDirty(int index)
+    {
+        for (; index >= 0; index = NextAliases[index])
+        {
+            if (!DirtyFlags[index])
+            {
+                DirtyFlags[index] = 1;
+                DirtyIndices.push_back(index);
+            }
+        }
+    }
+
+    void TransformCache::updateRange(int begin, int end)
+    {
+        // Parents precede their children, so the parent's world matrix is always up to date.
+        for (int i = begin; i < end; i++)
+        {
+            int parent = Parents[i];
+            if (parent < 0)
+                WorldMatrices[i] = Nodes[i]->GetMatrix();
+            else
+                WorldMatrices[i] = WorldMatrices[parent] * Nodes[i]->GetMatrix();
+        }
+    }
+
+    void TransformCache::Update()
+    {
+        for (size_t i = 0; i < ForeignIndices.size(); i++)
+        {
+            MarkDirty(ForeignIndices[i]);
+        }
+
+        if (DirtyIndices.empty())
+            return;
+
+        // Merge the dirty nodes into disjoint subtree ranges, and rebuild the local matrices
+        // of the dirty nodes here so that the jobs below only read the nodes.
+        std::sort(DirtyIndices.begin(), DirtyIndices.end());
+
+        std::vector<std::pair<int, int> > ranges;
+        int updateCount = 0;
+        for (size_t i = 0; i < DirtyIndices.size(); i++)
+        {
+            int index = DirtyIndices[i];
+            DirtyFlags[index] = 0;
+            Nodes[index]->GetMatrix();
+
+            if (ranges.empty() || index >= ranges.back().second)
+            {
+                ranges.push_back(std::make_pair(index, SubtreeEnds[index]));
+                updateCount += SubtreeEnds[index] - index;
+            }
+        }
+        DirtyIndices.clear();
+
+        if (updateCount < ParallelThreshold)
+        {
+            for (size_t i = 0; i < ranges.size(); i++)
+            {
+                updateRange(ranges[i].first, ranges[i].second);
+            }
+            return;
+        }
+
+        // Ranges are independent of each other, and so are the child subtrees of a range once
+        // its root is done, so large ranges are split into their root and child subtrees.
+        std::vector<std::pair<int, int> > jobRanges;
+        int splitSize = ParallelThreshold / 4;
+        for (size_t i = 0; i < ranges.size(); i++)
+        {
+            int begin = ranges[i].first;
+            int end = ranges[i].second;
+            if (end - begin <= splitSize)
+            {
+                jobRanges.push_back(ranges[i]);
+                continue;
+            }
+
+            updateRange(begin, begin + 1);
+            for (int child = begin + 1; child < end; child = SubtreeEnds[child])
+            {
+                jobRanges.push_back(std::make_pair(child, SubtreeEnds[child]));
+            }
+        }
+
+        Util::JobSystem::GetInstance()->ParallelFor(0, (int)jobRanges.size(), 1, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                updateRange(jobRanges[i].first, jobRanges[i].second);
+            }
+        });
+    }
+
+    void TransformCache::Render(const Matrix4f& view, RenderDevice* ren)
+    {
+        for (size_t i = 0; i < Nodes.size(); i++)
+        {
+            Node* node = Nodes[i];
+            switch (node->GetType())
+            {
+            case Node::Node_Container:
+                break;
+
+            case Node::Node_Model:
+                {
+                    Model* model = static_cast<Model*>(node);
+                    if (model->Visible)
+                    {
+                        AutoGpuProf prof(ren, (model->AssetName.length() > 0 ? model->AssetName.c_str() : "Model_Render"));
+                        ren->Render(view * WorldMatrices[i], model);
+                    }
+                }
+                break;
+
+            default:
+                // Other nodes render themselves from their parent's matrix, like in Container::Render.
+                node->Render(view * WorldMatrices[Parents[i]], ren);
+                break;
+            }
+        }
+    }
+
     Matrix4f SceneView::GetViewMatrix() const
     {
         Matrix4f view = Matrix4f(GetOrientation().Conj()) * Matrix4f::Translation(GetPosition());
@@ -69,7 +356,15 @@ namespace OVR { namespace Render {
 
         ren->SetLighting(&Lighting);
 
-        World.Render(view, ren);
+        if (!Transforms.IsEmpty())
+        {
+            Transforms.Update();
+            Transforms.Render(view, ren);
+        }
+        else
+        {
+            World.Render(view, ren);
+        }
     }
 
 
@@ -497,8 +792,23 @@ namespace OVR { namespace Render {
     // ***** Rendering
 
 
+    // Size of the vertex ring shared by text and the 2D fill helpers; about 2700 glyphs.
+    static const size_t TextVertexRingSize = 16384 * sizeof(Vertex);
+
+    // Number of batches a string's cached layout outlives its last use by.
+    static const unsigned TextLayoutLifetime = 8;
+
+    // Size of the per-draw uniform ring; 1024 draws at 256 byte alignment.
+    static const size_t UniformRingSize = 256 * 1024;
+
     RenderDevice::RenderDevice(ovrSession session) :
         Session(session),
+        TextVertexRingOffset(0),
+        TextBatchDepth(0),
+        TextBatchSerial(0),
+        TextBatchFill(NULL),
+        UniformRingOffset(0),
+        UniformRingAlignment(0),
         TotalTextureMemoryUsage(0)
     {
     }
@@ -514,6 +824,12 @@ namespace OVR { namespace Render {
         // from the destructor.
 
         pTextVertexBuffer.Clear();
+        TextVertexRingOffset = 0;
+        TextBatchVertices.clear();
+        TextBatchFill = NULL;
+        TextLayoutCache.clear();
+        pUniformRingBuffer.Clear();
+        UniformRingOffset = 0;
         LightingBuffer.Clear();
 
         Session = nullptr;
@@ -619,48 +935,14 @@ namespace OVR { namespace Render {
 
 
 
-    void RenderDevice::RenderText(const Font* font, const char* str,
-        float x, float y, float size, Color c, const Matrix4f* view)
+    // Writes the glyph quads of str in font units, before the string's transform, and
+    // returns the number of vertices written. out must have room for 6 per character.
+    static int LayoutText(const Font* font, const char* str, Vertex* out)
     {
-        size_t length = strlen(str);
-
-        // Do not attempt to render if we have an empty string.
-        if (length == 0) { return; }
-
-        if(!pTextVertexBuffer)
-        {
-            pTextVertexBuffer = *CreateBuffer();
-            if(!pTextVertexBuffer)
-            {
-                return;
-            }
-        }
-
-        if(!font->fill)
-        {
-            font->fill = CreateTextureFill(Ptr<Texture>(
-                *CreateTexture(Texture_R, font->twidth, font->theight, font->tex)), true, false);
-        }
-
-        pTextVertexBuffer->Data(Buffer_Vertex, NULL, length * 6 * sizeof(Vertex));
-        Vertex* vertices = (Vertex*)pTextVertexBuffer->Map(0, length * 6 * sizeof(Vertex), Map_Discard);
-        if(!vertices)
-        {
-            return;
-        }
-
-        Matrix4f m = Matrix4f(size / font->lineheight, 0, 0, 0,
-            0, size / font->lineheight, 0, 0,
-            0, 0, 0, 0,
-            x, y, 0, 1).Transposed();
-
-        if (view)
-            m = (*view) * m;
-
         float xp = 0, yp = (float)font->ascent;
         int   ivertex = 0;
 
-        for (size_t i = 0; i < length; i++)
+        for (size_t i = 0; str[i]; i++)
         {
             if(str[i] == '\n')
             {
@@ -679,46 +961,256 @@ namespace OVR { namespace Render {
             }
 
             const Font::Char* ch = &font->chars[(int)str[i]];
-            Vertex* chv = &vertices[ivertex];
-            for(int j = 0; j < 6; j++)
-            {
-                chv[j].C = c;
-            }
+            Vertex* chv = &out[ivertex];
             float fx = xp + ch->x;
             float fy = yp - ch->y;
             float cx = font->twidth * (ch->u2 - ch->u1);
             float cy = font->theight * (ch->v2 - ch->v1);
-            chv[0] = Vertex(Vector3f(fx, fy, 0), c, ch->u1, ch->v1);
-            chv[1] = Vertex(Vector3f(fx + cx, fy, 0), c, ch->u2, ch->v1);
-            chv[2] = Vertex(Vector3f(fx + cx, cy + fy, 0), c, ch->u2, ch->v2);
-            chv[3] = Vertex(Vector3f(fx, fy, 0), c, ch->u1, ch->v1);
-            chv[4] = Vertex(Vector3f(fx + cx, cy + fy, 0), c, ch->u2, ch->v2);
-            chv[5] = Vertex(Vector3f(fx, fy + cy, 0), c, ch->u1, ch->v2);
+            chv[0] = Vertex(Vector3f(fx, fy, 0), Color(), ch->u1, ch->v1);
+            chv[1] = Vertex(Vector3f(fx + cx, fy, 0), Color(), ch->u2, ch->v1);
+            chv[2] = Vertex(Vector3f(fx + cx, cy + fy, 0), Color(), ch->u2, ch->v2);
+            chv[3] = Vertex(Vector3f(fx, fy, 0), Color(), ch->u1, ch->v1);
+            chv[4] = Vertex(Vector3f(fx + cx, cy + fy, 0), Color(), ch->u2, ch->v2);
+            chv[5] = Vertex(Vector3f(fx, fy + cy, 0), Color(), ch->u1, ch->v2);
             ivertex += 6;
 
             xp += ch->advance;
         }
 
-        pTextVertexBuffer->Unmap(vertices);
+        return ivertex;
+    }
 
-        Render(font->fill, pTextVertexBuffer, NULL, m, 0, ivertex, Prim_Triangles);
+    const std::vector<Vertex>& RenderDevice::GetTextLayout(const Font* font, const char* str)
+    {
+        size_t      length = strlen(str);
+        size_t      key    = String::BernsteinHashFunction(str, length, (size_t)font);
+        TextLayout& layout = TextLayoutCache[key];
+
+        // A hash collision just lays out the newer string in place of the older.
+        if (layout.pFont != font || layout.Text != str)
+        {
+            layout.pFont = font;
+            layout.Text.assign(str, length);
+            layout.Vertices.resize(length * 6);
+            layout.Vertices.resize(LayoutText(font, str, &layout.Vertices[0]));
+        }
+
+        layout.LastBatch = TextBatchSerial;
+        return layout.Vertices;
     }
 
-    void RenderDevice::FillRect(float left, float top, float right, float bottom, Color c, const Matrix4f* matrix)
+    Vertex* RenderDevice::MapTextVertices(int count, int* byteOffset)
     {
-        if(!pTextVertexBuffer)
+        if (count <= 0)
+        {
+            return NULL;
+        }
+
+        size_t size  = count * sizeof(Vertex);
+        int    flags = Map_Unsynchronized;
+
+        if (!pTextVertexBuffer || pTextVertexBuffer->GetSize() < size)
         {
-            pTextVertexBuffer = *CreateBuffer();
             if(!pTextVertexBuffer)
             {
-                return;
+                pTextVertexBuffer = *CreateBuffer();
+                if(!pTextVertexBuffer)
+                {
+                    return NULL;
+                }
+            }
+
+            // Only a draw larger than the whole ring reallocates it.
+            if (!pTextVertexBuffer->Data(Buffer_Vertex, NULL, Alg::Max(size, TextVertexRingSize)))
+            {
+                return NULL;
+            }
+            TextVertexRingOffset = 0;
+            flags = Map_Discard;
+        }
+        else if (TextVertexRingOffset + size > pTextVertexBuffer->GetSize())
+        {
+            // Wrapping around renames the buffer, as the draws from the previous pass may still be pending.
+            TextVertexRingOffset = 0;
+            flags = Map_Discard;
+        }
+
+        Vertex* vertices = (Vertex*)pTextVertexBuffer->Map(TextVertexRingOffset, size, flags);
+        *byteOffset = (int)TextVertexRingOffset;
+        return vertices;
+    }
+
+    void RenderDevice::UnmapTextVertices(Vertex* vertices, int count)
+    {
+        pTextVertexBuffer->Unmap(vertices);
+        TextVertexRingOffset += count * sizeof(Vertex);
+    }
+
+    int RenderDevice::PushUniforms(const void* data, size_t size)
+    {
+        if (!UniformRingAlignment)
+        {
+            return -1;
+        }
+
+        size_t alignedSize = (size + UniformRingAlignment - 1) / UniformRingAlignment * UniformRingAlignment;
+        int    flags       = Map_Unsynchronized;
+
+        if (!pUniformRingBuffer)
+        {
+            pUniformRingBuffer = *CreateBuffer();
+            if (!pUniformRingBuffer || !pUniformRingBuffer->Data(Buffer_Uniform, NULL, UniformRingSize))
+            {
+                pUniformRingBuffer.Clear();
+                return -1;
+            }
+            UniformRingOffset = 0;
+            flags = Map_Discard;
+        }
+        else if (UniformRingOffset + alignedSize > pUniformRingBuffer->GetSize())
+        {
+            // As with the text ring, draws using the previous pass may still be pending.
+            UniformRingOffset = 0;
+            flags = Map_Discard;
+        }
+
+        if (alignedSize > pUniformRingBuffer->GetSize())
+        {
+            return -1;
+        }
+
+        void* block = pUniformRingBuffer->Map(UniformRingOffset, alignedSize, flags);
+        if (!block)
+        {
+            return -1;
+        }
+        memcpy(block, data, size);
+        pUniformRingBuffer->Unmap(block);
+
+        int offset = (int)UniformRingOffset;
+        UniformRingOffset += alignedSize;
+        return offset;
+    }
+
+    void RenderDevice::BeginTextBatch()
+    {
+        TextBatchDepth++;
+    }
+
+    void RenderDevice::EndTextBatch()
+    {
+        OVR_ASSERT(TextBatchDepth > 0);
+        if (--TextBatchDepth > 0)
+        {
+            return;
+        }
+
+        FlushTextBatch();
+
+        // Forget the layouts of strings that have stopped being drawn, such as old counter values.
+        for (auto it = TextLayoutCache.begin(); it != TextLayoutCache.end(); )
+        {
+            if (TextBatchSerial - it->second.LastBatch > TextLayoutLifetime)
+                it = TextLayoutCache.erase(it);
+            else
+                ++it;
+        }
+        TextBatchSerial++;
+    }
+
+    void RenderDevice::FlushTextBatch()
+    {
+        int count = (int)TextBatchVertices.size();
+        if (count > 0)
+        {
+            int     offset;
+            Vertex* vertices = MapTextVertices(count, &offset);
+            if (vertices)
+            {
+                memcpy(vertices, &TextBatchVertices[0], count * sizeof(Vertex));
+                UnmapTextVertices(vertices, count);
+
+                // Queued vertices are already transformed. The device RenderText overrides that
+                // set up blending have returned by now, so this blends the same way they do.
+                RenderWithAlpha(TextBatchFill, pTextVertexBuffer, NULL, Matrix4f(), offset, count, Prim_Triangles);
+            }
+            TextBatchVertices.clear();
+        }
+        TextBatchFill = NULL;
+    }
+
+    void RenderDevice::RenderText(const Font* font, const char* str,
+        float x, float y, float size, Color c, const Matrix4f* view)
+    {
+        // Do not attempt to render if we have an empty string.
+        if (str[0] == '\0') { return; }
+
+        if(!font->fill)
+        {
+            font->fill = CreateTextureFill(Ptr<Texture>(
+                *CreateTexture(Texture_R, font->twidth, font->theight, font->tex)), true, false);
+        }
+
+        Matrix4f m = Matrix4f(size / font->lineheight, 0, 0, 0,
+            0, size / font->lineheight, 0, 0,
+            0, 0, 0, 0,
+            x, y, 0, 1).Transposed();
+
+        if (view)
+            m = (*view) * m;
+
+        // Inside a batch, strings are queued with their transform applied, unless it's projective.
+        bool affine = (m.M[3][0] == 0.0f && m.M[3][1] == 0.0f && m.M[3][2] == 0.0f && m.M[3][3] == 1.0f);
+        if (TextBatchDepth > 0 && affine)
+        {
+            const std::vector<Vertex>& glyphs = GetTextLayout(font, str);
+
+            if (TextBatchFill != font->fill)
+            {
+                FlushTextBatch();
+                TextBatchFill = font->fill;
             }
+
+            size_t first = TextBatchVertices.size();
+            TextBatchVertices.resize(first + glyphs.size());
+            for (size_t i = 0; i < glyphs.size(); i++)
+            {
+                Vertex& v = TextBatchVertices[first + i];
+                v     = glyphs[i];
+                v.Pos = m.Transform(glyphs[i].Pos);
+                v.C   = c;
+            }
+            return;
         }
 
+        FlushTextBatch();
+
+        int     offset;
+        Vertex* vertices = MapTextVertices((int)strlen(str) * 6, &offset);
+        if(!vertices)
+        {
+            return;
+        }
+
+        int ivertex = LayoutText(font, str, vertices);
+        for (int i = 0; i < ivertex; i++)
+        {
+            vertices[i].C = c;
+        }
+
+        UnmapTextVertices(vertices, ivertex);
+
+        RenderWithAlpha(font->fill, pTextVertexBuffer, NULL, m, offset, ivertex, Prim_Triangles);
+    }
+
+    void RenderDevice::FillRect(float left, float top, float right, float bottom, Color c, const Matrix4f* matrix)
+    {
+        FlushTextBatch();
+
         Fill* fill = GetSimpleFill();
 
-        pTextVertexBuffer->Data(Buffer_Vertex, NULL, 6 * sizeof(Vertex));
-        Vertex* vertices = (Vertex*)pTextVertexBuffer->Map(0, 6 * sizeof(Vertex), Map_Discard);
+        int     offset;
+        Vertex* vertices = MapTextVertices(6, &offset);
         if(!vertices)
         {
             return;
@@ -731,29 +1223,22 @@ namespace OVR { namespace Render {
         vertices[4] = Vertex(Vector3f(right, top,    0.0f), c);
         vertices[5] = Vertex(Vector3f(right, bottom, 0.0f), c);
 
-        pTextVertexBuffer->Unmap(vertices);
+        UnmapTextVertices(vertices, 6);
 
         if (matrix == NULL)
-            Render(fill, pTextVertexBuffer, NULL, Matrix4f(), 0, 6, Prim_Triangles);
+            Render(fill, pTextVertexBuffer, NULL, Matrix4f(), offset, 6, Prim_Triangles);
         else
-            Render(fill, pTextVertexBuffer, NULL, *matrix, 0, 6, Prim_Triangles);
+            Render(fill, pTextVertexBuffer, NULL, *matrix, offset, 6, Prim_Triangles);
     }
 
     void RenderDevice::FillGradientRect(float left, float top, float right, float bottom, Color col_top, Color col_btm, const Matrix4f* matrix)
     {
-        if(!pTextVertexBuffer)
-        {
-            pTextVertexBuffer = *CreateBuffer();
-            if(!pTextVertexBuffer)
-            {
-                return;
-            }
-        }
+        FlushTextBatch();
 
         Fill* fill = GetSimpleFill();
 
-        pTextVertexBuffer->Data(Buffer_Vertex, NULL, 6 * sizeof(Vertex));
-        Vertex* vertices = (Vertex*)pTextVertexBuffer->Map(0, 6 * sizeof(Vertex), Map_Discard);
+        int     offset;
+        Vertex* vertices = MapTextVertices(6, &offset);
         if(!vertices)
         {
             return;
@@ -766,29 +1251,22 @@ namespace OVR { namespace Render {
         vertices[4] = Vertex(Vector3f(right, top,    0.0f), col_top);
         vertices[5] = Vertex(Vector3f(right, bottom, 0.0f), col_btm);
 
-        pTextVertexBuffer->Unmap(vertices);
+        UnmapTextVertices(vertices, 6);
 
         if (matrix)
-            Render(fill, pTextVertexBuffer, NULL, *matrix, 0, 6, Prim_Triangles);
+            Render(fill, pTextVertexBuffer, NULL, *matrix, offset, 6, Prim_Triangles);
         else
-            Render(fill, pTextVertexBuffer, NULL, Matrix4f(), 0, 6, Prim_Triangles);
+            Render(fill, pTextVertexBuffer, NULL, Matrix4f(), offset, 6, Prim_Triangles);
  }
 
     void RenderDevice::FillTexturedRect(float left, float top, float right, float bottom, float ul, float vt, float ur, float vb, Color c, Ptr<Texture> tex, const Matrix4f* matrix, bool premultAlpha /*= false*/)
     {
-        if(!pTextVertexBuffer)
-        {
-            pTextVertexBuffer = *CreateBuffer();
-            if(!pTextVertexBuffer)
-            {
-                return;
-            }
-        }
+        FlushTextBatch();
 
         Fill *fill = GetTextureFill(tex, premultAlpha, premultAlpha);
 
-        pTextVertexBuffer->Data(Buffer_Vertex, NULL, 6 * sizeof(Vertex));
-        Vertex* vertices = (Vertex*)pTextVertexBuffer->Map(0, 6 * sizeof(Vertex), Map_Discard);
+        int     offset;
+        Vertex* vertices = MapTextVertices(6, &offset);
         if(!vertices)
         {
             return;
@@ -801,7 +1279,7 @@ namespace OVR { namespace Render {
         vertices[4] = Vertex(Vector3f(right, top,    0.0f), c, ur, vt);
         vertices[5] = Vertex(Vector3f(right, bottom, 0.0f), c, ur, vb);
 
-        pTextVertexBuffer->Unmap(vertices);
+        UnmapTextVertices(vertices, 6);
 
         Matrix4f mat;
         if ( matrix != NULL )
@@ -811,11 +1289,11 @@ namespace OVR { namespace Render {
 
         if (premultAlpha)
         {
-            RenderWithAlpha(fill, pTextVertexBuffer, NULL, mat, 0, 6, Prim_Triangles);
+            RenderWithAlpha(fill, pTextVertexBuffer, NULL, mat, offset, 6, Prim_Triangles);
         }
         else
         {
-            Render(fill, pTextVertexBuffer, NULL, mat, 0, 6, Prim_Triangles);
+            Render(fill, pTextVertexBuffer, NULL, mat, offset, 6, Prim_Triangles);
         }
     }
 
@@ -826,21 +1304,14 @@ namespace OVR { namespace Render {
         OVR_ASSERT ( y != NULL );
         // z can be NULL for 2D stuff.
 
-        if(!pTextVertexBuffer)
-        {
-            pTextVertexBuffer = *CreateBuffer();
-            if(!pTextVertexBuffer)
-            {
-                return;
-            }
-        }
+        FlushTextBatch();
 
         Fill* fill = GetSimpleFill();
 
         int NumVerts = NumLines * 2;
 
-        pTextVertexBuffer->Data(Buffer_Vertex, NULL, NumVerts * sizeof(Vertex));
-        Vertex* vertices = (Vertex*)pTextVertexBuffer->Map(0, NumVerts * sizeof(Vertex), Map_Discard);
+        int     offset;
+        Vertex* vertices = MapTextVertices(NumVerts, &offset);
         if(!vertices)
         {
             return;
@@ -861,9 +1332,9 @@ namespace OVR { namespace Render {
             }
         }
 
-        pTextVertexBuffer->Unmap(vertices);
+        UnmapTextVertices(vertices, NumVerts);
 
-        Render(fill, pTextVertexBuffer, NULL, Matrix4f(), 0, NumVerts, Prim_Lines);
+        Render(fill, pTextVertexBuffer, NULL, Matrix4f(), offset, NumVerts, Prim_Lines);
     }
 
     void RenderDevice::RenderImage(float left,
@@ -874,6 +1345,8 @@ namespace OVR { namespace Render {
         unsigned char alpha,
         const Matrix4f* view)
     {
+        FlushTextBatch();
+
         Color c = Color(255, 255, 255, alpha);
         Ptr<Model> m = *new Model(Prim_Triangles);
         m->AddVertex(left,  bottom,  0.0f, c, 0.0f, 0.0f);
@@ -892,12 +1365,18 @@ namespace OVR { namespace Render {
 
     void RenderDevice::SetProjection(const Matrix4f& proj)
     {
+        // Queued text was positioned for the old projection.
+        FlushTextBatch();
+
         Proj = proj;
         SetWorldUniforms(Proj, GlobalTint);
     }
 
     void RenderDevice::SetGlobalTint(const Vector4f& globalTint)
     {
+        // Queued text was tinted with the old global tint.
+        FlushTextBatch();
+
         GlobalTint = globalTint;
         SetWorldUniforms(Proj, GlobalTint);
     }
@@ -31,6 +31,7 @@ limitations under the License.
 
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 namespace OVR { namespace Render {
 
@@ -424,23 +425,35 @@ public:
 	bool TestRay(const Vector3f& origin, const Vector3f& norm, float& len, Planef* ph = NULL) const;
 };
 
+class TransformCache;
+
 class Node : public RefCountBase<Node>
 {
+    friend class TransformCache;
+
     Vector3f     Pos;
     Quatf        Rot;
 
     mutable Matrix4f  Mat;
 	mutable bool      MatCurrent;
 
+    // Cache holding the world matrix of the node, which is told when the node moves.
+    TransformCache*   Cache;
+    int               CacheIndex;
+
+    void             Moved() { MatCurrent = 0; if (Cache) NotifyCache(); }
+    void             NotifyCache();
+
 public:
-    Node() : Pos(Vector3f(0)), MatCurrent(1) { }
+    Node() : Pos(Vector3f(0)), MatCurrent(1), Cache(nullptr), CacheIndex(-1) { }
     virtual ~Node() { }
 
     enum NodeType
     {
         Node_NonDisplay,
         Node_Container,
-        Node_Model
+        Node_Model,
+        Node_WorldContainer
     };
     virtual NodeType GetType() const { return Node_NonDisplay; }
 
@@ -448,11 +461,11 @@ public:
 
     const Vector3f&  GetPosition() const      { return Pos; }
     const Quatf&     GetOrientation() const   { return Rot; }
-    void             SetPosition(Vector3f p)  { Pos = p; MatCurrent = 0; }
-    void             SetOrientation(Quatf q)  { Rot = q; MatCurrent = 0; }
+    void             SetPosition(Vector3f p)  { Pos = p; Moved(); }
+    void             SetOrientation(Quatf q)  { Rot = q; Moved(); }
 
-    void             Move(Vector3f p)         { Pos += p; MatCurrent = 0; }
-    void             Rotate(Quatf q)          { Rot = q * Rot; MatCurrent = 0; }
+    void             Move(Vector3f p)         { Pos += p; Moved(); }
+    void             Rotate(Quatf q)          { Rot = q * Rot; Moved(); }
 
 
     // For testing only; causes Position an Orientation
@@ -460,6 +473,8 @@ public:
     {
         MatCurrent = true;
         Mat = m;        
+        if (Cache)
+            NotifyCache();
     }
 
 
@@ -720,6 +735,111 @@ public:
 	Container() : CollideChildren(1) {}
 };
 
+// Container for scenes that extend far from the origin, whose children are placed with
+// double precision world poses. Float matrices lose precision a few kilometers from the
+// origin, so instead of multiplying the children's world matrices by the view matrix, Render
+// rebases them to float matrices relative to an origin near the eye. The origin only moves
+// in whole cells of OriginCellSize, and the rebased matrices are cached, so only children
+// that were moved are rebased while the eye stays within a cell.
+class WorldContainer : public Node
+{
+public:
+    WorldContainer() : OriginCellSize(1024.0), Origin(0.0, 0.0, 0.0), OriginValid(false) { }
+
+    virtual NodeType GetType() const { return Node_WorldContainer; }
+
+    virtual void ClearRenderer()
+    {
+        for (size_t i = 0; i < Children.size(); i++)
+            Children[i].Child->ClearRenderer();
+    }
+
+    // Returns the index of the child, for use with SetWorldPose.
+    size_t Add(Node* n, const Posed& worldPose);
+    void   Clear() { Children.clear(); DirtyIndices.clear(); }
+
+    size_t       GetChildCount() const            { return Children.size(); }
+    Node*        GetChild(size_t index) const     { return Children[index].Child; }
+    const Posed& GetWorldPose(size_t index) const { return Children[index].WorldPose; }
+    void         SetWorldPose(size_t index, const Posed& worldPose);
+
+    // Renders the children from an eye placed in double precision world space, with the
+    // view matrix computed relative to the rebase origin. The world space is that of the
+    // children's world poses, so the container's own position and orientation are unused.
+    void Render(const Posed& eyeWorldPose, RenderDevice* ren);
+
+    // Renders with a float view matrix, such as from Scene::Render, which is only precise
+    // near the world origin.
+    virtual void Render(const Matrix4f& ltw, RenderDevice* ren);
+
+    double OriginCellSize; // Meters the eye can move before the children are all rebased.
+
+private:
+    struct ChildEntry
+    {
+        Ptr<Node> Child;
+        Posed     WorldPose;
+        Matrix4f  OriginToChild; // Float transform from the rebase origin.
+        bool      Dirty;
+    };
+
+    void SetOrigin(const Vector3d& origin);
+    void RebaseDirty();
+
+    std::vector<ChildEntry> Children;
+    std::vector<size_t>     DirtyIndices;
+    Vector3d                Origin;
+    bool                    OriginValid;
+};
+
+// Flattened world matrices of a Container hierarchy. The nodes are stored in depth-first
+// order along with the index of their parent and the end of their subtree, so that every
+// subtree is a contiguous range following its root, and the world matrices are kept in one
+// contiguous array. Nodes tell the cache when they move, and Update recomputes only the
+// world matrices of the subtrees below moved nodes, so rendering several eyes from the same
+// cache computes them once per frame. Large updates are split into jobs for the JobSystem.
+//
+// The hierarchy is captured by Build, which must be called again after nodes are added to
+// or removed from any of its containers.
+class TransformCache
+{
+public:
+    TransformCache() : ParallelThreshold(4096) { }
+    ~TransformCache() { Clear(); }
+
+    void Build(Container* root);
+    void Clear();
+    bool IsEmpty() const { return Nodes.empty(); }
+
+    // Called by nodes in the hierarchy when they move.
+    void MarkDirty(int index);
+
+    // Recomputes the world matrices of the moved subtrees.
+    void Update();
+
+    // Renders the hierarchy like Container::Render, using world matrices that are up to date.
+    void Render(const Matrix4f& view, RenderDevice* ren);
+
+    int             GetNodeCount() const             { return (int)Nodes.size(); }
+    Node*           GetNode(int index) const         { return Nodes[index]; }
+    const Matrix4f& GetWorldMatrix(int index) const  { return WorldMatrices[index]; }
+
+    int ParallelThreshold; // Number of world matrices to recompute before splitting the work into jobs.
+
+private:
+    void addNode(Node* node, int parent);
+    void updateRange(int begin, int end);
+
+    std::vector<Ptr<Node> > Nodes;
+    std::vector<int>        Parents;       // Index of the parent, or -1 for the root.
+    std::vector<int>        SubtreeEnds;   // One past the last node of the subtree.
+    std::vector<int>        NextAliases;   // Next index holding the same node, or -1.
+    std::vector<Matrix4f>   WorldMatrices;
+    std::vector<uint8_t>    DirtyFlags;
+    std::vector<int>        DirtyIndices;
+    std::vector<int>        ForeignIndices; // Nodes held by another cache, which are always updated.
+};
+
 class Scene
 {
 public:
@@ -728,9 +848,15 @@ public:
     LightingParams	            Lighting;
     std::vector<Ptr<Model> >	Models;
 
+    // When built, Render uses the cached world matrices instead of traversing World.
+    TransformCache              Transforms;
+
 public:
     void Render(RenderDevice* ren, const Matrix4f& view);
 
+    // Flattens World into Transforms. Must be called again after changing the nodes of World.
+    void BuildTransformCache() { Transforms.Build(&World); }
+
     void SetAmbient(Color4f color)
     {
         Lighting.Ambient = color;
@@ -746,6 +872,7 @@ public:
 
 	void Clear()
 	{
+		Transforms.Clear();
 		World.Clear();
 		Models.clear();
 		Lighting.Ambient = Color4f(0.0f, 0.0f, 0.0f, 0.0f);
@@ -817,7 +944,34 @@ protected:
 
     Matrix4f            Proj;
     Vector4f            GlobalTint;
+
+    // Ring of vertices for text and the 2D fill helpers. Each draw maps the space after the
+    // previous one unsynchronized, and only wrapping around discards the buffer.
     Ptr<Buffer>         pTextVertexBuffer;
+    size_t              TextVertexRingOffset;
+
+    // Glyph quads of a string in font units, cached across batches.
+    struct TextLayout
+    {
+        const Font*         pFont;
+        std::string         Text;
+        std::vector<Vertex> Vertices;
+        unsigned            LastBatch;
+
+        TextLayout() : pFont(NULL), LastBatch(0) { }
+    };
+
+    std::unordered_map<size_t, TextLayout> TextLayoutCache;
+    int                 TextBatchDepth;
+    unsigned            TextBatchSerial;
+    const Fill*         TextBatchFill;
+    std::vector<Vertex> TextBatchVertices;  // Transformed and colored, ready to copy to the ring.
+
+    // Ring of per-draw uniform blocks, bound by offset rather than updating a buffer or
+    // setting loose uniforms for every draw. Devices enable it with a nonzero alignment.
+    Ptr<Buffer>         pUniformRingBuffer;
+    size_t              UniformRingOffset;
+    size_t              UniformRingAlignment;
 
     size_t		        TotalTextureMemoryUsage;
 
@@ -937,6 +1091,14 @@ public:
                              const size_t charRange[2] = 0, Vector2f charRangeRect[2] = 0);
     virtual void RenderText(const Font* font, const char* str, float x, float y, float size, Color c, const Matrix4f* view = NULL);
 
+    // Between BeginTextBatch and EndTextBatch, RenderText queues the glyphs of each string with
+    // its transform and color applied, and they are drawn with one call per font. The other 2D
+    // helpers draw queued text first, so overlap order is kept. The render target and viewport
+    // must not change inside a batch. Batches nest, and the outermost EndTextBatch draws.
+    void BeginTextBatch();
+    void EndTextBatch();
+    void FlushTextBatch();
+
     virtual void FillRect(float left, float top, float right, float bottom, Color c, const Matrix4f* view = NULL);
     void RenderLines ( int NumLines, Color c, float *x, float *y, float *z = nullptr );
     virtual void FillTexturedRect(
@@ -949,6 +1111,20 @@ public:
     virtual Fill *GetTextureFill(Texture* tex, bool useAlpha = false, bool usePremult = false) = 0;
     Fill *        CreateTextureFill(Texture* tex, bool useAlpha = false, bool usePremult = false);
 
+protected:
+    // Maps count vertices at the write position of the text vertex ring; byteOffset receives
+    // their offset for Render. UnmapTextVertices advances the ring past those used.
+    Vertex* MapTextVertices(int count, int* byteOffset);
+    void    UnmapTextVertices(Vertex* vertices, int count);
+
+    const std::vector<Vertex>& GetTextLayout(const Font* font, const char* str);
+
+    // Copies a uniform block into the uniform ring, padded to the ring alignment, and returns
+    // its byte offset. Returns -1 if the device hasn't enabled the ring or it can't be mapped.
+    int     PushUniforms(const void* data, size_t size);
+
+public:
+
     virtual void SetWindowSize(int w, int h)
 	{
 		WindowWidth = w;
@@ -1004,6 +1180,58 @@ int GetTextureSize(int format, int w, int h);
 // Image size must be a power of 2.
 void FilterRgba2x2(const uint8_t* src, int w, int h, uint8_t* dest);
 
+// Filters used by MipChain to downsample each level from the one above it.
+enum MipFilterType
+{
+    MipFilter_Box,      // 2x2 average, the fastest.
+    MipFilter_Kaiser,   // Kaiser-windowed sinc, sharper with little ringing.
+    MipFilter_Lanczos   // Lanczos-3, the sharpest, with some ringing at hard edges.
+};
+
+struct MipChainDesc
+{
+    MipFilterType Filter;
+    // Color channels are sRGB encoded, and are filtered in linear light so that distant
+    // surfaces don't darken. Alpha is always linear.
+    bool          SRGB;
+    // If above 0, alpha is scaled in each level so that the same fraction of texels passes
+    // an alpha test at this cutoff as in level 0, which keeps alpha-tested foliage from thinning out.
+    float         AlphaCoverageCutoff;
+
+    MipChainDesc() : Filter(MipFilter_Box), SRGB(false), AlphaCoverageCutoff(0.0f) { }
+};
+
+// Generates all the mip levels of an RGBA image, down to 1x1. Each level is filtered from
+// the one above it with SIMD kernels, and large levels are split into bands of rows across
+// the job system.
+class MipChain
+{
+public:
+    MipChain();
+
+    // Level 0 is the image itself, which isn't copied and must stay valid while the chain is used.
+    // Returns false for an empty image.
+    bool Build(const uint8_t* rgba, int w, int h, const MipChainDesc& desc);
+    void Clear();
+
+    int            GetLevelCount() const           { return (int)Levels.size(); }
+    int            GetLevelWidth(int level) const  { return Levels[level].Width; }
+    int            GetLevelHeight(int level) const { return Levels[level].Height; }
+    const uint8_t* GetLevelData(int level) const;
+
+private:
+    struct Level
+    {
+        int    Width;
+        int    Height;
+        size_t Offset;  // Into Data, for levels other than 0.
+    };
+
+    const uint8_t*       Source;
+    std::vector<Level>   Levels;
+    std::vector<uint8_t> Data;
+};
+
 enum TextureLoadFlags
 {
     TextureLoad_SrgbAware           = 0x0001,
@@ -1012,12 +1240,78 @@ enum TextureLoadFlags
     TextureLoad_SwapTextureSet      = 0x0008,
     TextureLoad_StoreCompressed     = 0x0010,
     TextureLoad_Hdcp                = 0x0020,
+    TextureLoad_PreferCooked        = 0x0040,   // Load the cooked DDS file of a TGA file instead, if one matches.
 };
 
+// Layout of a TGA file, as read by ReadTgaHeader.
+struct TgaHeader
+{
+    int     Width;
+    int     Height;
+    int     BitsPerPixel;   // 24 or 32.
+    bool    Rle;            // Run-length encoded (image type 10) rather than uncompressed (image type 2).
+    bool    TopDown;        // The first row in the file is the top one.
+    size_t  PixelOffset;    // Offset of the pixel data in the file.
+};
+
+// Reads the header of TGA file data, and returns false if the image isn't a true-color 24 or 32
+// bit image, uncompressed or run-length encoded.
+bool ReadTgaHeader(const uint8_t* data, size_t dataSize, TgaHeader* outHeader);
+
+// Decodes TGA file data to Width * Height RGBA pixels, with the top row first unless bottomUp.
+// Opaque pixels get the given alpha. Returns false if the data is truncated.
+bool DecodeTgaPixels(const uint8_t* data, size_t dataSize, const TgaHeader& header,
+                     unsigned char alpha, bool premultiplyAlpha, bool bottomUp, uint8_t* outRgba);
+
 Texture* LoadTextureTgaTopDown (RenderDevice* ren, File* f, int textureLoadFlags, unsigned char alpha = 255);
 Texture* LoadTextureTgaBottomUp(RenderDevice* ren, File* f, int textureLoadFlags, unsigned char alpha = 255);
 Texture* LoadTextureDDSTopDown (RenderDevice* ren, File* f, int textureLoadFlags);
 
+// How the alpha of a DDS file is to be interpreted, as stored in its DX10 header.
+enum DdsAlphaMode
+{
+    DdsAlpha_Unknown        = 0,
+    DdsAlpha_Straight       = 1,
+    DdsAlpha_Premultiplied  = 2,
+    DdsAlpha_Opaque         = 3
+};
+
+// Writes a DDS file with a DX10 header. data holds mipCount levels laid out as GetTextureSize
+// expects, largest first. Texture_SRGB in format selects an sRGB DXGI format.
+bool SaveTextureDDS(File* f, int format, int w, int h, int mipCount, const void* data, DdsAlphaMode alphaMode);
+
+// Loads the cooked DDS file of a TGA file, if it exists and its alpha mode matches what
+// LoadTextureTgaTopDown would produce with these flags and alpha. Returns NULL otherwise.
+Texture* LoadCookedTextureDDS(RenderDevice* ren, const char* tgaPath, int textureLoadFlags, unsigned char alpha);
+
+// Compresses an RGBA image to Texture_BC1, Texture_BC3 or Texture_BC7 blocks, laid out as
+// GetTextureSize expects. Rows of blocks are split across the job system.
+// Returns false for other formats.
+bool CompressTextureBlocks(int format, const uint8_t* rgba, int w, int h, uint8_t* outBlocks);
+
+struct TextureCookDesc
+{
+    int           Format;               // Texture_BC1, Texture_BC3 or Texture_BC7.
+    bool          SRGB;                 // Filter the mips in linear light, and store an sRGB format.
+    bool          PremultiplyAlpha;     // As TextureLoad_MakePremultAlpha.
+    MipFilterType MipFilter;
+    float         AlphaCoverageCutoff;  // See MipChainDesc.
+
+    TextureCookDesc() : Format(Texture_BC7), SRGB(true), PremultiplyAlpha(false),
+                        MipFilter(MipFilter_Box), AlphaCoverageCutoff(0.0f) { }
+};
+
+// Path of the cooked DDS file of a source texture, which is next to it with a .cooked.dds extension.
+std::string GetCookedTexturePath(const char* sourcePath);
+
+// Converts a TGA file to a block-compressed DDS file with a full mip chain.
+bool CookTextureTga(const char* tgaPath, const char* ddsPath, const TextureCookDesc& desc);
+
+// Cooks TGA files to the paths given by GetCookedTexturePath, in parallel on the job system.
+// Returns the number of files that failed, which are added to outFailedPaths if given.
+int CookTexturesTga(const std::vector<std::string>& tgaPaths, const TextureCookDesc& desc,
+                    std::vector<std::string>* outFailedPaths = NULL);
+
 
 }} // namespace OVR::Render
 
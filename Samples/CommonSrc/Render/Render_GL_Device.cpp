@@ -23,6 +23,8 @@ limitations under the License.
 
 #include "../Render/Render_GL_Device.h"
 #include "../Util/Logger.h"
+#include "Kernel/OVR_SysFile.h"
+#include "Util/Util_SystemInfo.h"
 #include <assert.h>
 
 namespace OVR { namespace Render { namespace GL {
@@ -41,6 +43,7 @@ void InitGLExtensions()
 
 // glsl2Prefix / glsl3Prefix
 // These provide #defines for shader types that differ between GLSL 1.5 (OpenGL 3.2) and earlier versions.
+// With GLSL 1.5 the standard uniforms are a block, which Render binds from the uniform ring.
 static const char glsl2Prefix[] =
 "#version 110\n"
 "#extension GL_ARB_shader_texture_lod : enable\n"
@@ -50,7 +53,8 @@ static const char glsl2Prefix[] =
 "#define _FS_IN varying\n"
 "#define _TEXTURELOD texture2DLod\n"
 "#define _TEXTURE texture2D\n"
-"#define _FRAGCOLOR gl_FragColor\n";
+"#define _FRAGCOLOR gl_FragColor\n"
+"#define _STD_UNIFORMS uniform mat4 Proj; uniform mat4 View; uniform vec4 GlobalTint;\n";
 
 static const char glsl3Prefix[] =
 "#version 150\n"
@@ -60,13 +64,20 @@ static const char glsl3Prefix[] =
 "#define _FS_IN in\n"
 "#define _TEXTURELOD textureLod\n"
 "#define _TEXTURE texture\n"
-"#define _FRAGCOLOR FragColor\n";
+"#define _FRAGCOLOR FragColor\n"
+"#define _STD_UNIFORMS layout(std140) uniform StdUniforms { mat4 Proj; mat4 View; vec4 GlobalTint; };\n";
+
+// Matches the StdUniforms block.
+struct StandardUniformData
+{
+    Matrix4f  Proj;
+    Matrix4f  View;
+    Vector4f  GlobalTint;
+};
 
 
 static const char* MVPVertexShaderSrc =
-    "uniform mat4 Proj;\n"
-    "uniform mat4 View;\n"
-    "uniform vec4 GlobalTint;\n"
+    "_STD_UNIFORMS\n"
     
     "_VS_IN vec4 Position;\n"
     "_VS_IN vec4 Color;\n"
@@ -332,6 +343,95 @@ static bool CheckFramebufferStatus(GLenum target)
 }
 #endif // defined(OVR_BUILD_DEBUG)
 
+
+// Program binary cache
+// Linked programs are saved along with the locations reflected from them, keyed by a hash
+// of the shader sources (including the GLSL prefix) and the driver identity. A hit skips
+// compiling, linking and the uniform lookups. Anything that doesn't match, including a
+// binary the driver rejects, falls back to building the program and replaces the entry.
+
+static const uint32_t ProgramBinaryMagic   = 0x50474C4F; // "OLGP"
+static const uint32_t ProgramBinaryVersion = 1;
+
+struct ProgramBinaryHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t CacheKey;
+    uint32_t BinaryFormat;
+    uint32_t BinaryOffset;      // The uniform records lie between the header and the binary.
+    uint32_t BinaryLength;
+    int32_t  ProjLoc, ViewLoc, GlobalTintLoc;
+    int32_t  TexLoc[8];
+    uint32_t StdUniformsBlock;
+    uint32_t UsesLighting;
+    uint32_t UniformCount;
+};
+
+struct ProgramBinaryUniform
+{
+    int32_t  Location, Size, Type;
+    uint32_t NameLength;        // The name follows, without a terminator.
+};
+
+static String   ProgramBinaryCacheDir;  // Empty when the driver can't save program binaries.
+static uint64_t ProgramBinaryDriverHash;
+
+static uint64_t HashProgramBinaryKey(uint64_t hash, const char* str)
+{
+    // FNV-1a, including the terminator so consecutive strings can't run together.
+    const uint8_t* p = (const uint8_t*)(str ? str : "");
+    do
+    {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    } while (*p++);
+    return hash;
+}
+
+static void InitProgramBinaryCache(const GLVersionAndExtensions& glv)
+{
+    ProgramBinaryCacheDir.Clear();
+
+    if (glv.WholeVersion < 401 && !GLE_ARB_get_program_binary)
+        return;
+
+    // Drivers may support the API yet offer no binary formats.
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount <= 0)
+        return;
+
+    uint64_t hash = 14695981039346656037ULL;
+    hash = HashProgramBinaryKey(hash, (const char*)glGetString(GL_VENDOR));
+    hash = HashProgramBinaryKey(hash, (const char*)glGetString(GL_RENDERER));
+    hash = HashProgramBinaryKey(hash, (const char*)glGetString(GL_VERSION));
+    ProgramBinaryDriverHash = hash;
+
+    Util::GetBaseOVRPath(true);
+    ProgramBinaryCacheDir = Util::GetOVRPath(L"GLProgramCache", true);
+}
+
+// Returns 0 if the program can't be cached.
+static uint64_t GetProgramBinaryCacheKey(const Shader* vs, const Shader* fs)
+{
+    if (ProgramBinaryCacheDir.IsEmpty() || vs->Source.IsEmpty() || fs->Source.IsEmpty())
+        return 0;
+
+    uint64_t hash = ProgramBinaryDriverHash;
+    hash = HashProgramBinaryKey(hash, vs->Source.ToCStr());
+    hash = HashProgramBinaryKey(hash, fs->Source.ToCStr());
+    return hash ? hash : 1;
+}
+
+static String GetProgramBinaryCachePath(uint64_t cacheKey)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.bin", (unsigned long long)cacheKey);
+    return ProgramBinaryCacheDir + name;
+}
+
+
 RenderDevice::RenderDevice(ovrSession session, const RendererParams&)
   : Render::RenderDevice(session),
     VertexShaders(),
@@ -356,9 +456,18 @@ RenderDevice::RenderDevice(ovrSession session, const RendererParams&)
     GlobalTint = Vector4f ( 1.0f, 1.0f, 1.0f, 1.0f );
 
     GetGLVersionAndExtensions(GLVersionInfo);
+    InitProgramBinaryCache(GLVersionInfo);
 
     OVR_ASSERT(GLVersionInfo.MajorVersion >= 2);
     const char* shaderPrefix = (GLVersionInfo.WholeVersion >= 302) ? glsl3Prefix : glsl2Prefix;
+
+    if (GLVersionInfo.WholeVersion >= 302)
+    {
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        UniformRingAlignment = Alg::Max(alignment, 16);
+    }
+
     const size_t shaderPrefixSize = strlen(shaderPrefix);
     
     for (int i = 0; i < VShader_Count; i++)
@@ -450,6 +559,7 @@ void RenderDevice::Shutdown()
 
     DefaultFill.Clear();
     DepthBuffers.clear();
+    StdUniformsBuffer.Clear();
 
     DebugCallbackControl.Shutdown();
 }
@@ -512,6 +622,8 @@ void RenderDevice::Flush()
 
 void RenderDevice::FillRect(float left, float top, float right, float bottom, Color c, const Matrix4f* view)
 {    
+    // Queued text goes below, and drawing it resets the blend state.
+    FlushTextBatch();
     glEnable(GL_BLEND);
     glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     OVR::Render::RenderDevice::FillRect(left, top, right, bottom, c, view);
@@ -528,6 +640,7 @@ void RenderDevice::RenderText(const struct Font* font, const char* str, float x,
 
 void RenderDevice::FillGradientRect(float left, float top, float right, float bottom, Color col_top, Color col_btm, const Matrix4f* view)
 {
+    FlushTextBatch();
     glEnable(GL_BLEND);
     glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     OVR::Render::RenderDevice::FillGradientRect(left, top, right, bottom, col_top, col_btm, view);
@@ -536,6 +649,7 @@ void RenderDevice::FillGradientRect(float left, float top, float right, float bo
 
 void RenderDevice::RenderImage(float left, float top, float right, float bottom, ShaderFill* image, unsigned char alpha, const Matrix4f* view)
 {    
+    FlushTextBatch();
     glEnable(GL_BLEND);
     glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     OVR::Render::RenderDevice::RenderImage(left, top, right, bottom, image, alpha, view);
@@ -747,6 +861,30 @@ void RenderDevice::Render(const Fill* fill, Render::Buffer* vertices, Render::Bu
     }
 
     fill->Set();
+    if (shaders->StdUniformsBlock != GL_INVALID_INDEX)
+    {
+        StandardUniformData stdUniforms;
+        stdUniforms.Proj = Proj;
+        stdUniforms.View = matrix.Transposed();
+        stdUniforms.GlobalTint = GlobalTint;
+
+        int ringOffset = PushUniforms(&stdUniforms, sizeof(stdUniforms));
+        if (ringOffset >= 0)
+        {
+            glBindBufferRange(GL_UNIFORM_BUFFER, 0, ((Buffer*)pUniformRingBuffer.GetPtr())->GLBuffer, ringOffset, sizeof(stdUniforms));
+        }
+        else
+        {
+            if (!StdUniformsBuffer)
+                StdUniformsBuffer = *CreateBuffer();
+            if (!StdUniformsBuffer || !StdUniformsBuffer->Data(Buffer_Uniform, &stdUniforms, sizeof(stdUniforms)))
+            {
+                OVR_ASSERT(false);
+                return;
+            }
+            glBindBufferBase(GL_UNIFORM_BUFFER, 0, StdUniformsBuffer->GLBuffer);
+        }
+    }
     if (shaders->ProjLoc >= 0)
         glUniformMatrix4fv(shaders->ProjLoc, 1, 0, &Proj.M[0][0]);
     if (shaders->ViewLoc >= 0)
@@ -810,6 +948,7 @@ bool Buffer::Data(int use, const void* buffer, size_t size)
     switch (use & Buffer_TypeMask)
     {
     case Buffer_Index:     Use = GL_ELEMENT_ARRAY_BUFFER; break;
+    case Buffer_Uniform:   Use = GL_UNIFORM_BUFFER; break;
     default:               Use = GL_ARRAY_BUFFER; break;
     }
 
@@ -822,23 +961,44 @@ bool Buffer::Data(int use, const void* buffer, size_t size)
 
     glBindBuffer(Use, GLBuffer);
     glBufferData(Use, size, buffer, mode);
+    Size = size;
     return 1;
 }
 
-void* Buffer::Map(size_t, size_t, int)
+void* Buffer::Map(size_t start, size_t size, int flags)
 {
     int mode = GL_WRITE_ONLY;
-    //if (flags & Map_Unsynchronized)
-    //    mode |= GL_MAP_UNSYNCHRONIZED;
-    
+
     glBindBuffer(Use, GLBuffer);
-    void* v = glMapBuffer(Use, mode);
-    return v;
+
+    // glMapBuffer waits for draws still reading the buffer. Without glMapBufferRange, writes
+    // that promise to leave those ranges alone are staged, and glBufferSubData doesn't wait.
+    if (flags & Map_Unsynchronized)
+    {
+        StagingStart = start;
+        Staging.resize(size);
+        return &Staging[0];
+    }
+
+    // Orphaning gives the buffer new storage, leaving the old to pending draws.
+    if (flags & Map_Discard)
+        glBufferData(Use, Size, NULL, GL_DYNAMIC_DRAW);
+
+    char* v = (char*)glMapBuffer(Use, mode);
+    return v ? v + start : NULL;
 }
 
-bool Buffer::Unmap(void*)
+bool Buffer::Unmap(void* m)
 {
     glBindBuffer(Use, GLBuffer);
+
+    if (!Staging.empty() && m == &Staging[0])
+    {
+        glBufferSubData(Use, StagingStart, Staging.size(), m);
+        Staging.clear();
+        return true;
+    }
+
     int r = glUnmapBuffer(Use);
     return r != 0;
 }
@@ -849,6 +1009,13 @@ Shader::~Shader()
         glDeleteShader(GLShader);
 }
 
+bool Shader::EnsureCompiled()
+{
+    if (GLShader || Source.IsEmpty())
+        return GLShader != 0;
+    return Compile(Source.ToCStr());
+}
+
 bool Shader::Compile(const char* src)
 {
     if (!GLShader)
@@ -876,6 +1043,7 @@ ShaderSet::ShaderSet() :
     ProjLoc(0),
     ViewLoc(0),
     GlobalTintLoc(0),
+    StdUniformsBlock(GL_INVALID_INDEX),
   //TexLoc[8];
     UsesLighting(false),
     LightingVer(0)
@@ -891,29 +1059,49 @@ ShaderSet::~ShaderSet()
 void ShaderSet::SetShader(Render::Shader *s)
 {
     Shaders[s->GetStage()] = s;
-    Shader* gls = (Shader*)s;
-    glAttachShader(Prog, gls->GLShader);
     if (Shaders[Shader_Vertex] && Shaders[Shader_Fragment])
         Link();
 }
 
 void ShaderSet::UnsetShader(int stage)
 {
-    Shader* gls = (Shader*)(Render::Shader*)Shaders[stage];
-    if (gls)
-        glDetachShader(Prog, gls->GLShader);
+    // Shaders are only attached while linking.
     Shaders[stage] = NULL;
 }
 
 bool ShaderSet::Link()
 {
+    Shader* vs = (Shader*)(Render::Shader*)Shaders[Shader_Vertex];
+    Shader* fs = (Shader*)(Render::Shader*)Shaders[Shader_Fragment];
+
+    uint64_t cacheKey = GetProgramBinaryCacheKey(vs, fs);
+    if (cacheKey && LoadProgramBinary(cacheKey))
+    {
+        glUseProgram(Prog);
+        for (int i = 0; i < 8 && TexLoc[i] >= 0; i++)
+            glUniform1i(TexLoc[i], i);
+        if (StdUniformsBlock != GL_INVALID_INDEX)
+            glUniformBlockBinding(Prog, StdUniformsBlock, 0);
+        return 1;
+    }
+
+    if (!vs->EnsureCompiled() || !fs->EnsureCompiled())
+        return 0;
+
+    glAttachShader(Prog, vs->GLShader);
+    glAttachShader(Prog, fs->GLShader);
     glBindAttribLocation(Prog, 0, "Position");
     glBindAttribLocation(Prog, 1, "Color");
     glBindAttribLocation(Prog, 2, "TexCoord");
     glBindAttribLocation(Prog, 3, "TexCoord1");
     glBindAttribLocation(Prog, 4, "Normal");
 
+    if (cacheKey)
+        glProgramParameteri(Prog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     glLinkProgram(Prog);
+    glDetachShader(Prog, vs->GLShader);
+    glDetachShader(Prog, fs->GLShader);
     GLint r;
     glGetProgramiv(Prog, GL_LINK_STATUS, &r);
     if (!r)
@@ -978,6 +1166,14 @@ bool ShaderSet::Link()
     ProjLoc         = glGetUniformLocation(Prog, "Proj");
     ViewLoc         = glGetUniformLocation(Prog, "View");
     GlobalTintLoc   = glGetUniformLocation(Prog, "GlobalTint");
+
+    StdUniformsBlock = GL_INVALID_INDEX;
+    if (GLEContext::GetCurrentContext()->WholeVersion >= 302)
+    {
+        StdUniformsBlock = glGetUniformBlockIndex(Prog, "StdUniforms");
+        if (StdUniformsBlock != GL_INVALID_INDEX)
+            glUniformBlockBinding(Prog, StdUniformsBlock, 0);
+    }
     for (int i = 0; i < 8; i++)
     {
         char texv[32];
@@ -989,10 +1185,129 @@ bool ShaderSet::Link()
         glUniform1i(TexLoc[i], i);
     }
     if (UsesLighting)
-        OVR_ASSERT(ProjLoc >= 0 && ViewLoc >= 0 && GlobalTintLoc >= 0);
+        OVR_ASSERT(StdUniformsBlock != GL_INVALID_INDEX || (ProjLoc >= 0 && ViewLoc >= 0 && GlobalTintLoc >= 0));
+
+    if (cacheKey)
+        SaveProgramBinary(cacheKey);
     return 1;
 }
 
+bool ShaderSet::LoadProgramBinary(uint64_t cacheKey)
+{
+    SysFile file(GetProgramBinaryCachePath(cacheKey));
+    int     fileSize = file.IsValid() ? file.GetLength() : 0;
+    if (fileSize <= (int)sizeof(ProgramBinaryHeader))
+        return false;
+
+    std::vector<uint8_t> data(fileSize);
+    if (file.Read(&data[0], fileSize) != fileSize)
+        return false;
+
+    ProgramBinaryHeader header;
+    memcpy(&header, &data[0], sizeof(header));
+    if (header.Magic != ProgramBinaryMagic || header.Version != ProgramBinaryVersion || header.CacheKey != cacheKey ||
+        header.BinaryOffset < sizeof(header) || header.BinaryLength == 0 ||
+        (size_t)header.BinaryOffset + header.BinaryLength != data.size())
+        return false;
+
+    // Parse the uniform table before touching the program or any members, so that a
+    // truncated or corrupt cache file leaves this ShaderSet as it was for Link() to rebuild.
+    std::vector<Uniform> uniforms;
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.UniformCount; i++)
+    {
+        ProgramBinaryUniform pu;
+        if (sizeof(pu) > header.BinaryOffset - offset)
+            return false;
+        memcpy(&pu, data.data() + offset, sizeof(pu));
+        offset += sizeof(pu);
+
+        if (pu.NameLength > header.BinaryOffset - offset)
+            return false;
+
+        Uniform u;
+        u.Name     = String((const char*)data.data() + offset, pu.NameLength);
+        u.Location = pu.Location;
+        u.Size     = pu.Size;
+        u.Type     = pu.Type;
+        uniforms.push_back(u);
+        offset += pu.NameLength;
+    }
+
+    // The driver rejects binaries from other drivers or hardware by failing the link.
+    glProgramBinary(Prog, header.BinaryFormat, &data[header.BinaryOffset], header.BinaryLength);
+    GLint r = 0;
+    glGetProgramiv(Prog, GL_LINK_STATUS, &r);
+    if (!r)
+        return false;
+
+    ProjLoc          = header.ProjLoc;
+    ViewLoc          = header.ViewLoc;
+    GlobalTintLoc    = header.GlobalTintLoc;
+    StdUniformsBlock = header.StdUniformsBlock;
+    UsesLighting     = header.UsesLighting != 0;
+    LightingVer      = 0;
+    memcpy(TexLoc, header.TexLoc, sizeof(TexLoc));
+    UniformInfo.swap(uniforms);
+    return true;
+}
+
+void ShaderSet::SaveProgramBinary(uint64_t cacheKey) const
+{
+    GLint binaryLength = 0;
+    glGetProgramiv(Prog, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0)
+        return;
+
+    ProgramBinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    header.Magic            = ProgramBinaryMagic;
+    header.Version          = ProgramBinaryVersion;
+    header.CacheKey         = cacheKey;
+    header.ProjLoc          = ProjLoc;
+    header.ViewLoc          = ViewLoc;
+    header.GlobalTintLoc    = GlobalTintLoc;
+    header.StdUniformsBlock = StdUniformsBlock;
+    header.UsesLighting     = UsesLighting ? 1 : 0;
+    header.UniformCount     = (uint32_t)UniformInfo.size();
+    memcpy(header.TexLoc, TexLoc, sizeof(TexLoc));
+
+    std::vector<uint8_t> data(sizeof(header));
+    for (size_t i = 0; i < UniformInfo.size(); i++)
+    {
+        ProgramBinaryUniform pu;
+        pu.Location   = UniformInfo[i].Location;
+        pu.Size       = UniformInfo[i].Size;
+        pu.Type       = UniformInfo[i].Type;
+        pu.NameLength = (uint32_t)UniformInfo[i].Name.GetSize();
+
+        const uint8_t* name = (const uint8_t*)UniformInfo[i].Name.ToCStr();
+        data.insert(data.end(), (const uint8_t*)&pu, (const uint8_t*)&pu + sizeof(pu));
+        data.insert(data.end(), name, name + pu.NameLength);
+    }
+
+    header.BinaryOffset = (uint32_t)data.size();
+    data.resize(data.size() + binaryLength);
+
+    GLsizei length = 0;
+    GLenum  format = 0;
+    glGetProgramBinary(Prog, binaryLength, &length, &format, &data[header.BinaryOffset]);
+    if (length <= 0)
+        return;
+
+    header.BinaryFormat = format;
+    header.BinaryLength = (uint32_t)length;
+    data.resize(header.BinaryOffset + length);
+    memcpy(&data[0], &header, sizeof(header));
+
+    SysFile file;
+    if (file.Open(GetProgramBinaryCachePath(cacheKey), File::Open_Write | File::Open_Create | File::Open_Truncate, File::Mode_Write))
+    {
+        file.Write(&data[0], (int)data.size());
+        file.Close();
+    }
+}
+
 void ShaderSet::Set(PrimitiveType) const
 {
     glUseProgram(Prog);
@@ -1476,24 +1791,18 @@ Texture* RenderDevice::CreateTexture(int format, int width, int height, const vo
         (format & Texture_RGBA8) &&
         ((format & Texture_SwapTextureSetStatic) == 0))
     {
-        int srcw = width, srch = height;
-        int level = 0;
-        uint8_t* mipmaps = NULL;
-        do
+        MipChainDesc mipDesc;
+        mipDesc.SRGB = (format & Texture_SRGB) != 0;
+        MipChain mips;
+        mips.Build((const uint8_t*)data, width, height, mipDesc);
+
+        int level = 1;
+        for (; level < mips.GetLevelCount(); level++)
         {
-            level++;
-            int mipw = srcw >> 1; if (mipw < 1) mipw = 1;
-            int miph = srch >> 1; if (miph < 1) miph = 1;
-            if (mipmaps == NULL)
-                mipmaps = (uint8_t*)OVR_ALLOC(mipw * miph * 4);
-            FilterRgba2x2(level == 1 ? (const uint8_t*)data : mipmaps, srcw, srch, mipmaps);
-            glTexImage2D(GL_TEXTURE_2D, level, internalFormat, mipw, miph, 0, glformat, gltype, mipmaps);
-            srcw = mipw;
-            srch = miph;
-        } while (srcw > 1 || srch > 1);
-        if (mipmaps)
-            OVR_FREE(mipmaps);
-        glTexParameteri(textureTarget, GL_TEXTURE_MAX_LEVEL, level);
+            glTexImage2D(GL_TEXTURE_2D, level, internalFormat, mips.GetLevelWidth(level), mips.GetLevelHeight(level),
+                         0, glformat, gltype, mips.GetLevelData(level));
+        }
+        glTexParameteri(textureTarget, GL_TEXTURE_MAX_LEVEL, level - 1);
     }
     else if (furtherInitialization)
     {
@@ -225,8 +225,12 @@ public:
     GLenum        Use;
     GLuint        GLBuffer;
 
+    // Map_Unsynchronized writes, uploaded by Unmap.
+    std::vector<char> Staging;
+    size_t            StagingStart;
+
 public:
-    Buffer(RenderDevice* r) : Ren(r), Size(0), Use(0), GLBuffer(0) {}
+    Buffer(RenderDevice* r) : Ren(r), Size(0), Use(0), GLBuffer(0), StagingStart(0) {}
     ~Buffer();
 
     GLuint         GetBuffer() { return GLBuffer; }
@@ -287,15 +291,16 @@ class Shader : public Render::Shader
 {
 public:
     GLuint      GLShader;
+    String      Source;     // Compiled when a program using it isn't in the program binary cache.
 
     Shader(RenderDevice*, ShaderStage st, GLuint s) : Render::Shader(st), GLShader(s) {}
-    Shader(RenderDevice*, ShaderStage st, const char* src) : Render::Shader(st), GLShader(0)
+    Shader(RenderDevice*, ShaderStage st, const char* src) : Render::Shader(st), GLShader(0), Source(src)
     {
-        Compile(src);
     }
 
     ~Shader();
     bool Compile(const char* src);
+    bool EnsureCompiled();
 
     GLenum GLStage() const
     {
@@ -327,6 +332,7 @@ public:
     std::vector<Uniform> UniformInfo;
 
     int     ProjLoc, ViewLoc, GlobalTintLoc;
+    GLuint  StdUniformsBlock;   // GL_INVALID_INDEX unless the program declares the StdUniforms block.
     int     TexLoc[8];
     bool    UsesLighting;
     int     LightingVer;
@@ -346,6 +352,10 @@ public:
     virtual bool SetUniform4x4f(const char* name, const Matrix4f& m);
 
     bool Link();
+
+protected:
+    bool LoadProgramBinary(uint64_t cacheKey);
+    void SaveProgramBinary(uint64_t cacheKey) const;
 };
 
 class RBuffer : public RefCountBase<RBuffer>
@@ -383,6 +393,7 @@ protected:
     GLVersionAndExtensions         GLVersionInfo;
     DebugCallback                  DebugCallbackControl;
     const LightingParams*          Lighting;
+    Ptr<Buffer>                    StdUniformsBuffer; // Used when the uniform ring can't take a block.
 
 public:
     RenderDevice(ovrSession session, const RendererParams& p);
@@ -21,12 +21,23 @@ limitations under the License.
 
 ************************************************************************************/
 #include "Render_Device.h"
+#include "Kernel/OVR_SysFile.h"
 
 #include <dxgi.h>
 
 namespace OVR { namespace Render {
 
 static const size_t   OVR_DDS_PF_FOURCC = 0x4;
+static const uint32_t OVR_DDS_HEADER_SIZE = 124;
+static const uint32_t OVR_DDS_PIXELFORMAT_SIZE = 32;
+static const uint32_t OVR_DDSD_CAPS_HEIGHT_WIDTH_PIXELFORMAT = 0x1007;
+static const uint32_t OVR_DDSD_MIPMAPCOUNT = 0x20000;
+static const uint32_t OVR_DDSD_LINEARSIZE = 0x80000;
+static const uint32_t OVR_DDSCAPS_COMPLEX = 0x8;
+static const uint32_t OVR_DDSCAPS_TEXTURE = 0x1000;
+static const uint32_t OVR_DDSCAPS_MIPMAP = 0x400000;
+static const uint32_t OVR_DDS_DIMENSION_TEXTURE2D = 3;
+static const uint32_t OVR_DDS_ALPHA_MODE_MASK = 0x7;
 static const uint32_t OVR_DXT1_MAGIC_NUMBER = 0x31545844; // "DXT1"
 static const uint32_t OVR_DXT2_MAGIC_NUMBER = 0x32545844; // "DXT2"
 static const uint32_t OVR_DXT3_MAGIC_NUMBER = 0x33545844; // "DXT3"
@@ -178,6 +189,11 @@ Texture* LoadTextureDDSTopDown(RenderDevice* ren, File* f, int textureLoadFlags)
         format |= Texture_SwapTextureSetStatic;
     }
 
+    if (textureLoadFlags & TextureLoad_Hdcp)
+    {
+        format |= Texture_Hdcp;
+    }
+
     int            byteLen = f->BytesAvailable();
     unsigned char* bytes   = new unsigned char[byteLen];
     f->Read(bytes, byteLen);
@@ -200,6 +216,116 @@ Texture* LoadTextureDDSTopDown(RenderDevice* ren, File* f, int textureLoadFlags)
     return out;
 }
 
+bool SaveTextureDDS(File* f, int format, int w, int h, int mipCount, const void* data, DdsAlphaMode alphaMode)
+{
+    bool srgb = (format & Texture_SRGB) != 0;
+
+    OVR_DDS_HEADER_DXT10 dx10Header;
+    memset(&dx10Header, 0, sizeof(dx10Header));
+    switch (format & Texture_TypeMask)
+    {
+    case Texture_BC1:  dx10Header.dxgiFormat = srgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM; break;
+    case Texture_BC2:  dx10Header.dxgiFormat = srgb ? DXGI_FORMAT_BC2_UNORM_SRGB : DXGI_FORMAT_BC2_UNORM; break;
+    case Texture_BC3:  dx10Header.dxgiFormat = srgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM; break;
+    case Texture_BC6S: dx10Header.dxgiFormat = DXGI_FORMAT_BC6H_SF16; break;
+    case Texture_BC6U: dx10Header.dxgiFormat = DXGI_FORMAT_BC6H_UF16; break;
+    case Texture_BC7:  dx10Header.dxgiFormat = srgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM; break;
+    default:
+        return false;
+    }
+    dx10Header.resourceDimension = OVR_DDS_DIMENSION_TEXTURE2D;
+    dx10Header.arraySize = 1;
+    dx10Header.miscFlags2 = alphaMode;
+
+    size_t dataSize = 0;
+    for (int level = 0, mipw = w, miph = h; level < mipCount; level++)
+    {
+        dataSize += GetTextureSize(format, mipw, miph);
+        mipw = (mipw > 1) ? (mipw >> 1) : 1;
+        miph = (miph > 1) ? (miph >> 1) : 1;
+    }
+
+    OVR_DDS_HEADER header;
+    memset(&header, 0, sizeof(header));
+    header.Size = OVR_DDS_HEADER_SIZE;
+    header.Flags = OVR_DDSD_CAPS_HEIGHT_WIDTH_PIXELFORMAT | OVR_DDSD_MIPMAPCOUNT | OVR_DDSD_LINEARSIZE;
+    header.Height = h;
+    header.Width = w;
+    header.PitchOrLinearSize = GetTextureSize(format, w, h);
+    header.MipMapCount = mipCount;
+    header.PixelFormat.Size = OVR_DDS_PIXELFORMAT_SIZE;
+    header.PixelFormat.Flags = OVR_DDS_PF_FOURCC;
+    header.PixelFormat.FourCC = OVR_DX10_MAGIC_NUMBER;
+    header.Caps = OVR_DDSCAPS_TEXTURE | (mipCount > 1 ? (OVR_DDSCAPS_COMPLEX | OVR_DDSCAPS_MIPMAP) : 0);
+
+    return f->Write((const uint8_t*)"DDS ", 4) == 4 &&
+           f->Write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+           f->Write((const uint8_t*)&dx10Header, sizeof(dx10Header)) == sizeof(dx10Header) &&
+           f->Write((const uint8_t*)data, (int)dataSize) == (int)dataSize;
+}
+
+Texture* LoadCookedTextureDDS(RenderDevice* ren, const char* tgaPath, int textureLoadFlags, unsigned char alpha)
+{
+    // Opaque TGA texels would get a different alpha than was cooked.
+    if (alpha != 255)
+    {
+        return NULL;
+    }
+
+    SysFile f(GetCookedTexturePath(tgaPath).c_str());
+    if (!f.IsValid())
+    {
+        return NULL;
+    }
+
+    // Only cooked files have a DX10 header with the alpha mode.
+    unsigned char        filecode[4];
+    OVR_DDS_HEADER       header;
+    OVR_DDS_HEADER_DXT10 dx10Header;
+    if (f.Read(filecode, 4) != 4 || strncmp((const char*)filecode, "DDS ", 4) != 0 ||
+        f.Read((unsigned char*)&header, sizeof(header)) != sizeof(header) ||
+        !(header.PixelFormat.Flags & OVR_DDS_PF_FOURCC) || header.PixelFormat.FourCC != OVR_DX10_MAGIC_NUMBER ||
+        f.Read((unsigned char*)&dx10Header, sizeof(dx10Header)) != sizeof(dx10Header))
+    {
+        return NULL;
+    }
+
+    uint32_t alphaMode = dx10Header.miscFlags2 & OVR_DDS_ALPHA_MODE_MASK;
+    bool     premultiplied = (textureLoadFlags & TextureLoad_MakePremultAlpha) != 0;
+    if (alphaMode != DdsAlpha_Opaque &&
+        alphaMode != (uint32_t)(premultiplied ? DdsAlpha_Premultiplied : DdsAlpha_Straight))
+    {
+        return NULL;
+    }
+
+    // The cooked colour space must match the one the TGA would be decoded in.
+    // BC6H has no sRGB variant, so it is never considered a mismatch.
+    bool srgbAware = (textureLoadFlags & TextureLoad_SrgbAware) != 0;
+    bool srgbCooked = false;
+    switch (dx10Header.dxgiFormat)
+    {
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+    case DXGI_FORMAT_BC2_UNORM_SRGB:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+    case DXGI_FORMAT_BC7_UNORM_SRGB:
+        srgbCooked = true;
+        break;
+    case DXGI_FORMAT_BC6H_SF16:
+    case DXGI_FORMAT_BC6H_UF16:
+        srgbCooked = srgbAware;
+        break;
+    default:
+        break;
+    }
+    if (srgbCooked != srgbAware)
+    {
+        return NULL;
+    }
+
+    f.SeekToBegin();
+    return LoadTextureDDSTopDown(ren, &f, textureLoadFlags);
+}
+
 
 }}
 
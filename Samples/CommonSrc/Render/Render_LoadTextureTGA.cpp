@@ -24,45 +24,205 @@ limitations under the License.
 
 #include "Render_Device.h"
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #include <tmmintrin.h>
+    #define OVR_TGA_SSSE3 // Compiled in, and used if CPUID reports it.
+#elif defined(__SSSE3__)
+    #include <tmmintrin.h>
+    #define OVR_TGA_SSSE3
+#endif
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define OVR_TGA_SSE2
+#endif
+
+#include <string.h>
+
 namespace OVR { namespace Render {
 
-Texture* LoadTextureTgaEitherWay(RenderDevice* ren, File* f, int textureLoadFlags, unsigned char alpha, bool bottomUp)
+namespace {
+
+enum TgaImageTypes
 {
-    OVR_ASSERT(textureLoadFlags != 255); // probably means an older style call is being made
+    kTgaTrueColor    = 2,
+    kTgaTrueColorRle = 10
+};
 
-    bool srgbAware = (textureLoadFlags & TextureLoad_SrgbAware) != 0;
-    bool anisotropic = (textureLoadFlags & TextureLoad_Anisotropic) != 0;
-    bool generatePremultAlpha = (textureLoadFlags & TextureLoad_MakePremultAlpha) != 0;
-    bool createSwapTextureSet = (textureLoadFlags & TextureLoad_SwapTextureSet) != 0;
-    bool isHdcp = (textureLoadFlags & TextureLoad_Hdcp) != 0;
+const size_t kTgaHeaderSize = 18;
 
-    f->SeekToBegin();
+uint16_t tgaReadUInt16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
 
-    if ( f->GetLength() == 0 )
+// Same as (unsigned char)((float)c * (float)a / 255.0f) for 8 bit c and a.
+inline uint8_t tgaPremultiply(int c, int a)
+{
+    int x = c * a;
+    return (uint8_t)((x + 1 + (x >> 8)) >> 8);
+}
+
+#if defined(OVR_TGA_SSSE3)
+bool tgaHasSsse3()
+{
+#if defined(_MSC_VER)
+    static int hasSsse3 = -1;
+    if (hasSsse3 < 0)
     {
-        // File doesn't exist!
-        return NULL;
+        int cpuInfo[4] = {};
+        __cpuid(cpuInfo, 1);
+        hasSsse3 = (cpuInfo[2] & (1 << 9)) ? 1 : 0;
+    }
+    return (hasSsse3 != 0);
+#else
+    return true;
+#endif
+}
+#endif
+
+// Converts a row of BGR pixels to RGBA with a constant alpha.
+void tgaConvertRow24(const uint8_t* src, uint8_t* dest, int width, uint8_t alpha)
+{
+    int x = 0;
+
+#if defined(OVR_TGA_SSSE3)
+    if (tgaHasSsse3())
+    {
+        // Four pixels per iteration, from 16 byte loads of which the last 4 bytes are unused,
+        // so stop while at least 6 pixels are left to stay within the row.
+        const __m128i shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+        const __m128i alphaBits = _mm_set1_epi32((int)((uint32_t)alpha << 24));
+        for (; x + 6 <= width; x += 4)
+        {
+            __m128i bgr = _mm_loadu_si128((const __m128i*)(src + x * 3));
+            __m128i rgba = _mm_or_si128(_mm_shuffle_epi8(bgr, shuffle), alphaBits);
+            _mm_storeu_si128((__m128i*)(dest + x * 4), rgba);
+        }
     }
-    
-    int desclen = f->ReadUByte();
-    int palette = f->ReadUByte();
-    OVR_UNUSED(palette);
-    int imgtype = f->ReadUByte();
-    f->ReadUInt16();
-    int palCount = f->ReadUInt16();
-    int palSize = f->ReadUByte();
-    f->ReadUInt16();
-    f->ReadUInt16();
-    int width = f->ReadUInt16();
-    int height = f->ReadUInt16();
-    int bpp = f->ReadUByte();
-    int descbyte = f->ReadUByte();
-    int imgsize = width * height * 4;
-    unsigned char* imgdata = (unsigned char*) OVR_ALLOC(imgsize);
-    unsigned char buf[16];
-    f->Read(imgdata, desclen);
-    f->Read(imgdata, palCount * (palSize + 7) >> 3);
-    int bpl = width * 4;
+#endif
+
+    for (; x < width; x++)
+    {
+        dest[x * 4 + 0] = src[x * 3 + 2];
+        dest[x * 4 + 1] = src[x * 3 + 1];
+        dest[x * 4 + 2] = src[x * 3 + 0];
+        dest[x * 4 + 3] = alpha;
+    }
+}
+
+// Converts a row of BGRA pixels to RGBA, replacing opaque alpha with the given alpha, and
+// optionally premultiplying the colors by the alpha stored in the file.
+void tgaConvertRow32(const uint8_t* src, uint8_t* dest, int width, uint8_t alpha, bool premultiplyAlpha)
+{
+    int x = 0;
+
+#if defined(OVR_TGA_SSE2)
+    const __m128i greenMask = _mm_set1_epi32(0x0000FF00);
+    const __m128i byteMask = _mm_set1_epi32(0x000000FF);
+    const __m128i opaque = _mm_set1_epi32(0xFF);
+    const __m128i replacementAlpha = _mm_set1_epi32((int)((uint32_t)alpha << 24));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128i bgra = _mm_loadu_si128((const __m128i*)(src + x * 4));
+        __m128i fileAlpha = _mm_srli_epi32(bgra, 24);
+
+        // Swap red and blue, leaving alpha zero.
+        __m128i rgb = _mm_or_si128(_mm_and_si128(bgra, greenMask),
+                      _mm_or_si128(_mm_and_si128(_mm_srli_epi32(bgra, 16), byteMask),
+                                   _mm_slli_epi32(_mm_and_si128(bgra, byteMask), 16)));
+
+        if (premultiplyAlpha)
+        {
+            // Multiply each color by its pixel's alpha in 16 bits, and divide by 255 exactly.
+            __m128i rgba = _mm_or_si128(rgb, _mm_slli_epi32(fileAlpha, 24));
+            __m128i lo = _mm_unpacklo_epi8(rgba, zero);
+            __m128i hi = _mm_unpackhi_epi8(rgba, zero);
+            __m128i loAlpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            __m128i hiAlpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            lo = _mm_mullo_epi16(lo, loAlpha);
+            hi = _mm_mullo_epi16(hi, hiAlpha);
+            lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, one), _mm_srli_epi16(lo, 8)), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, one), _mm_srli_epi16(hi, 8)), 8);
+            rgb = _mm_and_si128(_mm_packus_epi16(lo, hi), _mm_set1_epi32(0x00FFFFFF));
+        }
+
+        __m128i isOpaque = _mm_cmpeq_epi32(fileAlpha, opaque);
+        __m128i outAlpha = _mm_or_si128(_mm_and_si128(isOpaque, replacementAlpha),
+                                        _mm_andnot_si128(isOpaque, _mm_slli_epi32(fileAlpha, 24)));
+        _mm_storeu_si128((__m128i*)(dest + x * 4), _mm_or_si128(rgb, outAlpha));
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+        const uint8_t* pixel = src + x * 4;
+        uint8_t* out = dest + x * 4;
+        out[0] = pixel[2];
+        out[1] = pixel[1];
+        out[2] = pixel[0];
+        out[3] = (pixel[3] == 255) ? alpha : pixel[3];
+        if (premultiplyAlpha)
+        {
+            // Image is in lerping alpha, but we want premult alpha.
+            out[0] = tgaPremultiply(pixel[2], pixel[3]);
+            out[1] = tgaPremultiply(pixel[1], pixel[3]);
+            out[2] = tgaPremultiply(pixel[0], pixel[3]);
+        }
+    }
+}
+
+// Expands RLE packets to uncompressed pixels. Packets may cross rows.
+bool tgaDecodeRle(const uint8_t* src, const uint8_t* srcEnd, uint8_t* dest, size_t pixelCount, int bytesPerPixel)
+{
+    uint8_t* destEnd = dest + pixelCount * bytesPerPixel;
+    while (dest < destEnd)
+    {
+        if (src >= srcEnd)
+            return false;
+
+        uint8_t packet = *src++;
+        size_t byteCount = ((packet & 0x7F) + 1) * (size_t)bytesPerPixel;
+        if (byteCount > (size_t)(destEnd - dest))
+            return false;
+
+        if (packet & 0x80)
+        {
+            // Run of a single pixel.
+            if (srcEnd - src < bytesPerPixel)
+                return false;
+            for (size_t i = 0; i < byteCount; i += bytesPerPixel)
+                memcpy(dest + i, src, bytesPerPixel);
+            src += bytesPerPixel;
+        }
+        else
+        {
+            if ((size_t)(srcEnd - src) < byteCount)
+                return false;
+            memcpy(dest, src, byteCount);
+            src += byteCount;
+        }
+        dest += byteCount;
+    }
+    return true;
+}
+
+} // namespace
+
+
+bool ReadTgaHeader(const uint8_t* data, size_t dataSize, TgaHeader* outHeader)
+{
+    if (!data || dataSize < kTgaHeaderSize)
+        return false;
+
+    int descLength   = data[0];
+    int imageType    = data[2];
+    int paletteCount = tgaReadUInt16(data + 5);
+    int paletteBits  = data[7];
 
     // From the interwebs (very reliable I'm sure):
     //
@@ -80,79 +240,116 @@ Texture* LoadTextureTgaEitherWay(RenderDevice* ren, File* f, int textureLoadFlag
     //            10 = four way interleaving.                   
     //            11 = reserved.                                
     // This entire byte should be set to 0
-    OVR_ASSERT ( ( ( bpp == 24 ) && ( descbyte == 0 ) ) || ( ( bpp == 32 ) && ( descbyte == 8 ) ) );
-    if ( ( descbyte & 0x10 ) != 0 )
+    int descByte = data[17];
+
+    outHeader->Width        = tgaReadUInt16(data + 12);
+    outHeader->Height       = tgaReadUInt16(data + 14);
+    outHeader->BitsPerPixel = data[16];
+    outHeader->Rle          = (imageType == kTgaTrueColorRle);
+    outHeader->TopDown      = (descByte & 0x20) != 0;
+    outHeader->PixelOffset  = kTgaHeaderSize + descLength + paletteCount * ((paletteBits + 7) >> 3);
+
+    if (imageType != kTgaTrueColor && imageType != kTgaTrueColorRle)
+        return false;
+    if (outHeader->BitsPerPixel != 24 && outHeader->BitsPerPixel != 32)
+        return false;
+
+    return (outHeader->PixelOffset <= dataSize);
+}
+
+bool DecodeTgaPixels(const uint8_t* data, size_t dataSize, const TgaHeader& header,
+                     unsigned char alpha, bool premultiplyAlpha, bool bottomUp, uint8_t* outRgba)
+{
+    const int    bytesPerPixel = header.BitsPerPixel / 8;
+    const size_t rowSize       = (size_t)header.Width * bytesPerPixel;
+    const size_t pixelsSize    = rowSize * header.Height;
+    const uint8_t* pixels      = data + header.PixelOffset;
+
+    uint8_t* expanded = nullptr;
+    if (header.Rle)
+    {
+        expanded = (uint8_t*)OVR_ALLOC(pixelsSize);
+        if (!expanded || !tgaDecodeRle(pixels, data + dataSize, expanded, (size_t)header.Width * header.Height, bytesPerPixel))
+        {
+            OVR_FREE(expanded);
+            return false;
+        }
+        pixels = expanded;
+    }
+    else if (dataSize - header.PixelOffset < pixelsSize)
     {
-        // TGA is stored top-down rather than bottom-up, so flip the way we read the data to cope.
-        OVR_ASSERT ( !"test me" );
-        bottomUp = !bottomUp;
+        return false;
     }
 
-    switch (imgtype)
+    // Rows are stored bottom-up in the file unless the descriptor says otherwise.
+    bool flip = (bottomUp == header.TopDown);
+    for (int row = 0; row < header.Height; row++)
+    {
+        int y = flip ? (header.Height - 1 - row) : row;
+        uint8_t* dest = outRgba + (size_t)y * header.Width * 4;
+        if (bytesPerPixel == 3)
+            tgaConvertRow24(pixels + row * rowSize, dest, header.Width, alpha);
+        else
+            tgaConvertRow32(pixels + row * rowSize, dest, header.Width, alpha, premultiplyAlpha);
+    }
+
+    OVR_FREE(expanded);
+    return true;
+}
+
+Texture* LoadTextureTgaEitherWay(RenderDevice* ren, File* f, int textureLoadFlags, unsigned char alpha, bool bottomUp)
+{
+    OVR_ASSERT(textureLoadFlags != 255); // probably means an older style call is being made
+
+    bool srgbAware = (textureLoadFlags & TextureLoad_SrgbAware) != 0;
+    bool anisotropic = (textureLoadFlags & TextureLoad_Anisotropic) != 0;
+    bool generatePremultAlpha = (textureLoadFlags & TextureLoad_MakePremultAlpha) != 0;
+    bool createSwapTextureSet = (textureLoadFlags & TextureLoad_SwapTextureSet) != 0;
+    bool isHdcp = (textureLoadFlags & TextureLoad_Hdcp) != 0;
+
+    // Cooked files are stored top-down.
+    if ((textureLoadFlags & TextureLoad_PreferCooked) && !bottomUp)
     {
-    case 2:
-        switch (bpp)
+        Texture* cooked = LoadCookedTextureDDS(ren, f->GetFilePath(), textureLoadFlags, alpha);
+        if (cooked)
         {
-        case 24:
-            for (int yc = height-1; yc >= 0; yc--)
-            {
-                int y = yc;
-                if ( bottomUp )
-                {
-                    y = (height-1) - y;
-                }
-                for (int x = 0; x < width; x++)
-                {
-                    f->Read(buf, 3);
-                    imgdata[y*bpl+x*4+0] = buf[2];
-                    imgdata[y*bpl+x*4+1] = buf[1];
-                    imgdata[y*bpl+x*4+2] = buf[0];
-                    imgdata[y*bpl+x*4+3] = alpha;
-                }
-            }
-            break;
-        case 32:
-            for (int yc = height-1; yc >= 0; yc--)
-            {
-                int y = yc;
-                if ( bottomUp )
-                {
-                    y = (height-1) - y;
-                }
-                for (int x = 0; x < width; x++)
-                {
-                    f->Read(buf, 4);
-                    imgdata[y*bpl+x*4+0] = buf[2];
-                    imgdata[y*bpl+x*4+1] = buf[1];
-                    imgdata[y*bpl+x*4+2] = buf[0];
-                    if (buf[3] == 255)
-                    {
-                        imgdata[y*bpl+x*4+3] = alpha;
-                    }
-                    else
-                    {
-                        imgdata[y*bpl+x*4+3] = buf[3];
-                    }
-                    if ( generatePremultAlpha )
-                    {
-                        // Image is in lerping alpha, but we want premult alpha.
-                        imgdata[y*bpl+x*4+0] = (unsigned char)((float)buf[2] * (float)buf[3] / 255.0f);
-                        imgdata[y*bpl+x*4+1] = (unsigned char)((float)buf[1] * (float)buf[3] / 255.0f);
-                        imgdata[y*bpl+x*4+2] = (unsigned char)((float)buf[0] * (float)buf[3] / 255.0f);
-                    }
-                }
-            }
-            break;
-
-        default:
-            OVR_ASSERT ( !"Unknown bits per pixel" );
-            OVR_FREE(imgdata);
-            return NULL;
+            return cooked;
         }
-        break;
+    }
 
-    default:
+    f->SeekToBegin();
+
+    int fileSize = f->GetLength();
+    if ( fileSize <= 0 )
+    {
+        // File doesn't exist!
+        return NULL;
+    }
+
+    // Read the whole file at once, and decode it from memory.
+    uint8_t* fileData = (uint8_t*) OVR_ALLOC(fileSize);
+    if (!fileData || f->Read(fileData, fileSize) != fileSize)
+    {
+        OVR_FREE(fileData);
+        return NULL;
+    }
+
+    TgaHeader header;
+    if (!ReadTgaHeader(fileData, fileSize, &header))
+    {
         OVR_ASSERT ( !"unknown file format" );
+        OVR_FREE(fileData);
+        return NULL;
+    }
+
+    int width = header.Width;
+    int height = header.Height;
+    unsigned char* imgdata = (unsigned char*) OVR_ALLOC(width * height * 4);
+    bool decoded = DecodeTgaPixels(fileData, fileSize, header, alpha, generatePremultAlpha, bottomUp, imgdata);
+    OVR_FREE(fileData);
+    if (!decoded)
+    {
+        OVR_ASSERT ( !"truncated file" );
         OVR_FREE(imgdata);
         return NULL;
     }
@@ -177,6 +374,7 @@ Texture* LoadTextureTgaEitherWay(RenderDevice* ren, File* f, int textureLoadFlag
     Texture* out = ren->CreateTexture(format, width, height, imgdata);
     if (!out)
     {
+        OVR_FREE(imgdata);
         return NULL;
     }
 
@@ -0,0 +1,499 @@
+/************************************************************************************
+
+Filename    :   Render_MipChain.cpp
+Content     :   Generation of mip levels for RGBA8 textures
+Created     :   October, 2016
+Authors     :
+
+Copyright   :   Copyright 2016 Oculus VR, LLC. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+
+#include "Render_Device.h"
+#include "Util/Util_JobSystem.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define OVR_MIP_SSE2
+#endif
+
+#include <math.h>
+#include <string.h>
+
+namespace OVR { namespace Render {
+
+namespace {
+
+// Levels with fewer texels than this are filtered on the calling thread.
+const int kMipParallelTexels = 64 * 1024;
+
+// Approximate number of destination texels per job.
+const int kMipTexelsPerJob = 16 * 1024;
+
+// Radius of the Kaiser and Lanczos kernels, in destination texels.
+const float kMipKernelRadius = 3.0f;
+
+// Kaiser window parameter; higher values trade sharpness for less ringing.
+const float kMipKaiserAlpha = 4.0f;
+
+// Conversion tables between 8 bit sRGB, 16 bit linear and float linear values.
+// Built at static initialization, so that concurrent MipChain::Build calls don't race.
+struct MipTables
+{
+    uint16_t SrgbToLinear16[256];
+    float    SrgbToLinear[256];
+    float    UnormToFloat[256];
+    uint8_t  Linear16ToSrgb[65536];
+
+    MipTables()
+    {
+        float thresholds[256];
+        for (int i = 0; i < 256; i++)
+        {
+            float linear = srgbToLinear(i / 255.0f);
+            SrgbToLinear[i]   = linear;
+            SrgbToLinear16[i] = (uint16_t)(linear * 65535.0f + 0.5f);
+            UnormToFloat[i]   = i / 255.0f;
+            // Linear value at which the encoding rounds up to i + 1.
+            thresholds[i]     = (i < 255) ? srgbToLinear((i + 0.5f) / 255.0f) : 2.0f;
+        }
+
+        int code = 0;
+        for (int i = 0; i < 65536; i++)
+        {
+            while (i / 65535.0f >= thresholds[code])
+                code++;
+            Linear16ToSrgb[i] = (uint8_t)code;
+        }
+    }
+
+    static float srgbToLinear(float c)
+    {
+        return (c <= 0.04045f) ? (c / 12.92f) : powf((c + 0.055f) / 1.055f, 2.4f);
+    }
+};
+
+const MipTables MipConversion;
+
+inline uint8_t mipEncodeUnorm(float v)
+{
+    if (v <= 0.0f) return 0;
+    if (v >= 1.0f) return 255;
+    return (uint8_t)(v * 255.0f + 0.5f);
+}
+
+inline uint8_t mipEncodeSrgb(float v)
+{
+    if (v <= 0.0f) return 0;
+    if (v >= 1.0f) return 255;
+    return MipConversion.Linear16ToSrgb[(int)(v * 65535.0f + 0.5f)];
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** Box filter
+
+// Averages 2x2 texel blocks, with a source width or height of 1 repeating its only row
+// or column. The last row or column of odd sizes is dropped, like FilterRgba2x2.
+
+void mipBoxRowsUnorm(const uint8_t* src, int srcW, int srcH, uint8_t* dest, int destW, int rowBegin, int rowEnd)
+{
+    const int xStep = (srcW > 1) ? 4 : 0;
+
+    for (int y = rowBegin; y < rowEnd; y++)
+    {
+        const uint8_t* row0 = src + (size_t)srcW * 4 * ((srcH > 1) ? y * 2 : 0);
+        const uint8_t* row1 = (srcH > 1) ? row0 + srcW * 4 : row0;
+        uint8_t*       out  = dest + (size_t)destW * 4 * y;
+        int            x    = 0;
+
+    #if defined(OVR_MIP_SSE2)
+        if (xStep)
+        {
+            const __m128i zero  = _mm_setzero_si128();
+            const __m128i round = _mm_set1_epi16(2);
+
+            // 8 source texels to 4 destination texels per iteration.
+            for (; x + 4 <= destW; x += 4)
+            {
+                __m128i a0 = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+                __m128i a1 = _mm_loadu_si128((const __m128i*)(row0 + x * 8 + 16));
+                __m128i b0 = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+                __m128i b1 = _mm_loadu_si128((const __m128i*)(row1 + x * 8 + 16));
+
+                // Vertical sums, two source texels per register.
+                __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+                __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+                __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+                __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+                // Horizontal sums of texel pairs, in the low half of each register.
+                s0 = _mm_add_epi16(s0, _mm_srli_si128(s0, 8));
+                s1 = _mm_add_epi16(s1, _mm_srli_si128(s1, 8));
+                s2 = _mm_add_epi16(s2, _mm_srli_si128(s2, 8));
+                s3 = _mm_add_epi16(s3, _mm_srli_si128(s3, 8));
+
+                __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s0, s1), round), 2);
+                __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s2, s3), round), 2);
+                _mm_storeu_si128((__m128i*)(out + x * 4), _mm_packus_epi16(lo, hi));
+            }
+        }
+    #endif
+
+        for (; x < destW; x++)
+        {
+            const uint8_t* p0 = row0 + x * 2 * xStep;
+            const uint8_t* p1 = row1 + x * 2 * xStep;
+            for (int c = 0; c < 4; c++)
+                out[x * 4 + c] = (uint8_t)((p0[c] + p0[xStep + c] + p1[c] + p1[xStep + c] + 2) >> 2);
+        }
+    }
+}
+
+void mipBoxRowsSrgb(const uint8_t* src, int srcW, int srcH, uint8_t* dest, int destW, int rowBegin, int rowEnd)
+{
+    const uint16_t* toLinear = MipConversion.SrgbToLinear16;
+    const uint8_t*  toSrgb   = MipConversion.Linear16ToSrgb;
+    const int       xStep    = (srcW > 1) ? 4 : 0;
+
+    for (int y = rowBegin; y < rowEnd; y++)
+    {
+        const uint8_t* row0 = src + (size_t)srcW * 4 * ((srcH > 1) ? y * 2 : 0);
+        const uint8_t* row1 = (srcH > 1) ? row0 + srcW * 4 : row0;
+        uint8_t*       out  = dest + (size_t)destW * 4 * y;
+
+        for (int x = 0; x < destW; x++, out += 4)
+        {
+            const uint8_t* p0 = row0 + x * 2 * xStep;
+            const uint8_t* p1 = row1 + x * 2 * xStep;
+            for (int c = 0; c < 3; c++)
+            {
+                unsigned sum = toLinear[p0[c]] + toLinear[p0[xStep + c]] + toLinear[p1[c]] + toLinear[p1[xStep + c]];
+                out[c] = toSrgb[(sum + 2) >> 2];
+            }
+            out[3] = (uint8_t)((p0[3] + p0[xStep + 3] + p1[3] + p1[xStep + 3] + 2) >> 2);
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** Kaiser and Lanczos filters
+
+float mipSinc(float x)
+{
+    if (fabsf(x) < 1e-5f)
+        return 1.0f;
+    x *= MATH_FLOAT_PI;
+    return sinf(x) / x;
+}
+
+// Zeroth order modified Bessel function of the first kind.
+float mipBesselI0(float x)
+{
+    float sum  = 1.0f;
+    float term = 1.0f;
+    float x2   = x * x * 0.25f;
+    for (int k = 1; k < 32 && term > sum * 1e-8f; k++)
+    {
+        term *= x2 / (float)(k * k);
+        sum  += term;
+    }
+    return sum;
+}
+
+float mipKernel(MipFilterType filter, float x)
+{
+    float t = x / kMipKernelRadius;
+    if (t * t >= 1.0f)
+        return 0.0f;
+
+    if (filter == MipFilter_Lanczos)
+        return mipSinc(x) * mipSinc(t);
+
+    return mipSinc(x) * mipBesselI0(kMipKaiserAlpha * sqrtf(1.0f - t * t)) / mipBesselI0(kMipKaiserAlpha);
+}
+
+// Normalized weights of the source texels of each destination texel along one axis.
+// Taps past the edges are clamped to the edge texel.
+struct MipAxisWeights
+{
+    int                TapCount;
+    std::vector<int>   Indices;     // TapCount per destination texel.
+    std::vector<float> Weights;
+
+    void Build(MipFilterType filter, int srcSize, int destSize)
+    {
+        float scale = (float)srcSize / (float)destSize;
+        TapCount = (int)ceilf(kMipKernelRadius * scale) * 2;
+        if (srcSize == destSize)
+            TapCount = 1;
+
+        Indices.resize((size_t)destSize * TapCount);
+        Weights.resize((size_t)destSize * TapCount);
+
+        for (int d = 0; d < destSize; d++)
+        {
+            int*   indices = &Indices[(size_t)d * TapCount];
+            float* weights = &Weights[(size_t)d * TapCount];
+
+            if (TapCount == 1)
+            {
+                indices[0] = d;
+                weights[0] = 1.0f;
+                continue;
+            }
+
+            float center = (d + 0.5f) * scale;
+            int   first  = (int)floorf(center - TapCount * 0.5f + 0.5f);
+            float total  = 0.0f;
+
+            for (int t = 0; t < TapCount; t++)
+            {
+                int s = first + t;
+                weights[t] = mipKernel(filter, (s + 0.5f - center) / scale);
+                indices[t] = (s < 0) ? 0 : (s >= srcSize ? srcSize - 1 : s);
+                total += weights[t];
+            }
+            for (int t = 0; t < TapCount; t++)
+                weights[t] /= total;
+        }
+    }
+};
+
+void mipKernelRows(const uint8_t* src, int srcW, uint8_t* dest, int destW, bool srgb,
+                   const MipAxisWeights& wx, const MipAxisWeights& wy, int rowBegin, int rowEnd)
+{
+    const float* toColor = srgb ? MipConversion.SrgbToLinear : MipConversion.UnormToFloat;
+    const float* toAlpha = MipConversion.UnormToFloat;
+
+    // Vertically filtered source row, in linear float RGBA.
+    std::vector<float> column((size_t)srcW * 4);
+
+    for (int y = rowBegin; y < rowEnd; y++)
+    {
+        const int*   rowIndices = &wy.Indices[(size_t)y * wy.TapCount];
+        const float* rowWeights = &wy.Weights[(size_t)y * wy.TapCount];
+        float*       acc        = &column[0];
+
+        memset(acc, 0, column.size() * sizeof(float));
+
+        for (int t = 0; t < wy.TapCount; t++)
+        {
+            const uint8_t* p = src + (size_t)srcW * 4 * rowIndices[t];
+            const float    w = rowWeights[t];
+
+        #if defined(OVR_MIP_SSE2)
+            const __m128 wv = _mm_set1_ps(w);
+            for (int x = 0; x < srcW; x++, p += 4)
+            {
+                __m128 texel = _mm_setr_ps(toColor[p[0]], toColor[p[1]], toColor[p[2]], toAlpha[p[3]]);
+                _mm_storeu_ps(acc + x * 4, _mm_add_ps(_mm_loadu_ps(acc + x * 4), _mm_mul_ps(texel, wv)));
+            }
+        #else
+            for (int x = 0; x < srcW; x++, p += 4)
+            {
+                acc[x * 4 + 0] += toColor[p[0]] * w;
+                acc[x * 4 + 1] += toColor[p[1]] * w;
+                acc[x * 4 + 2] += toColor[p[2]] * w;
+                acc[x * 4 + 3] += toAlpha[p[3]] * w;
+            }
+        #endif
+        }
+
+        uint8_t* out = dest + (size_t)destW * 4 * y;
+
+        for (int x = 0; x < destW; x++, out += 4)
+        {
+            const int*   indices = &wx.Indices[(size_t)x * wx.TapCount];
+            const float* weights = &wx.Weights[(size_t)x * wx.TapCount];
+            float        texel[4];
+
+        #if defined(OVR_MIP_SSE2)
+            __m128 sum = _mm_setzero_ps();
+            for (int t = 0; t < wx.TapCount; t++)
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(acc + indices[t] * 4), _mm_set1_ps(weights[t])));
+            _mm_storeu_ps(texel, sum);
+        #else
+            texel[0] = texel[1] = texel[2] = texel[3] = 0.0f;
+            for (int t = 0; t < wx.TapCount; t++)
+            {
+                const float* a = acc + indices[t] * 4;
+                texel[0] += a[0] * weights[t];
+                texel[1] += a[1] * weights[t];
+                texel[2] += a[2] * weights[t];
+                texel[3] += a[3] * weights[t];
+            }
+        #endif
+
+            for (int c = 0; c < 3; c++)
+                out[c] = srgb ? mipEncodeSrgb(texel[c]) : mipEncodeUnorm(texel[c]);
+            out[3] = mipEncodeUnorm(texel[3]);
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** Alpha coverage
+
+void mipAlphaHistogram(const uint8_t* rgba, size_t texelCount, uint32_t histogram[256])
+{
+    memset(histogram, 0, 256 * sizeof(uint32_t));
+    for (size_t i = 0; i < texelCount; i++)
+        histogram[rgba[i * 4 + 3]]++;
+}
+
+// Fraction of texels whose alpha, scaled by alphaScale, passes an alpha test at cutoff.
+float mipAlphaCoverage(const uint32_t histogram[256], size_t texelCount, float alphaScale, float cutoff)
+{
+    uint64_t covered = 0;
+    for (int a = 1; a < 256; a++)
+    {
+        if (a * alphaScale > cutoff * 255.0f)
+            covered += histogram[a];
+    }
+    return (float)((double)covered / (double)texelCount);
+}
+
+// Scales the alpha of a level so that the same fraction of it passes the alpha test as of level 0.
+void mipPreserveAlphaCoverage(uint8_t* rgba, size_t texelCount, float targetCoverage, float cutoff)
+{
+    uint32_t histogram[256];
+    mipAlphaHistogram(rgba, texelCount, histogram);
+
+    // Coverage only increases with the scale, so bisect it.
+    float lower = 0.0f, upper = 4.0f;
+    for (int i = 0; i < 20; i++)
+    {
+        float mid = (lower + upper) * 0.5f;
+        if (mipAlphaCoverage(histogram, texelCount, mid, cutoff) < targetCoverage)
+            lower = mid;
+        else
+            upper = mid;
+    }
+
+    // Small levels can't match the coverage exactly, so take the closer of the two bounds.
+    float lowerError = targetCoverage - mipAlphaCoverage(histogram, texelCount, lower, cutoff);
+    float upperError = mipAlphaCoverage(histogram, texelCount, upper, cutoff) - targetCoverage;
+    float alphaScale = (lowerError < upperError) ? lower : upper;
+
+    uint8_t scaled[256];
+    for (int a = 0; a < 256; a++)
+        scaled[a] = mipEncodeUnorm(a * alphaScale / 255.0f);
+
+    for (size_t i = 0; i < texelCount; i++)
+        rgba[i * 4 + 3] = scaled[rgba[i * 4 + 3]];
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------------
+// ***** MipChain
+
+MipChain::MipChain()
+    : Source(NULL)
+{
+}
+
+void MipChain::Clear()
+{
+    Source = NULL;
+    Levels.clear();
+    Data.clear();
+}
+
+bool MipChain::Build(const uint8_t* rgba, int w, int h, const MipChainDesc& desc)
+{
+    Clear();
+    if (!rgba || w <= 0 || h <= 0)
+        return false;
+
+    Source = rgba;
+
+    Level top = { w, h, 0 };
+    Levels.push_back(top);
+
+    size_t dataSize = 0;
+    while (w > 1 || h > 1)
+    {
+        w = (w > 1) ? (w >> 1) : 1;
+        h = (h > 1) ? (h >> 1) : 1;
+        Level level = { w, h, dataSize };
+        Levels.push_back(level);
+        dataSize += (size_t)w * h * 4;
+    }
+    Data.resize(dataSize);
+
+    float targetCoverage = 0.0f;
+    if (desc.AlphaCoverageCutoff > 0.0f)
+    {
+        uint32_t histogram[256];
+        size_t   texelCount = (size_t)Levels[0].Width * Levels[0].Height;
+        mipAlphaHistogram(rgba, texelCount, histogram);
+        targetCoverage = mipAlphaCoverage(histogram, texelCount, 1.0f, desc.AlphaCoverageCutoff);
+    }
+
+    for (int i = 1; i < (int)Levels.size(); i++)
+    {
+        const Level&   srcLevel = Levels[i - 1];
+        const Level&   level    = Levels[i];
+        const uint8_t* src      = GetLevelData(i - 1);
+        uint8_t*       dest     = &Data[level.Offset];
+
+        MipAxisWeights wx, wy;
+        if (desc.Filter != MipFilter_Box)
+        {
+            wx.Build(desc.Filter, srcLevel.Width, level.Width);
+            wy.Build(desc.Filter, srcLevel.Height, level.Height);
+        }
+
+        auto filterRows = [&](int rowBegin, int rowEnd)
+        {
+            if (desc.Filter != MipFilter_Box)
+                mipKernelRows(src, srcLevel.Width, dest, level.Width, desc.SRGB, wx, wy, rowBegin, rowEnd);
+            else if (desc.SRGB)
+                mipBoxRowsSrgb(src, srcLevel.Width, srcLevel.Height, dest, level.Width, rowBegin, rowEnd);
+            else
+                mipBoxRowsUnorm(src, srcLevel.Width, srcLevel.Height, dest, level.Width, rowBegin, rowEnd);
+        };
+
+        // Large levels are split into bands of rows, which only read the level above.
+        if (level.Width * level.Height >= kMipParallelTexels)
+        {
+            int rowsPerJob = (level.Width < kMipTexelsPerJob) ? (kMipTexelsPerJob / level.Width) : 1;
+            Util::JobSystem::GetInstance()->ParallelFor(0, level.Height, rowsPerJob, filterRows);
+        }
+        else
+        {
+            filterRows(0, level.Height);
+        }
+
+        if (desc.AlphaCoverageCutoff > 0.0f)
+            mipPreserveAlphaCoverage(dest, (size_t)level.Width * level.Height, targetCoverage, desc.AlphaCoverageCutoff);
+    }
+
+    return true;
+}
+
+const uint8_t* MipChain::GetLevelData(int level) const
+{
+    OVR_ASSERT(level >= 0 && level < (int)Levels.size());
+    return (level == 0) ? Source : &Data[Levels[level].Offset];
+}
+
+}} // namespace OVR::Render
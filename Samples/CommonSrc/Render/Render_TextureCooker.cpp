@@ -0,0 +1,846 @@
+/************************************************************************************
+
+Filename    :   Render_TextureCooker.cpp
+Content     :   Offline conversion of TGA textures to block-compressed DDS files
+Created     :   October, 2016
+Authors     :
+
+Copyright   :   Copyright 2016 Oculus VR, LLC. All Rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+************************************************************************************/
+
+
+#include "Render_Device.h"
+#include "Kernel/OVR_SysFile.h"
+#include "Util/Util_JobSystem.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define OVR_BC_SSE2
+#endif
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+namespace OVR { namespace Render {
+
+namespace {
+
+// Levels with fewer blocks than this are compressed on the calling thread.
+const int kBcParallelBlocks = 1024;
+
+// Approximate number of blocks per job.
+const int kBcBlocksPerJob = 256;
+
+// Number of least-squares endpoint refinements tried after the principal axis fit.
+const int kBcRefineIterations = 2;
+
+// Interpolation weights of the BC7 4 bit indices, out of 64.
+const int kBc7Weights2[4]  = { 0, 21, 43, 64 };
+const int kBc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// A 4x4 block of texels, in both texel order for endpoint fitting and channel order
+// for the SIMD index search. Values are in [0, 255].
+struct BcBlock
+{
+    float Texels[16][4];
+    OVR_ALIGNAS(16) float Channels[4][16];
+};
+
+void bcLoadBlock(const uint8_t* rgba, int w, int h, int bx, int by, BcBlock* block)
+{
+    // Texels past the right or bottom edge repeat the edge texels.
+    for (int y = 0; y < 4; y++)
+    {
+        int sy = Alg::Min(by * 4 + y, h - 1);
+        for (int x = 0; x < 4; x++)
+        {
+            int            sx = Alg::Min(bx * 4 + x, w - 1);
+            const uint8_t* p  = rgba + ((size_t)sy * w + sx) * 4;
+            for (int c = 0; c < 4; c++)
+            {
+                block->Texels[y * 4 + x][c]   = p[c];
+                block->Channels[c][y * 4 + x] = p[c];
+            }
+        }
+    }
+}
+
+// Picks the palette entry closest to each texel, with channels weighted by channelWeights.
+// Returns the total weighted squared error of the texels in texelMask.
+float bcFindIndices(const BcBlock& block, const float (*palette)[4], int paletteCount,
+                    const float channelWeights[4], uint8_t indices[16], uint32_t texelMask = 0xffff)
+{
+    float totalError = 0.0f;
+
+#if defined(OVR_BC_SSE2)
+    const __m128 wr = _mm_set1_ps(channelWeights[0]);
+    const __m128 wg = _mm_set1_ps(channelWeights[1]);
+    const __m128 wb = _mm_set1_ps(channelWeights[2]);
+    const __m128 wa = _mm_set1_ps(channelWeights[3]);
+
+    // Four texels at a time.
+    for (int i = 0; i < 16; i += 4)
+    {
+        __m128  r         = _mm_load_ps(&block.Channels[0][i]);
+        __m128  g         = _mm_load_ps(&block.Channels[1][i]);
+        __m128  b         = _mm_load_ps(&block.Channels[2][i]);
+        __m128  a         = _mm_load_ps(&block.Channels[3][i]);
+        __m128  bestError = _mm_set1_ps(FLT_MAX);
+        __m128i bestIndex = _mm_setzero_si128();
+
+        for (int k = 0; k < paletteCount; k++)
+        {
+            __m128 dr = _mm_sub_ps(r, _mm_set1_ps(palette[k][0]));
+            __m128 dg = _mm_sub_ps(g, _mm_set1_ps(palette[k][1]));
+            __m128 db = _mm_sub_ps(b, _mm_set1_ps(palette[k][2]));
+            __m128 da = _mm_sub_ps(a, _mm_set1_ps(palette[k][3]));
+            __m128 error = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(dr, dr), wr), _mm_mul_ps(_mm_mul_ps(dg, dg), wg)),
+                                      _mm_add_ps(_mm_mul_ps(_mm_mul_ps(db, db), wb), _mm_mul_ps(_mm_mul_ps(da, da), wa)));
+
+            __m128i closer = _mm_castps_si128(_mm_cmplt_ps(error, bestError));
+            bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(k)), _mm_andnot_si128(closer, bestIndex));
+            bestError = _mm_min_ps(error, bestError);
+        }
+
+        OVR_ALIGNAS(16) int   lanesIndex[4];
+        OVR_ALIGNAS(16) float lanesError[4];
+        _mm_store_si128((__m128i*)lanesIndex, bestIndex);
+        _mm_store_ps(lanesError, bestError);
+        for (int j = 0; j < 4; j++)
+        {
+            indices[i + j] = (uint8_t)lanesIndex[j];
+            if (texelMask & (1u << (i + j)))
+                totalError += lanesError[j];
+        }
+    }
+#else
+    for (int i = 0; i < 16; i++)
+    {
+        float bestError = FLT_MAX;
+        for (int k = 0; k < paletteCount; k++)
+        {
+            float error = 0.0f;
+            for (int c = 0; c < 4; c++)
+            {
+                float d = block.Channels[c][i] - palette[k][c];
+                error += d * d * channelWeights[c];
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                indices[i] = (uint8_t)k;
+            }
+        }
+        if (texelMask & (1u << i))
+            totalError += bestError;
+    }
+#endif
+
+    return totalError;
+}
+
+// Fits a line through the selected texels along their principal axis, and returns the
+// extreme points of their projections on it, moved inward by insetFraction of their distance.
+void bcFitEndpoints(const BcBlock& block, const uint8_t* texels, int texelCount, int channelCount,
+                    float insetFraction, float e0[4], float e1[4])
+{
+    float mean[4] = {};
+    for (int i = 0; i < texelCount; i++)
+        for (int c = 0; c < channelCount; c++)
+            mean[c] += block.Texels[texels[i]][c];
+    for (int c = 0; c < channelCount; c++)
+        mean[c] /= (float)texelCount;
+
+    float covariance[4][4] = {};
+    for (int i = 0; i < texelCount; i++)
+    {
+        float d[4];
+        for (int c = 0; c < channelCount; c++)
+            d[c] = block.Texels[texels[i]][c] - mean[c];
+        for (int c = 0; c < channelCount; c++)
+            for (int k = 0; k < channelCount; k++)
+                covariance[c][k] += d[c] * d[k];
+    }
+
+    // Power iteration, starting from the covariance of the channel that varies most, which
+    // unlike a fixed start can't be orthogonal to the principal axis.
+    int widest = 0;
+    for (int c = 1; c < channelCount; c++)
+    {
+        if (covariance[c][c] > covariance[widest][widest])
+            widest = c;
+    }
+    float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    if (covariance[widest][widest] > 0.0f)
+    {
+        for (int c = 0; c < channelCount; c++)
+            axis[c] = covariance[widest][c];
+    }
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        float next[4] = {};
+        float length  = 0.0f;
+        for (int c = 0; c < channelCount; c++)
+        {
+            for (int k = 0; k < channelCount; k++)
+                next[c] += covariance[c][k] * axis[k];
+            length = Alg::Max(length, fabsf(next[c]));
+        }
+        if (length < 1e-6f)
+            break;
+        for (int c = 0; c < channelCount; c++)
+            axis[c] = next[c] / length;
+    }
+
+    float axisLengthSq = 0.0f;
+    for (int c = 0; c < channelCount; c++)
+        axisLengthSq += axis[c] * axis[c];
+
+    float tMin = FLT_MAX, tMax = -FLT_MAX;
+    for (int i = 0; i < texelCount; i++)
+    {
+        float t = 0.0f;
+        for (int c = 0; c < channelCount; c++)
+            t += (block.Texels[texels[i]][c] - mean[c]) * axis[c];
+        t /= axisLengthSq;
+        tMin = Alg::Min(tMin, t);
+        tMax = Alg::Max(tMax, t);
+    }
+
+    float inset = (tMax - tMin) * insetFraction;
+    tMin += inset;
+    tMax -= inset;
+
+    for (int c = 0; c < channelCount; c++)
+    {
+        e0[c] = Alg::Clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+        e1[c] = Alg::Clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+    }
+}
+
+// Solves for the endpoints that best reproduce the selected texels with the interpolation
+// weights of their current indices. Returns false if the weights don't determine them.
+bool bcRefineEndpoints(const BcBlock& block, const uint8_t* texels, int texelCount, int channelCount,
+                       const uint8_t indices[16], const float* indexWeights, float e0[4], float e1[4])
+{
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    float ax[4] = {}, bx[4] = {};
+
+    for (int i = 0; i < texelCount; i++)
+    {
+        int   t     = texels[i];
+        float beta  = indexWeights[indices[t]];
+        float alpha = 1.0f - beta;
+        aa += alpha * alpha;
+        ab += alpha * beta;
+        bb += beta * beta;
+        for (int c = 0; c < channelCount; c++)
+        {
+            ax[c] += alpha * block.Texels[t][c];
+            bx[c] += beta * block.Texels[t][c];
+        }
+    }
+
+    float det = aa * bb - ab * ab;
+    if (fabsf(det) < 1e-6f)
+        return false;
+
+    for (int c = 0; c < channelCount; c++)
+    {
+        e0[c] = Alg::Clamp((bb * ax[c] - ab * bx[c]) / det, 0.0f, 255.0f);
+        e1[c] = Alg::Clamp((aa * bx[c] - ab * ax[c]) / det, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** BC1 and BC3
+
+uint16_t bcPack565(const float color[4])
+{
+    int r = (int)(color[0] * (31.0f / 255.0f) + 0.5f);
+    int g = (int)(color[1] * (63.0f / 255.0f) + 0.5f);
+    int b = (int)(color[2] * (31.0f / 255.0f) + 0.5f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+void bcUnpack565(uint16_t packed, float color[4])
+{
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = (float)((r << 3) | (r >> 2));
+    color[1] = (float)((g << 2) | (g >> 4));
+    color[2] = (float)((b << 3) | (b >> 2));
+    color[3] = 0.0f;
+}
+
+struct BcColorResult
+{
+    uint16_t Color0, Color1;
+    uint8_t  Indices[16];
+    float    Error;
+};
+
+// Evaluates a pair of endpoints in four color mode (color0 > color1), or in three color
+// mode (color0 <= color1), which leaves the fourth index for texels outside texelMask.
+void bcEvaluateColor(const BcBlock& block, const float e0[4], const float e1[4], bool threeColor,
+                     uint32_t texelMask, BcColorResult* result)
+{
+    static const float channelWeights[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+
+    uint16_t c0 = bcPack565(e0), c1 = bcPack565(e1);
+    if (threeColor ? (c0 > c1) : (c0 < c1))
+        Alg::Swap(c0, c1);
+
+    result->Color0 = c0;
+    result->Color1 = c1;
+
+    if (c0 == c1)
+    {
+        // Every index selects color0 in either mode.
+        float palette[1][4];
+        bcUnpack565(c0, palette[0]);
+        memset(result->Indices, 0, sizeof(result->Indices));
+        uint8_t ignored[16];
+        result->Error = bcFindIndices(block, palette, 1, channelWeights, ignored, texelMask);
+        return;
+    }
+
+    float palette[4][4];
+    bcUnpack565(c0, palette[0]);
+    bcUnpack565(c1, palette[1]);
+    for (int c = 0; c < 3; c++)
+    {
+        if (threeColor)
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) * 0.5f;
+        }
+        else
+        {
+            palette[2][c] = (palette[0][c] * 2.0f + palette[1][c]) / 3.0f;
+            palette[3][c] = (palette[0][c] + palette[1][c] * 2.0f) / 3.0f;
+        }
+    }
+    palette[2][3] = palette[3][3] = 0.0f;
+
+    result->Error = bcFindIndices(block, palette, threeColor ? 3 : 4, channelWeights, result->Indices, texelMask);
+}
+
+// Encodes the color of the selected texels, and returns the 8 byte color block. In three
+// color mode, the other texels are transparent.
+void bcCompressColor(const BcBlock& block, const uint8_t* texels, int texelCount, bool threeColor, uint8_t out[8])
+{
+    // Weight of color1 for each index, in four and three color mode.
+    static const float fourColorWeights[4]  = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    static const float threeColorWeights[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+    uint32_t texelMask = 0;
+    for (int i = 0; i < texelCount; i++)
+        texelMask |= 1u << texels[i];
+
+    BcColorResult best;
+    best.Color0 = best.Color1 = 0;
+    memset(best.Indices, 0, sizeof(best.Indices));
+    best.Error = FLT_MAX;
+
+    if (texelCount > 0)
+    {
+        float e0[4], e1[4];
+        bcFitEndpoints(block, texels, texelCount, 3, threeColor ? 0.0f : 1.0f / 16.0f, e0, e1);
+        bcEvaluateColor(block, e0, e1, threeColor, texelMask, &best);
+
+        for (int iteration = 0; iteration < kBcRefineIterations; iteration++)
+        {
+            if (!bcRefineEndpoints(block, texels, texelCount, 3, best.Indices,
+                                   threeColor ? threeColorWeights : fourColorWeights, e0, e1))
+                break;
+
+            BcColorResult refined;
+            bcEvaluateColor(block, e0, e1, threeColor, texelMask, &refined);
+            if (refined.Error >= best.Error)
+                break;
+            best = refined;
+        }
+    }
+
+    uint32_t bits = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        uint32_t index = (texelMask & (1u << i)) ? best.Indices[i] : 3;
+        bits |= index << (i * 2);
+    }
+
+    out[0] = (uint8_t)(best.Color0 & 0xff);
+    out[1] = (uint8_t)(best.Color0 >> 8);
+    out[2] = (uint8_t)(best.Color1 & 0xff);
+    out[3] = (uint8_t)(best.Color1 >> 8);
+    out[4] = (uint8_t)(bits & 0xff);
+    out[5] = (uint8_t)((bits >> 8) & 0xff);
+    out[6] = (uint8_t)((bits >> 16) & 0xff);
+    out[7] = (uint8_t)(bits >> 24);
+}
+
+void bcCompressBC1(const BcBlock& block, uint8_t out[8])
+{
+    // Texels with alpha below one half are made transparent with three color mode.
+    uint8_t texels[16];
+    int     opaqueCount = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        if (block.Texels[i][3] >= 128.0f)
+            texels[opaqueCount++] = (uint8_t)i;
+    }
+
+    bcCompressColor(block, texels, opaqueCount, (opaqueCount < 16), out);
+}
+
+void bcCompressAlpha(const BcBlock& block, uint8_t out[8])
+{
+    static const float channelWeights[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    float minAlpha = 255.0f, maxAlpha = 0.0f;
+    for (int i = 0; i < 16; i++)
+    {
+        minAlpha = Alg::Min(minAlpha, block.Texels[i][3]);
+        maxAlpha = Alg::Max(maxAlpha, block.Texels[i][3]);
+    }
+
+    int     a0 = (int)maxAlpha, a1 = (int)minAlpha;
+    uint8_t indices[16] = {};
+
+    // With alpha0 > alpha1, the indices select alpha0, alpha1 and six values in between.
+    if (a0 > a1)
+    {
+        float palette[8][4] = {};
+        palette[0][3] = (float)a0;
+        palette[1][3] = (float)a1;
+        for (int k = 2; k < 8; k++)
+            palette[k][3] = (float)(((8 - k) * a0 + (k - 1) * a1) / 7);
+        bcFindIndices(block, palette, 8, channelWeights, indices);
+    }
+
+    out[0] = (uint8_t)a0;
+    out[1] = (uint8_t)a1;
+    uint64_t bits = 0;
+    for (int i = 0; i < 16; i++)
+        bits |= (uint64_t)indices[i] << (i * 3);
+    for (int i = 0; i < 6; i++)
+        out[2 + i] = (uint8_t)(bits >> (i * 8));
+}
+
+void bcCompressBC3(const BcBlock& block, uint8_t out[16])
+{
+    static const uint8_t allTexels[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+    bcCompressAlpha(block, out);
+    bcCompressColor(block, allTexels, 16, false, out + 8);
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** BC7
+
+// BC7 is encoded with two of its eight modes. Mode 6 is a single subset with 7 bit RGBA
+// endpoints, a p-bit per endpoint and 4 bit indices, which suits opaque texels and alpha
+// that follows the color. Mode 5 interpolates color and alpha with separate 2 bit indices,
+// which blocks with independent alpha (cutouts, decals) need.
+
+struct Bc7Result
+{
+    int     Endpoints[2][4];    // 7 bit values.
+    int     PBits[2];
+    uint8_t Indices[16];
+    float   Error;
+};
+
+void bc7Evaluate(const BcBlock& block, const float e0[4], const float e1[4], bool opaque, Bc7Result* best)
+{
+    static const float channelWeights[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+    // Each endpoint uses the p-bit that rounds it best, tried in all four combinations.
+    // Opaque blocks keep both p-bits set, as only those reproduce an alpha of 255 exactly.
+    for (int p = opaque ? 3 : 0; p < 4; p++)
+    {
+        Bc7Result candidate;
+        candidate.PBits[0] = p & 1;
+        candidate.PBits[1] = p >> 1;
+
+        float palette[16][4];
+        int   v0[4], v1[4];
+        for (int c = 0; c < 4; c++)
+        {
+            candidate.Endpoints[0][c] = Alg::Clamp((int)((e0[c] - candidate.PBits[0]) * 0.5f + 0.5f), 0, 127);
+            candidate.Endpoints[1][c] = Alg::Clamp((int)((e1[c] - candidate.PBits[1]) * 0.5f + 0.5f), 0, 127);
+            v0[c] = candidate.Endpoints[0][c] * 2 + candidate.PBits[0];
+            v1[c] = candidate.Endpoints[1][c] * 2 + candidate.PBits[1];
+        }
+        for (int k = 0; k < 16; k++)
+        {
+            for (int c = 0; c < 4; c++)
+                palette[k][c] = (float)(((64 - kBc7Weights4[k]) * v0[c] + kBc7Weights4[k] * v1[c] + 32) >> 6);
+        }
+
+        candidate.Error = bcFindIndices(block, palette, 16, channelWeights, candidate.Indices);
+        if (candidate.Error < best->Error)
+            *best = candidate;
+    }
+}
+
+struct Bc7Mode5Result
+{
+    int     Color[2][3];        // 7 bit values.
+    int     Alpha[2];
+    uint8_t ColorIndices[16];
+    uint8_t AlphaIndices[16];
+    float   Error;
+};
+
+void bc7EvaluateMode5(const BcBlock& block, const float e0[4], const float e1[4], Bc7Mode5Result* best)
+{
+    static const float colorWeights[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+    static const float alphaWeights[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    Bc7Mode5Result candidate;
+    float          colorPalette[4][4], alphaPalette[4][4];
+    int            v0[4], v1[4];
+    for (int c = 0; c < 3; c++)
+    {
+        candidate.Color[0][c] = Alg::Clamp((int)(e0[c] * (127.0f / 255.0f) + 0.5f), 0, 127);
+        candidate.Color[1][c] = Alg::Clamp((int)(e1[c] * (127.0f / 255.0f) + 0.5f), 0, 127);
+        v0[c] = (candidate.Color[0][c] << 1) | (candidate.Color[0][c] >> 6);
+        v1[c] = (candidate.Color[1][c] << 1) | (candidate.Color[1][c] >> 6);
+    }
+    candidate.Alpha[0] = v0[3] = Alg::Clamp((int)(e0[3] + 0.5f), 0, 255);
+    candidate.Alpha[1] = v1[3] = Alg::Clamp((int)(e1[3] + 0.5f), 0, 255);
+
+    for (int k = 0; k < 4; k++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            float value = (float)(((64 - kBc7Weights2[k]) * v0[c] + kBc7Weights2[k] * v1[c] + 32) >> 6);
+            colorPalette[k][c] = (c < 3) ? value : 0.0f;
+            alphaPalette[k][c] = (c < 3) ? 0.0f : value;
+        }
+    }
+
+    candidate.Error = bcFindIndices(block, colorPalette, 4, colorWeights, candidate.ColorIndices) +
+                      bcFindIndices(block, alphaPalette, 4, alphaWeights, candidate.AlphaIndices);
+    if (candidate.Error < best->Error)
+        *best = candidate;
+}
+
+struct Bc7BitWriter
+{
+    uint8_t* Out;
+    int      BitPosition;
+
+    void Write(uint32_t value, int bitCount)
+    {
+        for (int i = 0; i < bitCount; i++, BitPosition++)
+        {
+            if (value & (1u << i))
+                Out[BitPosition >> 3] |= (uint8_t)(1u << (BitPosition & 7));
+        }
+    }
+};
+
+void bcCompressBC7(const BcBlock& block, uint8_t out[16])
+{
+    static const uint8_t allTexels[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+    float alphaMin = 255.0f, alphaMax = 0.0f;
+    for (int i = 0; i < 16; i++)
+    {
+        alphaMin = Alg::Min(alphaMin, block.Channels[3][i]);
+        alphaMax = Alg::Max(alphaMax, block.Channels[3][i]);
+    }
+    bool opaque = (alphaMin == 255.0f);
+
+    float indexWeights[16];
+    for (int k = 0; k < 16; k++)
+        indexWeights[k] = kBc7Weights4[k] / 64.0f;
+
+    Bc7Result best;
+    best.Error = FLT_MAX;
+
+    float e0[4], e1[4];
+    bcFitEndpoints(block, allTexels, 16, 4, 0.0f, e0, e1);
+    bc7Evaluate(block, e0, e1, opaque, &best);
+
+    for (int iteration = 0; iteration < kBcRefineIterations; iteration++)
+    {
+        float previousError = best.Error;
+        if (!bcRefineEndpoints(block, allTexels, 16, 4, best.Indices, indexWeights, e0, e1))
+            break;
+        bc7Evaluate(block, e0, e1, opaque, &best);
+        if (best.Error >= previousError)
+            break;
+    }
+
+    // Mode 5 fits color on its own line, and alpha between its extremes.
+    Bc7Mode5Result best5;
+    best5.Error = FLT_MAX;
+    if (alphaMin != alphaMax)
+    {
+        float colorWeights[4];
+        for (int k = 0; k < 4; k++)
+            colorWeights[k] = kBc7Weights2[k] / 64.0f;
+
+        bcFitEndpoints(block, allTexels, 16, 3, 0.0f, e0, e1);
+        e0[3] = alphaMin;
+        e1[3] = alphaMax;
+        bc7EvaluateMode5(block, e0, e1, &best5);
+
+        for (int iteration = 0; iteration < kBcRefineIterations; iteration++)
+        {
+            float previousError = best5.Error;
+            if (!bcRefineEndpoints(block, allTexels, 16, 3, best5.ColorIndices, colorWeights, e0, e1))
+                break;
+            bc7EvaluateMode5(block, e0, e1, &best5);
+            if (best5.Error >= previousError)
+                break;
+        }
+    }
+
+    memset(out, 0, 16);
+    Bc7BitWriter writer = { out, 0 };
+
+    if (best5.Error < best.Error)
+    {
+        // The top bit of the first index of each set is implied zero, which swapping
+        // that set's endpoints ensures.
+        if (best5.ColorIndices[0] & 2)
+        {
+            for (int c = 0; c < 3; c++)
+                Alg::Swap(best5.Color[0][c], best5.Color[1][c]);
+            for (int i = 0; i < 16; i++)
+                best5.ColorIndices[i] = (uint8_t)(3 - best5.ColorIndices[i]);
+        }
+        if (best5.AlphaIndices[0] & 2)
+        {
+            Alg::Swap(best5.Alpha[0], best5.Alpha[1]);
+            for (int i = 0; i < 16; i++)
+                best5.AlphaIndices[i] = (uint8_t)(3 - best5.AlphaIndices[i]);
+        }
+
+        writer.Write(1 << 5, 6);    // Mode 5.
+        writer.Write(0, 2);         // No channel rotation.
+        for (int c = 0; c < 3; c++)
+        {
+            writer.Write(best5.Color[0][c], 7);
+            writer.Write(best5.Color[1][c], 7);
+        }
+        writer.Write(best5.Alpha[0], 8);
+        writer.Write(best5.Alpha[1], 8);
+        writer.Write(best5.ColorIndices[0], 1);
+        for (int i = 1; i < 16; i++)
+            writer.Write(best5.ColorIndices[i], 2);
+        writer.Write(best5.AlphaIndices[0], 1);
+        for (int i = 1; i < 16; i++)
+            writer.Write(best5.AlphaIndices[i], 2);
+        return;
+    }
+
+    // The top bit of the first index is implied zero, which swapping the endpoints ensures.
+    if (best.Indices[0] & 8)
+    {
+        for (int c = 0; c < 4; c++)
+            Alg::Swap(best.Endpoints[0][c], best.Endpoints[1][c]);
+        Alg::Swap(best.PBits[0], best.PBits[1]);
+        for (int i = 0; i < 16; i++)
+            best.Indices[i] = (uint8_t)(15 - best.Indices[i]);
+    }
+
+    writer.Write(1 << 6, 7);    // Mode 6.
+    for (int c = 0; c < 4; c++)
+    {
+        writer.Write(best.Endpoints[0][c], 7);
+        writer.Write(best.Endpoints[1][c], 7);
+    }
+    writer.Write(best.PBits[0], 1);
+    writer.Write(best.PBits[1], 1);
+    writer.Write(best.Indices[0], 3);
+    for (int i = 1; i < 16; i++)
+        writer.Write(best.Indices[i], 4);
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------------
+// ***** Block compression
+
+bool CompressTextureBlocks(int format, const uint8_t* rgba, int w, int h, uint8_t* outBlocks)
+{
+    int blockSize;
+    switch (format & Texture_TypeMask)
+    {
+    case Texture_BC1: blockSize = 8;  break;
+    case Texture_BC3: blockSize = 16; break;
+    case Texture_BC7: blockSize = 16; break;
+    default:
+        return false;
+    }
+
+    int blocksWide = (w + 3) / 4;
+    int blocksHigh = (h + 3) / 4;
+
+    auto compressRows = [&](int rowBegin, int rowEnd)
+    {
+        for (int by = rowBegin; by < rowEnd; by++)
+        {
+            uint8_t* out = outBlocks + (size_t)by * blocksWide * blockSize;
+            for (int bx = 0; bx < blocksWide; bx++, out += blockSize)
+            {
+                BcBlock block;
+                bcLoadBlock(rgba, w, h, bx, by, &block);
+                switch (format & Texture_TypeMask)
+                {
+                case Texture_BC1: bcCompressBC1(block, out); break;
+                case Texture_BC3: bcCompressBC3(block, out); break;
+                default:          bcCompressBC7(block, out); break;
+                }
+            }
+        }
+    };
+
+    if (blocksWide * blocksHigh >= kBcParallelBlocks)
+    {
+        int rowsPerJob = (blocksWide < kBcBlocksPerJob) ? (kBcBlocksPerJob / blocksWide) : 1;
+        Util::JobSystem::GetInstance()->ParallelFor(0, blocksHigh, rowsPerJob, compressRows);
+    }
+    else
+    {
+        compressRows(0, blocksHigh);
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------------
+// ***** Cooking
+
+std::string GetCookedTexturePath(const char* sourcePath)
+{
+    std::string path(sourcePath);
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+        path.resize(dot);
+    return path + ".cooked.dds";
+}
+
+bool CookTextureTga(const char* tgaPath, const char* ddsPath, const TextureCookDesc& desc)
+{
+    SysFile tgaFile(tgaPath);
+    int     fileSize = tgaFile.IsValid() ? tgaFile.GetLength() : 0;
+    if (fileSize <= 0)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> fileData(fileSize);
+    if (tgaFile.Read(&fileData[0], fileSize) != fileSize)
+    {
+        return false;
+    }
+    tgaFile.Close();
+
+    TgaHeader header;
+    if (!ReadTgaHeader(&fileData[0], fileData.size(), &header))
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> pixels((size_t)header.Width * header.Height * 4);
+    if (!DecodeTgaPixels(&fileData[0], fileData.size(), header, 255, desc.PremultiplyAlpha, false, &pixels[0]))
+    {
+        return false;
+    }
+
+    bool opaque = true;
+    for (size_t i = 3; i < pixels.size() && opaque; i += 4)
+        opaque = (pixels[i] == 255);
+
+    MipChainDesc mipDesc;
+    mipDesc.Filter              = desc.MipFilter;
+    mipDesc.SRGB                = desc.SRGB;
+    mipDesc.AlphaCoverageCutoff = desc.AlphaCoverageCutoff;
+    MipChain mips;
+    mips.Build(&pixels[0], header.Width, header.Height, mipDesc);
+
+    size_t dataSize = 0;
+    for (int level = 0; level < mips.GetLevelCount(); level++)
+        dataSize += GetTextureSize(desc.Format, mips.GetLevelWidth(level), mips.GetLevelHeight(level));
+
+    std::vector<uint8_t> data(dataSize);
+    uint8_t*             out = &data[0];
+    for (int level = 0; level < mips.GetLevelCount(); level++)
+    {
+        int w = mips.GetLevelWidth(level), h = mips.GetLevelHeight(level);
+        if (!CompressTextureBlocks(desc.Format, mips.GetLevelData(level), w, h, out))
+        {
+            return false;
+        }
+        out += GetTextureSize(desc.Format, w, h);
+    }
+
+    DdsAlphaMode alphaMode = opaque ? DdsAlpha_Opaque : (desc.PremultiplyAlpha ? DdsAlpha_Premultiplied : DdsAlpha_Straight);
+
+    // Create alone appends to a file cooked earlier.
+    SysFile ddsFile;
+    if (!ddsFile.Open(ddsPath, File::Open_Write | File::Open_Create | File::Open_Truncate, File::Mode_Write))
+    {
+        return false;
+    }
+    bool saved = SaveTextureDDS(&ddsFile, desc.Format | (desc.SRGB ? Texture_SRGB : 0), header.Width, header.Height,
+                                mips.GetLevelCount(), &data[0], alphaMode);
+    return ddsFile.Close() && saved;
+}
+
+int CookTexturesTga(const std::vector<std::string>& tgaPaths, const TextureCookDesc& desc,
+                    std::vector<std::string>* outFailedPaths)
+{
+    Util::JobSystem* jobs = Util::JobSystem::GetInstance();
+
+    // Files are cooked in parallel, and the blocks of each level in parallel again.
+    std::vector<char>  cooked(tgaPaths.size(), 0);
+    Util::JobCounter   done;
+    for (size_t i = 0; i < tgaPaths.size(); i++)
+    {
+        jobs->Run([&, i]
+        {
+            cooked[i] = CookTextureTga(tgaPaths[i].c_str(), GetCookedTexturePath(tgaPaths[i].c_str()).c_str(), desc);
+        }, &done);
+    }
+    jobs->Wait(&done);
+
+    int failedCount = 0;
+    for (size_t i = 0; i < tgaPaths.size(); i++)
+    {
+        if (!cooked[i])
+        {
+            failedCount++;
+            if (outFailedPaths)
+                outFailedPaths->push_back(tgaPaths[i]);
+        }
+    }
+    return failedCount;
+}
+
+}} // namespace OVR::Render
@@ -46,7 +46,8 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
                           std::vector<Ptr<CollisionModel> >* pCollisions,
                           std::vector<Ptr<CollisionModel> >* pGroundCollisions,
                           bool srgbAware /*= false*/,
-                          bool anisotropic /*= false*/)
+                          bool anisotropic /*= false*/,
+                          bool preferCooked /*= false*/)
 {
     if(pXmlDocument->LoadFile(fileName) != 0)
     {
@@ -95,6 +96,7 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
         int textureLoadFlags = 0;
         textureLoadFlags |= srgbAware ? TextureLoad_SrgbAware : 0;
         textureLoadFlags |= anisotropic ? TextureLoad_Anisotropic : 0;
+        textureLoadFlags |= preferCooked ? TextureLoad_PreferCooked : 0;
 
         SysFile* pFile = new SysFile(fname);
 		Ptr<Texture> texture;
@@ -262,25 +264,16 @@ bool XmlHandler::ReadFile(const char* fileName, OVR::Render::RenderDevice* pRend
         const char* indexStr = pXmlModel->FirstChildElement("indices")->
                                           FirstChild()->ToText()->Value();
         
-        size_t stringLength = strlen(indexStr);
-
-        for(size_t j = 0; j < stringLength; )
+        for(const char* p = indexStr; *p; )
         {
-            size_t k = j + 1;
-            for(; k < stringLength; ++k)
-            {
-                if (indexStr[k] == ' ')
-                    break;                
-            }
-            char text[20];
-            for(size_t l = 0; l < k - j; ++l)
-            {
-                text[l] = indexStr[j + l];
-            }
-            text[k - j] = '\0';
-
-            Models[i]->Indices.push_back((unsigned short)atoi(text));
-            j = k + 1;
+            char* end;
+            Models[i]->Indices.push_back((unsigned short)OVR_strtol(p, &end, 10));
+
+            // Skip the rest of the space separated token, and the space.
+            for(p = (end > p) ? end : (p + 1); *p && (*p != ' '); ++p)
+                ;
+            if (*p)
+                ++p;
         }
 
         // Reverse index order to match original expected orientation
@@ -392,27 +385,14 @@ void XmlHandler::ParseVectorString(const char* str, std::vector<OVR::Vector3f> *
 	                               bool is2element)
 {
     size_t stride = is2element ? 2 : 3;
-    size_t stringLength = strlen(str);
     size_t element = 0;
     float v[3];
 
-    for(size_t j = 0; j < stringLength;)
+    for(const char* p = str; *p; )
     {
-        size_t k = j + 1;
-        for(; k < stringLength; ++k)
-        {
-            if(str[k] == ' ')
-            {
-                break;
-            }
-        }
-        char text[20];
-        for(size_t l = 0; l < k - j; ++l)
-        {
-            text[l] = str[j + l];
-        }
-        text[k - j] = '\0';
-        v[element] = (float)atof(text);
+        // Parse in place; OVR_strtod doesn't depend on the locale like atof does.
+        char* end;
+        v[element] = (float)OVR_strtod(p, &end);
 
         if(element == (stride - 1))
         {
@@ -424,7 +404,12 @@ void XmlHandler::ParseVectorString(const char* str, std::vector<OVR::Vector3f> *
             array->push_back(vect);
         }
 
-        j = k + 1;
+        // Skip the rest of the space separated token, and the space.
+        for(p = (end > p) ? end : (p + 1); *p && (*p != ' '); ++p)
+            ;
+        if (*p)
+            ++p;
+
         element = (element + 1) % stride;
     }
 }
@@ -47,7 +47,8 @@ public:
                   std::vector<Ptr<CollisionModel> >* pCollisions,
                   std::vector<Ptr<CollisionModel> >* pGroundCollisions,
                   bool srgbAware = false,
-                  bool anisotropic = false);
+                  bool anisotropic = false,
+                  bool preferCooked = false);
 
 protected:
     void ParseVectorString(const char* str, std::vector<OVR::Vector3f> *array,
@@ -44,6 +44,7 @@ private:
     XMVECTOR mObjPosition[Scene::MAX_MODELS];                               // Objects cached position 
     XMVECTOR mObjVelocity[Scene::MAX_MODELS];                               // Objects velocity
     Scene mDynamicScene;                                                    // Scene graph
+    ovrBoundaryField mBoundaryField = {};                                   // Local copy of the outer boundary
 
     ovrSession mSession = nullptr;
     high_resolution_clock mLastUpdateClock;                                 // Stores last update time
@@ -186,6 +187,7 @@ void GuardianSystemDemo::Start(HINSTANCE hinst)
         Render();
     }
 
+    ovr_ReleaseBoundaryField(&mBoundaryField);
     ovr_Shutdown();
 }
 
@@ -233,26 +235,32 @@ void GuardianSystemDemo::UpdateObjectsCollisionWithBoundary(float elapsedTimeSec
 {
     if (mGlobalTimeSec < 1.0f) return; // Start update after 1s
 
+    // Copy the boundary locally once, so that all the objects are tested without calling the runtime
+    ovr_UpdateBoundaryField(mSession, ovrBoundary_Outer, &mBoundaryField);
+
+    XMFLOAT3 newPosition[Scene::MAX_MODELS];
     for (int32_t i = 0; i < mDynamicScene.numModels; ++i) {
-        XMFLOAT3 newPosition;
-        XMVECTOR newPositionVec = XMVectorAdd(mObjPosition[i], XMVectorScale(mObjVelocity[i], elapsedTimeSec));
-        XMStoreFloat3(&newPosition, newPositionVec);
+        XMStoreFloat3(&newPosition[i], XMVectorAdd(mObjPosition[i], XMVectorScale(mObjVelocity[i], elapsedTimeSec)));
+    }
 
-        // Test object collision with boundary
-        ovrBoundaryTestResult test;
-        ovr_TestBoundaryPoint(mSession, (ovrVector3f*)&newPosition.x, ovrBoundary_Outer, &test);
+    // Test object collisions with boundary
+    ovrBoundaryTestResult test[Scene::MAX_MODELS];
+    ovr_TestBoundaryFieldPoints(&mBoundaryField, (ovrVector3f*)newPosition, mDynamicScene.numModels, test, nullptr);
+
+    for (int32_t i = 0; i < mDynamicScene.numModels; ++i) {
+        XMVECTOR newPositionVec = XMLoadFloat3(&newPosition[i]);
 
         // Collides with surface at 2cm
-        if (test.ClosestDistance < 0.02f) {
-            XMVECTOR surfaceNormal = XMVectorSet(test.ClosestPointNormal.x, test.ClosestPointNormal.y, test.ClosestPointNormal.z, 0.0f);
+        if (test[i].ClosestDistance < 0.02f) {
+            XMVECTOR surfaceNormal = XMVectorSet(test[i].ClosestPointNormal.x, test[i].ClosestPointNormal.y, test[i].ClosestPointNormal.z, 0.0f);
             mObjVelocity[i] = XMVector3Reflect(mObjVelocity[i], surfaceNormal);
 
             newPositionVec = XMVectorAdd(mObjPosition[i], XMVectorScale(mObjVelocity[i], elapsedTimeSec));
-            XMStoreFloat3(&newPosition, newPositionVec);
+            XMStoreFloat3(&newPosition[i], newPositionVec);
         }
 
         mObjPosition[i] = newPositionVec;
-        mDynamicScene.Models[i]->Pos = newPosition;
+        mDynamicScene.Models[i]->Pos = newPosition[i];
     }
 }
 
@@ -79,6 +79,8 @@ const bool OculusWorldDemoApp::UseDepth[OculusWorldDemoApp::Rendertarget_LAST] =
     false, //Rendertarget_Menu
 };
 
+const double OculusWorldDemoApp::PropertyRefreshInterval = 1.0;
+
 //-------------------------------------------------------------------------------------
 // ***** OculusWorldDemoApp
 
@@ -135,6 +137,8 @@ OculusWorldDemoApp::OculusWorldDemoApp() :
 
     Recording(false),
     Replaying(false),
+    ClientReplaying(false),
+    ClientRecording(false),
     LastSyncTime(0.0),
 
     LastControllerState(),
@@ -180,6 +184,7 @@ OculusWorldDemoApp::OculusWorldDemoApp() :
     InterAxialDistance(0.0f),
     MonoscopicRenderMode(Mono_Off),
     PositionTrackingScale(1.0f),
+    WorldOffsetKm(0.0f),
     ScaleAffectsEyeHeight(false),
     DesiredPixelDensity(1.0f),
     AdaptivePixelDensity(1.0f),
@@ -245,6 +250,7 @@ OculusWorldDemoApp::OculusWorldDemoApp() :
     MultisampleEnabled(true),
     SrgbRequested(true),
     AnisotropicSample(true),
+    PreferCookedTextures(true),
     SceneBrightnessGrayscale(true),
     SceneBrightness(255.0f),
     SceneBlack(false),
@@ -444,6 +450,13 @@ void OculusWorldDemoApp::DestroyRendering()
         pPlatform->DestroyGraphics();
         pRender = nullptr;
 
+        // The property handles are freed along with the session.
+        InterAxialDistanceProperty = nullptr;
+        TrackingTrackerCountProperty = nullptr;
+        NeckToEyeDistanceProperty = nullptr;
+        DK2LatencyProperty = nullptr;
+        LivePropertyCount = 0;
+
         ovr_Destroy(Session);
         Session = nullptr;
     }
@@ -460,6 +473,56 @@ static void OVR_CDECL LogCallback(uintptr_t /*userData*/, int /*level*/, const c
     WriteLog(message);
 }
 
+// Handles "-cook [options] file.tga ...", which converts TGA files to the cooked DDS files that
+// are loaded in their place when "Prefer Cooked Textures" is on. Returns the number of failures.
+//     -bc1, -bc3, -bc7    Block compression format. The default is BC7.
+//     -linear             The files aren't sRGB encoded.
+//     -premultiply        Premultiply alpha, as the Oculus cube and cockpit textures are loaded.
+//     -kaiser, -lanczos   Mip filter. The default is a box filter.
+//     -alphacoverage x    Preserve alpha-tested coverage at cutoff x in the mips.
+static int CookTexturesFromCommandLine(int argc, const char** argv)
+{
+    TextureCookDesc          desc;
+    std::vector<std::string> files;
+
+    for (int i = 0; i < argc; i++)
+    {
+        if (!OVR_stricmp(argv[i], "-bc1"))
+            desc.Format = Texture_BC1;
+        else if (!OVR_stricmp(argv[i], "-bc3"))
+            desc.Format = Texture_BC3;
+        else if (!OVR_stricmp(argv[i], "-bc7"))
+            desc.Format = Texture_BC7;
+        else if (!OVR_stricmp(argv[i], "-linear"))
+            desc.SRGB = false;
+        else if (!OVR_stricmp(argv[i], "-premultiply"))
+            desc.PremultiplyAlpha = true;
+        else if (!OVR_stricmp(argv[i], "-kaiser"))
+            desc.MipFilter = MipFilter_Kaiser;
+        else if (!OVR_stricmp(argv[i], "-lanczos"))
+            desc.MipFilter = MipFilter_Lanczos;
+        else if (!OVR_stricmp(argv[i], "-alphacoverage") && (i + 1 < argc))
+            desc.AlphaCoverageCutoff = (float)atof(argv[++i]);
+        else
+        {
+            // Quoted paths keep their quotes in the argument list.
+            std::string file(argv[i]);
+            file.erase(std::remove(file.begin(), file.end(), '"'), file.end());
+            files.push_back(file);
+        }
+    }
+
+    std::vector<std::string> failed;
+    int failedCount = CookTexturesTga(files, desc, &failed);
+    for (size_t i = 0; i < failed.size(); i++)
+    {
+        WriteLog("[OculusWorldDemoApp] Failed to cook %s", failed[i].c_str());
+    }
+    WriteLog("[OculusWorldDemoApp] Cooked %d of %d textures", (int)files.size() - failedCount, (int)files.size());
+
+    return failedCount;
+}
+
 
 // Return 0 upon success, else non-zero.
 int OculusWorldDemoApp::OnStartup(int argc, const char** argv)
@@ -494,6 +557,13 @@ int OculusWorldDemoApp::OnStartup(int argc, const char** argv)
             InteractiveMode = false;
         }
 
+        if (!OVR_stricmp(argStr, "cook"))
+        {
+            // Cooking runs without LibOVR, and exits once done.
+            pPlatform->Exit(CookTexturesFromCommandLine(argc - i - 1, argv + i + 1));
+            return 0;
+        }
+
         if (!OVR_stricmp(argStr, "replay"))
         {
             if ( i <= argc - 1 ) // next arg is the filename
@@ -544,6 +614,20 @@ int OculusWorldDemoApp::InitializeRendering(bool firstTime)
 
     HmdDisplayAcquired = true;
 
+    ovr_GetPropertyHandle(Session, "server:InterAxialDistance", ovrPropertyType_Float, -1.0, &InterAxialDistanceProperty);
+    ovr_GetPropertyHandle(Session, "TrackingTrackerCountForHmd", ovrPropertyType_Int, 0, &TrackingTrackerCountProperty);
+    ovr_GetPropertyHandle(Session, OVR_KEY_NECK_TO_EYE_DISTANCE, ovrPropertyType_FloatArray, 0, &NeckToEyeDistanceProperty);
+    ovr_GetPropertyHandle(Session, "DK2Latency", ovrPropertyType_FloatArray, 0, &DK2LatencyProperty);
+    LastPropertyRefreshTime = ovr_GetTimeInSeconds();
+
+    const ovrPropertyHandle liveProperties[] = { InterAxialDistanceProperty, TrackingTrackerCountProperty, DK2LatencyProperty };
+    LivePropertyCount = 0;
+    for (size_t i = 0; i < OVR_ARRAY_COUNT(liveProperties); ++i)
+    {
+        if (liveProperties[i])
+            LiveProperties[LivePropertyCount++] = liveProperties[i];
+    }
+
 
     // Did we end up with a debug HMD?
     HmdDesc = ovr_GetHmdDesc(Session);
@@ -879,7 +963,11 @@ void OculusWorldDemoApp::PopulateOptionMenu()
                  AddEnumValue("16-pixel RT-centered",Grid_Rendertarget16).
                  AddEnumValue("Lens-centered grid",  Grid_Lens);
 
+    Menu.AddFloat("Scene Content.World Offset", &WorldOffsetKm, 0.0f, 100000.0f, 1000.0f, "%.0f km").
+                                                SetNotify(this, &OWD::WorldOffsetChange);
+
     Menu.AddBool("Scene Content.Anisotropic Sampling", &AnisotropicSample).SetNotify(this, &OWD::ForceAssetReloading); // same sRGB function works fine
+    Menu.AddBool("Scene Content.Prefer Cooked Textures", &PreferCookedTextures).SetNotify(this, &OWD::ForceAssetReloading);
 
     Menu.AddBool("Scene Content.Tint.Grayscale Tint", &SceneBrightnessGrayscale);
     Menu.AddFloat("Scene Content.Tint.R (Full=255)", &SceneBrightness.x, 0.0f, 1000.0f, 0.5f, "%.1f");
@@ -1671,6 +1759,19 @@ void OculusWorldDemoApp::OnKey(OVR::KeyCode key, int chr, bool down, int modifie
                 ovr_SetBool(Session, "server:RecordingWithImagesEnabled", Recording);
             }
         }
+        else if (!down && (modifiers == Mod_Shift))
+        {
+            // Shift+F2 records the tracking and input the app receives, rather than the runtime's sensor data.
+            if (ClientRecording)
+            {
+                ovr_StopCallRecording();
+                ClientRecording = false;
+            }
+            else
+            {
+                ClientRecording = OVR_SUCCESS(ovr_StartCallRecording("OculusWorldDemo.ovrcalls"));
+            }
+        }
         break;
 
     case Key_F3:
@@ -1679,6 +1780,19 @@ void OculusWorldDemoApp::OnKey(OVR::KeyCode key, int chr, bool down, int modifie
             Replaying = !Replaying;
             ovr_SetBool(Session, "server:ReplayEnabled", Replaying);
         }
+        else if (!down && (modifiers == Mod_Shift))
+        {
+            if (ClientReplaying)
+            {
+                ovr_StopCallReplay();
+                Timer::SetVirtualSeconds(0.0, false);
+                ClientReplaying = false;
+            }
+            else
+            {
+                ClientReplaying = OVR_SUCCESS(ovr_StartCallReplay("OculusWorldDemo.ovrcalls", OnCallReplayTime, 0));
+            }
+        }
         break;
 
     case Key_Q:
@@ -1764,18 +1878,27 @@ void OculusWorldDemoApp::OnKey(OVR::KeyCode key, int chr, bool down, int modifie
 //-----------------------------------------------------------------------------
 
 
-Matrix4f OculusWorldDemoApp::CalculateViewFromPose(const Posef& pose)
+Posef OculusWorldDemoApp::CalculateWorldFromEye(const Posef& pose)
 {
     Posef worldPose = ThePlayer.VirtualWorldTransformfromRealPose(pose, TrackingOriginType);
 
-    // Rotate and position View Camera
-    Vector3f up      = worldPose.Rotation.Rotate(UpVector);
-    Vector3f forward = worldPose.Rotation.Rotate(ForwardVector);
-
     // Transform the position of the center eye in the real world (i.e. sitting in your chair)
     // into the frame of the player's virtual body.
 
-    Vector3f viewPos = ForceZeroHeadMovement ? ThePlayer.GetBodyPos(TrackingOriginType) : worldPose.Translation;
+    if (ForceZeroHeadMovement)
+        worldPose.Translation = ThePlayer.GetBodyPos(TrackingOriginType);
+
+    return worldPose;
+}
+
+Matrix4f OculusWorldDemoApp::CalculateViewFromPose(const Posef& pose)
+{
+    Posef worldPose = CalculateWorldFromEye(pose);
+
+    // Rotate and position View Camera
+    Vector3f up      = worldPose.Rotation.Rotate(UpVector);
+    Vector3f forward = worldPose.Rotation.Rotate(ForwardVector);
+    Vector3f viewPos = worldPose.Translation;
 
     Matrix4f view = Matrix4f::LookAtRH(viewPos, viewPos + forward, up);
     return view;
@@ -2046,6 +2169,11 @@ void OculusWorldDemoApp::HandleHaptics()
     }
 }
 
+void OVR_CDECL OculusWorldDemoApp::OnCallReplayTime(uintptr_t /*userData*/, double timeInSeconds)
+{
+    Timer::SetVirtualSeconds(timeInSeconds);
+}
+
 void OculusWorldDemoApp::OnIdle()
 {
     // Check to see if we are being asked to quit.
@@ -2063,6 +2191,13 @@ void OculusWorldDemoApp::OnIdle()
         ResetHmdPose();
     }
 
+    // Client replay stops by itself at the end of the recording.
+    if (ClientReplaying && !ovr_IsCallReplayActive())
+    {
+        Timer::SetVirtualSeconds(0.0, false);
+        ClientReplaying = false;
+    }
+
     if (!HmdDisplayAcquired)
     {
         InitializeRendering(false);
@@ -2109,7 +2244,18 @@ void OculusWorldDemoApp::OnIdle()
 
 
 
-    InterAxialDistance = ovr_GetFloat(Session, "server:InterAxialDistance", -1.0f );
+    if (LivePropertyCount > 0)
+    {
+        ovr_RefreshProperties(Session, LiveProperties, LivePropertyCount);
+    }
+
+    if (NeckToEyeDistanceProperty && (ovr_GetTimeInSeconds() - LastPropertyRefreshTime >= PropertyRefreshInterval))
+    {
+        ovr_RefreshProperties(Session, &NeckToEyeDistanceProperty, 1);
+        LastPropertyRefreshTime = ovr_GetTimeInSeconds();
+    }
+
+    InterAxialDistance = InterAxialDistanceProperty ? InterAxialDistanceProperty->Float : -1.0f;
 
     ovrTrackingState trackState = ovr_GetTrackingState(Session, HmdFrameTiming, ovrFalse);
     ovrTrackerPose trackerPose = ovr_GetTrackerPose(Session, 0);
@@ -2119,7 +2265,7 @@ void OculusWorldDemoApp::OnIdle()
     UpdateTrackingStateForSittingHeight(&trackState);
 
     HmdStatus = trackState.StatusFlags;
-    TrackingTrackerCount = ovr_GetInt(Session, "TrackingTrackerCountForHmd", 0);
+    TrackingTrackerCount = TrackingTrackerCountProperty ? TrackingTrackerCountProperty->Int : 0;
     ConnectedTrackerCount = ovr_GetTrackerCount(Session);
 
     memcpy(&LastInputState, &InputState, sizeof(InputState));
@@ -2478,6 +2624,8 @@ void OculusWorldDemoApp::OnIdle()
 
         ViewFromWorld[0] = CalculateViewFromPose(localEyeRenderPose[0]);
         ViewFromWorld[1] = CalculateViewFromPose(localEyeRenderPose[1]);
+        WorldFromEye[0]  = CalculateWorldFromEye(localEyeRenderPose[0]);
+        WorldFromEye[1]  = CalculateWorldFromEye(localEyeRenderPose[1]);
 
         int currDrawFlushCount = 0;
         bool secondSwapChainUsed = false;
@@ -3300,7 +3448,20 @@ void OculusWorldDemoApp::RenderEyeView(ovrEyeType eye)
     {
         if (SceneMode != Scene_OculusCubes && SceneMode != Scene_DistortTune)
         {
-            MainScene.Render(pRender, ViewFromWorld[eye]);
+            if ((WorldOffsetKm != 0.0f) && (LargeWorld.GetChildCount() > 0))
+            {
+                // The lights are placed in scene space, so they still use the scene space view.
+                MainScene.Lighting.Update(ViewFromWorld[eye], MainScene.LightPos);
+                pRender->SetLighting(&MainScene.Lighting);
+
+                Posed eyeWorldPose(WorldFromEye[eye]);
+                eyeWorldPose.Translation += LargeWorld.GetWorldPose(0).Translation;
+                LargeWorld.Render(eyeWorldPose, pRender);
+            }
+            else
+            {
+                MainScene.Render(pRender, ViewFromWorld[eye]);
+            }
 
             RenderControllers(eye);
             RenderCockpitPanels(eye);
@@ -3326,7 +3487,11 @@ void OculusWorldDemoApp::RenderEyeView(ovrEyeType eye)
 
 				// Store the neck model
 				float neckeye[2] = { OVR_DEFAULT_NECK_TO_EYE_HORIZONTAL, OVR_DEFAULT_NECK_TO_EYE_VERTICAL };
-				ovr_GetFloatArray(Session, OVR_KEY_NECK_TO_EYE_DISTANCE, neckeye, 2);
+				if (NeckToEyeDistanceProperty && (NeckToEyeDistanceProperty->FloatCount >= 2))
+				{
+					neckeye[0] = NeckToEyeDistanceProperty->FloatArray[0];
+					neckeye[1] = NeckToEyeDistanceProperty->FloatArray[1];
+				}
 				float	 neckToEyeVertical = neckeye[1];
 				float	 neckToEyeHorizontal = neckeye[0];
 				Vector3f neckModel(0.0, neckToEyeVertical, -neckToEyeHorizontal);
@@ -3579,7 +3744,10 @@ Recti OculusWorldDemoApp::RenderMenu(float textHeight)
     ortho.M[2][2] = 0;
     pRender->SetProjection(ortho);
 
+    // The menu's strings are drawn together.
+    pRender->BeginTextBatch();
     Recti rect = Menu.Render(pRender, "", textHeight, centerX, centerY);
+    pRender->EndTextBatch();
 
     // Commit changes to the menu swap chain
     DrawEyeTargets[Rendertarget_Menu]->pColorTex->Commit();
@@ -3646,6 +3814,8 @@ Recti OculusWorldDemoApp::RenderTextInfoHud(float textHeight)
     ortho.M[2][2] = 0;
     pRender->SetProjection(ortho);
 
+    pRender->BeginTextBatch();
+
     switch(TextScreen)
     {
     case Text_Info:
@@ -3667,9 +3837,9 @@ Recti OculusWorldDemoApp::RenderTextInfoHud(float textHeight)
         char latency2Text[128] = "";
         {
             static const int NUM_LATENCIES = 5;
-            float latencies[NUM_LATENCIES] = {};
-            if (ovr_GetFloatArray(Session, "DK2Latency", latencies, NUM_LATENCIES) == NUM_LATENCIES)
+            if (DK2LatencyProperty && (DK2LatencyProperty->FloatCount == NUM_LATENCIES))
             {
+                const float* latencies = DK2LatencyProperty->FloatArray;
                 bool nonZero = false;
                 char text[5][32];
                 for (int i = 0; i < NUM_LATENCIES; ++i)
@@ -3885,6 +4055,8 @@ Recti OculusWorldDemoApp::RenderTextInfoHud(float textHeight)
         break;
     }
 
+    pRender->EndTextBatch();
+
     // Commit changes to the HUD swap chain
     DrawEyeTargets[Rendertarget_Hud]->pColorTex->Commit();
 
@@ -4201,6 +4373,12 @@ void OculusWorldDemoApp::CenterPupilDepthChange(OptionVar*)
     ovr_SetFloat(Session, "CenterPupilDepth", CenterPupilDepthMeters);
 }
 
+void OculusWorldDemoApp::WorldOffsetChange(OptionVar*)
+{
+    if (LargeWorld.GetChildCount() > 0)
+        LargeWorld.SetWorldPose(0, Posed(Quatd(), Vector3d(WorldOffsetKm * 1000.0, 0.0, 0.0)));
+}
+
 void OculusWorldDemoApp::DistortionClearColorChange(OptionVar*)
 {
     float clearColor[2][4] = { { 0.0f, 0.0f, 0.0f, 0.0f },
@@ -33,6 +33,8 @@ limitations under the License.
 #include "Kernel/OVR_Timer.h"
 #include "Kernel/OVR_DebugHelp.h"
 #include "Extras/OVR_Math.h"
+#include "Extras/OVR_CAPI_Properties.h"
+#include "Extras/OVR_CAPI_Replay.h"
 
 #include "../CommonSrc/Platform/Platform_Default.h"
 #include "../CommonSrc/Render/Render_Device.h"
@@ -150,6 +152,7 @@ public:
     void         RenderControllers(ovrEyeType eye);
     void         RenderCockpitPanels(ovrEyeType eye);
 
+    Posef        CalculateWorldFromEye(const Posef& pose);
     Matrix4f     CalculateViewFromPose(const Posef& pose);
 
     // Determine whether this frame needs rendering based on timewarp timing and flags.
@@ -191,6 +194,7 @@ public:
     void RendertargetResolutionModeChange(OptionVar* = 0);
     void ForceAssetReloading(OptionVar* = 0);
     void CenterPupilDepthChange(OptionVar* = 0);
+    void WorldOffsetChange(OptionVar* = 0);
     void DistortionClearColorChange(OptionVar* = 0);
     void WindowSizeChange(OptionVar* = 0);
     void WindowSizeToNativeResChange(OptionVar* = 0);
@@ -296,6 +300,8 @@ protected:
     bool                HaveSync;
     bool                Replaying;
     bool                Recording;
+    bool                ClientReplaying;        // True while ovr_StartCallReplay results are returned by the shim.
+    bool                ClientRecording;        // True while the shim records with ovr_StartCallRecording.
 
     double              LastSyncTime;
     unsigned int        LastCameraFrame;
@@ -305,6 +311,7 @@ protected:
 
     Player				ThePlayer;
     Matrix4f            ViewFromWorld[2];   // One per eye.
+    Posef               WorldFromEye[2];    // The inverse of ViewFromWorld, as poses.
     Scene               MainScene;
     Scene               SmallGreenCube;
     Scene               SmallOculusCube;
@@ -317,6 +324,11 @@ protected:
     Scene               RedCubesScene;
     Scene               YellowCubesScene;
 
+    // Holds MainScene.World placed WorldOffsetKm kilometers from the origin. While the offset
+    // is non-zero, the world scene is rendered through it relative to the eye, and should look
+    // the same as without the offset.
+    WorldContainer      LargeWorld;
+
     //Boundary information related
     Scene               BoundaryScene;
     void                PopulateBoundaryScene(Scene* scene);
@@ -387,6 +399,19 @@ protected:
     // Read from the device, not sent to it.
     float               InterAxialDistance;
 
+    // Properties read every frame, resolved once per session. The live ones are refreshed
+    // together in a single call every frame, while the neck to eye distance, which only
+    // changes with the user profile, is refreshed every PropertyRefreshInterval. Properties
+    // that we set ourselves are updated on the spot.
+    static const double PropertyRefreshInterval;
+    ovrPropertyHandle   InterAxialDistanceProperty = nullptr;
+    ovrPropertyHandle   TrackingTrackerCountProperty = nullptr;
+    ovrPropertyHandle   NeckToEyeDistanceProperty = nullptr;
+    ovrPropertyHandle   DK2LatencyProperty = nullptr;
+    ovrPropertyHandle   LiveProperties[3];
+    unsigned int        LivePropertyCount = 0;
+    double              LastPropertyRefreshTime = 0.0;
+
     enum EyeTextureFormatOpt
     {
         //EyeTextureFormat_UNKNOWN,
@@ -405,6 +430,9 @@ protected:
         //EyeTextureFormat_BGRX8_SRGB,  - Not supported in OpenGL mode
     };
     EyeTextureFormatOpt EyeTextureFormat;
+    // Runs the kernel Timer on the recorded time while replaying a client recording.
+    static void OVR_CDECL OnCallReplayTime(uintptr_t userData, double timeInSeconds);
+
     static bool ShouldLoadedTexturesBeSrgb(EyeTextureFormatOpt eyeTextureFormat);
     static int GetRenderDeviceTextureFormatForEyeTextureFormat(EyeTextureFormatOpt eyeTextureFormat);
 
@@ -418,6 +446,7 @@ protected:
     };
     MonoscopicMode      MonoscopicRenderMode;
     float               PositionTrackingScale;
+    float               WorldOffsetKm;
     bool                ScaleAffectsEyeHeight;
     float               DesiredPixelDensity;
     float               AdaptivePixelDensity;
@@ -521,6 +550,7 @@ protected:
     bool                MultisampleEnabled;         // Did we actually get it?
     bool                SrgbRequested;
     bool                AnisotropicSample;
+    bool                PreferCookedTextures;   // Load the cooked DDS files of TGA textures where they exist.
     bool                SceneBrightnessGrayscale;
     Vector3f            SceneBrightness;
     bool                SceneBlack;
@@ -196,7 +196,8 @@ void OculusWorldDemoApp::PopulateScene(const char *fileName)
     ClearScene();
 
     XmlHandler xmlHandler;
-    if(!xmlHandler.ReadFile(fileName, pRender, &MainScene, &CollisionModels, &GroundCollisionModels, SrgbRequested, AnisotropicSample))
+    if(!xmlHandler.ReadFile(fileName, pRender, &MainScene, &CollisionModels, &GroundCollisionModels, SrgbRequested, AnisotropicSample,
+                            PreferCookedTextures))
     {
         Menu.SetPopupMessage("FILE LOAD FAILED");
         Menu.SetPopupTimeout(10.0f, true);
@@ -210,6 +211,7 @@ void OculusWorldDemoApp::PopulateScene(const char *fileName)
     unsigned int fillTextureLoadFlags = 0;
     fillTextureLoadFlags |= SrgbRequested ? TextureLoad_SrgbAware : 0;
     fillTextureLoadFlags |= AnisotropicSample ? TextureLoad_Anisotropic : 0;
+    fillTextureLoadFlags |= PreferCookedTextures ? TextureLoad_PreferCooked : 0;
 
     // 10x10x10 cubes.
     Ptr<Fill> fillR = *CreateTextureFill(pRender, mainFilePathNoExtension + "_greenCube.tga", fillTextureLoadFlags);
@@ -224,6 +226,16 @@ void OculusWorldDemoApp::PopulateScene(const char *fileName)
     Ptr<Fill> imageFill = *CreateTextureFill(pRender, mainFilePathNoExtension + "_OculusCube.tga", fillTextureLoadFlags);
     PopulateCubeFieldScene(&OculusCubesScene, imageFill.GetPtr(), 11, 4, 35, Vector3f(0.0f, 0.0f, -6.0f), 0.5f);
 
+    // These scenes don't change once loaded, so their world matrices are only computed once.
+    MainScene.BuildTransformCache();
+    GreenCubesScene.BuildTransformCache();
+    RedCubesScene.BuildTransformCache();
+    YellowCubesScene.BuildTransformCache();
+    OculusCubesScene.BuildTransformCache();
+
+    LargeWorld.Clear();
+    LargeWorld.Add(&MainScene.World, Posed(Quatd(), Vector3d(WorldOffsetKm * 1000.0, 0.0, 0.0)));
+
     Vector3f blockModelSizeVec = Vector3f(BlockModelSize, BlockModelSize, BlockModelSize);
 
     // Handy untextured green cube.
@@ -246,6 +258,7 @@ void OculusWorldDemoApp::PopulateScene(const char *fileName)
     int textureLoadFlags = 0;
     textureLoadFlags |= SrgbRequested ? TextureLoad_SrgbAware : 0;
     textureLoadFlags |= AnisotropicSample ? TextureLoad_Anisotropic : 0;
+    textureLoadFlags |= PreferCookedTextures ? TextureLoad_PreferCooked : 0;
     textureLoadFlags |= TextureLoad_MakePremultAlpha;
     textureLoadFlags |= TextureLoad_SwapTextureSet;
 
@@ -310,11 +323,13 @@ void OculusWorldDemoApp::PopulatePreloadScene()
 
     Ptr<File>    imageFile = *new SysFile((fileName + "_LoadScreen.tga").c_str());
     if (imageFile->IsValid())
-        LoadingTexture = *LoadTextureTgaTopDown(pRender, imageFile, TextureLoad_SrgbAware | TextureLoad_SwapTextureSet, 255);
+        LoadingTexture = *LoadTextureTgaTopDown(pRender, imageFile, TextureLoad_SrgbAware | TextureLoad_SwapTextureSet |
+                                                (PreferCookedTextures ? TextureLoad_PreferCooked : 0), 255);
 }
 
 void OculusWorldDemoApp::ClearScene()
 {
+    LargeWorld.Clear();
     MainScene.Clear();
     SmallGreenCube.Clear();
     SmallOculusCube.Clear();